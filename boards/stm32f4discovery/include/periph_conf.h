@@ -232,6 +232,16 @@ extern "C" {
 #define SPI_0_BUS_DIV           1   /* 1 -> SPI runs with half CPU clock, 0 -> quarter CPU clock */
 #define SPI_0_IRQ               SPI1_IRQn
 #define SPI_0_IRQ_HANDLER       isr_spi1
+/* SPI 0 DMA configuration (DMA2, channel 3, RX stream 0, TX stream 3) */
+#define SPI_0_DMA               DMA2
+#define SPI_0_DMA_CLKEN()       (RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN)
+#define SPI_0_DMA_CHAN          (3)
+#define SPI_0_DMA_RX_STREAM     DMA2_Stream0
+#define SPI_0_DMA_RX_NUM        (0)
+#define SPI_0_DMA_TX_STREAM     DMA2_Stream3
+#define SPI_0_DMA_TX_NUM        (3)
+#define SPI_0_DMA_IRQ           DMA2_Stream0_IRQn
+#define SPI_0_DMA_IRQ_HANDLER   isr_dma2_stream0
 /* SPI 0 pin configuration */
 #define SPI_0_SCK_PORT          GPIOA
 #define SPI_0_SCK_PIN           5
@@ -253,6 +263,16 @@ extern "C" {
 #define SPI_1_BUS_DIV           0   /* 1 -> SPI runs with half CPU clock, 0 -> quarter CPU clock */
 #define SPI_1_IRQ               SPI2_IRQn
 #define SPI_1_IRQ_HANDLER       isr_spi2
+/* SPI 1 DMA configuration (DMA1, channel 0, RX stream 3, TX stream 4) */
+#define SPI_1_DMA               DMA1
+#define SPI_1_DMA_CLKEN()       (RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN)
+#define SPI_1_DMA_CHAN          (0)
+#define SPI_1_DMA_RX_STREAM     DMA1_Stream3
+#define SPI_1_DMA_RX_NUM        (3)
+#define SPI_1_DMA_TX_STREAM     DMA1_Stream4
+#define SPI_1_DMA_TX_NUM        (4)
+#define SPI_1_DMA_IRQ           DMA1_Stream3_IRQn
+#define SPI_1_DMA_IRQ_HANDLER   isr_dma1_stream3
 /* SPI 1 pin configuration */
 #define SPI_1_SCK_PORT          GPIOB
 #define SPI_1_SCK_PIN           13
@@ -15,6 +15,15 @@
  * @file
  * @brief       RIOT synchronization API
  *
+ * With the pseudo module `mutex_priority_inheritance` the owner of a locked
+ * mutex is boosted to the priority of its highest priority waiter, also
+ * transitively along chains of threads blocked on mutexes. On unlock the
+ * owner drops to the highest priority of its own base priority and the
+ * waiters of the mutexes it still holds, so nested mutexes may be unlocked
+ * in any order. A mutex unlocked by an ISR or by a thread that does not own
+ * it is used for signalling: the thread woken up is not tracked as its
+ * owner and inherits no priority through it.
+ *
  * @author      Kaspar Schleiser <kaspar@schleiser.de>
  */
 
@@ -23,6 +32,7 @@
 
 #include "priority_queue.h"
 #include "atomic.h"
+#include "kernel_types.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -45,13 +55,31 @@ typedef struct mutex_t {
      * @internal
      */
     priority_queue_t queue;
+#if defined(MODULE_MUTEX_PRIORITY_INHERITANCE) || defined(DOXYGEN)
+    /**
+     * @brief   The thread holding the mutex. **Must never be changed by the
+     *          user.**
+     * @internal
+     */
+    kernel_pid_t owner;
+    /**
+     * @brief   The next mutex held by @p owner. **Must never be changed by
+     *          the user.**
+     * @internal
+     */
+    struct mutex_t *owner_next;
+#endif
 } mutex_t;
 
 /**
  * @brief Static initializer for mutex_t.
  * @details This initializer is preferable to mutex_init().
  */
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+#define MUTEX_INIT { ATOMIC_INIT(0), PRIORITY_QUEUE_INIT, KERNEL_PID_UNDEF, NULL }
+#else
 #define MUTEX_INIT { ATOMIC_INIT(0), PRIORITY_QUEUE_INIT }
+#endif
 
 /**
  * @brief Initializes a mutex object.
@@ -28,11 +28,29 @@
 
 /**
  * @brief data type for priority queue nodes
+ *
+ * All nodes are chained by @p next in priority order. Additionally the
+ * first node of each priority links to the first node of the next priority
+ * and to the last node of its own priority. So adding a node only walks the
+ * distinct priorities in the queue (at most SCHED_PRIO_LEVELS for thread
+ * priorities), not all nodes.
  */
 typedef struct priority_queue_node_t {
     struct priority_queue_node_t *next; /**< next queue node */
     uint32_t priority;                  /**< queue node priority */
     unsigned int data;                  /**< queue node data */
+    /**
+     * @brief   first node of the next priority, only valid for the first
+     *          node of each priority
+     * @internal
+     */
+    struct priority_queue_node_t *next_bucket;
+    /**
+     * @brief   last node of this priority, only valid for the first node of
+     *          each priority
+     * @internal
+     */
+    struct priority_queue_node_t *bucket_tail;
 } priority_queue_node_t;
 
 /**
@@ -45,7 +63,7 @@ typedef struct queue {
 /**
  * @brief Static initializer for priority_queue_node_t.
  */
-#define PRIORITY_QUEUE_NODE_INIT { NULL, 0, 0 }
+#define PRIORITY_QUEUE_NODE_INIT { NULL, 0, 0, NULL, NULL }
 
 /**
  * @brief   Initialize a priority queue node object.
@@ -84,6 +102,8 @@ static inline void priority_queue_init(priority_queue_t *priority_queue)
 /**
  * @brief remove the priority queue's head
  *
+ * @details Runs in constant time.
+ *
  * @param[out]  root    the queue's root
  *
  * @return              the old head
@@ -95,6 +115,7 @@ priority_queue_node_t *priority_queue_remove_head(priority_queue_t *root);
  *
  * @details
  * The new object will be appended after objects with the same priority.
+ * Runs in time linear in the number of distinct priorities in the queue.
  *
  * @param[in,out]   root    the queue's root
  * @param[in]       new_obj the object to prepend
@@ -104,6 +125,9 @@ void priority_queue_add(priority_queue_t *root, priority_queue_node_t *new_obj);
 /**
  * @brief remove `node` from `root`
  *
+ * @details Runs in time linear in the number of distinct priorities in the
+ *          queue plus the number of nodes of the same priority as `node`.
+ *
  * @param[in,out]   root    the priority queue's root
  * @param[in]       node    the node to remove
  */
@@ -104,6 +104,37 @@ unsigned ringbuffer_get(ringbuffer_t *__restrict rb, char *buf, unsigned n);
  */
 unsigned ringbuffer_remove(ringbuffer_t *__restrict rb, unsigned n);
 
+/**
+ * @brief           Get the contiguous region at the start of the ringbuffer.
+ * @details         Allows to read elements in place. The ringbuffer wraps at
+ *                  most once, so a second call after ringbuffer_remove()
+ *                  yields the rest.
+ * @param[in]       rb       Ringbuffer to operate on.
+ * @param[out]      region   Start of the oldest element.
+ * @returns         Number of elements that can be read from @p region.
+ *                  Pass the number actually read to ringbuffer_remove().
+ */
+unsigned ringbuffer_get_region(const ringbuffer_t *__restrict rb, char **region);
+
+/**
+ * @brief           Get the contiguous free region at the end of the ringbuffer.
+ * @details         Allows to write elements in place, e.g. by a driver.
+ * @param[in]       rb       Ringbuffer to operate on.
+ * @param[out]      region   Position of the next element to add.
+ * @returns         Number of elements that can be written to @p region.
+ *                  Pass the number actually written to ringbuffer_add_commit().
+ */
+unsigned ringbuffer_add_region(const ringbuffer_t *__restrict rb, char **region);
+
+/**
+ * @brief           Add elements written to the region returned by
+ *                  ringbuffer_add_region().
+ * @param[in,out]   rb    Ringbuffer to operate on.
+ * @param[in]       n     Number of elements written.
+ * @returns         Number of elements actually added.
+ */
+unsigned ringbuffer_add_commit(ringbuffer_t *__restrict rb, unsigned n);
+
 /**
  * @brief           Test if the ringbuffer is empty.
  * @param[in,out]   rb    Ringbuffer to operate on.
@@ -114,6 +114,18 @@ int sched_run(void);
  */
 void sched_set_status(tcb_t *process, unsigned int status);
 
+/**
+ * @brief       Change the priority of a thread
+ *
+ * @details     A thread on a run queue is moved to the run queue of its new
+ *              priority. Does not yield, the caller has to trigger a context
+ *              switch if appropriate.
+ *
+ * @param[in]   process     The thread to change the priority of
+ * @param[in]   priority    The new priority
+ */
+void sched_change_priority(tcb_t *process, uint16_t priority);
+
 /**
  * @brief       Yield if approriate.
  *
@@ -173,6 +185,8 @@ typedef struct {
                                          scheduled to run */
     unsigned int schedules;         /**< How often the thread was scheduled to run */
     unsigned long runtime_ticks;    /**< The total runtime of this thread in ticks */
+    unsigned int msg_queue_peak;    /**< Highest number of messages that were
+                                         queued at the same time */
 } schedstat;
 
 /**
@@ -180,6 +194,29 @@ typedef struct {
  */
 extern schedstat sched_pidlist[KERNEL_PID_LAST + 1];
 
+/**
+ *  Total time spent in interrupt service routines in ticks
+ */
+extern unsigned long sched_isr_ticks;
+
+/**
+ *  Longest time spent in a single interrupt service routine in ticks
+ */
+extern unsigned long sched_isr_max_ticks;
+
+/**
+ *  @brief  Marks the entry of an interrupt service routine
+ *
+ *  Nested calls are only accounted for once. Has to be paired with
+ *  sched_isr_exit().
+ */
+void sched_isr_enter(void);
+
+/**
+ *  @brief  Marks the exit of an interrupt service routine
+ */
+void sched_isr_exit(void);
+
 /**
  *  @brief  Register a callback that will be called on every scheduler run
  *
@@ -25,6 +25,7 @@
 #include "clist.h"
 #include "cib.h"
 #include "msg.h"
+#include "thread_flags.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -44,6 +45,8 @@
 #define STATUS_RECEIVE_BLOCKED  3               /**< waiting for a message              */
 #define STATUS_SEND_BLOCKED     4               /**< waiting for message to be delivered*/
 #define STATUS_REPLY_BLOCKED    5               /**< waiting for a message response     */
+#define STATUS_FLAG_BLOCKED_ANY 6               /**< waiting for any of its flags       */
+#define STATUS_FLAG_BLOCKED_ALL 7               /**< waiting for all of its flags       */
 /** @} */
 
 /**
@@ -51,8 +54,8 @@
  * @{*/
 #define STATUS_ON_RUNQUEUE      STATUS_RUNNING  /**< to check if on run queue:
                                                  `st >= STATUS_ON_RUNQUEUE`             */
-#define STATUS_RUNNING          6               /**< currently running                  */
-#define STATUS_PENDING          7               /**< waiting to be scheduled to run     */
+#define STATUS_RUNNING          8               /**< currently running                  */
+#define STATUS_PENDING          9               /**< waiting to be scheduled to run     */
 /** @} */
 /** @} */
 
@@ -74,12 +77,23 @@ typedef struct tcb_t {
     cib_t msg_queue;            /**< message queue                  */
     msg_t *msg_array;           /**< memory holding messages        */
 
+#if defined(MODULE_THREAD_FLAGS) || defined(DOXYGEN)
+    thread_flags_t flags;       /**< thread flags                   */
+#endif
+
+#if defined(MODULE_MUTEX_PRIORITY_INHERITANCE) || defined(DOXYGEN)
+    uint16_t base_priority;     /**< priority without inheritance   */
+    struct mutex_t *mutexes;    /**< mutexes held by the thread     */
+#endif
+
 #if defined DEVELHELP || defined(SCHED_TEST_STACK)
     char *stack_start;          /**< thread's stack start address   */
 #endif
 #ifdef DEVELHELP
     const char *name;           /**< thread's name                  */
     int stack_size;             /**< thread's stack size            */
+    char *stack_watermark;      /**< lowest stack address known to
+                                     be used                         */
 #endif
 } tcb_t;
 
@@ -75,6 +75,14 @@
 #define THREAD_STACKSIZE_MINIMUM  (sizeof(tcb_t))
 #endif
 
+/**
+ * @brief Number of consecutive untouched stack words after which
+ *        thread_measure_stack_free_cached() stops searching
+ */
+#ifndef THREAD_STACK_WATERMARK_GAP
+#define THREAD_STACK_WATERMARK_GAP (8)
+#endif
+
 /**
  * @def THREAD_PRIORITY_MIN
  * @brief Least priority a thread can have
@@ -236,6 +244,22 @@ const char *thread_getname(kernel_pid_t pid);
  * @return          the amount of unused space of the thread's stack
  */
 uintptr_t thread_measure_stack_free(char *stack);
+
+/**
+ * @brief Updates and returns the cached stack watermark of a thread
+ *
+ * Only the words below the last known watermark are checked, so repeated
+ * calls are cheap. The search stops after THREAD_STACK_WATERMARK_GAP
+ * untouched words, so a large local buffer that was never written can hide
+ * deeper usage. Use thread_measure_stack_free() for an exact value.
+ *
+ * Only works if the thread was created with the flag CREATE_STACKTEST.
+ *
+ * @param[in] thread    the thread to measure
+ *
+ * @return              the amount of unused space of the thread's stack
+ */
+uintptr_t thread_measure_stack_free_cached(tcb_t *thread);
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    core_thread_flags  Thread Flags
+ * @ingroup     core
+ * @brief       Thread flags
+ *
+ * Thread flags are a lightweight way to signal events to a thread. Every
+ * thread has a set of 16 flags stored in its @ref tcb_t. Other threads and
+ * interrupt service routines can set flags with thread_flags_set(), a thread
+ * waits for any or all of a set of flags with thread_flags_wait_any() or
+ * thread_flags_wait_all().
+ *
+ * Other than an empty @ref msg_t used as a wakeup signal, setting a flag
+ * needs no message queue and can never fail because a queue is full. Setting
+ * a flag that is already set has no further effect, so flags do not count
+ * events.
+ *
+ * Enable with `USEMODULE += thread_flags`. Waiting with a timeout is
+ * provided by xtimer_thread_flags_wait_any() and
+ * xtimer_thread_flags_wait_all().
+ *
+ * @{
+ *
+ * @file
+ * @brief       Thread flags API
+ */
+
+#ifndef THREAD_FLAGS_H
+#define THREAD_FLAGS_H
+
+#include <stdint.h>
+
+#include "kernel_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Type of a thread's flags
+ */
+typedef uint16_t thread_flags_t;
+
+/**
+ * @brief   Flag set by a timed out xtimer_thread_flags_wait_any() or
+ *          xtimer_thread_flags_wait_all()
+ *
+ * If this flag is part of the mask passed to thread_flags_wait_all(), it is
+ * not waited for itself but ends the wait on its own.
+ */
+#define THREAD_FLAG_TIMEOUT     (1u << 15)
+
+/**
+ * @brief   Set flags of a thread
+ *
+ * Wakes up the thread if it waits for the flags. May be called from
+ * interrupt context.
+ *
+ * @param[in] pid   thread to set the flags of
+ * @param[in] mask  flags to set
+ *
+ * @return  1 on success
+ * @return  STATUS_NOT_FOUND if @p pid is no valid thread
+ */
+int thread_flags_set(kernel_pid_t pid, thread_flags_t mask);
+
+/**
+ * @brief   Clear flags of the current thread
+ *
+ * @param[in] mask  flags to clear
+ *
+ * @return  the flags of @p mask that were set
+ */
+thread_flags_t thread_flags_clear(thread_flags_t mask);
+
+/**
+ * @brief   Wait until any of the given flags of the current thread is set
+ *
+ * Returns immediately if any of the flags is already set.
+ *
+ * @param[in] mask  flags to wait for
+ *
+ * @return  the flags of @p mask that were set, they are cleared
+ */
+thread_flags_t thread_flags_wait_any(thread_flags_t mask);
+
+/**
+ * @brief   Wait until all of the given flags of the current thread are set
+ *
+ * Returns immediately if all of the flags are already set.
+ *
+ * @param[in] mask  flags to wait for
+ *
+ * @return  @p mask without THREAD_FLAG_TIMEOUT, these flags are cleared
+ * @return  THREAD_FLAG_TIMEOUT if it is part of @p mask and was set before
+ *          all other flags, only this flag is cleared then
+ */
+thread_flags_t thread_flags_wait_all(thread_flags_t mask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREAD_FLAGS_H */
+/** @} */
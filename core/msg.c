@@ -51,6 +51,15 @@ static int queue_msg(tcb_t *target, const msg_t *m)
     DEBUG("queue_msg(): queuing message\n");
     msg_t *dest = &target->msg_array[n];
     *dest = *m;
+
+#ifdef MODULE_SCHEDSTATISTICS
+    schedstat *stat = &sched_pidlist[target->pid];
+    unsigned int queued = cib_avail(&(target->msg_queue));
+    if (queued > stat->msg_queue_peak) {
+        stat->msg_queue_peak = queued;
+    }
+#endif
+
     return 1;
 }
 
@@ -377,6 +386,9 @@ int msg_init_queue(msg_t *array, int num)
         tcb_t *me = (tcb_t*) sched_active_thread;
         me->msg_array = array;
         cib_init(&(me->msg_queue), num);
+#ifdef MODULE_SCHEDSTATISTICS
+        sched_pidlist[me->pid].msg_queue_peak = 0;
+#endif
         return 0;
     }
 
@@ -36,6 +36,126 @@
 
 static void mutex_wait(struct mutex_t *mutex);
 
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+#ifndef MUTEX_PI_MAX_DEPTH
+/**
+ * @brief   Maximum length of a chain of blocked threads that is boosted
+ */
+#define MUTEX_PI_MAX_DEPTH  (8)
+#endif
+
+/**
+ * @brief   Make @p thread the owner of @p mutex, must be called with
+ *          interrupts disabled
+ */
+static inline void set_owner(struct mutex_t *mutex, tcb_t *thread)
+{
+    mutex->owner = thread->pid;
+    mutex->owner_next = thread->mutexes;
+    thread->mutexes = mutex;
+}
+
+/**
+ * @brief   Boost the owner of @p mutex to @p priority and follow the chain
+ *          of mutexes the owners are blocked on, must be called with
+ *          interrupts disabled
+ */
+static void boost_owners(struct mutex_t *mutex, uint16_t priority)
+{
+    for (unsigned depth = 0; depth < MUTEX_PI_MAX_DEPTH; depth++) {
+        if (!pid_is_valid(mutex->owner)) {
+            return;
+        }
+
+        tcb_t *owner = (tcb_t *) sched_threads[mutex->owner];
+
+        if (!owner || (owner->priority <= priority)) {
+            return;
+        }
+
+        DEBUG("mutex: boosting thread %" PRIkernel_pid " to %" PRIu16 "\n", owner->pid, priority);
+        sched_change_priority(owner, priority);
+
+        if (owner->status != STATUS_MUTEX_BLOCKED) {
+            return;
+        }
+
+        /* the owner waits for another mutex: resort it in the waiting queue
+         * and boost that mutex' owner as well */
+        mutex = owner->wait_data;
+
+        for (priority_queue_node_t *n = mutex->queue.first; n; n = n->next) {
+            if (n->data == (unsigned int) owner) {
+                priority_queue_remove(&mutex->queue, n);
+                n->priority = priority;
+                priority_queue_add(&mutex->queue, n);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Release @p mutex from its owner and give the owner the priority
+ *          it inherits from the mutexes it still holds, must be called with
+ *          interrupts disabled
+ *
+ * @return  1 if the priority was lowered, 0 otherwise
+ */
+static int restore_owner(struct mutex_t *mutex)
+{
+    int lowered = 0;
+
+    if (pid_is_valid(mutex->owner) && sched_threads[mutex->owner]) {
+        tcb_t *owner = (tcb_t *) sched_threads[mutex->owner];
+        uint16_t priority = owner->base_priority;
+
+        for (struct mutex_t **m = &owner->mutexes; *m; m = &(*m)->owner_next) {
+            if (*m == mutex) {
+                *m = mutex->owner_next;
+                break;
+            }
+        }
+
+        /* the wait queues are sorted, so their heads are the highest
+         * priority waiters */
+        for (struct mutex_t *m = owner->mutexes; m; m = m->owner_next) {
+            if (m->queue.first && (m->queue.first->priority < priority)) {
+                priority = m->queue.first->priority;
+            }
+        }
+
+        lowered = (owner->priority < priority);
+        sched_change_priority(owner, priority);
+    }
+
+    mutex->owner = KERNEL_PID_UNDEF;
+    mutex->owner_next = NULL;
+    return lowered;
+}
+
+int mutex_trylock(struct mutex_t *mutex)
+{
+    DEBUG("%s: trylocking to get mutex. val: %u\n", sched_active_thread->name, ATOMIC_VALUE(mutex->val));
+    unsigned irqstate = disableIRQ();
+    int res = atomic_set_to_one(&mutex->val);
+
+    if (res) {
+        set_owner(mutex, (tcb_t *) sched_active_thread);
+    }
+
+    restoreIRQ(irqstate);
+    return res;
+}
+
+void mutex_lock(struct mutex_t *mutex)
+{
+    DEBUG("%s: trying to get mutex. val: %u\n", sched_active_thread->name, ATOMIC_VALUE(mutex->val));
+
+    /* mutex_wait() takes the mutex right away if it is unlocked */
+    mutex_wait(mutex);
+}
+#else
 int mutex_trylock(struct mutex_t *mutex)
 {
     DEBUG("%s: trylocking to get mutex. val: %u\n", sched_active_thread->name, ATOMIC_VALUE(mutex->val));
@@ -51,6 +171,7 @@ void mutex_lock(struct mutex_t *mutex)
         mutex_wait(mutex);
     }
 }
+#endif /* MODULE_MUTEX_PRIORITY_INHERITANCE */
 
 static void mutex_wait(struct mutex_t *mutex)
 {
@@ -60,6 +181,9 @@ static void mutex_wait(struct mutex_t *mutex)
     if (atomic_set_to_one(&mutex->val)) {
         /* somebody released the mutex. return. */
         DEBUG("%s: mutex_wait early out. %u\n", sched_active_thread->name, ATOMIC_VALUE(mutex->val));
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+        set_owner(mutex, (tcb_t *) sched_active_thread);
+#endif
         restoreIRQ(irqstate);
         return;
     }
@@ -75,6 +199,11 @@ static void mutex_wait(struct mutex_t *mutex)
 
     priority_queue_add(&(mutex->queue), &n);
 
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    sched_active_thread->wait_data = (void *) mutex;
+    boost_owners(mutex, sched_active_thread->priority);
+#endif
+
     restoreIRQ(irqstate);
 
     thread_yield_higher();
@@ -93,17 +222,36 @@ void mutex_unlock(struct mutex_t *mutex)
         return;
     }
 
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    /* a mutex unlocked by an ISR or a foreign thread is used for signalling,
+     * the woken up thread is not tracked as its owner */
+    int handoff = !inISR() && (mutex->owner == sched_active_pid);
+    int lowered = restore_owner(mutex);
+#endif
+
     priority_queue_node_t *next = priority_queue_remove_head(&(mutex->queue));
     if (!next) {
         /* the mutex was locked and no thread was waiting for it */
         ATOMIC_VALUE(mutex->val) = 0;
         restoreIRQ(irqstate);
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+        if (lowered && !inISR()) {
+            thread_yield_higher();
+        }
+#endif
         return;
     }
 
     tcb_t *process = (tcb_t *) next->data;
     DEBUG("mutex_unlock: waking up waiting thread %" PRIkernel_pid "\n", process->pid);
     sched_set_status(process, STATUS_PENDING);
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    if (handoff) {
+        set_owner(mutex, process);
+        /* the remaining waiters don't have a higher priority than the new
+         * owner */
+    }
+#endif
 
     uint16_t process_priority = process->priority;
     restoreIRQ(irqstate);
@@ -116,11 +264,20 @@ void mutex_unlock_and_sleep(struct mutex_t *mutex)
     unsigned irqstate = disableIRQ();
 
     if (ATOMIC_VALUE(mutex->val) != 0) {
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+        int handoff = (mutex->owner == sched_active_pid);
+        restore_owner(mutex);
+#endif
         priority_queue_node_t *next = priority_queue_remove_head(&(mutex->queue));
         if (next) {
             tcb_t *process = (tcb_t *) next->data;
             DEBUG("%s: waking up waiter.\n", process->name);
             sched_set_status(process, STATUS_PENDING);
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+            if (handoff) {
+                set_owner(mutex, process);
+            }
+#endif
         }
         else {
             ATOMIC_VALUE(mutex->val) = 0; /* This is safe, interrupts are disabled */
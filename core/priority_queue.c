@@ -24,48 +24,106 @@
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-void priority_queue_remove(priority_queue_t *root_, priority_queue_node_t *node)
+void priority_queue_remove(priority_queue_t *root, priority_queue_node_t *node)
 {
-    /* The strict aliasing rules allow this assignment. */
-    priority_queue_node_t *root = (priority_queue_node_t *) root_;
+    priority_queue_node_t *prev_bucket = NULL;
+    priority_queue_node_t *bucket = root->first;
 
-    while (root->next != NULL) {
-        if (root->next == node) {
-            root->next = node->next;
-            node->next = NULL;
+    while (bucket && (bucket->priority < node->priority)) {
+        prev_bucket = bucket;
+        bucket = bucket->next_bucket;
+    }
+
+    if (!bucket || (bucket->priority != node->priority)) {
+        return;
+    }
+
+    /* find the predecessor of node within its bucket */
+    priority_queue_node_t *prev = prev_bucket ? prev_bucket->bucket_tail : NULL;
+
+    for (priority_queue_node_t *n = bucket; n != node; n = n->next) {
+        if (n == bucket->bucket_tail) {
+            /* node is not in the queue */
             return;
         }
+        prev = n;
+    }
+
+    if (node == bucket) {
+        priority_queue_node_t *first = node->next_bucket;
+
+        if (node != node->bucket_tail) {
+            /* the successor becomes the first node of the bucket */
+            first = node->next;
+            first->next_bucket = node->next_bucket;
+            first->bucket_tail = node->bucket_tail;
+        }
+
+        if (prev_bucket) {
+            prev_bucket->next_bucket = first;
+        }
+    }
+    else if (node == bucket->bucket_tail) {
+        bucket->bucket_tail = prev;
+    }
 
-        root = root->next;
+    if (prev) {
+        prev->next = node->next;
+    }
+    else {
+        root->first = node->next;
     }
+
+    node->next = NULL;
 }
 
 priority_queue_node_t *priority_queue_remove_head(priority_queue_t *root)
 {
     priority_queue_node_t *head = root->first;
     if (head) {
-        root->first = head->next;
+        priority_queue_node_t *next = head->next;
+
+        if (next && (next->priority == head->priority)) {
+            next->next_bucket = head->next_bucket;
+            next->bucket_tail = head->bucket_tail;
+        }
+
+        root->first = next;
     }
     return head;
 }
 
 void priority_queue_add(priority_queue_t *root, priority_queue_node_t *new_obj)
 {
-    /* The strict aliasing rules allow this assignment. */
-    priority_queue_node_t *node = (priority_queue_node_t *) root;
+    priority_queue_node_t *prev_bucket = NULL;
+    priority_queue_node_t *bucket = root->first;
 
-    while (node->next != NULL) {
-        if (node->next->priority > new_obj->priority) {
-            new_obj->next = node->next;
-            node->next = new_obj;
-            return;
-        }
+    /* only visit the first node of every priority */
+    while (bucket && (bucket->priority <= new_obj->priority)) {
+        prev_bucket = bucket;
+        bucket = bucket->next_bucket;
+    }
 
-        node = node->next;
+    if (prev_bucket && (prev_bucket->priority == new_obj->priority)) {
+        /* append to the nodes of the same priority */
+        new_obj->next = prev_bucket->bucket_tail->next;
+        prev_bucket->bucket_tail->next = new_obj;
+        prev_bucket->bucket_tail = new_obj;
+        return;
     }
 
-    node->next = new_obj;
-    new_obj->next = NULL;
+    /* first node of its priority */
+    new_obj->next = bucket;
+    new_obj->next_bucket = bucket;
+    new_obj->bucket_tail = new_obj;
+
+    if (prev_bucket) {
+        prev_bucket->bucket_tail->next = new_obj;
+        prev_bucket->next_bucket = new_obj;
+    }
+    else {
+        root->first = new_obj;
+    }
 }
 
 #if ENABLE_DEBUG
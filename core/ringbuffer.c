@@ -54,14 +54,49 @@ static char get_head(ringbuffer_t *restrict rb)
 
 unsigned ringbuffer_add(ringbuffer_t *restrict rb, const char *buf, unsigned n)
 {
-    unsigned i;
-    for (i = 0; i < n; i++) {
-        if (ringbuffer_full(rb)) {
-            break;
+    unsigned free = rb->size - rb->avail;
+    if (n > free) {
+        n = free;
+    }
+    if (n > 0) {
+        unsigned pos = rb->start + rb->avail;
+        if (pos >= rb->size) {
+            pos -= rb->size;
+        }
+        unsigned bytes_till_end = rb->size - pos;
+        if (bytes_till_end >= n) {
+            memcpy(rb->buf + pos, buf, n);
+        }
+        else {
+            memcpy(rb->buf + pos, buf, bytes_till_end);
+            memcpy(rb->buf, buf + bytes_till_end, n - bytes_till_end);
         }
-        add_tail(rb, buf[i]);
+        rb->avail += n;
+    }
+    return n;
+}
+
+unsigned ringbuffer_add_region(const ringbuffer_t *restrict rb, char **region)
+{
+    unsigned pos = rb->start + rb->avail;
+    if (pos >= rb->size) {
+        pos -= rb->size;
+        /* the free space ends at the read position */
+        *region = rb->buf + pos;
+        return rb->start - pos;
     }
-    return i;
+    *region = rb->buf + pos;
+    return rb->size - pos;
+}
+
+unsigned ringbuffer_add_commit(ringbuffer_t *restrict rb, unsigned n)
+{
+    unsigned free = rb->size - rb->avail;
+    if (n > free) {
+        n = free;
+    }
+    rb->avail += n;
+    return n;
 }
 
 int ringbuffer_add_one(ringbuffer_t *restrict rb, char c)
@@ -112,23 +147,30 @@ unsigned ringbuffer_get(ringbuffer_t *restrict rb, char *buf, unsigned n)
 
 unsigned ringbuffer_remove(ringbuffer_t *restrict rb, unsigned n)
 {
-    if (n > rb->avail) {
+    if (n >= rb->avail) {
         n = rb->avail;
         rb->start = rb->avail = 0;
     }
     else {
-        rb->start -= n;
+        rb->start += n;
         rb->avail -= n;
 
-        /* compensate underflow */
-        if (rb->start > rb->size) {
-            rb->start += rb->size;
+        /* compensate overflow */
+        if (rb->start >= rb->size) {
+            rb->start -= rb->size;
         }
     }
 
     return n;
 }
 
+unsigned ringbuffer_get_region(const ringbuffer_t *restrict rb, char **region)
+{
+    unsigned bytes_till_end = rb->size - rb->start;
+    *region = rb->buf + rb->start;
+    return (rb->avail < bytes_till_end) ? rb->avail : bytes_till_end;
+}
+
 int ringbuffer_peek_one(const ringbuffer_t *restrict rb_)
 {
     ringbuffer_t rb = *rb_;
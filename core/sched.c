@@ -58,6 +58,10 @@ static uint32_t runqueue_bitcache = 0;
 #ifdef MODULE_SCHEDSTATISTICS
 static void (*sched_cb) (uint32_t timestamp, uint32_t value) = NULL;
 schedstat sched_pidlist[KERNEL_PID_LAST + 1];
+unsigned long sched_isr_ticks;
+unsigned long sched_isr_max_ticks;
+static unsigned sched_isr_nesting;
+static uint32_t sched_isr_start;
 #endif
 
 int sched_run(void)
@@ -127,6 +131,24 @@ void sched_register_cb(void (*callback)(uint32_t, uint32_t))
 {
     sched_cb = callback;
 }
+
+void sched_isr_enter(void)
+{
+    if (sched_isr_nesting++ == 0) {
+        sched_isr_start = xtimer_now();
+    }
+}
+
+void sched_isr_exit(void)
+{
+    if (--sched_isr_nesting == 0) {
+        unsigned long duration = xtimer_now() - sched_isr_start;
+        sched_isr_ticks += duration;
+        if (duration > sched_isr_max_ticks) {
+            sched_isr_max_ticks = duration;
+        }
+    }
+}
 #endif
 
 void sched_set_status(tcb_t *process, unsigned int status)
@@ -154,6 +176,29 @@ void sched_set_status(tcb_t *process, unsigned int status)
     process->status = status;
 }
 
+void sched_change_priority(tcb_t *process, uint16_t priority)
+{
+    if (process->priority == priority) {
+        return;
+    }
+
+    DEBUG("sched_change_priority: thread %" PRIkernel_pid " from %" PRIu16 " to %" PRIu16 ".\n",
+          process->pid, process->priority, priority);
+
+    if (process->status >= STATUS_ON_RUNQUEUE) {
+        clist_remove(&sched_runqueues[process->priority], &(process->rq_entry));
+
+        if (!sched_runqueues[process->priority]) {
+            runqueue_bitcache &= ~(1 << process->priority);
+        }
+
+        clist_add(&sched_runqueues[priority], &(process->rq_entry));
+        runqueue_bitcache |= 1 << priority;
+    }
+
+    process->priority = priority;
+}
+
 void sched_switch(uint16_t other_prio)
 {
     tcb_t *active_thread = (tcb_t *) sched_active_thread;
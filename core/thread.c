@@ -20,6 +20,7 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "thread.h"
 #include "kernel.h"
@@ -116,6 +117,30 @@ uintptr_t thread_measure_stack_free(char *stack)
     uintptr_t space_free = (uintptr_t) stackp - (uintptr_t) stack;
     return space_free;
 }
+
+uintptr_t thread_measure_stack_free_cached(tcb_t *thread)
+{
+    uintptr_t *stack = (uintptr_t *) thread->stack_start;
+    uintptr_t *mark = (uintptr_t *) thread->stack_watermark;
+    uintptr_t *stackp = mark;
+    unsigned clean = 0;
+
+    /* the used part only grows, so start below the last known watermark and
+     * stop after a couple of untouched words */
+    while (stackp > stack && clean < THREAD_STACK_WATERMARK_GAP) {
+        stackp--;
+        if (*stackp == (uintptr_t) stackp) {
+            clean++;
+        }
+        else {
+            mark = stackp;
+            clean = 0;
+        }
+    }
+
+    thread->stack_watermark = (char *) mark;
+    return (uintptr_t) mark - (uintptr_t) stack;
+}
 #endif
 
 kernel_pid_t thread_create(char *stack, int stacksize, char priority, int flags, thread_task_func_t function, void *arg, const char *name)
@@ -189,9 +214,14 @@ kernel_pid_t thread_create(char *stack, int stacksize, char priority, int flags,
 #ifdef DEVELHELP
     cb->stack_start = stack;
     cb->stack_size = total_stacksize;
+    cb->stack_watermark = (char *) cb;
     cb->name = name;
 #endif
 
+#ifdef MODULE_SCHEDSTATISTICS
+    memset(&sched_pidlist[pid], 0, sizeof(schedstat));
+#endif
+
     cb->priority = priority;
     cb->status = 0;
 
@@ -205,6 +235,15 @@ kernel_pid_t thread_create(char *stack, int stacksize, char priority, int flags,
     cib_init(&(cb->msg_queue), 0);
     cb->msg_array = NULL;
 
+#ifdef MODULE_THREAD_FLAGS
+    cb->flags = 0;
+#endif
+
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    cb->base_priority = priority;
+    cb->mutexes = NULL;
+#endif
+
     sched_num_threads++;
 
     DEBUG("Created thread %s. PID: %" PRIkernel_pid ". Priority: %u.\n", name, cb->pid, priority);
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     core_thread_flags
+ * @{
+ *
+ * @file
+ * @brief       Thread flags implementation
+ *
+ * @}
+ */
+
+#ifdef MODULE_THREAD_FLAGS
+
+#include "thread_flags.h"
+#include "thread.h"
+#include "irq.h"
+#include "sched.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* the mask a thread waits for is kept in wait_data */
+#define WAIT_MASK(thread)   ((thread_flags_t)(uintptr_t)(thread)->wait_data)
+
+/* THREAD_FLAG_TIMEOUT in mask is not waited for but ends the wait */
+static inline int _all_set(thread_flags_t flags, thread_flags_t mask)
+{
+    thread_flags_t wanted = mask & ~THREAD_FLAG_TIMEOUT;
+
+    return ((flags & wanted) == wanted) || (flags & mask & THREAD_FLAG_TIMEOUT);
+}
+
+static int _wake(tcb_t *thread)
+{
+    thread_flags_t mask = WAIT_MASK(thread);
+
+    switch (thread->status) {
+        case STATUS_FLAG_BLOCKED_ANY:
+            return (thread->flags & mask) != 0;
+        case STATUS_FLAG_BLOCKED_ALL:
+            return _all_set(thread->flags, mask);
+        default:
+            return 0;
+    }
+}
+
+static void _wait(tcb_t *me, thread_flags_t mask, unsigned status,
+                  unsigned state)
+{
+    DEBUG("thread_flags: %" PRIkernel_pid " waits for 0x%04x\n", me->pid,
+          (unsigned)mask);
+
+    me->wait_data = (void *)(uintptr_t)mask;
+    sched_set_status(me, status);
+    restoreIRQ(state);
+    thread_yield_higher();
+}
+
+int thread_flags_set(kernel_pid_t pid, thread_flags_t mask)
+{
+    unsigned state = disableIRQ();
+    tcb_t *thread = (tcb_t *)thread_get(pid);
+
+    if (thread == NULL) {
+        restoreIRQ(state);
+        return STATUS_NOT_FOUND;
+    }
+
+    thread->flags |= mask;
+
+    if (_wake(thread)) {
+        thread->wait_data = NULL;
+        sched_set_status(thread, STATUS_PENDING);
+        restoreIRQ(state);
+        sched_switch(thread->priority);
+    }
+    else {
+        restoreIRQ(state);
+    }
+
+    return 1;
+}
+
+thread_flags_t thread_flags_clear(thread_flags_t mask)
+{
+    tcb_t *me = (tcb_t *)sched_active_thread;
+    unsigned state = disableIRQ();
+
+    mask &= me->flags;
+    me->flags &= ~mask;
+
+    restoreIRQ(state);
+    return mask;
+}
+
+thread_flags_t thread_flags_wait_any(thread_flags_t mask)
+{
+    tcb_t *me = (tcb_t *)sched_active_thread;
+    unsigned state = disableIRQ();
+
+    while (!(me->flags & mask)) {
+        _wait(me, mask, STATUS_FLAG_BLOCKED_ANY, state);
+        state = disableIRQ();
+    }
+
+    mask &= me->flags;
+    me->flags &= ~mask;
+
+    restoreIRQ(state);
+    return mask;
+}
+
+thread_flags_t thread_flags_wait_all(thread_flags_t mask)
+{
+    tcb_t *me = (tcb_t *)sched_active_thread;
+    unsigned state = disableIRQ();
+
+    while (!_all_set(me->flags, mask)) {
+        _wait(me, mask, STATUS_FLAG_BLOCKED_ALL, state);
+        state = disableIRQ();
+    }
+
+    thread_flags_t wanted = mask & ~THREAD_FLAG_TIMEOUT;
+
+    if ((me->flags & wanted) == wanted) {
+        mask = wanted;
+    }
+    else {
+        /* timed out, leave the other flags alone */
+        mask = THREAD_FLAG_TIMEOUT;
+    }
+    me->flags &= ~mask;
+
+    restoreIRQ(state);
+    return mask;
+}
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_THREAD_FLAGS */
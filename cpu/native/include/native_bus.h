@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  native_cpu
+ * @{
+ *
+ * @file
+ * @brief       Device models for the simulated GPIO, SPI, I2C and UART buses
+ *
+ * Drivers talk to the simulated buses through the regular periph
+ * interfaces. Devices are modelled at register level and attached to a bus,
+ * SPI devices are selected by their chip select pin. Every SPI and I2C bus
+ * and every device on them counts transactions, bytes and the time the
+ * transfers would take on a real bus, so the bus efficiency of a driver can
+ * be measured on native. A UART connects to a single device model that
+ * receives the bytes sent and feeds bytes back through native_uart_input().
+ */
+
+#ifndef NATIVE_BUS_H
+#define NATIVE_BUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "periph/gpio.h"
+#include "periph/spi.h"
+#include "periph/i2c.h"
+#include "periph/uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of simulated GPIO pins
+ */
+#ifndef NATIVE_GPIO_NUMOF
+#define NATIVE_GPIO_NUMOF       (32U)
+#endif
+
+/**
+ * @brief Bus usage counters
+ */
+typedef struct {
+    uint32_t transactions;      /**< SPI chip select cycles or I2C
+                                     transfers from start to stop */
+    uint32_t bytes;             /**< bytes on the bus, including I2C
+                                     addresses */
+    uint64_t bus_time;          /**< time on the bus in nanoseconds */
+} native_bus_stats_t;
+
+/**
+ * @brief SPI device model
+ */
+typedef struct native_spi_dev {
+    struct native_spi_dev *next;        /**< next device on the bus */
+    gpio_t cs;                          /**< chip select, active low */
+    /** chip select was asserted, may be NULL */
+    void (*select)(struct native_spi_dev *dev);
+    /** exchange one byte, returns the byte sent on MISO */
+    uint8_t (*transfer)(struct native_spi_dev *dev, uint8_t mosi);
+    /** chip select was released, may be NULL */
+    void (*deselect)(struct native_spi_dev *dev);
+    native_bus_stats_t stats;           /**< counters of this device */
+} native_spi_dev_t;
+
+/**
+ * @brief I2C device model
+ */
+typedef struct native_i2c_dev {
+    struct native_i2c_dev *next;        /**< next device on the bus */
+    uint8_t addr;                       /**< 7-bit address */
+    /** (repeated) start addressed to this device, may be NULL */
+    void (*start)(struct native_i2c_dev *dev, int read);
+    /** byte written by the master, returns 0 to ACK */
+    int (*write)(struct native_i2c_dev *dev, uint8_t data);
+    /** byte read by the master */
+    uint8_t (*read)(struct native_i2c_dev *dev);
+    /** stop condition, may be NULL */
+    void (*stop)(struct native_i2c_dev *dev);
+    native_bus_stats_t stats;           /**< counters of this device */
+} native_i2c_dev_t;
+
+/**
+ * @brief UART device model
+ */
+typedef struct native_uart_dev {
+    /** byte sent to the device */
+    void (*write)(struct native_uart_dev *dev, uint8_t data);
+} native_uart_dev_t;
+
+/**
+ * @brief Register file behind a SPI command byte
+ *
+ * The first byte of every transaction holds the register address and the
+ * read flag, the following bytes are read from or written to consecutive
+ * registers.
+ */
+typedef struct {
+    native_spi_dev_t dev;       /**< SPI device, has to be first */
+    uint8_t *regs;              /**< register contents */
+    size_t size;                /**< number of registers */
+    uint8_t read_mask;          /**< command bit that selects a read */
+    uint8_t inc_mask;           /**< command bit that enables address
+                                     auto increment, 0 if always on */
+    uint8_t addr;               /**< current register */
+    uint8_t state;              /**< position in the transaction */
+} native_spi_regmap_t;
+
+/**
+ * @brief Register file behind an I2C register pointer
+ *
+ * The first byte written after a start sets the register pointer, every
+ * further byte read or written advances it.
+ */
+typedef struct {
+    native_i2c_dev_t dev;       /**< I2C device, has to be first */
+    uint8_t *regs;              /**< register contents */
+    size_t size;                /**< number of registers */
+    uint8_t ptr;                /**< register pointer */
+    uint8_t first;              /**< next written byte sets the pointer */
+} native_i2c_regmap_t;
+
+/**
+ * @brief Drive a GPIO input from a device model
+ *
+ * Calls the pin's interrupt callback if the change matches the configured
+ * flank. The callback runs with interrupts disabled in the context of the
+ * caller.
+ *
+ * @param[in] pin       pin to drive
+ * @param[in] value     new level
+ */
+void native_gpio_input(gpio_t pin, int value);
+
+/**
+ * @brief Attach a device model to a simulated SPI bus
+ *
+ * @param[in] bus       bus to attach to
+ * @param[in] dev       device, select and transfer have to be set
+ *
+ * @return  0 on success
+ * @return  -1 if @p bus is unknown
+ */
+int native_spi_attach(spi_t bus, native_spi_dev_t *dev);
+
+/**
+ * @brief Get the counters of a simulated SPI bus
+ */
+const native_bus_stats_t *native_spi_stats(spi_t bus);
+
+/**
+ * @brief Reset the counters of a SPI bus and all devices attached to it
+ */
+void native_spi_stats_reset(spi_t bus);
+
+/**
+ * @brief Notify the SPI simulation of a changed output pin
+ *
+ * @internal    called by the GPIO simulation
+ */
+void native_spi_cs(gpio_t pin, int value);
+
+/**
+ * @brief Attach a device model to a simulated I2C bus
+ *
+ * @param[in] bus       bus to attach to
+ * @param[in] dev       device, write and read have to be set
+ *
+ * @return  0 on success
+ * @return  -1 if @p bus is unknown
+ */
+int native_i2c_attach(i2c_t bus, native_i2c_dev_t *dev);
+
+/**
+ * @brief Get the counters of a simulated I2C bus
+ */
+const native_bus_stats_t *native_i2c_stats(i2c_t bus);
+
+/**
+ * @brief Reset the counters of an I2C bus and all devices attached to it
+ */
+void native_i2c_stats_reset(i2c_t bus);
+
+/**
+ * @brief Connect a device model to a simulated UART
+ *
+ * @param[in] uart      UART to connect to
+ * @param[in] dev       device, write has to be set
+ *
+ * @return  0 on success
+ * @return  -1 if @p uart is unknown
+ */
+int native_uart_attach(uart_t uart, native_uart_dev_t *dev);
+
+/**
+ * @brief Send a byte from a device model to a simulated UART
+ *
+ * Calls the UART's receive callback as an interrupt handler: with interrupts
+ * disabled and inISR() set. Threads it wakes up run once it returned.
+ *
+ * @param[in] uart      UART to drive
+ * @param[in] data      received byte
+ */
+void native_uart_input(uart_t uart, uint8_t data);
+
+/**
+ * @brief Set up a SPI register file model
+ *
+ * @param[out] map      model to set up
+ * @param[in] cs        chip select pin
+ * @param[in] regs      register contents
+ * @param[in] size      number of registers
+ * @param[in] read_mask command bit that selects a read
+ * @param[in] inc_mask  command bit that enables auto increment, 0 if the
+ *                      address always increments
+ */
+void native_spi_regmap_init(native_spi_regmap_t *map, gpio_t cs,
+                            uint8_t *regs, size_t size,
+                            uint8_t read_mask, uint8_t inc_mask);
+
+/**
+ * @brief Set up an I2C register file model
+ *
+ * @param[out] map      model to set up
+ * @param[in] addr      7-bit address
+ * @param[in] regs      register contents
+ * @param[in] size      number of registers
+ */
+void native_i2c_regmap_init(native_i2c_regmap_t *map, uint8_t addr,
+                            uint8_t *regs, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NATIVE_BUS_H */
+/** @} */
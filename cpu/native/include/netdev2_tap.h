@@ -26,6 +26,7 @@ extern "C" {
 
 #include <stdint.h>
 #include "net/netdev2.h"
+#include "net/netopt.h"
 
 #include "net/ethernet/hdr.h"
 
@@ -44,6 +45,8 @@ typedef struct netdev2_tap {
     int tap_fd;                         /**< host file descriptor for the TAP */
     uint8_t addr[ETHERNET_ADDR_LEN];    /**< The MAC address of the TAP */
     uint8_t promiscous;                 /**< Flag for promiscous mode */
+    netopt_state_t state;               /**< simulated radio state, frames
+                                         *   are dropped while sleeping */
 } netdev2_tap_t;
 
 /**
@@ -41,6 +41,38 @@
 #define RTC_NUMOF (1)
 /** @} */
 
+/**
+ * @name I2C configuration
+ *
+ * Device models are attached with native_i2c_attach().
+ * @{
+ */
+#define I2C_NUMOF          (1U)
+#define I2C_0_EN           1
+/** @} */
+
+/**
+ * @name SPI configuration
+ *
+ * Device models are attached with native_spi_attach(), without a selected
+ * device the simulated bus loops MOSI back to MISO.
+ * @{
+ */
+#define SPI_NUMOF          (1U)
+#define SPI_0_EN           1
+/** @} */
+
+/**
+ * @name UART configuration
+ *
+ * A device model is attached with native_uart_attach(), the UARTs are not
+ * connected to the terminal.
+ * @{
+ */
+#define UART_NUMOF         (1U)
+#define UART_0_EN          1
+/** @} */
+
 /**
  * @name Timer peripheral configuration
  * @{
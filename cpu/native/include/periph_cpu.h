@@ -25,7 +25,25 @@
 extern "C" {
 #endif
 
-/* nothing defined here so far... */
+/**
+ * @brief Mandatory macro for defining GPIO pins
+ *
+ * Native has a single port of simulated pins, the port is zeroed.
+ */
+#define GPIO(x, y)          ((x & 0) | y)
+
+/**
+ * @brief declare needed generic SPI functions
+ * @{
+ */
+#define PERIPH_SPI_NEEDS_TRANSFER_REG
+#define PERIPH_SPI_NEEDS_TRANSFER_REGS
+/** @} */
+
+/**
+ * @brief spi_transfer_async() completes after the simulated bus time
+ */
+#define PERIPH_SPI_HAS_TRANSFER_ASYNC
 
 #ifdef __cplusplus
 }
@@ -42,6 +42,10 @@
 
 #include "native_internal.h"
 
+#ifdef MODULE_SCHEDSTATISTICS
+#include "sched.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
@@ -246,6 +250,10 @@ void native_irq_handler(void)
 {
     DEBUG("\n\n\t\tnative_irq_handler\n\n");
 
+#ifdef MODULE_SCHEDSTATISTICS
+    sched_isr_enter();
+#endif
+
     while (_native_sigpend > 0) {
         int sig = _native_popsig();
         _native_sigpend--;
@@ -262,6 +270,10 @@ void native_irq_handler(void)
         }
     }
 
+#ifdef MODULE_SCHEDSTATISTICS
+    sched_isr_exit();
+#endif
+
     DEBUG("native_irq_handler: return\n");
     cpu_switch_context_exit();
 }
@@ -162,6 +162,15 @@ int _get(netdev2_t *dev, netopt_t opt, void *value, size_t max_len)
         case NETOPT_IS_WIRED:
             res = 1;
             break;
+        case NETOPT_STATE:
+            if (max_len < sizeof(netopt_state_t)) {
+                res = -EOVERFLOW;
+            }
+            else {
+                *((netopt_state_t *)value) = ((netdev2_tap_t *)dev)->state;
+                res = sizeof(netopt_state_t);
+            }
+            break;
         default:
             res = -ENOTSUP;
             break;
@@ -188,6 +197,13 @@ int _set(netdev2_t *dev, netopt_t opt, void *value, size_t value_len)
         case NETOPT_PROMISCUOUSMODE:
             _set_promiscous(dev, ((bool *)value)[0]);
             break;
+        case NETOPT_STATE:
+            /* there is no radio, sleeping only stops the reception to
+             * simulate duty cycling */
+            assert(value_len == sizeof(netopt_state_t));
+            ((netdev2_tap_t *)dev)->state = *((netopt_state_t *)value);
+            res = sizeof(netopt_state_t);
+            break;
         default:
             return -ENOTSUP;
     }
@@ -232,6 +248,14 @@ static int _recv(netdev2_t *netdev2, char *buf, int len)
 
     if (nread > 0) {
         ethernet_hdr_t *hdr = (ethernet_hdr_t *)buf;
+        if ((dev->state == NETOPT_STATE_OFF) ||
+            (dev->state == NETOPT_STATE_SLEEP)) {
+            DEBUG("netdev2_tap: sleeping => Dropped\n");
+#ifdef __MACH__
+            kill(_sigio_child_pid, SIGCONT);
+#endif
+            return 0;
+        }
         if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
             !_is_addr_broadcast(hdr->dst) &&
             (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
@@ -334,6 +358,7 @@ static int _init(netdev2_t *netdev)
 #endif
     /* initialize device descriptor */
     dev->promiscous = 0;
+    dev->state = NETOPT_STATE_IDLE;
     /* implicitly create the tap interface */
     if ((dev->tap_fd = real_open(clonedev , O_RDWR)) == -1) {
         err(EXIT_FAILURE, "open(%s)", clonedev);
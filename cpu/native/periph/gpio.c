@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     native_cpu
+ * @{
+ *
+ * @file
+ * @brief       Simulated GPIO pins
+ *
+ * Outputs drive the chip select lines of the simulated SPI devices, inputs
+ * are driven by device models through native_gpio_input().
+ *
+ * @}
+ */
+
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+#include "periph/gpio.h"
+#include "periph_conf.h"
+#include "native_bus.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/**
+ * @brief State of a simulated pin
+ */
+typedef struct {
+    gpio_cb_t cb;               /**< interrupt callback */
+    void *arg;                  /**< argument for cb */
+    uint8_t dir;                /**< gpio_dir_t */
+    uint8_t flank;              /**< gpio_flank_t */
+    uint8_t value;              /**< current level */
+    uint8_t irq;                /**< interrupt enabled */
+} gpio_sim_t;
+
+static gpio_sim_t gpio_sim[NATIVE_GPIO_NUMOF];
+
+static inline int _valid(gpio_t pin)
+{
+    return (pin >= 0) && ((unsigned)pin < NATIVE_GPIO_NUMOF);
+}
+
+int gpio_init(gpio_t pin, gpio_dir_t dir, gpio_pp_t pullup)
+{
+    if (!_valid(pin)) {
+        return -1;
+    }
+    gpio_sim[pin].dir = dir;
+    gpio_sim[pin].irq = 0;
+    if (dir == GPIO_DIR_IN) {
+        gpio_sim[pin].value = (pullup == GPIO_PULLUP);
+    }
+    return 0;
+}
+
+int gpio_init_int(gpio_t pin, gpio_pp_t pullup, gpio_flank_t flank,
+                  gpio_cb_t cb, void *arg)
+{
+    if (gpio_init(pin, GPIO_DIR_IN, pullup) < 0) {
+        return -1;
+    }
+    gpio_sim[pin].cb = cb;
+    gpio_sim[pin].arg = arg;
+    gpio_sim[pin].flank = flank;
+    gpio_sim[pin].irq = 1;
+    return 0;
+}
+
+void gpio_irq_enable(gpio_t pin)
+{
+    if (_valid(pin)) {
+        gpio_sim[pin].irq = 1;
+    }
+}
+
+void gpio_irq_disable(gpio_t pin)
+{
+    if (_valid(pin)) {
+        gpio_sim[pin].irq = 0;
+    }
+}
+
+int gpio_read(gpio_t pin)
+{
+    return _valid(pin) ? gpio_sim[pin].value : 0;
+}
+
+void gpio_set(gpio_t pin)
+{
+    gpio_write(pin, 1);
+}
+
+void gpio_clear(gpio_t pin)
+{
+    gpio_write(pin, 0);
+}
+
+void gpio_toggle(gpio_t pin)
+{
+    gpio_write(pin, !gpio_read(pin));
+}
+
+void gpio_write(gpio_t pin, int value)
+{
+    if (!_valid(pin) || gpio_sim[pin].dir != GPIO_DIR_OUT) {
+        return;
+    }
+    value = (value != 0);
+    if (gpio_sim[pin].value == value) {
+        return;
+    }
+    gpio_sim[pin].value = value;
+#if SPI_NUMOF
+    native_spi_cs(pin, value);
+#endif
+}
+
+void native_gpio_input(gpio_t pin, int value)
+{
+    gpio_sim_t *sim;
+
+    if (!_valid(pin) || gpio_sim[pin].dir != GPIO_DIR_IN) {
+        return;
+    }
+    sim = &gpio_sim[pin];
+    value = (value != 0);
+    if (sim->value == value) {
+        return;
+    }
+    sim->value = value;
+    if (!sim->irq || !sim->cb) {
+        return;
+    }
+    if (sim->flank == GPIO_BOTH || sim->flank == (gpio_flank_t)value) {
+        DEBUG("native_gpio_input: interrupt on pin %i\n", pin);
+        unsigned state = disableIRQ();
+        sim->cb(sim->arg);
+        restoreIRQ(state);
+        /* callbacks may wake up threads like a real interrupt would */
+        if (sched_context_switch_request) {
+            thread_yield();
+        }
+    }
+}
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     native_cpu
+ * @{
+ *
+ * @file
+ * @brief       Simulated I2C bus
+ *
+ * Transfers are passed to the device model attached with the addressed
+ * slave address, see native_bus.h. Unknown addresses are not acknowledged.
+ * With xtimer, transfers take the time they would take on a real bus.
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "irq.h"
+#include "mutex.h"
+#include "periph/i2c.h"
+#include "periph_conf.h"
+#include "native_bus.h"
+
+#ifdef MODULE_XTIMER
+#include "xtimer.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#if I2C_NUMOF
+
+/**
+ * @brief State of a simulated I2C bus
+ */
+typedef struct {
+    mutex_t lock;               /**< bus lock */
+    uint32_t clock;             /**< bus clock in Hz */
+    native_i2c_dev_t *devs;     /**< attached device models */
+    native_bus_stats_t stats;   /**< bus counters */
+} i2c_sim_t;
+
+static i2c_sim_t i2c_sim[I2C_NUMOF] = {
+    [I2C_0] = { .lock = MUTEX_INIT },
+};
+
+static const uint32_t i2c_clock[] = {
+    [I2C_SPEED_LOW]       = 10000,
+    [I2C_SPEED_NORMAL]    = 100000,
+    [I2C_SPEED_FAST]      = 400000,
+    [I2C_SPEED_FAST_PLUS] = 1000000,
+    [I2C_SPEED_HIGH]      = 3400000,
+};
+
+static native_i2c_dev_t *_find(i2c_t dev, uint8_t address)
+{
+    for (native_i2c_dev_t *slave = i2c_sim[dev].devs; slave;
+         slave = slave->next) {
+        if (slave->addr == address) {
+            return slave;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run one transaction from start to stop condition
+ *
+ * Every byte takes 9 clock cycles including the acknowledge, start, repeated
+ * start and stop conditions take one cycle each.
+ *
+ * @param[in] dev       bus
+ * @param[in] address   slave address
+ * @param[in] reg       register to write before the data or NULL
+ * @param[in,out] data  data to read or write
+ * @param[in] length    number of data bytes
+ * @param[in] read      read the data instead of writing it
+ *
+ * @return  number of data bytes
+ * @return  -1 on undefined device
+ * @return  -2 if the address or a written byte was not acknowledged
+ */
+static int _transaction(i2c_t dev, uint8_t address, const uint8_t *reg,
+                        char *data, int length, int read)
+{
+    i2c_sim_t *sim;
+    native_i2c_dev_t *slave;
+    unsigned int bytes = 1;
+    unsigned int bits = 2;
+    int res = length;
+
+    if (dev >= I2C_NUMOF || !i2c_sim[dev].clock || length < 0) {
+        return -1;
+    }
+    sim = &i2c_sim[dev];
+    slave = _find(dev, address);
+
+    if (slave == NULL) {
+        DEBUG("i2c: no device at 0x%02x\n", address);
+        res = -2;
+    }
+    else {
+        if (reg) {
+            if (slave->start) {
+                slave->start(slave, 0);
+            }
+            bytes++;
+            if (slave->write(slave, *reg) != 0) {
+                res = -2;
+            }
+            else if (read) {
+                /* repeated start and address for the read direction */
+                bytes++;
+                bits++;
+            }
+        }
+        if (res >= 0 && (read || !reg) && slave->start) {
+            slave->start(slave, read);
+        }
+        for (int i = 0; res >= 0 && i < length; i++) {
+            if (read) {
+                data[i] = (char)slave->read(slave);
+            }
+            else if (slave->write(slave, (uint8_t)data[i]) != 0) {
+                res = -2;
+            }
+            bytes++;
+        }
+        if (slave->stop) {
+            slave->stop(slave);
+        }
+    }
+
+    bits += bytes * 9;
+    uint64_t time = ((uint64_t)bits * 1000000000) / sim->clock;
+    sim->stats.transactions++;
+    sim->stats.bytes += bytes;
+    sim->stats.bus_time += time;
+    if (slave) {
+        slave->stats.transactions++;
+        slave->stats.bytes += bytes;
+        slave->stats.bus_time += time;
+    }
+#ifdef MODULE_XTIMER
+    xtimer_spin((uint32_t)(time / 1000));
+#endif
+    return res;
+}
+
+int i2c_init_master(i2c_t dev, i2c_speed_t speed)
+{
+    if (dev >= I2C_NUMOF) {
+        return -1;
+    }
+    if ((unsigned)speed >= sizeof(i2c_clock) / sizeof(i2c_clock[0])) {
+        return -2;
+    }
+    i2c_sim[dev].clock = i2c_clock[speed];
+    return 0;
+}
+
+int i2c_init_slave(i2c_t dev, uint8_t address)
+{
+    (void)dev;
+    (void)address;
+
+    DEBUG("i2c_init_slave: not supported\n");
+    return -1;
+}
+
+int i2c_acquire(i2c_t dev)
+{
+    if (dev >= I2C_NUMOF) {
+        return -1;
+    }
+    mutex_lock(&i2c_sim[dev].lock);
+    return 0;
+}
+
+int i2c_release(i2c_t dev)
+{
+    if (dev >= I2C_NUMOF) {
+        return -1;
+    }
+    mutex_unlock(&i2c_sim[dev].lock);
+    return 0;
+}
+
+int i2c_read_byte(i2c_t dev, uint8_t address, char *data)
+{
+    return _transaction(dev, address, NULL, data, 1, 1);
+}
+
+int i2c_read_bytes(i2c_t dev, uint8_t address, char *data, int length)
+{
+    return _transaction(dev, address, NULL, data, length, 1);
+}
+
+int i2c_read_reg(i2c_t dev, uint8_t address, uint8_t reg, char *data)
+{
+    return _transaction(dev, address, &reg, data, 1, 1);
+}
+
+int i2c_read_regs(i2c_t dev, uint8_t address, uint8_t reg,
+                  char *data, int length)
+{
+    return _transaction(dev, address, &reg, data, length, 1);
+}
+
+int i2c_write_byte(i2c_t dev, uint8_t address, char data)
+{
+    return _transaction(dev, address, NULL, &data, 1, 0);
+}
+
+int i2c_write_bytes(i2c_t dev, uint8_t address, char *data, int length)
+{
+    return _transaction(dev, address, NULL, data, length, 0);
+}
+
+int i2c_write_reg(i2c_t dev, uint8_t address, uint8_t reg, char data)
+{
+    return _transaction(dev, address, &reg, &data, 1, 0);
+}
+
+int i2c_write_regs(i2c_t dev, uint8_t address, uint8_t reg,
+                   char *data, int length)
+{
+    return _transaction(dev, address, &reg, data, length, 0);
+}
+
+void i2c_poweron(i2c_t dev)
+{
+    (void)dev;
+}
+
+void i2c_poweroff(i2c_t dev)
+{
+    (void)dev;
+}
+
+int native_i2c_attach(i2c_t bus, native_i2c_dev_t *dev)
+{
+    if (bus >= I2C_NUMOF) {
+        return -1;
+    }
+    unsigned state = disableIRQ();
+    dev->next = i2c_sim[bus].devs;
+    i2c_sim[bus].devs = dev;
+    restoreIRQ(state);
+    return 0;
+}
+
+const native_bus_stats_t *native_i2c_stats(i2c_t bus)
+{
+    return (bus < I2C_NUMOF) ? &i2c_sim[bus].stats : NULL;
+}
+
+void native_i2c_stats_reset(i2c_t bus)
+{
+    if (bus >= I2C_NUMOF) {
+        return;
+    }
+    memset(&i2c_sim[bus].stats, 0, sizeof(native_bus_stats_t));
+    for (native_i2c_dev_t *dev = i2c_sim[bus].devs; dev; dev = dev->next) {
+        memset(&dev->stats, 0, sizeof(native_bus_stats_t));
+    }
+}
+
+#endif /* I2C_NUMOF */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     native_cpu
+ * @{
+ *
+ * @file
+ * @brief       Register file models for the simulated SPI and I2C buses
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "native_bus.h"
+
+/**
+ * @name Transaction state of the SPI register file
+ * @{
+ */
+#define STATE_CMD       (0x00)  /**< next byte is the command */
+#define STATE_DATA      (0x01)  /**< command received */
+#define STATE_READ      (0x02)  /**< command was a read */
+#define STATE_INC       (0x04)  /**< auto increment the address */
+/** @} */
+
+static void _spi_select(native_spi_dev_t *dev)
+{
+    ((native_spi_regmap_t *)dev)->state = STATE_CMD;
+}
+
+static uint8_t _spi_transfer(native_spi_dev_t *dev, uint8_t mosi)
+{
+    native_spi_regmap_t *map = (native_spi_regmap_t *)dev;
+    uint8_t miso = 0xff;
+
+    if (map->state == STATE_CMD) {
+        map->addr = mosi & ~(map->read_mask | map->inc_mask);
+        map->state = STATE_DATA;
+        if (mosi & map->read_mask) {
+            map->state |= STATE_READ;
+        }
+        if (!map->inc_mask || (mosi & map->inc_mask)) {
+            map->state |= STATE_INC;
+        }
+        return 0;
+    }
+
+    if (map->addr < map->size) {
+        if (map->state & STATE_READ) {
+            miso = map->regs[map->addr];
+        }
+        else {
+            map->regs[map->addr] = mosi;
+        }
+    }
+    if (map->state & STATE_INC) {
+        map->addr++;
+    }
+    return miso;
+}
+
+void native_spi_regmap_init(native_spi_regmap_t *map, gpio_t cs,
+                            uint8_t *regs, size_t size,
+                            uint8_t read_mask, uint8_t inc_mask)
+{
+    memset(map, 0, sizeof(native_spi_regmap_t));
+    map->dev.cs = cs;
+    map->dev.select = _spi_select;
+    map->dev.transfer = _spi_transfer;
+    map->regs = regs;
+    map->size = size;
+    map->read_mask = read_mask;
+    map->inc_mask = inc_mask;
+}
+
+static void _i2c_start(native_i2c_dev_t *dev, int read)
+{
+    ((native_i2c_regmap_t *)dev)->first = !read;
+}
+
+static int _i2c_write(native_i2c_dev_t *dev, uint8_t data)
+{
+    native_i2c_regmap_t *map = (native_i2c_regmap_t *)dev;
+
+    if (map->first) {
+        map->ptr = data;
+        map->first = 0;
+        return 0;
+    }
+    if (map->ptr >= map->size) {
+        return -1;
+    }
+    map->regs[map->ptr++] = data;
+    return 0;
+}
+
+static uint8_t _i2c_read(native_i2c_dev_t *dev)
+{
+    native_i2c_regmap_t *map = (native_i2c_regmap_t *)dev;
+
+    if (map->ptr >= map->size) {
+        return 0xff;
+    }
+    return map->regs[map->ptr++];
+}
+
+void native_i2c_regmap_init(native_i2c_regmap_t *map, uint8_t addr,
+                            uint8_t *regs, size_t size)
+{
+    memset(map, 0, sizeof(native_i2c_regmap_t));
+    map->dev.addr = addr;
+    map->dev.start = _i2c_start;
+    map->dev.write = _i2c_write;
+    map->dev.read = _i2c_read;
+    map->regs = regs;
+    map->size = size;
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     native_cpu
+ * @{
+ *
+ * @file
+ * @brief       Simulated SPI bus
+ *
+ * Bytes are exchanged with the device model whose chip select is asserted,
+ * see native_bus.h. Without a selected device MOSI is looped back to MISO.
+ * With xtimer, transfers take the time they would take on a real bus:
+ * blocking transfers spin, asynchronous transfers complete from a timer
+ * interrupt.
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "irq.h"
+#include "mutex.h"
+#include "periph/spi.h"
+#include "periph_conf.h"
+#include "native_bus.h"
+
+#ifdef MODULE_XTIMER
+#include "xtimer.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#if SPI_NUMOF
+
+/**
+ * @brief State of a simulated SPI bus
+ */
+typedef struct {
+    mutex_t lock;               /**< bus lock */
+    uint32_t clock;             /**< bus clock in Hz */
+    native_spi_dev_t *devs;     /**< attached device models */
+    native_spi_dev_t *sel;      /**< device with asserted chip select */
+    native_bus_stats_t stats;   /**< bus counters */
+#ifdef MODULE_XTIMER
+    xtimer_t timer;             /**< signals the end of an async transfer */
+    const spi_xfer_t *xfers;    /**< segments of the async transfer */
+    unsigned int count;         /**< number of segments */
+    spi_async_cb_t cb;          /**< called when the async transfer is done */
+    void *arg;                  /**< argument for cb */
+#endif
+} spi_sim_t;
+
+static spi_sim_t spi_sim[SPI_NUMOF] = {
+    [SPI_0] = { .lock = MUTEX_INIT },
+};
+
+static const uint32_t spi_clock[] = {
+    [SPI_SPEED_100KHZ] = 100000,
+    [SPI_SPEED_400KHZ] = 400000,
+    [SPI_SPEED_1MHZ]   = 1000000,
+    [SPI_SPEED_5MHZ]   = 5000000,
+    [SPI_SPEED_10MHZ]  = 10000000,
+};
+
+/**
+ * @brief Bus time of @p bytes bytes in microseconds
+ */
+static inline uint32_t _bus_time(spi_t dev, unsigned int bytes)
+{
+    return (uint32_t)(((uint64_t)bytes * 8 * 1000000) / spi_sim[dev].clock);
+}
+
+/**
+ * @brief Bus time of @p bytes bytes in nanoseconds
+ */
+static inline uint64_t _bus_time_ns(spi_t dev, unsigned int bytes)
+{
+    return ((uint64_t)bytes * 8 * 1000000000) / spi_sim[dev].clock;
+}
+
+static void _exchange(spi_t dev, const spi_xfer_t *xfer)
+{
+    spi_sim_t *sim = &spi_sim[dev];
+    native_spi_dev_t *model = sim->sel;
+    uint64_t time = _bus_time_ns(dev, xfer->length);
+
+    sim->stats.bytes += xfer->length;
+    sim->stats.bus_time += time;
+    if (model == NULL) {
+        /* nobody listens, count every call as a transaction of its own */
+        sim->stats.transactions++;
+        if (xfer->in == NULL) {
+            return;
+        }
+        if (xfer->out) {
+            memmove(xfer->in, xfer->out, xfer->length);
+        }
+        else {
+            memset(xfer->in, 0, xfer->length);
+        }
+        return;
+    }
+    model->stats.bytes += xfer->length;
+    model->stats.bus_time += time;
+    for (unsigned int i = 0; i < xfer->length; i++) {
+        uint8_t miso = model->transfer(model, xfer->out ? xfer->out[i] : 0);
+        if (xfer->in) {
+            xfer->in[i] = (char)miso;
+        }
+    }
+}
+
+int spi_init_master(spi_t dev, spi_conf_t conf, spi_speed_t speed)
+{
+    (void)conf;
+
+    if (dev >= SPI_NUMOF) {
+        return -2;
+    }
+    if ((unsigned)speed >= sizeof(spi_clock) / sizeof(spi_clock[0])) {
+        return -1;
+    }
+    spi_sim[dev].clock = spi_clock[speed];
+    return 0;
+}
+
+int spi_init_slave(spi_t dev, spi_conf_t conf, char (*cb)(char data))
+{
+    (void)dev;
+    (void)conf;
+    (void)cb;
+
+    DEBUG("spi_init_slave: not supported\n");
+    return -1;
+}
+
+int spi_conf_pins(spi_t dev)
+{
+    return (dev < SPI_NUMOF) ? 0 : -1;
+}
+
+int spi_acquire(spi_t dev)
+{
+    if (dev >= SPI_NUMOF) {
+        return -1;
+    }
+    mutex_lock(&spi_sim[dev].lock);
+    return 0;
+}
+
+int spi_release(spi_t dev)
+{
+    if (dev >= SPI_NUMOF) {
+        return -1;
+    }
+    mutex_unlock(&spi_sim[dev].lock);
+    return 0;
+}
+
+int spi_transfer_byte(spi_t dev, char out, char *in)
+{
+    return spi_transfer_bytes(dev, &out, in, 1);
+}
+
+int spi_transfer_bytes(spi_t dev, char *out, char *in, unsigned int length)
+{
+    spi_xfer_t xfer = { .out = out, .in = in, .length = length };
+
+    if (dev >= SPI_NUMOF || !spi_sim[dev].clock) {
+        return -1;
+    }
+    _exchange(dev, &xfer);
+#ifdef MODULE_XTIMER
+    xtimer_spin(_bus_time(dev, length));
+#endif
+    return length;
+}
+
+#ifdef MODULE_XTIMER
+static void _async_done(void *arg)
+{
+    spi_sim_t *sim = (spi_sim_t *)arg;
+    int res = 0;
+
+    for (unsigned int i = 0; i < sim->count; i++) {
+        _exchange(sim - spi_sim, &sim->xfers[i]);
+        res += sim->xfers[i].length;
+    }
+    sim->cb(sim->arg, res);
+}
+#endif
+
+int spi_transfer_async(spi_t dev, const spi_xfer_t *xfers, unsigned int count,
+                       spi_async_cb_t cb, void *arg)
+{
+    unsigned int length = 0;
+
+    if (dev >= SPI_NUMOF || !spi_sim[dev].clock) {
+        return -1;
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        length += xfers[i].length;
+    }
+
+#ifdef MODULE_XTIMER
+    spi_sim_t *sim = &spi_sim[dev];
+    sim->xfers = xfers;
+    sim->count = count;
+    sim->cb = cb;
+    sim->arg = arg;
+    sim->timer.callback = _async_done;
+    sim->timer.arg = sim;
+    xtimer_set(&sim->timer, _bus_time(dev, length));
+#else
+    for (unsigned int i = 0; i < count; i++) {
+        _exchange(dev, &xfers[i]);
+    }
+    cb(arg, length);
+#endif
+    return 0;
+}
+
+void spi_transmission_begin(spi_t dev, char reset_val)
+{
+    (void)dev;
+    (void)reset_val;
+}
+
+void spi_poweron(spi_t dev)
+{
+    (void)dev;
+}
+
+void spi_poweroff(spi_t dev)
+{
+    (void)dev;
+}
+
+int native_spi_attach(spi_t bus, native_spi_dev_t *dev)
+{
+    if (bus >= SPI_NUMOF) {
+        return -1;
+    }
+    unsigned state = disableIRQ();
+    dev->next = spi_sim[bus].devs;
+    spi_sim[bus].devs = dev;
+    restoreIRQ(state);
+    return 0;
+}
+
+const native_bus_stats_t *native_spi_stats(spi_t bus)
+{
+    return (bus < SPI_NUMOF) ? &spi_sim[bus].stats : NULL;
+}
+
+void native_spi_stats_reset(spi_t bus)
+{
+    if (bus >= SPI_NUMOF) {
+        return;
+    }
+    memset(&spi_sim[bus].stats, 0, sizeof(native_bus_stats_t));
+    for (native_spi_dev_t *dev = spi_sim[bus].devs; dev; dev = dev->next) {
+        memset(&dev->stats, 0, sizeof(native_bus_stats_t));
+    }
+}
+
+void native_spi_cs(gpio_t pin, int value)
+{
+    for (unsigned int bus = 0; bus < SPI_NUMOF; bus++) {
+        spi_sim_t *sim = &spi_sim[bus];
+        for (native_spi_dev_t *dev = sim->devs; dev; dev = dev->next) {
+            if (dev->cs != pin) {
+                continue;
+            }
+            if (!value && sim->sel == NULL) {
+                DEBUG("spi: select device on pin %i\n", pin);
+                sim->sel = dev;
+                sim->stats.transactions++;
+                dev->stats.transactions++;
+                if (dev->select) {
+                    dev->select(dev);
+                }
+            }
+            else if (value && sim->sel == dev) {
+                sim->sel = NULL;
+                if (dev->deselect) {
+                    dev->deselect(dev);
+                }
+            }
+        }
+    }
+}
+
+#endif /* SPI_NUMOF */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     native_cpu
+ * @{
+ *
+ * @file
+ * @brief       Simulated UART
+ *
+ * Bytes sent are passed to the device model connected with
+ * native_uart_attach(), the model sends bytes back through
+ * native_uart_input(), see native_bus.h. Without a model sent bytes are
+ * dropped.
+ *
+ * @}
+ */
+
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+#include "periph/uart.h"
+#include "periph_conf.h"
+#include "native_bus.h"
+#include "native_internal.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#if UART_NUMOF
+
+/**
+ * @brief State of a simulated UART
+ */
+typedef struct {
+    uart_rx_cb_t rx_cb;         /**< receive callback */
+    uart_tx_cb_t tx_cb;         /**< transmit callback */
+    void *arg;                  /**< argument for the callbacks */
+    native_uart_dev_t *dev;     /**< connected device model */
+} uart_sim_t;
+
+static uart_sim_t uart_sim[UART_NUMOF];
+
+/**
+ * @brief Run the RX (@p rx != 0) or TX callback like an interrupt would
+ *
+ * In thread context the callback runs with interrupts disabled and inISR()
+ * set, so threads it wakes up are switched to once it returned and not from
+ * within the callback. Called in interrupt context, e.g. from a timer of a
+ * device model, the interrupt that is running does the switch.
+ */
+static void _isr(uart_sim_t *sim, int rx, char data)
+{
+    int in_thread = !inISR();
+    unsigned state = disableIRQ();
+
+    if (in_thread) {
+        _native_in_isr = 1;
+    }
+    if (rx) {
+        sim->rx_cb(sim->arg, data);
+    }
+    else {
+        /* the TX interrupt fires until the callback has no more data */
+        while (sim->tx_cb(sim->arg)) {}
+    }
+    if (in_thread) {
+        _native_in_isr = 0;
+    }
+    restoreIRQ(state);
+    if (in_thread && sched_context_switch_request) {
+        thread_yield();
+    }
+}
+
+int uart_init(uart_t uart, uint32_t baudrate, uart_rx_cb_t rx_cb,
+              uart_tx_cb_t tx_cb, void *arg)
+{
+    if (uart_init_blocking(uart, baudrate) < 0) {
+        return -1;
+    }
+    unsigned state = disableIRQ();
+    uart_sim[uart].rx_cb = rx_cb;
+    uart_sim[uart].tx_cb = tx_cb;
+    uart_sim[uart].arg = arg;
+    restoreIRQ(state);
+    return 0;
+}
+
+int uart_init_blocking(uart_t uart, uint32_t baudrate)
+{
+    (void)baudrate;
+
+    return (uart < UART_NUMOF) ? 0 : -1;
+}
+
+void uart_tx_begin(uart_t uart)
+{
+    if (uart >= UART_NUMOF || !uart_sim[uart].tx_cb) {
+        return;
+    }
+    _isr(&uart_sim[uart], 0, 0);
+}
+
+int uart_write(uart_t uart, char data)
+{
+    if (uart >= UART_NUMOF) {
+        return -1;
+    }
+    if (uart_sim[uart].dev) {
+        uart_sim[uart].dev->write(uart_sim[uart].dev, (uint8_t)data);
+    }
+    return 1;
+}
+
+int uart_read_blocking(uart_t uart, char *data)
+{
+    (void)uart;
+    (void)data;
+
+    DEBUG("uart_read_blocking: not supported\n");
+    return -1;
+}
+
+int uart_write_blocking(uart_t uart, char data)
+{
+    return uart_write(uart, data);
+}
+
+void uart_poweron(uart_t uart)
+{
+    (void)uart;
+}
+
+void uart_poweroff(uart_t uart)
+{
+    (void)uart;
+}
+
+int native_uart_attach(uart_t uart, native_uart_dev_t *dev)
+{
+    if (uart >= UART_NUMOF) {
+        return -1;
+    }
+    uart_sim[uart].dev = dev;
+    return 0;
+}
+
+void native_uart_input(uart_t uart, uint8_t data)
+{
+    if (uart >= UART_NUMOF || !uart_sim[uart].rx_cb) {
+        return;
+    }
+    _isr(&uart_sim[uart], 1, (char)data);
+}
+
+#endif /* UART_NUMOF */
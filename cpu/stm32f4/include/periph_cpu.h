@@ -99,6 +99,12 @@ void gpio_init_af(gpio_t pin, gpio_af_t af);
 #define PERIPH_SPI_NEEDS_TRANSFER_REGS
 /** @} */
 
+/**
+ * @brief   spi_transfer_async() is implemented using DMA for devices that
+ *          have a SPI_x_DMA configuration
+ */
+#define PERIPH_SPI_HAS_TRANSFER_ASYNC
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,8 +41,26 @@
  */
 typedef struct {
     char(*cb)(char data);
+    const spi_xfer_t *xfers;    /**< current segment of an async transfer */
+    unsigned int count;         /**< number of segments left */
+    int res;                    /**< bytes transferred so far */
+    spi_async_cb_t async_cb;    /**< called when the async transfer is done */
+    void *async_arg;            /**< argument for async_cb */
 } spi_state_t;
 
+/**
+ * @brief DMA streams used for asynchronous transfers
+ */
+typedef struct {
+    SPI_TypeDef *spi;
+    DMA_TypeDef *dma;
+    DMA_Stream_TypeDef *rx_stream;
+    DMA_Stream_TypeDef *tx_stream;
+    uint8_t rx_num;
+    uint8_t tx_num;
+    uint8_t chan;
+} spi_dma_t;
+
 static inline void irq_handler_transfer(SPI_TypeDef *spi, spi_t dev);
 
 /**
@@ -50,6 +68,28 @@ static inline void irq_handler_transfer(SPI_TypeDef *spi, spi_t dev);
  */
 static spi_state_t spi_config[SPI_NUMOF];
 
+/**
+ * @brief DMA configuration, devices without DMA transfer synchronously
+ */
+static const spi_dma_t spi_dma[SPI_NUMOF] = {
+#if SPI_0_EN && defined(SPI_0_DMA)
+    [SPI_0] = { SPI_0_DEV, SPI_0_DMA, SPI_0_DMA_RX_STREAM, SPI_0_DMA_TX_STREAM,
+                SPI_0_DMA_RX_NUM, SPI_0_DMA_TX_NUM, SPI_0_DMA_CHAN },
+#endif
+#if SPI_1_EN && defined(SPI_1_DMA)
+    [SPI_1] = { SPI_1_DEV, SPI_1_DMA, SPI_1_DMA_RX_STREAM, SPI_1_DMA_TX_STREAM,
+                SPI_1_DMA_RX_NUM, SPI_1_DMA_TX_NUM, SPI_1_DMA_CHAN },
+#endif
+#if SPI_2_EN && defined(SPI_2_DMA)
+    [SPI_2] = { SPI_2_DEV, SPI_2_DMA, SPI_2_DMA_RX_STREAM, SPI_2_DMA_TX_STREAM,
+                SPI_2_DMA_RX_NUM, SPI_2_DMA_TX_NUM, SPI_2_DMA_CHAN },
+#endif
+};
+
+/* sent when a segment has no output buffer, and sink for dropped input */
+static const char dma_zero = 0;
+static char dma_sink;
+
 /* static bus div mapping */
 static const uint8_t spi_bus_div_map[SPI_NUMOF] = {
 #if SPI_0_EN
@@ -112,6 +152,11 @@ int spi_init_master(spi_t dev, spi_conf_t conf, spi_speed_t speed)
             SPI_0_SCK_PORT_CLKEN();
             SPI_0_MISO_PORT_CLKEN();
             SPI_0_MOSI_PORT_CLKEN();
+#ifdef SPI_0_DMA
+            SPI_0_DMA_CLKEN();
+            NVIC_SetPriority(SPI_0_DMA_IRQ, SPI_IRQ_PRIO);
+            NVIC_EnableIRQ(SPI_0_DMA_IRQ);
+#endif
             break;
 #endif /* SPI_0_EN */
 #if SPI_1_EN
@@ -122,6 +167,11 @@ int spi_init_master(spi_t dev, spi_conf_t conf, spi_speed_t speed)
             SPI_1_SCK_PORT_CLKEN();
             SPI_1_MISO_PORT_CLKEN();
             SPI_1_MOSI_PORT_CLKEN();
+#ifdef SPI_1_DMA
+            SPI_1_DMA_CLKEN();
+            NVIC_SetPriority(SPI_1_DMA_IRQ, SPI_IRQ_PRIO);
+            NVIC_EnableIRQ(SPI_1_DMA_IRQ);
+#endif
             break;
 #endif /* SPI_1_EN */
 #if SPI_2_EN
@@ -132,6 +182,11 @@ int spi_init_master(spi_t dev, spi_conf_t conf, spi_speed_t speed)
             SPI_2_SCK_PORT_CLKEN();
             SPI_2_MISO_PORT_CLKEN();
             SPI_2_MOSI_PORT_CLKEN();
+#ifdef SPI_2_DMA
+            SPI_2_DMA_CLKEN();
+            NVIC_SetPriority(SPI_2_DMA_IRQ, SPI_IRQ_PRIO);
+            NVIC_EnableIRQ(SPI_2_DMA_IRQ);
+#endif
             break;
 #endif /* SPI_2_EN */
         default:
@@ -350,6 +405,106 @@ int spi_transfer_byte(spi_t dev, char out, char *in)
     return 1;
 }
 
+/**
+ * @brief Get the interrupt flags of a DMA stream
+ */
+static inline uint32_t dma_flags(DMA_TypeDef *dma, int num)
+{
+    static const uint8_t shift[] = { 0, 6, 16, 22 };
+    uint32_t isr = (num < 4) ? dma->LISR : dma->HISR;
+    return (isr >> shift[num & 0x3]) & 0x3d;
+}
+
+/**
+ * @brief Clear all interrupt flags of a DMA stream
+ */
+static inline void dma_clear(DMA_TypeDef *dma, int num)
+{
+    static const uint8_t shift[] = { 0, 6, 16, 22 };
+    uint32_t mask = 0x3d << shift[num & 0x3];
+    if (num < 4) {
+        dma->LIFCR = mask;
+    }
+    else {
+        dma->HIFCR = mask;
+    }
+}
+
+/**
+ * @brief Start the DMA transfer of the next non-empty segment
+ *
+ * @return  0 if there is no segment left
+ */
+static int dma_next(spi_t dev)
+{
+    const spi_dma_t *d = &spi_dma[dev];
+    spi_state_t *state = &spi_config[dev];
+
+    while (state->count && state->xfers->length == 0) {
+        state->xfers++;
+        state->count--;
+    }
+    if (!state->count) {
+        return 0;
+    }
+
+    const spi_xfer_t *x = state->xfers;
+    dma_clear(d->dma, d->rx_num);
+    dma_clear(d->dma, d->tx_num);
+
+    /* the rx stream finishes last, so only it raises an interrupt */
+    d->rx_stream->PAR = (uint32_t)&d->spi->DR;
+    d->rx_stream->M0AR = (uint32_t)(x->in ? x->in : &dma_sink);
+    d->rx_stream->NDTR = x->length;
+    d->rx_stream->CR = (d->chan << 25) | (x->in ? DMA_SxCR_MINC : 0)
+                       | DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_EN;
+
+    d->tx_stream->PAR = (uint32_t)&d->spi->DR;
+    d->tx_stream->M0AR = (uint32_t)(x->out ? x->out : &dma_zero);
+    d->tx_stream->NDTR = x->length;
+    d->tx_stream->CR = (d->chan << 25) | DMA_SxCR_DIR_0
+                       | (x->out ? DMA_SxCR_MINC : 0) | DMA_SxCR_EN;
+
+    d->spi->CR2 |= (SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+    return 1;
+}
+
+int spi_transfer_async(spi_t dev, const spi_xfer_t *xfers, unsigned int count,
+                       spi_async_cb_t cb, void *arg)
+{
+    if (dev >= SPI_NUMOF) {
+        return -1;
+    }
+
+    if (spi_dma[dev].dma == NULL) {
+        /* no DMA configured for this device, transfer right away */
+        int res = 0;
+        for (unsigned int i = 0; i < count; i++) {
+            int trans_ret = spi_transfer_bytes(dev, (char *)xfers[i].out,
+                                               xfers[i].in, xfers[i].length);
+            if (trans_ret < 0) {
+                res = -1;
+                break;
+            }
+            res += trans_ret;
+        }
+        cb(arg, res);
+        return 0;
+    }
+
+    spi_state_t *state = &spi_config[dev];
+    state->xfers = xfers;
+    state->count = count;
+    state->res = 0;
+    state->async_cb = cb;
+    state->async_arg = arg;
+
+    if (!dma_next(dev)) {
+        cb(arg, 0);
+    }
+    return 0;
+}
+
 void spi_transmission_begin(spi_t dev, char reset_val)
 {
 
@@ -432,6 +587,59 @@ static inline void irq_handler_transfer(SPI_TypeDef *spi, spi_t dev)
     }
 }
 
+static inline void irq_handler_dma(spi_t dev)
+{
+    const spi_dma_t *d = &spi_dma[dev];
+    spi_state_t *state = &spi_config[dev];
+    uint32_t flags = dma_flags(d->dma, d->rx_num);
+
+    d->spi->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+    d->rx_stream->CR = 0;
+    d->tx_stream->CR = 0;
+    dma_clear(d->dma, d->rx_num);
+    dma_clear(d->dma, d->tx_num);
+
+    if (flags & DMA_LISR_TEIF0) {
+        state->res = -1;
+        state->count = 0;
+    }
+    else {
+        state->res += state->xfers->length;
+        state->xfers++;
+        state->count--;
+    }
+
+    if (!dma_next(dev)) {
+        state->async_cb(state->async_arg, state->res);
+    }
+
+    /* see if a thread with higher priority wants to run now */
+    if (sched_context_switch_request) {
+        thread_yield();
+    }
+}
+
+#if SPI_0_EN && defined(SPI_0_DMA)
+void SPI_0_DMA_IRQ_HANDLER(void)
+{
+    irq_handler_dma(SPI_0);
+}
+#endif
+
+#if SPI_1_EN && defined(SPI_1_DMA)
+void SPI_1_DMA_IRQ_HANDLER(void)
+{
+    irq_handler_dma(SPI_1);
+}
+#endif
+
+#if SPI_2_EN && defined(SPI_2_DMA)
+void SPI_2_DMA_IRQ_HANDLER(void)
+{
+    irq_handler_dma(SPI_2);
+}
+#endif
+
 #if SPI_0_EN
 void SPI_0_IRQ_HANDLER(void)
 {
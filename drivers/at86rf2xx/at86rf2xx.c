@@ -258,7 +258,9 @@ void at86rf2xx_tx_exec(at86rf2xx_t *dev)
 size_t at86rf2xx_rx_len(at86rf2xx_t *dev)
 {
     uint8_t phr;
+    at86rf2xx_fb_start(dev);
     at86rf2xx_fb_read(dev, &phr, 1);
+    at86rf2xx_fb_stop(dev);
 
     /* ignore MSB (refer p.80) and substract length of FCS field */
     return (size_t)((phr & 0x7f) - 2);
@@ -60,12 +60,16 @@ void at86rf2xx_sram_read(const at86rf2xx_t *dev,
                          uint8_t *data,
                          const size_t len)
 {
+    const char cmd[] = { AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_READ,
+                         (char)offset };
+    spi_xfer_t xfers[] = {
+        { .out = cmd, .in = NULL, .length = sizeof(cmd) },
+        { .out = NULL, .in = (char *)data, .length = len },
+    };
+
     spi_acquire(dev->spi);
     gpio_clear(dev->cs_pin);
-    spi_transfer_reg(dev->spi,
-                     AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_READ,
-                     (char)offset, NULL);
-    spi_transfer_bytes(dev->spi, NULL, (char *)data, len);
+    spi_transfer_sg(dev->spi, xfers, 2);
     gpio_set(dev->cs_pin);
     spi_release(dev->spi);
 }
@@ -75,26 +79,41 @@ void at86rf2xx_sram_write(const at86rf2xx_t *dev,
                           const uint8_t *data,
                           const size_t len)
 {
+    const char cmd[] = { AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_WRITE,
+                         (char)offset };
+    spi_xfer_t xfers[] = {
+        { .out = cmd, .in = NULL, .length = sizeof(cmd) },
+        { .out = (const char *)data, .in = NULL, .length = len },
+    };
+
     spi_acquire(dev->spi);
     gpio_clear(dev->cs_pin);
-    spi_transfer_reg(dev->spi,
-                     AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_WRITE,
-                     (char)offset, NULL);
-    spi_transfer_bytes(dev->spi, (char *)data, NULL, len);
+    spi_transfer_sg(dev->spi, xfers, 2);
     gpio_set(dev->cs_pin);
     spi_release(dev->spi);
 }
 
-void at86rf2xx_fb_read(const at86rf2xx_t *dev,
-                       uint8_t *data,
-                       const size_t len)
+void at86rf2xx_fb_start(const at86rf2xx_t *dev)
 {
     spi_acquire(dev->spi);
     gpio_clear(dev->cs_pin);
-    spi_transfer_byte(dev->spi,
-                      AT86RF2XX_ACCESS_FB | AT86RF2XX_ACCESS_READ,
+    spi_transfer_byte(dev->spi, AT86RF2XX_ACCESS_FB | AT86RF2XX_ACCESS_READ,
                       NULL);
-    spi_transfer_bytes(dev->spi, NULL, (char *)data, len);
+}
+
+void at86rf2xx_fb_read(const at86rf2xx_t *dev,
+                       uint8_t *data,
+                       const size_t len)
+{
+    /* the burst runs asynchronously (e.g. via DMA) where the CPU supports
+     * it, the chip stays selected in between */
+    spi_xfer_t xfer = { .out = NULL, .in = (char *)data, .length = len };
+
+    spi_transfer_sg(dev->spi, &xfer, 1);
+}
+
+void at86rf2xx_fb_stop(const at86rf2xx_t *dev)
+{
     gpio_set(dev->cs_pin);
     spi_release(dev->spi);
 }
@@ -19,9 +19,12 @@
  * @}
  */
 
+#include <string.h>
+
 #include "net/eui64.h"
 #include "net/ieee802154.h"
 #include "net/gnrc.h"
+#include "net/gnrc/ieee802154.h"
 #include "at86rf2xx.h"
 #include "at86rf2xx_netdev.h"
 #include "at86rf2xx_internal.h"
@@ -32,187 +35,34 @@
 
 #define _MAX_MHR_OVERHEAD   (25)
 
-/* TODO: generalize and move to (gnrc_)ieee802154 */
-static size_t _make_data_frame_hdr(at86rf2xx_t *dev, uint8_t *buf,
-                                   gnrc_netif_hdr_t *hdr)
+/**
+ * @brief   Collect the device configuration the MAC header depends on
+ */
+static void _hdr_cfg(const at86rf2xx_t *dev, gnrc_ieee802154_cfg_t *cfg)
 {
-    int pos = 0;
-
-    /* we are building a data frame here */
-    buf[0] = IEEE802154_FCF_TYPE_DATA;
-    buf[1] = IEEE802154_FCF_VERS_V1;
-
-    /* if AUTOACK is enabled, then we also expect ACKs for this packet */
-    if (!(hdr->flags & GNRC_NETIF_HDR_FLAGS_BROADCAST) &&
-        !(hdr->flags & GNRC_NETIF_HDR_FLAGS_MULTICAST) &&
-        (dev->options & AT86RF2XX_OPT_AUTOACK)) {
-        buf[0] |= IEEE802154_FCF_ACK_REQ;
+    cfg->pan = dev->pan;
+    cfg->opts = 0;
+    if (dev->options & AT86RF2XX_OPT_AUTOACK) {
+        cfg->opts |= GNRC_IEEE802154_OPT_ACK_REQ;
     }
-
-    /* fill in destination PAN ID */
-    pos = 3;
-    buf[pos++] = (uint8_t)((dev->pan) & 0xff);
-    buf[pos++] = (uint8_t)((dev->pan) >> 8);
-
-    /* fill in destination address */
-    if (hdr->flags &
-        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
-        buf[1] |= IEEE802154_FCF_DST_ADDR_SHORT;
-        buf[pos++] = 0xff;
-        buf[pos++] = 0xff;
-    }
-    else if (hdr->dst_l2addr_len == 2) {
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-        buf[1] |= IEEE802154_FCF_DST_ADDR_SHORT;
-        buf[pos++] = dst_addr[1];
-        buf[pos++] = dst_addr[0];
-    }
-    else if (hdr->dst_l2addr_len == 8) {
-        buf[1] |= IEEE802154_FCF_DST_ADDR_LONG;
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-        for (int i = 7;  i >= 0; i--) {
-            buf[pos++] = dst_addr[i];
-        }
-    }
-    else {
-        /* unsupported address length */
-        return 0;
-    }
-
-    /* fill in source PAN ID (if applicable */
     if (dev->options & AT86RF2XX_OPT_USE_SRC_PAN) {
-        buf[pos++] = (uint8_t)((dev->pan) & 0xff);
-        buf[pos++] = (uint8_t)((dev->pan) >> 8);
-    } else {
-        buf[0] |= IEEE802154_FCF_PAN_COMP;
+        cfg->opts |= GNRC_IEEE802154_OPT_USE_SRC_PAN;
     }
-
-    /* fill in source address */
     if (dev->options & AT86RF2XX_OPT_SRC_ADDR_LONG) {
-        buf[1] |= IEEE802154_FCF_SRC_ADDR_LONG;
-        memcpy(&(buf[pos]), dev->addr_long, 8);
-        pos += 8;
-    }
-    else {
-        buf[1] |= IEEE802154_FCF_SRC_ADDR_SHORT;
-        buf[pos++] = dev->addr_short[0];
-        buf[pos++] = dev->addr_short[1];
-    }
-
-    /* set sequence number */
-    buf[2] = dev->seq_nr++;
-    /* return actual header length */
-    return pos;
-}
-
-/* TODO: generalize and move to ieee802154 */
-/* TODO: include security header implications */
-static size_t _get_frame_hdr_len(uint8_t *mhr)
-{
-    uint8_t tmp;
-    size_t len = 3;
-
-    /* figure out address sizes */
-    tmp = (mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        len += 4;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        len += 10;
-    }
-    else if (tmp != IEEE802154_FCF_DST_ADDR_VOID) {
-        return 0;
-    }
-    tmp = (mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK);
-    if (tmp == IEEE802154_FCF_SRC_ADDR_VOID) {
-        return len;
+        cfg->src_len = 8;
+        memcpy(cfg->src, dev->addr_long, 8);
     }
     else {
-        if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-            len += 2;
-        }
-        if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-            return (len + 2);
-        }
-        else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-            return (len + 8);
-        }
+        cfg->src_len = 2;
+        memcpy(cfg->src, dev->addr_short, 2);
     }
-    return 0;
 }
 
-/* TODO: generalize and move to (gnrc_)ieee802154 */
-static gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr)
-{
-    uint8_t tmp;
-    uint8_t *addr;
-    uint8_t src_len, dst_len;
-    gnrc_pktsnip_t *snip;
-    gnrc_netif_hdr_t *hdr;
-
-    /* figure out address sizes */
-    tmp = mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK;
-    if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-        src_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-        src_len = 8;
-    }
-    else if (tmp == IEEE802154_FCF_SRC_ADDR_VOID) {
-        src_len = 0;
-    }
-    else {
-        return NULL;
-    }
-    tmp = mhr[1] & IEEE802154_FCF_DST_ADDR_MASK;
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        dst_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        dst_len = 8;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_VOID) {
-        dst_len = 0;
-    }
-    else {
-        return NULL;
-    }
-    /* allocate space for header */
-    snip = gnrc_pktbuf_add(NULL, NULL, sizeof(gnrc_netif_hdr_t) + src_len + dst_len,
-                           GNRC_NETTYPE_NETIF);
-    if (snip == NULL) {
-        return NULL;
-    }
-    /* fill header */
-    hdr = (gnrc_netif_hdr_t *)snip->data;
-    gnrc_netif_hdr_init(hdr, src_len, dst_len);
-    if (dst_len > 0) {
-        tmp = 5 + dst_len;
-        addr = gnrc_netif_hdr_get_dst_addr(hdr);
-        for (int i = 0; i < dst_len; i++) {
-            addr[i] = mhr[5 + (dst_len - i) - 1];
-        }
-    }
-    else {
-        tmp = 3;
-    }
-    if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-        tmp += 2;
-    }
-    if (src_len > 0) {
-        addr = gnrc_netif_hdr_get_src_addr(hdr);
-        for (int i = 0; i < src_len; i++) {
-            addr[i] = mhr[tmp + (src_len - i) - 1];
-        }
-    }
-    return snip;
-}
-
-
 static int _send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
 {
     at86rf2xx_t *dev = (at86rf2xx_t *)netdev;
     gnrc_pktsnip_t *snip;
+    gnrc_ieee802154_cfg_t cfg;
     uint8_t mhr[IEEE802154_MAX_HDR_LEN];
     size_t len;
 
@@ -224,12 +74,22 @@ static int _send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
         return -ENODEV;
     }
 
-    /* create 802.15.4 header */
-    len = _make_data_frame_hdr(dev, mhr, (gnrc_netif_hdr_t *)pkt->data);
-    if (len == 0) {
-        DEBUG("[at86rf2xx] error: unable to create 802.15.4 header\n");
-        gnrc_pktbuf_release(pkt);
-        return -ENOMSG;
+    if (dev->options & AT86RF2XX_OPT_RAWDUMP) {
+        /* the MAC header is part of the payload */
+        len = 0;
+    }
+    else {
+        /* create 802.15.4 header */
+        _hdr_cfg(dev, &cfg);
+        len = gnrc_ieee802154_build_hdr(&dev->hdr_cache, &cfg,
+                                        (gnrc_netif_hdr_t *)pkt->data,
+                                        dev->seq_nr, mhr);
+        if (len == 0) {
+            DEBUG("[at86rf2xx] error: unable to create 802.15.4 header\n");
+            gnrc_pktbuf_release(pkt);
+            return -ENOMSG;
+        }
+        dev->seq_nr++;
     }
     /* check if packet (header + payload + FCS) fits into FIFO */
     snip = pkt->next;
@@ -258,64 +118,119 @@ static int _send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
     return (int)len;
 }
 
+/**
+ * @brief   Upload the received frame in a single frame buffer access
+ *
+ * @param[in] dev       device to read from
+ * @param[out] trailer  FCS and the bytes following the PSDU
+ *
+ * @return  snip holding the PSDU without FCS
+ * @return  NULL if the frame is dropped
+ */
+static gnrc_pktsnip_t *_upload(at86rf2xx_t *dev, uint8_t *trailer)
+{
+    gnrc_pktsnip_t *pkt = NULL;
+    uint8_t phr;
+    size_t pkt_len;
+
+#ifdef MODULE_AT86RF2XX_RX_BUF
+    /* copy the frame to the driver's buffer first, so the radio can receive
+     * the next frame while this one is handed to the packet buffer */
+    at86rf2xx_fb_start(dev);
+    at86rf2xx_fb_read(dev, &phr, 1);
+    phr &= 0x7f;
+    at86rf2xx_fb_read(dev, dev->rx_buf, phr + AT86RF2XX_RX_TRAILER_LEN);
+    at86rf2xx_fb_stop(dev);
+
+    if (!dev->event_cb || (phr <= IEEE802154_FCS_LEN)) {
+        return NULL;
+    }
+    pkt_len = phr - IEEE802154_FCS_LEN;
+    memcpy(trailer, &dev->rx_buf[pkt_len],
+           IEEE802154_FCS_LEN + AT86RF2XX_RX_TRAILER_LEN);
+    pkt = gnrc_pktbuf_add(NULL, dev->rx_buf, pkt_len, GNRC_NETTYPE_UNDEF);
+    if (pkt == NULL) {
+        DEBUG("[at86rf2xx] error: unable to allocate incoming frame\n");
+    }
+#else
+    /* the frame buffer stays protected until the access is stopped, so the
+     * packet buffer is allocated in the middle of the burst */
+    at86rf2xx_fb_start(dev);
+    at86rf2xx_fb_read(dev, &phr, 1);
+    phr &= 0x7f;
+    if (dev->event_cb && (phr > IEEE802154_FCS_LEN)) {
+        pkt_len = phr - IEEE802154_FCS_LEN;
+        pkt = gnrc_pktbuf_add(NULL, NULL, pkt_len, GNRC_NETTYPE_UNDEF);
+        if (pkt == NULL) {
+            DEBUG("[at86rf2xx] error: unable to allocate incoming frame\n");
+        }
+        else {
+            at86rf2xx_fb_read(dev, pkt->data, pkt_len);
+            at86rf2xx_fb_read(dev, trailer,
+                              IEEE802154_FCS_LEN + AT86RF2XX_RX_TRAILER_LEN);
+        }
+    }
+    at86rf2xx_fb_stop(dev);
+#endif
+    return pkt;
+}
+
 static void _receive_data(at86rf2xx_t *dev)
 {
-    uint8_t mhr[IEEE802154_MAX_HDR_LEN];
-    size_t pkt_len, hdr_len;
-    gnrc_pktsnip_t *hdr, *payload = NULL;
+    uint8_t trailer[IEEE802154_FCS_LEN + AT86RF2XX_RX_TRAILER_LEN];
+    size_t hdr_len;
+    gnrc_pktsnip_t *pkt, *mhr, *hdr;
     gnrc_netif_hdr_t *netif;
 
-    /* get the size of the received packet (unlocks frame buffer protection) */
-    pkt_len = at86rf2xx_rx_len(dev);
-
-    /* abort here already if no event callback is registered */
-    if (!dev->event_cb) {
+    /* read PHR, PSDU, LQI and ED in one go (releases frame buffer
+     * protection) */
+    pkt = _upload(dev, trailer);
+    if (pkt == NULL) {
         return;
     }
 
-    /* in raw mode, just read the binary dump into the packet buffer */
+    /* in raw mode, just pass the binary dump on */
     if (dev->options & AT86RF2XX_OPT_RAWDUMP) {
-        payload = gnrc_pktbuf_add(NULL, NULL, pkt_len, GNRC_NETTYPE_UNDEF);
-        if (payload == NULL ) {
-            DEBUG("[at86rf2xx] error: unable to allocate RAW data\n");
-            return;
-        }
-        at86rf2xx_rx_read(dev, payload->data, pkt_len, 0);
-        dev->event_cb(NETDEV_EVENT_RX_COMPLETE, payload);
+        dev->event_cb(NETDEV_EVENT_RX_COMPLETE, pkt);
         return;
     }
 
-    /* get FCF field and compute 802.15.4 header length */
-    at86rf2xx_rx_read(dev, mhr, 2, 0);
-    hdr_len = _get_frame_hdr_len(mhr);
-    if (hdr_len == 0) {
+    /* compute 802.15.4 header length and parse the netif header from it */
+    hdr_len = gnrc_ieee802154_get_hdr_len(pkt->data);
+    if ((hdr_len == 0) || (hdr_len >= pkt->size)) {
         DEBUG("[at86rf2xx] error: unable parse incoming frame header\n");
+        gnrc_pktbuf_release(pkt);
         return;
     }
-    /* read the rest of the header and parse the netif header from it */
-    at86rf2xx_rx_read(dev, &(mhr[2]), hdr_len - 2, 2);
-    hdr = _make_netif_hdr(mhr);
+    hdr = gnrc_ieee802154_make_netif_hdr(pkt->data, hdr_len);
     if (hdr == NULL) {
         DEBUG("[at86rf2xx] error: unable to allocate netif header\n");
+        gnrc_pktbuf_release(pkt);
         return;
     }
     /* fill missing fields in netif header */
     netif = (gnrc_netif_hdr_t *)hdr->data;
     netif->if_pid = dev->mac_pid;
-    at86rf2xx_rx_read(dev, &(netif->lqi), 1, pkt_len);
+    netif->lqi = trailer[IEEE802154_FCS_LEN];
+#ifdef MODULE_AT86RF231
     netif->rssi = at86rf2xx_reg_read(dev, AT86RF2XX_REG__PHY_ED_LEVEL);
-
-    /* allocate payload */
-    payload = gnrc_pktbuf_add(hdr, NULL, (pkt_len - hdr_len), dev->proto);
-    if (payload == NULL) {
-        DEBUG("[at86rf2xx] error: unable to allocate incoming payload\n");
+#else
+    netif->rssi = trailer[IEEE802154_FCS_LEN + 1];
+#endif
+
+    /* split off the MAC header and replace it by the netif header */
+    mhr = gnrc_pktbuf_mark(pkt, hdr_len, GNRC_NETTYPE_UNDEF);
+    if (mhr == NULL) {
+        DEBUG("[at86rf2xx] error: unable to split incoming frame\n");
         gnrc_pktbuf_release(hdr);
+        gnrc_pktbuf_release(pkt);
         return;
     }
-    /* copy payload */
-    at86rf2xx_rx_read(dev, payload->data, payload->size, hdr_len);
+    pkt = gnrc_pktbuf_remove_snip(pkt, mhr);
+    pkt->type = dev->proto;
+    pkt->next = hdr;
     /* finish up and send data to upper layers */
-    dev->event_cb(NETDEV_EVENT_RX_COMPLETE, payload);
+    dev->event_cb(NETDEV_EVENT_RX_COMPLETE, pkt);
 }
 
 static int _set_state(at86rf2xx_t *dev, netopt_state_t state)
@@ -78,10 +78,23 @@ void at86rf2xx_sram_write(const at86rf2xx_t *dev,
                           const size_t len);
 
 /**
- * @brief   Read the internal frame buffer of the given device
+ * @brief   Start a read access to the internal frame buffer
  *
  * Reading the frame buffer returns some extra bytes that are not accessible
- * through reading the RAM directly.
+ * through reading the RAM directly. The access keeps the bus and the chip
+ * selected until at86rf2xx_fb_stop() is called, so a frame can be uploaded
+ * in a single burst. With RX_SAFE_MODE enabled, the radio will not overwrite
+ * the frame buffer before the access is stopped.
+ *
+ * @param[in]  dev      device to read from
+ */
+void at86rf2xx_fb_start(const at86rf2xx_t *dev);
+
+/**
+ * @brief   Read the next bytes of an ongoing frame buffer access
+ *
+ * Uses spi_transfer_sg(), so the calling thread sleeps while CPUs with
+ * DMA support transfer the data. Must not be called from interrupt context.
  *
  * @param[in]  dev      device to read from
  * @param[out] data     buffer to copy the data to
@@ -90,6 +103,13 @@ void at86rf2xx_sram_write(const at86rf2xx_t *dev,
 void at86rf2xx_fb_read(const at86rf2xx_t *dev,
                        uint8_t *data, const size_t len);
 
+/**
+ * @brief   Stop an ongoing frame buffer access
+ *
+ * @param[in]  dev      device to read from
+ */
+void at86rf2xx_fb_stop(const at86rf2xx_t *dev);
+
 /**
  * @brief   Cancel ongoing transactions and switch to TRX_OFF state
  *
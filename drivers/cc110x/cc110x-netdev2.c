@@ -123,6 +123,12 @@ static int _get(netdev2_t *dev, netopt_t opt, void *value, size_t value_len)
             return 1;
         case NETOPT_IPV6_IID:
             return _get_iid(dev, value, value_len);
+        case NETOPT_STATE:
+            assert(value_len >= sizeof(netopt_state_t));
+            *((netopt_state_t *)value) =
+                (cc110x_rd_set_mode(cc110x, RADIO_MODE_GET) == RADIO_MODE_ON)
+                ? NETOPT_STATE_IDLE : NETOPT_STATE_SLEEP;
+            return sizeof(netopt_state_t);
         default:
             break;
     }
@@ -155,6 +161,24 @@ static int _set(netdev2_t *dev, netopt_t opt, void *value, size_t value_len)
                 return -EINVAL;
             }
             return 1;
+        case NETOPT_STATE:
+            if (value_len < sizeof(netopt_state_t)) {
+                return -EINVAL;
+            }
+            switch (*((netopt_state_t *)value)) {
+                case NETOPT_STATE_OFF:
+                case NETOPT_STATE_SLEEP:
+                    cc110x_rd_set_mode(cc110x, RADIO_MODE_OFF);
+                    break;
+                case NETOPT_STATE_IDLE:
+                case NETOPT_STATE_RX:
+                    /* the receiver is on whenever the radio is not sleeping */
+                    cc110x_rd_set_mode(cc110x, RADIO_MODE_ON);
+                    break;
+                default:
+                    return -ENOTSUP;
+            }
+            return sizeof(netopt_state_t);
         default:
             return -ENOTSUP;
     }
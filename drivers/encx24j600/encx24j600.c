@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <string.h>
 
 #include "mutex.h"
 #include "encx24j600.h"
@@ -48,12 +49,16 @@
 #define TX_BUFFER_LEN   (0x2000)
 #define TX_BUFFER_END   (RX_BUFFER_START)
 #define TX_BUFFER_START (TX_BUFFER_END - TX_BUFFER_LEN)
+#define TX_SLOT_LEN     (TX_BUFFER_LEN / 2)
 
 static void cmd(encx24j600_t *dev, char cmd);
 static void reg_set(encx24j600_t *dev, uint8_t reg, uint16_t value);
 static uint16_t reg_get(encx24j600_t *dev, uint8_t reg);
 static void reg_clear_bits(encx24j600_t *dev, uint8_t reg, uint16_t mask);
 static inline int _packets_available(encx24j600_t *dev);
+static void _rx_hdr(encx24j600_t *dev);
+static void _rx_done(encx24j600_t *dev);
+static void _rx_free(encx24j600_t *dev);
 
 static int _get_iid(netdev2_t *netdev, eui64_t *value, size_t max_len);
 static void _get_mac_addr(netdev2_t *dev, uint8_t* buf);
@@ -90,6 +95,11 @@ void encx24j600_setup(encx24j600_t *dev, spi_t spi, gpio_t cs, gpio_t int_pin)
     dev->cs = cs;
     dev->int_pin = int_pin;
     dev->rx_next_ptr = RX_BUFFER_START;
+    dev->rx_hdr_len = 0;
+    dev->rx_batch = 0;
+    dev->rx_pktdec = 0;
+    dev->tx_slot = 0;
+    memset(&dev->stats, 0, sizeof(netstats_t));
 
     mutex_init(&dev->mutex);
 }
@@ -129,11 +139,27 @@ static void _isr(netdev2_t *netdev)
 
     /* check & handle available packets */
     if (eir & PKTIF) {
-        while (_packets_available(dev)) {
-            unlock(dev);
-            netdev->event_callback(netdev, NETDEV2_EVENT_RX_COMPLETE,
-                    NULL);
-            lock(dev);
+        int pending;
+
+        /* PKTCNT is read once per batch, the tail pointer is moved once
+         * after the batch */
+        while ((pending = _packets_available(dev))) {
+            dev->rx_batch = pending;
+            while (dev->rx_batch) {
+                unlock(dev);
+                netdev->event_callback(netdev, NETDEV2_EVENT_RX_COMPLETE,
+                        NULL);
+                lock(dev);
+
+                /* drop the packet if the upper layer did not take it */
+                if (dev->rx_batch == pending) {
+                    DEBUG("encx24j600: dropping packet\n");
+                    _rx_hdr(dev);
+                    _rx_done(dev);
+                }
+                pending = dev->rx_batch;
+            }
+            _rx_free(dev);
         }
     }
 
@@ -286,6 +312,10 @@ static int _init(netdev2_t *encdev)
     reg_set(dev, ERXST, RX_BUFFER_START);
     reg_set(dev, ERXTAIL, RX_BUFFER_END);
     dev->rx_next_ptr = RX_BUFFER_START;
+    dev->rx_hdr_len = 0;
+    dev->rx_batch = 0;
+    dev->rx_pktdec = 0;
+    dev->tx_slot = 0;
 
     /* configure receive filter to receive multicast frames */
     reg_set_bits(dev, ERXFCON, MCEN);
@@ -304,29 +334,48 @@ static int _init(netdev2_t *encdev)
 
 static int _send(netdev2_t *netdev, const struct iovec *vector, int count) {
     encx24j600_t * dev = (encx24j600_t *) netdev;
-    lock(dev);
-
-    /* wait until previous packet has been sent */
-    while ((reg_get(dev, ECON1) & TXRTS));
-
-    /* copy packet to SRAM */
     size_t len = 0;
+    uint16_t start;
 
     for (int i = 0; i < count; i++) {
-        sram_op(dev, WGPDATA, (i ? 0xFFFF : TX_BUFFER_START), vector[i].iov_base, vector[i].iov_len);
         len += vector[i].iov_len;
     }
 
+    if (len > TX_SLOT_LEN) {
+        return -EOVERFLOW;
+    }
+
+    lock(dev);
+
+    /* copy packet to the free half of the TX buffer, the previous packet
+     * may still be sent from the other half meanwhile */
+    start = TX_BUFFER_START + (dev->tx_slot * TX_SLOT_LEN);
+
+    for (int i = 0; i < count; i++) {
+        sram_op(dev, WGPDATA, (i ? 0xFFFF : start), vector[i].iov_base, vector[i].iov_len);
+    }
+
+    /* wait until previous packet has been sent */
+    while ((reg_get(dev, ECON1) & TXRTS));
+
     /* set start of TX packet and length */
-    reg_set(dev, ETXST, TX_BUFFER_START);
+    reg_set(dev, ETXST, start);
     reg_set(dev, ETXLEN, len);
 
     /* initiate sending */
     cmd(dev, SETTXRTS);
 
-    /* wait for sending to complete */
-    /* (not sure if it is needed, keeping the line uncommented) */
-    /*while ((reg_get(dev, ECON1) & TXRTS));*/
+    dev->tx_slot ^= 1;
+
+    /* the group bit of the destination address tells multicast frames */
+    if ((count > 0) && (vector[0].iov_len > 0) &&
+        (((uint8_t *)vector[0].iov_base)[0] & 0x01)) {
+        dev->stats.tx_mcast_count++;
+    }
+    else {
+        dev->stats.tx_unicast_count++;
+    }
+    dev->stats.tx_bytes += len;
 
     unlock(dev);
 
@@ -353,30 +402,84 @@ static void _get_mac_addr(netdev2_t *encdev, uint8_t* buf)
     unlock(dev);
 }
 
-static int _recv(netdev2_t *netdev, char* buf, int len)
+static void _rx_hdr(encx24j600_t *dev)
 {
-    encx24j600_t * dev = (encx24j600_t *) netdev;
     encx24j600_frame_hdr_t hdr;
 
-    lock(dev);
+    /* the header is read once per packet, the first call to _recv() only
+     * asks for the length */
+    if (dev->rx_hdr_len) {
+        return;
+    }
 
-    /* read frame header */
     sram_op(dev, RRXDATA, dev->rx_next_ptr, (char*)&hdr, sizeof(hdr));
 
     /* hdr.frame_len given by device contains 4 bytes checksum */
-    size_t payload_len = hdr.frame_len - 4;
+    dev->rx_hdr_len = hdr.frame_len - 4;
+    dev->rx_hdr_next = hdr.rx_next_ptr;
+}
 
-    if (buf) {
-        /* read packet (without 4 bytes checksum) */
-        sram_op(dev, RRXDATA, 0xFFFF, buf, payload_len);
+static void _rx_done(encx24j600_t *dev)
+{
+    /* the packet count is decremented when the ring is freed */
+    dev->rx_pktdec++;
 
-        /* decrement available packet count */
-        cmd(dev, SETPKTDEC);
+    dev->rx_next_ptr = dev->rx_hdr_next;
+    dev->rx_hdr_len = 0;
 
-        dev->rx_next_ptr = hdr.rx_next_ptr;
+    if (dev->rx_batch) {
+        dev->rx_batch--;
+    }
+    else {
+        _rx_free(dev);
+    }
+}
+
+static void _rx_free(encx24j600_t *dev)
+{
+    /* decrement the available packet count for all packets read since the
+     * last call, SETPKTDEC takes one packet per command */
+    spi_acquire(dev->spi);
+    for (; dev->rx_pktdec; dev->rx_pktdec--) {
+        gpio_clear(dev->cs);
+        spi_transfer_byte(dev->spi, SETPKTDEC, NULL);
+        gpio_set(dev->cs);
+    }
+    spi_release(dev->spi);
 
+    /* free the ring up to the next packet, ERXTAIL must stay inside it */
+    if (dev->rx_next_ptr == RX_BUFFER_START) {
+        reg_set(dev, ERXTAIL, RX_BUFFER_END - 1);
+    }
+    else {
         reg_set(dev, ERXTAIL, dev->rx_next_ptr - 2);
     }
+}
+
+static int _recv(netdev2_t *netdev, char* buf, int len)
+{
+    encx24j600_t * dev = (encx24j600_t *) netdev;
+    int payload_len;
+
+    lock(dev);
+
+    _rx_hdr(dev);
+    payload_len = dev->rx_hdr_len;
+
+    if (buf) {
+        if (len < payload_len) {
+            payload_len = len;
+        }
+
+        /* read packet (without 4 bytes checksum), only _rx_hdr() moves the
+         * read pointer, so it still points behind the header */
+        sram_op(dev, RRXDATA, 0xFFFF, buf, payload_len);
+
+        dev->stats.rx_count++;
+        dev->stats.rx_bytes += payload_len;
+
+        _rx_done(dev);
+    }
 
     unlock(dev);
 
@@ -426,6 +529,19 @@ int _get(netdev2_t *dev, netopt_t opt, void *value, size_t max_len)
             break;
         case NETOPT_IPV6_IID:
             return _get_iid(dev, value, max_len);
+        case NETOPT_STATS:
+            if (max_len < sizeof(netstats_t)) {
+                res = -EOVERFLOW;
+            }
+            else {
+                encx24j600_t *encdev = (encx24j600_t *) dev;
+
+                lock(encdev);
+                memcpy(value, &encdev->stats, sizeof(netstats_t));
+                unlock(encdev);
+                res = sizeof(netstats_t);
+            }
+            break;
         default:
             res = -ENOTSUP;
             break;
@@ -33,6 +33,7 @@
 #include "periph/spi.h"
 #include "periph/gpio.h"
 #include "net/gnrc/netdev.h"
+#include "net/gnrc/ieee802154.h"
 #include "at86rf2xx.h"
 
 #ifdef __cplusplus
@@ -44,6 +45,17 @@ extern "C" {
  */
 #define AT86RF2XX_MAX_PKT_LENGTH        (127)
 
+/**
+ * @brief   Number of bytes a frame buffer read returns after the PSDU
+ *
+ * All chips append the LQI, all but the AT86RF231 also the ED level.
+ */
+#ifdef MODULE_AT86RF231
+#define AT86RF2XX_RX_TRAILER_LEN        (1U)
+#else
+#define AT86RF2XX_RX_TRAILER_LEN        (2U)
+#endif
+
 /**
  * @brief   Default addresses used if the CPUID module is not present
  * @{
@@ -156,6 +168,19 @@ typedef struct {
     uint8_t addr_long[8];               /**< the radio's long address */
     uint16_t options;                   /**< state of used options */
     uint8_t idle_state;                 /**< state to return to after sending */
+    gnrc_ieee802154_hdr_cache_t hdr_cache;  /**< MAC headers for the last
+                                             *   destinations */
+#if defined(MODULE_AT86RF2XX_RX_BUF) || defined(DOXYGEN)
+    /**
+     * @brief   Received frame, uploaded before it is passed to the packet
+     *          buffer (enabled with the at86rf2xx_rx_buf pseudo module)
+     *
+     * With RX_SAFE_MODE the radio drops incoming frames until the frame
+     * buffer was read. The extra buffer shortens that window to the SPI
+     * burst itself.
+     */
+    uint8_t rx_buf[AT86RF2XX_MAX_PKT_LENGTH + AT86RF2XX_RX_TRAILER_LEN];
+#endif
 } at86rf2xx_t;
 
 /**
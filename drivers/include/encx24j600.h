@@ -26,6 +26,7 @@
 #include "periph/spi.h"
 #include "periph/gpio.h"
 #include "net/netdev2.h"
+#include "net/netstats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,7 +42,16 @@ typedef struct {
     gpio_t cs;              /**< SPI chip select pin */
     gpio_t int_pin;         /**< SPI interrupt pin */
     uint16_t rx_next_ptr;   /**< ptr to next packet whithin devices memory */
+    uint16_t rx_hdr_next;   /**< ptr to the packet after the one whose
+                                 header was read */
+    uint16_t rx_hdr_len;    /**< payload length of the packet whose header
+                                 was read, 0 if no header was read */
+    uint8_t rx_batch;       /**< packets left in the current RX batch */
+    uint8_t rx_pktdec;      /**< packets read but not yet subtracted from
+                                 the device's packet counter */
+    uint8_t tx_slot;        /**< TX buffer slot the next packet goes to */
     mutex_t mutex;          /**< mutex used to lock device access */
+    netstats_t stats;       /**< packet and byte counters */
 } encx24j600_t;
 
 /**
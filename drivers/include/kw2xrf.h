@@ -28,6 +28,7 @@
 #include "periph/spi.h"
 #include "periph/gpio.h"
 #include "net/gnrc/netdev.h"
+#include "net/gnrc/ieee802154.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -118,6 +119,8 @@ typedef struct {
     uint16_t option;                      /**< Bit field to save enable/disable options */
     int8_t tx_power;                      /**< The current tx-power setting of the device */
     gnrc_nettype_t proto;                 /**< Protocol the interface speaks */
+    gnrc_ieee802154_hdr_cache_t hdr_cache;    /**< MAC headers for the last
+                                               *   destinations */
 } kw2xrf_t;
 
 /**
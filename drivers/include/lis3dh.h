@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 
+#include "ringbuffer.h"
 #include "periph/spi.h"
 #include "periph/gpio.h"
 
@@ -678,6 +679,11 @@ typedef enum {
 #define LIS3DH_FIFO_MODE_STREAM_TO_FIFO (0x03 << LIS3DH_FIFO_CTRL_REG_FM_SHIFT)
 /** @} */
 
+/**
+ * @brief Number of samples the FIFO holds
+ */
+#define LIS3DH_FIFO_SIZE (32)
+
 /**
  * @brief Device descriptor for LIS3DH sensors
  */
@@ -687,6 +693,9 @@ typedef struct {
     gpio_t int1;            /**< INT1 pin */
     gpio_t int2;            /**< INT2 (DRDY) pin */
     int16_t scale;          /**< Current scale setting of the sensor */
+    uint32_t period;        /**< Sample period of the current ODR in us */
+    uint32_t fifo_time;     /**< Time of the newest sample read from the FIFO */
+    uint8_t fifo_synced;    /**< fifo_time is valid, no samples were lost */
 } lis3dh_t;
 
 /**
@@ -700,6 +709,14 @@ typedef struct __attribute__((packed))
 }
 lis3dh_data_t;
 
+/**
+ * @brief Timestamped sample read from the FIFO
+ */
+typedef struct {
+    uint32_t time;          /**< xtimer time of the sample in microseconds */
+    lis3dh_data_t data;     /**< Acceleration of the sample */
+} lis3dh_sample_t;
+
 
 /**
  * @brief Initialize a LIS3DH sensor instance
@@ -853,6 +870,44 @@ int lis3dh_set_int1(lis3dh_t *dev, const uint8_t mode);
  */
 int lis3dh_get_fifo_level(lis3dh_t *dev);
 
+/**
+ * @brief Sample into the FIFO and signal its watermark on INT1
+ *
+ * Puts the FIFO into stream mode and routes the watermark interrupt to the
+ * INT1 pin. @p cb is called in interrupt context whenever the FIFO level
+ * reaches @p watermark, lis3dh_read_fifo() then drains it. The output
+ * data rate must be set with lis3dh_set_odr() before.
+ *
+ * @param[in]  dev          Device descriptor of sensor
+ * @param[in]  watermark    FIFO level to signal, 0 to 31
+ * @param[in]  cb           Callback for the watermark interrupt
+ * @param[in]  arg          Argument passed to @p cb
+ *
+ * @return                  0 on success
+ * @return                  -1 on error
+ */
+int lis3dh_start_fifo(lis3dh_t *dev, uint8_t watermark, gpio_cb_t cb, void *arg);
+
+/**
+ * @brief Drain the FIFO into a ring buffer of lis3dh_sample_t
+ *
+ * All samples in the FIFO are read in a single SPI transaction, scaled to
+ * milli-G and added to @p rb as lis3dh_sample_t, oldest first. Samples that
+ * do not fit into @p rb stay in the FIFO.
+ *
+ * The sensor does not timestamp samples. They are spread evenly between the
+ * newest sample of the previous call and the time of this call. On the first
+ * call and after a FIFO overrun the period of the output data rate is used
+ * instead.
+ *
+ * @param[in]  dev          Device descriptor of sensor
+ * @param[out] rb           Ring buffer the samples are added to
+ *
+ * @return                  number of samples added to @p rb
+ * @return                  -1 on error
+ */
+int lis3dh_read_fifo(lis3dh_t *dev, ringbuffer_t *rb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,7 @@
 #ifndef MPU9150_H_
 #define MPU9150_H_
 
+#include "ringbuffer.h"
 #include "periph/i2c.h"
 
 #ifdef __cplusplus
@@ -38,6 +39,18 @@ extern "C" {
 #define MPU9150_MAX_COMP_SMPL_RATE  (100)
 /** @} */
 
+/**
+ * @brief Size of the FIFO in bytes, it holds 85 accel and gyro samples
+ */
+#define MPU9150_FIFO_SIZE           (1024)
+
+/**
+ * @brief Number of samples read from the FIFO per I2C transaction
+ */
+#ifndef MPU9150_FIFO_BURST
+#define MPU9150_FIFO_BURST          (16)
+#endif
+
 /**
  * @name Power Management 1 register macros
  * @{
@@ -167,8 +180,19 @@ typedef struct {
     uint8_t hw_addr;            /**< Hardware address of the MPU-9150 */
     uint8_t comp_addr;          /**< Address of the MPU-9150s compass */
     mpu9150_status_t conf;      /**< Device configuration */
+    uint32_t fifo_time;         /**< Time of the newest sample read from the FIFO */
+    uint8_t fifo_synced;        /**< fifo_time is valid, no samples were lost */
 } mpu9150_t;
 
+/**
+ * @brief Timestamped sample read from the FIFO
+ */
+typedef struct {
+    uint32_t time;              /**< xtimer time of the sample in microseconds */
+    mpu9150_results_t accel;    /**< Acceleration in mG per axis */
+    mpu9150_results_t gyro;     /**< Angular speed in dps per axis */
+} mpu9150_sample_t;
+
 /**
  * @brief Initialize the given MPU9150 device
  *
@@ -332,6 +356,43 @@ int mpu9150_set_sample_rate(mpu9150_t *dev, uint16_t rate);
  */
 int mpu9150_set_compass_sample_rate(mpu9150_t *dev, uint8_t rate);
 
+/**
+ * @brief Sample accelerometer and gyroscope into the FIFO
+ *
+ * The FIFO is cleared and from then on filled at the configured sample rate,
+ * mpu9150_read_fifo() drains it. The sensor has no FIFO watermark interrupt,
+ * so the caller wakes up after a batch of samples, e.g. with an xtimer, before
+ * @ref MPU9150_FIFO_SIZE bytes are filled.
+ *
+ * @param[in] dev           Device descriptor of MPU9150 device
+ *
+ * @return                  0 on success
+ * @return                  -1 if device's I2C is not enabled in board config
+ */
+int mpu9150_start_fifo(mpu9150_t *dev);
+
+/**
+ * @brief Drain the FIFO into a ring buffer of mpu9150_sample_t
+ *
+ * The samples are read in bursts of up to @ref MPU9150_FIFO_BURST samples per
+ * I2C transaction, normalized like mpu9150_read_accel() and
+ * mpu9150_read_gyro() and added to @p rb as mpu9150_sample_t, oldest first.
+ * Samples that do not fit into @p rb stay in the FIFO.
+ *
+ * The sensor does not timestamp samples. They are spread evenly between the
+ * newest sample of the previous call and the time of this call. On the first
+ * call and after a FIFO overflow the configured sample rate is used instead.
+ * An overflow clears the FIFO, as it no longer starts with a complete sample.
+ *
+ * @param[in]  dev          Device descriptor of MPU9150 device
+ * @param[out] rb           Ring buffer the samples are added to
+ *
+ * @return                  number of samples added to @p rb
+ * @return                  -1 if device's I2C is not enabled in board config
+ * @return                  -2 if a full-scale range is configured wrong
+ */
+int mpu9150_read_fifo(mpu9150_t *dev, ringbuffer_t *rb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for more
+ * details.
+ */
+
+/**
+ * @ingroup     nvram
+ * @{
+ *
+ * @file
+ *
+ * @brief       Write combining cache on top of any NVRAM device.
+ *
+ * The cache is an nvram_t itself and forwards to the cached device:
+ *
+ * - Writes are collected in a buffer of one device page. A write that
+ *   overlaps or touches the pending data of the same page is merged into
+ *   it, any other write flushes the pending data first. Writes never cross
+ *   a page boundary on the device.
+ * - A read that continues where the previous one ended fetches a whole
+ *   prefetch buffer, the following sequential reads are served from it.
+ * - Pending data is written to the device by nvram_cache_flush(). If
+ *   nvram_cache_params_t::flush_pid is set, a message of type
+ *   @ref NVRAM_CACHE_MSG_TYPE_FLUSH is sent to that thread
+ *   nvram_cache_params_t::flush_us after the first pending write, the thread
+ *   is expected to call nvram_cache_flush() then.
+ *
+ * Pending data is lost on a power failure, so flush before the device may
+ * lose power.
+ */
+
+#ifndef DRIVERS_NVRAM_CACHE_H_
+#define DRIVERS_NVRAM_CACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "kernel_types.h"
+#include "msg.h"
+#include "mutex.h"
+#include "xtimer.h"
+#include "nvram.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Message type sent to nvram_cache_params_t::flush_pid
+ */
+#define NVRAM_CACHE_MSG_TYPE_FLUSH  (0x0260)
+
+/**
+ * @brief Parameters of an NVRAM cache.
+ */
+typedef struct nvram_cache_params {
+    /** @brief Cached device */
+    nvram_t *dev;
+    /** @brief Write buffer of nvram_cache_params::page_size bytes */
+    uint8_t *page_buf;
+    /** @brief Page size of the device, writes never cross a page boundary */
+    size_t page_size;
+    /** @brief Prefetch buffer, NULL to disable prefetching */
+    uint8_t *read_buf;
+    /** @brief Size of nvram_cache_params::read_buf */
+    size_t read_size;
+    /** @brief Flush this many microseconds after the first pending write */
+    uint32_t flush_us;
+    /** @brief Thread to notify when the flush is due, KERNEL_PID_UNDEF to
+     * flush on demand only */
+    kernel_pid_t flush_pid;
+} nvram_cache_params_t;
+
+/**
+ * @brief Counters of an NVRAM cache.
+ */
+typedef struct nvram_cache_stats {
+    uint32_t reads;             /**< Read calls */
+    uint32_t read_hits;         /**< Reads served from the prefetch buffer */
+    uint32_t writes;            /**< Write calls */
+    uint32_t write_merges;      /**< Writes merged into pending data */
+    uint32_t dev_reads;         /**< Reads of the device */
+    uint32_t dev_read_bytes;    /**< Bytes read from the device */
+    uint32_t dev_writes;        /**< Writes to the device */
+    uint32_t dev_write_bytes;   /**< Bytes written to the device */
+} nvram_cache_stats_t;
+
+/**
+ * @brief State of an NVRAM cache.
+ */
+typedef struct nvram_cache {
+    /** @brief Parameters */
+    const nvram_cache_params_t *params;
+    /** @brief Device address of the pending data */
+    uint32_t dirty_addr;
+    /** @brief Number of pending bytes, 0 if nothing is pending */
+    size_t dirty_len;
+    /** @brief Device address of the prefetch buffer contents */
+    uint32_t read_addr;
+    /** @brief Valid bytes in the prefetch buffer */
+    size_t read_len;
+    /** @brief Address following the previous read */
+    uint32_t read_next;
+    /** @brief Timer of the delayed flush */
+    xtimer_t timer;
+    /** @brief Message of the delayed flush */
+    msg_t msg;
+    /** @brief Serializes access to the cache */
+    mutex_t lock;
+    /** @brief Counters */
+    nvram_cache_stats_t stats;
+} nvram_cache_t;
+
+/**
+ * @brief Initialize an nvram_t structure as cache of another NVRAM device.
+ *
+ * @param[out] dev          Pointer to NVRAM device descriptor of the cache
+ * @param[out] cache        State of the cache
+ * @param[in]  params       Parameters, must stay valid while the cache is used
+ *
+ * @return                  0 on success
+ * @return                  <0 on errors
+ */
+int nvram_cache_init(nvram_t *dev, nvram_cache_t *cache,
+                     const nvram_cache_params_t *params);
+
+/**
+ * @brief Write pending data to the cached device.
+ *
+ * @param[in]  dev          Pointer to NVRAM device descriptor of the cache
+ *
+ * @return                  Number of bytes written on success
+ * @return                  <0 on errors
+ */
+int nvram_cache_flush(nvram_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVERS_NVRAM_CACHE_H_ */
+/** @} */
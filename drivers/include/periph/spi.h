@@ -11,9 +11,11 @@
  * @ingroup     driver_periph
  * @brief       Low-level SPI peripheral driver
  *
- * The current design of this interface targets implementations that use the SPI in blocking mode.
- *
- * TODO: add means for asynchronous SPI usage
+ * The byte-wise transfer functions use the SPI in blocking mode. Longer transfers can be
+ * described as a list of segments and run asynchronously with spi_transfer_async(), which
+ * uses DMA where the CPU implementation supports it. All other CPUs get a synchronous
+ * implementation of it from the periph_common module, which is used together with the
+ * periph module on every CPU.
  *
  * @{
  * @file
@@ -226,6 +228,60 @@ int spi_transfer_reg(spi_t dev, uint8_t reg, char out, char *in);
  */
 int spi_transfer_regs(spi_t dev, uint8_t reg, char *out, char *in, unsigned int length);
 
+/**
+ * @brief One segment of a scatter/gather transfer
+ */
+typedef struct {
+    const char *out;            /**< bytes to send, NULL to send zeros */
+    char *in;                   /**< buffer for received bytes, NULL to drop them */
+    unsigned int length;        /**< number of bytes in this segment */
+} spi_xfer_t;
+
+/**
+ * @brief Signature of the completion callback of spi_transfer_async()
+ *
+ * @param[in] arg       argument given to spi_transfer_async()
+ * @param[in] res       number of bytes transferred, -1 on error
+ */
+typedef void (*spi_async_cb_t)(void *arg, int res);
+
+/**
+ * @brief Start a transfer of several segments without waiting for it to finish
+ *
+ * The segments are transferred back to back, so they appear as one transaction to the
+ * device. The bus has to be acquired and chip select asserted by the caller. The segment
+ * list and all buffers have to stay valid until @p cb was called.
+ *
+ * @p cb is called in interrupt context when the transfer is done. On CPUs without DMA
+ * support the transfer is done right away and @p cb is called before this function
+ * returns.
+ *
+ * @param[in] dev       SPI device to use
+ * @param[in] xfers     list of segments
+ * @param[in] count     number of segments
+ * @param[in] cb        called when the transfer is done
+ * @param[in] arg       argument passed to @p cb
+ * @return              0 if the transfer was started
+ * @return              -1 on error
+ */
+int spi_transfer_async(spi_t dev, const spi_xfer_t *xfers, unsigned int count,
+                       spi_async_cb_t cb, void *arg);
+
+/**
+ * @brief Transfer several segments and sleep until the transfer is done
+ *
+ * Like spi_transfer_async(), but the calling thread is blocked until the transfer is
+ * complete, so other threads can run in the meantime. Must not be called from interrupt
+ * context.
+ *
+ * @param[in] dev       SPI device to use
+ * @param[in] xfers     list of segments
+ * @param[in] count     number of segments
+ * @return              Number of bytes that were transfered
+ * @return              -1 on error
+ */
+int spi_transfer_sg(spi_t dev, const spi_xfer_t *xfers, unsigned int count);
+
 /**
  * @brief Tell the SPI driver that a new transaction was started. Call only when SPI in slave mode!
  *
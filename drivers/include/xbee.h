@@ -27,6 +27,7 @@
 
 #include "kernel.h"
 #include "mutex.h"
+#include "ringbuffer.h"
 #include "periph/uart.h"
 #include "periph/gpio.h"
 #include "net/gnrc.h"
@@ -51,6 +52,23 @@ extern "C" {
  */
 #define XBEE_MAX_RESP_LENGTH        (16U)
 
+/**
+ * @brief   Size of the buffer for raw incoming UART data
+ *
+ * The buffer has to hold everything that arrives while the driver's thread is
+ * busy, at least one complete frame.
+ */
+#ifndef XBEE_RX_BUF_SIZE
+#define XBEE_RX_BUF_SIZE            (2 * XBEE_MAX_PKT_LENGTH)
+#endif
+
+/**
+ * @brief   Number of AT commands that can wait for their response at a time
+ */
+#ifndef XBEE_AT_SLOTS
+#define XBEE_AT_SLOTS               (4U)
+#endif
+
 /**
  * @brief   Default protocol for data that is coming in
  */
@@ -84,11 +102,12 @@ extern "C" {
  */
 
 /**
- * @brief   States of the internal FSM for handling incoming UART frames
+ * @brief   States of the internal FSM for parsing incoming UART frames
  *
- * Incoming data frames on the UART interfaces are handled using a finite state
- * machine (FSM) in the UARTs RX interrupt handler. The FSM is needed to extract
- * frame specific data as the frame size, frame type, and checksums.
+ * The UART RX interrupt handler only stores the incoming bytes in a
+ * ringbuffer. The FSM runs in the context of the thread using the device and
+ * extracts the frame size, the frame data and the checksum from the buffered
+ * data.
  */
 typedef enum {
     XBEE_INT_STATE_IDLE,        /**< waiting for the beginning of a new frame */
@@ -96,13 +115,23 @@ typedef enum {
                                  *   frame size field */
     XBEE_INT_STATE_SIZE2,       /**< waiting for the second byte (LSB) of the
                                  *   frame size field */
-    XBEE_INT_STATE_TYPE,        /**< waiting for the frame type field */
-    XBEE_INT_STATE_RESP,        /**< handling incoming data for AT command
-                                 *   responses */
-    XBEE_INT_STATE_RX,          /**< handling incoming data when receiving radio
-                                 *   packets */
+    XBEE_INT_STATE_DATA,        /**< receiving the frame data, starting with the
+                                 *   frame type */
+    XBEE_INT_STATE_CKSUM,       /**< waiting for the checksum of the frame */
 } xbee_rx_state_t;
 
+/**
+ * @brief   AT command waiting for its response
+ */
+typedef struct {
+    uint8_t frame_id;           /**< frame ID of the command, 0 if unused */
+    uint8_t done;               /**< set when the response was received */
+    uint8_t status;             /**< AT command response status, 0 for
+                                 *   success */
+    uint8_t data_len;           /**< number of bytes written to @p data */
+    uint8_t data[8];            /**< returned data from the AT command */
+} xbee_at_slot_t;
+
 /**
  * @brief   XBee device descriptor
  */
@@ -120,26 +149,30 @@ typedef struct {
     uint8_t addr_flags;                 /**< address flags as defined above */
     uint8_t addr_short[2];              /**< onw 802.15.4 short address */
     eui64_t addr_long;                  /**< own 802.15.4 long address */
+    /* buffer and synchronization for raw incoming UART data */
+    ringbuffer_t rx_rb;                 /**< bytes received by the UART */
+    char rx_mem[XBEE_RX_BUF_SIZE];      /**< memory of @p rx_rb */
+    kernel_pid_t at_pid;                /**< thread waiting for an AT
+                                         *   response, woken up when new
+                                         *   data arrived */
+    uint8_t rx_event;                   /**< set while an RX event is queued
+                                         *   for the driver's thread */
     /* general variables for the UART RX state machine */
     xbee_rx_state_t int_state;          /**< current state if the UART RX FSM */
-    uint16_t int_size;                  /**< temporary space for parsing the
-                                         *   frame size */
+    uint16_t int_size;                  /**< size of the current frame */
+    uint8_t int_cksum;                  /**< running sum of the frame data */
     /* values for the UART TX state machine */
     mutex_t tx_lock;                    /**< mutex to allow only one
                                          *   transmission at a time */
     uint8_t tx_buf[XBEE_MAX_PKT_LENGTH];/**< transmit data buffer */
     uint16_t tx_count;                  /**< counter for ongoing transmission */
     uint16_t tx_limit;                  /**< size of TX frame transferred */
-    /* buffer and synchronization for command responses */
-    mutex_t resp_lock;                  /**< mutex for waiting for AT command
-                                         *   response frames */
-    uint8_t resp_buf[XBEE_MAX_RESP_LENGTH]; /**< AT response data buffer */
-    uint16_t resp_count;                /**< counter for ongoing transmission */
-    uint16_t resp_limit;                /**< size RESP frame in transferred */
-    /* buffer and synchronization for incoming network packets */
+    /* AT commands waiting for their response */
+    xbee_at_slot_t at[XBEE_AT_SLOTS];   /**< pending AT commands */
+    uint8_t at_id;                      /**< last frame ID used */
+    /* buffer for the frame currently parsed */
     uint8_t rx_buf[XBEE_MAX_PKT_LENGTH];/**< receiving data buffer */
-    uint16_t rx_count;                  /**< counter for ongoing transmission */
-    uint16_t rx_limit;                  /**< size RX frame transferred */
+    uint16_t rx_count;                  /**< bytes of the frame received */
 } xbee_t;
 
 /**
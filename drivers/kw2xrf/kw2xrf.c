@@ -26,6 +26,7 @@
 #include "periph/gpio.h"
 #include "periph/cpuid.h"
 #include "net/gnrc.h"
+#include "net/gnrc/ieee802154.h"
 #include "net/ieee802154.h"
 
 #define ENABLE_DEBUG    (0)
@@ -827,126 +828,6 @@ int kw2xrf_set(gnrc_netdev_t *netdev, netopt_t opt, void *value, size_t value_le
     }
 }
 
-/* TODO: generalize and move to ieee802154 */
-/* TODO: include security header implications */
-static size_t _get_frame_hdr_len(uint8_t *mhr)
-{
-    uint8_t tmp;
-    size_t len = 3;
-
-    /* figure out address sizes */
-    tmp = (mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
-
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        len += 4;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        len += 10;
-    }
-    else if (tmp != IEEE802154_FCF_DST_ADDR_VOID) {
-        return 0;
-    }
-
-    tmp = (mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK);
-
-    if (tmp == IEEE802154_FCF_SRC_ADDR_VOID) {
-        return len;
-    }
-    else {
-        if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-            len += 2;
-        }
-
-        if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-            return (len + 2);
-        }
-        else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-            return (len + 8);
-        }
-    }
-
-    return 0;
-}
-
-/* TODO: generalize and move to (gnrc_)ieee802154 */
-static gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr)
-{
-    uint8_t tmp;
-    uint8_t *addr;
-    uint8_t src_len, dst_len;
-    gnrc_pktsnip_t *snip;
-    gnrc_netif_hdr_t *hdr;
-
-    /* figure out address sizes */
-    tmp = mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK;
-
-    if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-        src_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-        src_len = 8;
-    }
-    else if (tmp == 0) {
-        src_len = 0;
-    }
-    else {
-        return NULL;
-    }
-
-    tmp = mhr[1] & IEEE802154_FCF_DST_ADDR_MASK;
-
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        dst_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        dst_len = 8;
-    }
-    else if (tmp == 0) {
-        dst_len = 0;
-    }
-    else {
-        return NULL;
-    }
-
-    /* allocate space for header */
-    snip = gnrc_pktbuf_add(NULL, NULL, sizeof(gnrc_netif_hdr_t) + src_len + dst_len,
-                           GNRC_NETTYPE_NETIF);
-
-    if (snip == NULL) {
-        return NULL;
-    }
-
-    /* fill header */
-    hdr = (gnrc_netif_hdr_t *)snip->data;
-    gnrc_netif_hdr_init(hdr, src_len, dst_len);
-
-    if (dst_len > 0) {
-        tmp = 5 + dst_len;
-        addr = gnrc_netif_hdr_get_dst_addr(hdr);
-
-        for (int i = 0; i < dst_len; i++) {
-            addr[i] = mhr[5 + (dst_len - i) - 1];
-        }
-    }
-    else {
-        tmp = 3;
-    }
-
-    if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-        tmp += 2;
-    }
-
-    if (src_len > 0) {
-        addr = gnrc_netif_hdr_get_src_addr(hdr);
-
-        for (int i = 0; i < src_len; i++) {
-            addr[i] = mhr[tmp + (src_len - i) - 1];
-        }
-    }
-
-    return snip;
-}
-
 void _receive_data(kw2xrf_t *dev)
 {
     size_t pkt_len, hdr_len;
@@ -979,15 +860,15 @@ void _receive_data(kw2xrf_t *dev)
     }
 
     /* get FCF field and compute 802.15.4 header length */
-    hdr_len = _get_frame_hdr_len(dev->buf);
+    hdr_len = gnrc_ieee802154_get_hdr_len(dev->buf);
 
-    if (hdr_len == 0) {
+    if ((hdr_len == 0) || (hdr_len + IEEE802154_FCS_LEN > pkt_len)) {
         DEBUG("kw2xrf error: unable parse incoming frame header\n");
         return;
     }
 
     /* read the rest of the header and parse the netif header from it */
-    hdr = _make_netif_hdr(dev->buf);
+    hdr = gnrc_ieee802154_make_netif_hdr(dev->buf, hdr_len);
 
     if (hdr == NULL) {
         DEBUG("kw2xrf error: unable to allocate netif header\n");
@@ -1060,11 +941,11 @@ void kw2xrf_isr_event(gnrc_netdev_t *netdev, uint32_t event_type)
     }
 }
 
-/* TODO: Move to gnrc_ieee802.15.4 as soon as ready */
 int _assemble_tx_buf(kw2xrf_t *dev, gnrc_pktsnip_t *pkt)
 {
     gnrc_netif_hdr_t *hdr;
-    int index = 0;
+    gnrc_ieee802154_cfg_t cfg;
+    size_t len;
 
     if (dev == NULL) {
         gnrc_pktbuf_release(pkt);
@@ -1074,80 +955,34 @@ int _assemble_tx_buf(kw2xrf_t *dev, gnrc_pktsnip_t *pkt)
     /* get netif header check address length */
     hdr = (gnrc_netif_hdr_t *)pkt->data;
 
-    /* FCF, set up data frame, request for ack, panid_compression */
     /* TODO: Currently we don´t request for Ack in this device.
      * since this is a soft_mac device this has to be
      * handled in a upcoming CSMA-MAC layer.
      */
-    /*if (dev->option & KW2XRF_OPT_AUTOACK) {
-        dev->buf[1] = 0x61;
-    }
-    else {
-        dev->buf[1] = 0x51;
-    }*/
-    dev->buf[1] = 0x51;
-
-    index = 4;
-
-    /* set destination pan_id */
-    dev->buf[index++] = (uint8_t)((dev->radio_pan) & 0xff);
-    dev->buf[index++] = (uint8_t)((dev->radio_pan) >> 8);
-
-    /* fill in destination address */
-    if (hdr->flags &
-        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
-        dev->buf[2] = IEEE802154_FCF_DST_ADDR_SHORT;
-        dev->buf[index++] = 0xff;
-        dev->buf[index++] = 0xff;
-    }
-    else if (hdr->dst_l2addr_len == 2) {
-        /* set to short addressing mode */
-        dev->buf[2] = IEEE802154_FCF_DST_ADDR_SHORT;
-        /* set destination address, byte order is inverted */
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-        dev->buf[index++] = dst_addr[1];
-        dev->buf[index++] = dst_addr[0];
-    }
-    else if (hdr->dst_l2addr_len == 8) {
-        /* default to use long address mode for src and dst */
-        dev->buf[2] |= IEEE802154_FCF_DST_ADDR_LONG;
-        /* set destination address located directly after gnrc_ifhrd_t in memory */
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-        for (int i = 7;  i >= 0; i--) {
-            dev->buf[index++] = dst_addr[i];
-        }
-    }
-    else {
-        gnrc_pktbuf_release(pkt);
-        return -ENOMSG;
-    }
-
-    /* fill in source PAN ID (if applicable */
-    /* FIXME: compare with at86rf2xx, currently not working
-    if (dev->option & KW2XRF_OPT_USE_SRC_PAN) {
-        dev->buf[index++] = (uint8_t)((dev->radio_pan) & 0xff);
-        dev->buf[index++] = (uint8_t)((dev->radio_pan) >> 8);
-    } else {
-        dev->buf[1] |= IEEE802154_FCF_PAN_COMP;
-    }
-    */
+    cfg.pan = dev->radio_pan;
+    cfg.opts = 0;
 
     /* insert source address according to length */
     if (hdr->src_l2addr_len == 2) {
-        dev->buf[2] |= IEEE802154_FCF_SRC_ADDR_SHORT;
-        dev->buf[index++] = (uint8_t)(dev->addr_short[0]);
-        dev->buf[index++] = (uint8_t)(dev->addr_short[1]);
+        cfg.src_len = 2;
+        memcpy(cfg.src, dev->addr_short, 2);
     }
     else {
-        dev->buf[2] |= IEEE802154_FCF_SRC_ADDR_LONG;
-        memcpy(&(dev->buf[index]), dev->addr_long, 8);
-        index += 8;
+        cfg.src_len = 8;
+        memcpy(cfg.src, dev->addr_long, 8);
     }
-    /* set sequence number */
-    dev->buf[3] = dev->seq_nr++;
+
+    /* the header follows the length field in the tx-buf */
+    len = gnrc_ieee802154_build_hdr(&dev->hdr_cache, &cfg, hdr, dev->seq_nr,
+                                    &dev->buf[1]);
+    if (len == 0) {
+        gnrc_pktbuf_release(pkt);
+        return -ENOMSG;
+    }
+    dev->seq_nr++;
 
     /* return header size */
-    return index;
+    return len + 1;
 }
 
 int kw2xrf_send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
@@ -1169,6 +1004,9 @@ int kw2xrf_send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
     if (pkt->type == GNRC_NETTYPE_NETIF) {
         /* Build header and fills this already into the tx-buf */
         index = _assemble_tx_buf(dev, pkt);
+        if (index < 0) {
+            return index;
+        }
         DEBUG("Assembled header for GNRC_NETTYPE_UNDEF to tx-buf, index: %i\n", index);
     }
     else if (pkt->type == GNRC_NETTYPE_UNDEF) {
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include "periph/gpio.h"
 #include "periph/spi.h"
+#include "xtimer.h"
 #include "lis3dh.h"
 
 /**
@@ -28,6 +29,13 @@ static inline int lis3dh_write_bits(const lis3dh_t *dev, const lis3dh_reg_t reg,
 static int lis3dh_write_reg(const lis3dh_t *dev, const lis3dh_reg_t reg, const uint8_t value);
 static int lis3dh_read_regs(const lis3dh_t *dev, const lis3dh_reg_t reg, const uint8_t len,
                             uint8_t *buf);
+static void lis3dh_scale(const lis3dh_t *dev, lis3dh_data_t *acc_data);
+
+/* Sample period in us for each ODR setting, normal mode. The last setting
+ * (LIS3DH_ODR_NP1250Hz) samples at 1.344 kHz according to the data sheet. */
+static const uint32_t lis3dh_periods[] = {
+    0, 1000000, 100000, 40000, 20000, 10000, 5000, 2500, 625, 744
+};
 
 
 int lis3dh_init(lis3dh_t *dev, spi_t spi, gpio_t cs_pin, gpio_t int1_pin, gpio_t int2_pin, uint8_t scale)
@@ -39,6 +47,8 @@ int lis3dh_init(lis3dh_t *dev, spi_t spi, gpio_t cs_pin, gpio_t int1_pin, gpio_t
     dev->int1 = int1_pin;
     dev->int2 = int2_pin;
     dev->scale = 0;
+    dev->period = 0;
+    dev->fifo_synced = 0;
 
     /* CS */
     gpio_init(dev->cs, GPIO_DIR_OUT, GPIO_NOPULL);
@@ -82,7 +92,6 @@ int lis3dh_init(lis3dh_t *dev, spi_t spi, gpio_t cs_pin, gpio_t int1_pin, gpio_t
 
 int lis3dh_read_xyz(const lis3dh_t *dev, lis3dh_data_t *acc_data)
 {
-    uint8_t i;
     /* Set READ MULTIPLE mode */
     static const uint8_t addr = (LIS3DH_REG_OUT_X_L | LIS3DH_SPI_READ_MASK | LIS3DH_SPI_MULTI_MASK);
 
@@ -104,13 +113,7 @@ int lis3dh_read_xyz(const lis3dh_t *dev, lis3dh_data_t *acc_data)
     /* Release the bus for other threads. */
     spi_release(dev->spi);
 
-    /* Scale to milli-G */
-    for (i = 0; i < 3; ++i) {
-        int32_t tmp = (int32_t)(((int16_t *)acc_data)[i]);
-        tmp *= dev->scale;
-        tmp /= 32768;
-        (((int16_t *)acc_data)[i]) = (int16_t)tmp;
-    }
+    lis3dh_scale(dev, acc_data);
 
     return 0;
 }
@@ -166,6 +169,12 @@ int lis3dh_set_fifo(lis3dh_t *dev, const uint8_t mode, const uint8_t watermark)
 
 int lis3dh_set_odr(lis3dh_t *dev, const uint8_t odr)
 {
+    uint8_t index = (odr & LIS3DH_CTRL_REG1_ODR_MASK) >> LIS3DH_CTRL_REG1_ODR_SHIFT;
+
+    if (index < sizeof(lis3dh_periods) / sizeof(lis3dh_periods[0])) {
+        dev->period = lis3dh_periods[index];
+    }
+    dev->fifo_synced = 0;
     return lis3dh_write_bits(dev, LIS3DH_REG_CTRL_REG1,
         LIS3DH_CTRL_REG1_ODR_MASK, odr);
 }
@@ -212,6 +221,75 @@ int lis3dh_get_fifo_level(lis3dh_t *dev)
     return level;
 }
 
+int lis3dh_start_fifo(lis3dh_t *dev, uint8_t watermark, gpio_cb_t cb, void *arg)
+{
+    dev->fifo_synced = 0;
+    if (lis3dh_set_fifo(dev, LIS3DH_FIFO_MODE_STREAM, watermark) < 0) {
+        return -1;
+    }
+    if (lis3dh_set_int1(dev, LIS3DH_CTRL_REG3_I1_WTM_MASK) < 0) {
+        return -1;
+    }
+    if (gpio_init_int(dev->int1, GPIO_NOPULL, GPIO_RISING, cb, arg) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int lis3dh_read_fifo(lis3dh_t *dev, ringbuffer_t *rb)
+{
+    lis3dh_data_t data[LIS3DH_FIFO_SIZE];
+    lis3dh_sample_t sample;
+    uint32_t now, newest, step;
+    uint8_t reg;
+    int level, count;
+
+    if (lis3dh_read_regs(dev, LIS3DH_REG_FIFO_SRC_REG, 1, &reg) != 0) {
+        return -1;
+    }
+    now = xtimer_now();
+    level = (reg & LIS3DH_FIFO_SRC_REG_FSS_MASK) >> LIS3DH_FIFO_SRC_REG_FSS_SHIFT;
+    if (reg & LIS3DH_FIFO_SRC_REG_OVRN_FIFO_MASK) {
+        /* FSS counts up to 31 only, the FIFO is full and samples were lost */
+        level = LIS3DH_FIFO_SIZE;
+        dev->fifo_synced = 0;
+    }
+    count = ringbuffer_get_free(rb) / sizeof(lis3dh_sample_t);
+    if (count > level) {
+        count = level;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    /* With the FIFO enabled the address wraps from OUT_Z_H back to OUT_X_L,
+     * so the whole FIFO is read in a single transaction */
+    if (lis3dh_read_regs(dev, LIS3DH_REG_OUT_X_L, count * sizeof(lis3dh_data_t),
+                         (uint8_t *)data) != 0) {
+        return -1;
+    }
+
+    if (dev->fifo_synced) {
+        step = (now - dev->fifo_time) / level;
+        newest = dev->fifo_time + (count * step);
+    }
+    else {
+        step = dev->period;
+        newest = now - ((level - count) * step);
+    }
+    dev->fifo_time = newest;
+    dev->fifo_synced = 1;
+
+    for (int i = 0; i < count; i++) {
+        sample.time = newest - ((count - 1 - i) * step);
+        sample.data = data[i];
+        lis3dh_scale(dev, &sample.data);
+        ringbuffer_add(rb, (char *)&sample, sizeof(sample));
+    }
+
+    return count;
+}
+
 
 /**
  * @brief Read sequential registers from the LIS3DH.
@@ -250,6 +328,25 @@ static int lis3dh_read_regs(const lis3dh_t *dev, const lis3dh_reg_t reg, const u
     return 0;
 }
 
+/**
+ * @brief Scale raw measurements to milli-G.
+ *
+ * @param[in]  dev          Device descriptor
+ * @param[in,out] acc_data  Raw measurements, scaled in place
+ */
+static void lis3dh_scale(const lis3dh_t *dev, lis3dh_data_t *acc_data)
+{
+    uint8_t i;
+
+    /* Sensor full range is -32768 -- +32767 (measurements are left adjusted) */
+    for (i = 0; i < 3; ++i) {
+        int32_t tmp = (int32_t)(((int16_t *)acc_data)[i]);
+        tmp *= dev->scale;
+        tmp /= 32768;
+        (((int16_t *)acc_data)[i]) = (int16_t)tmp;
+    }
+}
+
 /**
  * @brief Write a value to an 8 bit register in the LIS3DH.
  *
@@ -93,6 +93,11 @@
 #define BIT_SLAVE_RW                    (0x80)
 #define BIT_SLAVE_EN                    (0x80)
 #define BIT_DMP_EN                      (0x80)
+#define BIT_FIFO_RESET                  (0x04)
+#define BIT_FIFO_ACCEL                  (0x08)
+#define BIT_FIFO_OFLOW_INT              (0x10)
+#define BIT_FIFO_GYRO                   (0x70)
+#define BIT_FIFO_EN                     (0x40)
 /** @} */
 
 #ifdef __cplusplus
@@ -28,6 +28,7 @@
 
 #define REG_RESET           (0x00)
 #define MAX_VALUE           (0x7FFF)
+#define FIFO_SAMPLE_SIZE    (12)
 
 /* Default config settings */
 static const mpu9150_status_t DEFAULT_STATUS = {
@@ -47,6 +48,9 @@ static const mpu9150_status_t DEFAULT_STATUS = {
 static int compass_init(mpu9150_t *dev);
 static void conf_bypass(mpu9150_t *dev, uint8_t bypass_enable);
 static void conf_lpf(mpu9150_t *dev, uint16_t rate);
+static float gyro_fsr(mpu9150_t *dev);
+static float accel_fsr(mpu9150_t *dev);
+static void normalize(const char *data, float fsr, mpu9150_results_t *output);
 
 /*---------------------------------------------------------------------------*
  *                          MPU9150 Core API                                 *
@@ -61,6 +65,7 @@ int mpu9150_init(mpu9150_t *dev, i2c_t i2c, mpu9150_hw_addr_t hw_addr,
     dev->hw_addr = hw_addr;
     dev->comp_addr = comp_addr;
     dev->conf = DEFAULT_STATUS;
+    dev->fifo_synced = 0;
 
     /* Initialize I2C interface */
     if (i2c_init_master(dev->i2c_dev, I2C_SPEED_FAST)) {
@@ -245,24 +250,10 @@ int mpu9150_set_compass_power(mpu9150_t *dev, mpu9150_pwr_t pwr_conf)
 int mpu9150_read_gyro(mpu9150_t *dev, mpu9150_results_t *output)
 {
     char data[6];
-    int16_t temp;
-    float fsr;
+    float fsr = gyro_fsr(dev);
 
-    switch (dev->conf.gyro_fsr) {
-        case MPU9150_GYRO_FSR_250DPS:
-            fsr = 250.0;
-            break;
-        case MPU9150_GYRO_FSR_500DPS:
-            fsr = 500.0;
-            break;
-        case MPU9150_GYRO_FSR_1000DPS:
-            fsr = 1000.0;
-            break;
-        case MPU9150_GYRO_FSR_2000DPS:
-            fsr = 2000.0;
-            break;
-        default:
-            return -2;
+    if (fsr == 0.0) {
+        return -2;
     }
 
     /* Acquire exclusive access */
@@ -275,12 +266,7 @@ int mpu9150_read_gyro(mpu9150_t *dev, mpu9150_results_t *output)
     i2c_release(dev->i2c_dev);
 
     /* Normalize data according to configured full scale range */
-    temp = (data[0] << 8) | data[1];
-    output->x_axis = (temp * fsr) / MAX_VALUE;
-    temp = (data[2] << 8) | data[3];
-    output->y_axis = (temp * fsr) / MAX_VALUE;
-    temp = (data[4] << 8) | data[5];
-    output->z_axis = (temp * fsr) / MAX_VALUE;
+    normalize(data, fsr, output);
 
     return 0;
 }
@@ -288,24 +274,10 @@ int mpu9150_read_gyro(mpu9150_t *dev, mpu9150_results_t *output)
 int mpu9150_read_accel(mpu9150_t *dev, mpu9150_results_t *output)
 {
     char data[6];
-    int16_t temp;
-    float fsr;
+    float fsr = accel_fsr(dev);
 
-    switch (dev->conf.accel_fsr) {
-        case MPU9150_ACCEL_FSR_2G:
-            fsr = 2000.0;
-            break;
-        case MPU9150_ACCEL_FSR_4G:
-            fsr = 4000.0;
-            break;
-        case MPU9150_ACCEL_FSR_8G:
-            fsr = 8000.0;
-            break;
-        case MPU9150_ACCEL_FSR_16G:
-            fsr = 16000.0;
-            break;
-        default:
-            return -2;
+    if (fsr == 0.0) {
+        return -2;
     }
 
     /* Acquire exclusive access */
@@ -318,12 +290,7 @@ int mpu9150_read_accel(mpu9150_t *dev, mpu9150_results_t *output)
     i2c_release(dev->i2c_dev);
 
     /* Normalize data according to configured full scale range */
-    temp = (data[0] << 8) | data[1];
-    output->x_axis = (temp * fsr) / MAX_VALUE;
-    temp = (data[2] << 8) | data[3];
-    output->y_axis = (temp * fsr) / MAX_VALUE;
-    temp = (data[4] << 8) | data[5];
-    output->z_axis = (temp * fsr) / MAX_VALUE;
+    normalize(data, fsr, output);
 
     return 0;
 }
@@ -454,6 +421,7 @@ int mpu9150_set_sample_rate(mpu9150_t *dev, uint16_t rate)
 
     /* Store configured sample rate */
     dev->conf.sample_rate = 1000 / (((uint16_t) divider) + 1);
+    dev->fifo_synced = 0;
 
     /* Always set LPF to a maximum of half the configured sampling rate */
     conf_lpf(dev, (dev->conf.sample_rate >> 1));
@@ -489,6 +457,105 @@ int mpu9150_set_compass_sample_rate(mpu9150_t *dev, uint8_t rate)
     return 0;
 }
 
+int mpu9150_start_fifo(mpu9150_t *dev)
+{
+    char data;
+
+    if (i2c_acquire(dev->i2c_dev)) {
+        return -1;
+    }
+    /* Stop and clear the FIFO, then let accel and gyro fill it */
+    i2c_read_reg(dev->i2c_dev, dev->hw_addr, MPU9150_USER_CTRL_REG, &data);
+    data &= ~BIT_FIFO_EN;
+    i2c_write_reg(dev->i2c_dev, dev->hw_addr, MPU9150_USER_CTRL_REG, (data | BIT_FIFO_RESET));
+    i2c_write_reg(dev->i2c_dev, dev->hw_addr, MPU9150_FIFO_EN_REG,
+            (BIT_FIFO_ACCEL | BIT_FIFO_GYRO));
+    i2c_write_reg(dev->i2c_dev, dev->hw_addr, MPU9150_USER_CTRL_REG, (data | BIT_FIFO_EN));
+    i2c_release(dev->i2c_dev);
+
+    dev->fifo_synced = 0;
+
+    return 0;
+}
+
+int mpu9150_read_fifo(mpu9150_t *dev, ringbuffer_t *rb)
+{
+    char data[MPU9150_FIFO_BURST * FIFO_SAMPLE_SIZE];
+    char status, count_regs[2];
+    mpu9150_sample_t sample;
+    uint32_t now, newest, step;
+    float afsr = accel_fsr(dev);
+    float gfsr = gyro_fsr(dev);
+    int level, count;
+
+    if ((afsr == 0.0) || (gfsr == 0.0)) {
+        return -2;
+    }
+
+    /* Acquire exclusive access */
+    if (i2c_acquire(dev->i2c_dev)) {
+        return -1;
+    }
+    /* Reading the interrupt status clears the overflow flag */
+    i2c_read_reg(dev->i2c_dev, dev->hw_addr, MPU9150_INT_STATUS, &status);
+    if (status & BIT_FIFO_OFLOW_INT) {
+        DEBUG("[Warning] FIFO overflow, clearing it\n");
+        i2c_read_reg(dev->i2c_dev, dev->hw_addr, MPU9150_USER_CTRL_REG, &status);
+        i2c_write_reg(dev->i2c_dev, dev->hw_addr, MPU9150_USER_CTRL_REG,
+                (status | BIT_FIFO_RESET));
+        i2c_release(dev->i2c_dev);
+        dev->fifo_synced = 0;
+        return 0;
+    }
+    i2c_read_regs(dev->i2c_dev, dev->hw_addr, MPU9150_FIFO_COUNT_START_REG,
+            count_regs, 2);
+    now = xtimer_now();
+    level = (((uint8_t)count_regs[0] << 8) | (uint8_t)count_regs[1]) / FIFO_SAMPLE_SIZE;
+
+    count = ringbuffer_get_free(rb) / sizeof(mpu9150_sample_t);
+    if (count > level) {
+        count = level;
+    }
+    if (count == 0) {
+        i2c_release(dev->i2c_dev);
+        return 0;
+    }
+
+    /* Spread the samples between the previous call and now */
+    if (dev->fifo_synced) {
+        step = (now - dev->fifo_time) / level;
+        newest = dev->fifo_time + (count * step);
+    }
+    else {
+        step = 1000000 / dev->conf.sample_rate;
+        newest = now - ((level - count) * step);
+    }
+    dev->fifo_time = newest;
+    dev->fifo_synced = 1;
+
+    /* The FIFO register does not auto increment, so a burst read drains
+     * consecutive bytes. Samples are ordered by register: accel, gyro */
+    for (int i = 0; i < count; i += MPU9150_FIFO_BURST) {
+        int burst = count - i;
+
+        if (burst > MPU9150_FIFO_BURST) {
+            burst = MPU9150_FIFO_BURST;
+        }
+        i2c_read_regs(dev->i2c_dev, dev->hw_addr, MPU9150_FIFO_RW_REG, data,
+                burst * FIFO_SAMPLE_SIZE);
+        for (int j = 0; j < burst; j++) {
+            sample.time = newest - ((count - 1 - (i + j)) * step);
+            normalize(&data[j * FIFO_SAMPLE_SIZE], afsr, &sample.accel);
+            normalize(&data[j * FIFO_SAMPLE_SIZE + 6], gfsr, &sample.gyro);
+            ringbuffer_add(rb, (char *)&sample, sizeof(sample));
+        }
+    }
+    /* Release the bus */
+    i2c_release(dev->i2c_dev);
+
+    return count;
+}
+
 /*------------------------------------------------------------------------------------*/
 /*                                Internal functions                                  */
 /*------------------------------------------------------------------------------------*/
@@ -618,3 +685,56 @@ static void conf_lpf(mpu9150_t *dev, uint16_t half_rate)
     /* Write LPF setting to configuration register */
     i2c_write_reg(dev->i2c_dev, dev->hw_addr, MPU9150_LPF_REG, (char)lpf_setting);
 }
+
+/**
+ * Get the configured gyro full-scale range in dps, 0 if it is invalid
+ */
+static float gyro_fsr(mpu9150_t *dev)
+{
+    switch (dev->conf.gyro_fsr) {
+        case MPU9150_GYRO_FSR_250DPS:
+            return 250.0;
+        case MPU9150_GYRO_FSR_500DPS:
+            return 500.0;
+        case MPU9150_GYRO_FSR_1000DPS:
+            return 1000.0;
+        case MPU9150_GYRO_FSR_2000DPS:
+            return 2000.0;
+        default:
+            return 0.0;
+    }
+}
+
+/**
+ * Get the configured accel full-scale range in mG, 0 if it is invalid
+ */
+static float accel_fsr(mpu9150_t *dev)
+{
+    switch (dev->conf.accel_fsr) {
+        case MPU9150_ACCEL_FSR_2G:
+            return 2000.0;
+        case MPU9150_ACCEL_FSR_4G:
+            return 4000.0;
+        case MPU9150_ACCEL_FSR_8G:
+            return 8000.0;
+        case MPU9150_ACCEL_FSR_16G:
+            return 16000.0;
+        default:
+            return 0.0;
+    }
+}
+
+/**
+ * Normalize raw big endian data according to the given full-scale range
+ */
+static void normalize(const char *data, float fsr, mpu9150_results_t *output)
+{
+    int16_t temp;
+
+    temp = (data[0] << 8) | (uint8_t)data[1];
+    output->x_axis = (temp * fsr) / MAX_VALUE;
+    temp = (data[2] << 8) | (uint8_t)data[3];
+    output->y_axis = (temp * fsr) / MAX_VALUE;
+    temp = (data[4] << 8) | (uint8_t)data[5];
+    output->z_axis = (temp * fsr) / MAX_VALUE;
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for more
+ * details.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <string.h>
+#include "nvram.h"
+#include "nvram-cache.h"
+#include "mutex.h"
+#include "xtimer.h"
+
+/**
+ * @ingroup     nvram
+ * @{
+ *
+ * @file
+ *
+ * @brief       Write combining cache on top of any NVRAM device.
+ */
+
+/**
+ * @brief Copy data from system memory to the cache.
+ *
+ * @param[in]  dev   Pointer to NVRAM device descriptor
+ * @param[in]  src   Pointer to the first byte in the system memory address space
+ * @param[in]  dst   Starting address in the NVRAM device address space
+ * @param[in]  len   Number of bytes to copy
+ *
+ * @return           Number of bytes written on success
+ * @return           <0 on errors
+ */
+static int nvram_cache_write(nvram_t *dev, uint8_t *src, uint32_t dst, size_t len);
+
+/**
+ * @brief Copy data from the cache or the device to system memory.
+ *
+ * @param[in]  dev   Pointer to NVRAM device descriptor
+ * @param[out] dst   Pointer to the first byte in the system memory address space
+ * @param[in]  src   Starting address in the NVRAM device address space
+ * @param[in]  len   Number of bytes to copy
+ *
+ * @return           Number of bytes read on success
+ * @return           <0 on errors
+ */
+static int nvram_cache_read(nvram_t *dev, uint8_t *dst, uint32_t src, size_t len);
+
+/**
+ * @brief Copy the overlap of two address ranges between a buffer and data.
+ *
+ * @param[in]  buf       Buffer holding the range starting at @p buf_addr
+ * @param[in]  buf_addr  Device address of the first byte in @p buf
+ * @param[in]  buf_len   Valid bytes in @p buf
+ * @param[in]  data      Data of the range starting at @p addr
+ * @param[in]  addr      Device address of the first byte in @p data
+ * @param[in]  len       Number of bytes in @p data
+ * @param[in]  to_buf    Copy from @p data to @p buf if set, else the other way
+ */
+static void nvram_cache_overlap(uint8_t *buf, uint32_t buf_addr, size_t buf_len,
+                                uint8_t *data, uint32_t addr, size_t len,
+                                int to_buf)
+{
+    uint32_t start = (addr > buf_addr) ? addr : buf_addr;
+    uint32_t end = ((addr + len) < (buf_addr + buf_len)) ? (addr + len)
+                                                          : (buf_addr + buf_len);
+
+    if (start >= end) {
+        return;
+    }
+    if (to_buf) {
+        memcpy(&buf[start - buf_addr], &data[start - addr], end - start);
+    }
+    else {
+        memcpy(&data[start - addr], &buf[start - buf_addr], end - start);
+    }
+}
+
+static int nvram_cache_do_flush(nvram_cache_t *cache)
+{
+    const nvram_cache_params_t *params = cache->params;
+    int status;
+
+    if (cache->dirty_len == 0) {
+        return 0;
+    }
+    xtimer_remove(&cache->timer);
+    status = params->dev->write(params->dev,
+                                &params->page_buf[cache->dirty_addr % params->page_size],
+                                cache->dirty_addr, cache->dirty_len);
+    if (status < 0) {
+        return status;
+    }
+    cache->stats.dev_writes++;
+    cache->stats.dev_write_bytes += cache->dirty_len;
+    cache->dirty_len = 0;
+    return status;
+}
+
+int nvram_cache_init(nvram_t *dev, nvram_cache_t *cache,
+                     const nvram_cache_params_t *params)
+{
+    if ((params->dev == NULL) || (params->page_buf == NULL) ||
+        (params->page_size == 0)) {
+        return -EINVAL;
+    }
+    memset(cache, 0, sizeof(nvram_cache_t));
+    cache->params = params;
+    cache->msg.type = NVRAM_CACHE_MSG_TYPE_FLUSH;
+    cache->msg.content.ptr = (char *)dev;
+    mutex_init(&cache->lock);
+
+    dev->size = params->dev->size;
+    dev->write = nvram_cache_write;
+    dev->read = nvram_cache_read;
+    dev->extra = cache;
+
+    return 0;
+}
+
+int nvram_cache_flush(nvram_t *dev)
+{
+    nvram_cache_t *cache = (nvram_cache_t *) dev->extra;
+    int status;
+
+    mutex_lock(&cache->lock);
+    status = nvram_cache_do_flush(cache);
+    mutex_unlock(&cache->lock);
+    return status;
+}
+
+static int nvram_cache_write(nvram_t *dev, uint8_t *src, uint32_t dst, size_t len)
+{
+    nvram_cache_t *cache = (nvram_cache_t *) dev->extra;
+    const nvram_cache_params_t *params = cache->params;
+    size_t done = 0;
+    int status;
+
+    mutex_lock(&cache->lock);
+    cache->stats.writes++;
+
+    /* Keep the prefetched data up to date */
+    if (params->read_buf != NULL) {
+        nvram_cache_overlap(params->read_buf, cache->read_addr, cache->read_len,
+                            src, dst, len, 1);
+    }
+
+    while (done < len) {
+        uint32_t addr = dst + done;
+        size_t chunk = params->page_size - (addr % params->page_size);
+
+        if (chunk > (len - done)) {
+            chunk = len - done;
+        }
+
+        if ((cache->dirty_len > 0) &&
+            ((addr / params->page_size) == (cache->dirty_addr / params->page_size)) &&
+            (addr <= (cache->dirty_addr + cache->dirty_len)) &&
+            ((addr + chunk) >= cache->dirty_addr)) {
+            /* Touches the pending data of the same page, merge */
+            uint32_t end = cache->dirty_addr + cache->dirty_len;
+
+            if ((addr + chunk) > end) {
+                end = addr + chunk;
+            }
+            if (addr < cache->dirty_addr) {
+                cache->dirty_addr = addr;
+            }
+            cache->dirty_len = end - cache->dirty_addr;
+            cache->stats.write_merges++;
+        }
+        else {
+            status = nvram_cache_do_flush(cache);
+            if (status < 0) {
+                mutex_unlock(&cache->lock);
+                return status;
+            }
+            cache->dirty_addr = addr;
+            cache->dirty_len = chunk;
+            if (params->flush_pid != KERNEL_PID_UNDEF) {
+                xtimer_set_msg(&cache->timer, params->flush_us, &cache->msg,
+                               params->flush_pid);
+            }
+        }
+        memcpy(&params->page_buf[addr % params->page_size], &src[done], chunk);
+        done += chunk;
+    }
+
+    mutex_unlock(&cache->lock);
+    return len;
+}
+
+static int nvram_cache_read(nvram_t *dev, uint8_t *dst, uint32_t src, size_t len)
+{
+    nvram_cache_t *cache = (nvram_cache_t *) dev->extra;
+    const nvram_cache_params_t *params = cache->params;
+    int status;
+
+    mutex_lock(&cache->lock);
+    cache->stats.reads++;
+
+    if ((cache->read_len > 0) && (src >= cache->read_addr) &&
+        ((src + len) <= (cache->read_addr + cache->read_len))) {
+        memcpy(dst, &params->read_buf[src - cache->read_addr], len);
+        cache->stats.read_hits++;
+    }
+    else if ((params->read_buf != NULL) && (len < params->read_size) &&
+             (src == cache->read_next) && (src < dev->size)) {
+        /* Sequential read, fetch ahead */
+        size_t fetch = params->read_size;
+
+        if (fetch > (dev->size - src)) {
+            fetch = dev->size - src;
+        }
+        cache->read_len = 0;
+        status = params->dev->read(params->dev, params->read_buf, src, fetch);
+        if (status < 0) {
+            mutex_unlock(&cache->lock);
+            return status;
+        }
+        cache->stats.dev_reads++;
+        cache->stats.dev_read_bytes += fetch;
+        cache->read_addr = src;
+        cache->read_len = fetch;
+        if (fetch >= len) {
+            memcpy(dst, params->read_buf, len);
+        }
+        else {
+            /* Only the part up to the end of the device was fetched, the
+             * rest is up to the device like any read past its end */
+            memcpy(dst, params->read_buf, fetch);
+            status = params->dev->read(params->dev, dst + fetch, src + fetch,
+                                       len - fetch);
+            if (status < 0) {
+                mutex_unlock(&cache->lock);
+                return status;
+            }
+            cache->stats.dev_reads++;
+            cache->stats.dev_read_bytes += len - fetch;
+        }
+    }
+    else {
+        status = params->dev->read(params->dev, dst, src, len);
+        if (status < 0) {
+            mutex_unlock(&cache->lock);
+            return status;
+        }
+        cache->stats.dev_reads++;
+        cache->stats.dev_read_bytes += len;
+    }
+    cache->read_next = src + len;
+
+    /* Pending data is newer than the device contents */
+    nvram_cache_overlap(params->page_buf + (cache->dirty_addr % params->page_size),
+                        cache->dirty_addr, cache->dirty_len, dst, src, len, 0);
+
+    mutex_unlock(&cache->lock);
+    return len;
+}
+
+/** @} */
@@ -21,8 +21,10 @@
 
 #include "board.h"
 #include "cpu.h"
+#include "irq.h"
 #include "periph/spi.h"
 #include "periph_cpu.h"
+#include "thread.h"
 
 #if SPI_NUMOF
 
@@ -87,4 +89,63 @@ int spi_transfer_regs(spi_t dev, uint8_t reg, char *out, char *in, unsigned int
 }
 #endif
 
+#ifndef PERIPH_SPI_HAS_TRANSFER_ASYNC
+int spi_transfer_async(spi_t dev, const spi_xfer_t *xfers, unsigned int count,
+                       spi_async_cb_t cb, void *arg)
+{
+    int res = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        int trans_ret = spi_transfer_bytes(dev, (char *)xfers[i].out, xfers[i].in,
+                                           xfers[i].length);
+        if (trans_ret < 0) {
+            res = -1;
+            break;
+        }
+        res += trans_ret;
+    }
+
+    cb(arg, res);
+    return 0;
+}
+#endif
+
+typedef struct {
+    kernel_pid_t pid;
+    volatile int done;
+    int res;
+} _sg_wait_t;
+
+static void _sg_done(void *arg, int res)
+{
+    _sg_wait_t *wait = (_sg_wait_t *)arg;
+    wait->res = res;
+    wait->done = 1;
+    thread_wakeup(wait->pid);
+}
+
+int spi_transfer_sg(spi_t dev, const spi_xfer_t *xfers, unsigned int count)
+{
+    _sg_wait_t wait = { .pid = thread_getpid(), .done = 0, .res = -1 };
+
+    if (spi_transfer_async(dev, xfers, count, _sg_done, &wait) < 0) {
+        return -1;
+    }
+
+    /* the callback may already have run (synchronously or from an ISR), so
+     * only go to sleep while it has not, with interrupts disabled in between
+     * the check and the sleep */
+    unsigned state = disableIRQ();
+    while (!wait.done) {
+        thread_sleep();
+        restoreIRQ(state);
+        state = disableIRQ();
+    }
+    restoreIRQ(state);
+
+    return wait.res;
+}
+
+#else
+typedef int dont_be_pedantic;
 #endif /* SPI_NUMOF */
@@ -20,11 +20,14 @@
  * @}
  */
 
+#include <assert.h>
 #include <string.h>
 
 #include "xbee.h"
+#include "irq.h"
 #include "xtimer.h"
 #include "msg.h"
+#include "thread_flags.h"
 #include "net/eui64.h"
 #include "net/ieee802154.h"
 #include "periph/cpuid.h"
@@ -33,9 +36,20 @@
 #include "debug.h"
 
 /**
- * @brief   Internal driver event type when RX is finished
+ * @brief   Internal driver event type when new data is in the RX buffer
  */
-#define ISR_EVENT_RX_DONE           (0x0001)
+#define ISR_EVENT_RX_DATA           (0x0001)
+
+/**
+ * @brief   Thread flag set for a thread waiting for an AT response when new
+ *          data is in the RX buffer
+ */
+#define AT_FLAG_RX_DATA             (0x0001)
+
+/**
+ * @brief   Number of bytes taken from the RX buffer at once for parsing
+ */
+#define RX_CHUNK_SIZE               (16U)
 
 /**
  * @brief   Delay when entering command mode, must be > 1s
@@ -45,6 +59,10 @@
  * @brief   Delay when resetting the device, 10ms
  */
 #define RESET_DELAY                 (10U * 1000U)
+/**
+ * @brief   Timeout for the response to an AT command, 1s
+ */
+#define AT_RESP_TIMEOUT             (1000U * 1000U)
 
 /**
  * @brief   Start delimiter in API frame mode
@@ -66,6 +84,12 @@
 #define API_ID_RX_SHORT_ADDR        (0x81)  /**< RX frame (short address) */
 /** @} */
 
+/**
+ * @brief   AT command response status used when a command could not be sent
+ *          or its response did not arrive in time
+ */
+#define AT_STATUS_ERROR             (0x01)
+
 /**
  * @brief   Internal option flags (to be expanded if needed)
  * @{
@@ -104,8 +128,29 @@ static void _at_cmd(xbee_t *dev, const char *cmd)
     }
 }
 
-static void _api_at_cmd(xbee_t *dev, uint8_t *cmd, uint8_t size, resp_t *resp)
+static int _api_at_send(xbee_t *dev, const uint8_t *cmd, uint8_t size)
 {
+    xbee_at_slot_t *at = NULL;
+    unsigned slot;
+
+    /* find a free slot for the response */
+    for (slot = 0; slot < XBEE_AT_SLOTS; slot++) {
+        if (dev->at[slot].frame_id == 0) {
+            at = &(dev->at[slot]);
+            break;
+        }
+    }
+    if (at == NULL) {
+        DEBUG("xbee: Error sending AT command, too many pending commands\n");
+        return -EBUSY;
+    }
+    /* frame ID 0 would disable the response frame */
+    if (++dev->at_id == 0) {
+        dev->at_id = 1;
+    }
+    at->frame_id = dev->at_id;
+    at->done = 0;
+
     /* acquire TX lock */
     mutex_lock(&(dev->tx_lock));
     /* construct API frame */
@@ -113,28 +158,255 @@ static void _api_at_cmd(xbee_t *dev, uint8_t *cmd, uint8_t size, resp_t *resp)
     dev->tx_buf[1] = (size + 2) >> 8;
     dev->tx_buf[2] = (size + 2) & 0xff;
     dev->tx_buf[3] = API_ID_AT;
-    dev->tx_buf[4] = 1;             /* use fixed frame id */
+    dev->tx_buf[4] = at->frame_id;
     memcpy(dev->tx_buf + 5, cmd, size);
     dev->tx_buf[size + 5] = _cksum(dev->tx_buf, size + 5);
 
-    /* prepare UART for sending out the data and receiving the response */
+    /* start send data, the TX lock is released once the frame is out */
     dev->tx_limit = size + 6;
     dev->tx_count = 0;
-    dev->resp_count = 0;
-    /* start send data */
     uart_tx_begin(dev->uart);
 
-    /* wait for results */
-    while (dev->resp_limit != dev->resp_count) {
-        mutex_lock(&(dev->resp_lock));
+    return (int)slot;
+}
+
+static void _rx_process(xbee_t *dev);
+
+static void _api_at_wait(xbee_t *dev, int slot, resp_t *resp)
+{
+    xbee_at_slot_t *at = &(dev->at[slot]);
+    uint32_t start = xtimer_now();
+
+    /* parse incoming data until the response arrived or it is overdue, the
+     * flag stays set if data arrived while parsing */
+    dev->at_pid = thread_getpid();
+    while (!at->done) {
+        uint32_t elapsed = xtimer_now() - start;
+        if (elapsed >= AT_RESP_TIMEOUT) {
+            break;
+        }
+        xtimer_thread_flags_wait_any(AT_FLAG_RX_DATA, AT_RESP_TIMEOUT - elapsed);
+        _rx_process(dev);
     }
+    dev->at_pid = KERNEL_PID_UNDEF;
 
-    /* populate response data structure */
-    resp->status = dev->resp_buf[3];
-    resp->data_len = dev->resp_limit - 5;
-    if (resp->data_len > 0) {
-        memcpy(resp->data, &(dev->resp_buf[4]), resp->data_len);
+    /* populate response data structure and release the slot, a late
+     * response does not match the slot anymore */
+    if (at->done) {
+        resp->status = at->status;
+        resp->data_len = at->data_len;
+        memcpy(resp->data, at->data, at->data_len);
     }
+    else {
+        DEBUG("xbee: No response to AT command, frame ID %u\n",
+              (unsigned)at->frame_id);
+        resp->status = AT_STATUS_ERROR;
+        resp->data_len = 0;
+    }
+    at->frame_id = 0;
+}
+
+/*
+ * Send the given AT commands back to back without waiting for the responses
+ * in between, then collect the responses. At most XBEE_AT_SLOTS commands can
+ * be given at once.
+ */
+static void _api_at_cmds(xbee_t *dev, uint8_t *const *cmds, const uint8_t *sizes,
+                         unsigned num, resp_t *resp)
+{
+    int slots[XBEE_AT_SLOTS];
+
+    assert(num <= XBEE_AT_SLOTS);
+    for (unsigned i = 0; i < num; i++) {
+        slots[i] = _api_at_send(dev, cmds[i], sizes[i]);
+    }
+    for (unsigned i = 0; i < num; i++) {
+        if (slots[i] < 0) {
+            resp[i].status = AT_STATUS_ERROR;
+            resp[i].data_len = 0;
+        }
+        else {
+            _api_at_wait(dev, slots[i], &resp[i]);
+        }
+    }
+}
+
+static void _api_at_cmd(xbee_t *dev, uint8_t *cmd, uint8_t size, resp_t *resp)
+{
+    _api_at_cmds(dev, &cmd, &size, 1, resp);
+}
+
+static void _rx_at_resp(xbee_t *dev)
+{
+    /* response frame: API ID, frame ID, 2 byte command, status, data */
+    if (dev->rx_count < 5) {
+        return;
+    }
+    for (unsigned i = 0; i < XBEE_AT_SLOTS; i++) {
+        xbee_at_slot_t *at = &(dev->at[i]);
+
+        if ((at->frame_id == dev->rx_buf[1]) && !at->done) {
+            at->status = dev->rx_buf[4];
+            at->data_len = dev->rx_count - 5;
+            if (at->data_len > sizeof(at->data)) {
+                at->data_len = sizeof(at->data);
+            }
+            memcpy(at->data, &(dev->rx_buf[5]), at->data_len);
+            at->done = 1;
+            return;
+        }
+    }
+    DEBUG("xbee: Received AT response for unknown frame ID %u\n",
+          (unsigned)dev->rx_buf[1]);
+}
+
+static void _rx_data(xbee_t *dev)
+{
+    gnrc_pktsnip_t *pkt_head;
+    gnrc_pktsnip_t *pkt;
+    gnrc_netif_hdr_t *hdr;
+    size_t pos;
+    size_t addr_len;
+
+    if (dev->event_cb == NULL) {
+        return;
+    }
+
+    /* read address length */
+    if (dev->rx_buf[0] == API_ID_RX_SHORT_ADDR) {
+        addr_len = 2;
+    }
+    else {
+        addr_len = 8;
+    }
+    pos = 3 + addr_len;
+    if (dev->rx_count < pos) {
+        DEBUG("xbee: Received truncated packet, dropping it\n");
+        return;
+    }
+
+    /* allocate and fill interface header */
+    pkt_head = gnrc_pktbuf_add(NULL, NULL,
+                               sizeof(gnrc_netif_hdr_t) + (2 * addr_len),
+                               GNRC_NETTYPE_NETIF);
+    if (pkt_head == NULL) {
+        DEBUG("xbee: Error allocating netif header in packet buffer on RX\n");
+        return;
+    }
+    hdr = (gnrc_netif_hdr_t *)pkt_head->data;
+    hdr->src_l2addr_len = (uint8_t)addr_len;
+    hdr->dst_l2addr_len = (uint8_t)addr_len;
+    hdr->if_pid = dev->mac_pid;
+    hdr->rssi = dev->rx_buf[2 + addr_len];
+    hdr->lqi = 0;
+    gnrc_netif_hdr_set_src_addr(hdr, &(dev->rx_buf[1]), addr_len);
+    if (addr_len == 2) {
+        gnrc_netif_hdr_set_dst_addr(hdr, dev->addr_short, 2);
+    }
+    else {
+        gnrc_netif_hdr_set_dst_addr(hdr, dev->addr_long.uint8, 8);
+    }
+    /* allocate and copy payload */
+    pkt = gnrc_pktbuf_add(pkt_head, &(dev->rx_buf[pos]), dev->rx_count - pos,
+                          dev->proto);
+    if (pkt == NULL) {
+        DEBUG("xbee: Error allocating payload in packet buffer on RX\n");
+        gnrc_pktbuf_release(pkt_head);
+        return;
+    }
+
+    /* pass on the received packet */
+    dev->event_cb(NETDEV_EVENT_RX_COMPLETE, pkt);
+}
+
+/*
+ * Run the RX state machine over a chunk of buffered UART data. The checksum
+ * is summed up while the frame data is copied, so complete frames can be
+ * handled right away.
+ */
+static void _rx_parse(xbee_t *dev, const uint8_t *data, unsigned len)
+{
+    unsigned pos = 0;
+
+    while (pos < len) {
+        switch (dev->int_state) {
+            case XBEE_INT_STATE_IDLE: {
+                /* skip everything up to the beginning of a new frame */
+                const uint8_t *start = memchr(&data[pos], API_START_DELIMITER,
+                                              len - pos);
+                if (start == NULL) {
+                    return;
+                }
+                pos = (start - data) + 1;
+                dev->int_state = XBEE_INT_STATE_SIZE1;
+                break;
+            }
+            case XBEE_INT_STATE_SIZE1:
+                dev->int_size = ((uint16_t)data[pos++]) << 8;
+                dev->int_state = XBEE_INT_STATE_SIZE2;
+                break;
+            case XBEE_INT_STATE_SIZE2:
+                dev->int_size |= data[pos++];
+                dev->int_cksum = 0;
+                dev->rx_count = 0;
+                if ((dev->int_size == 0) ||
+                    (dev->int_size > sizeof(dev->rx_buf))) {
+                    DEBUG("xbee: Received frame of invalid size, dropping it\n");
+                    dev->int_state = XBEE_INT_STATE_IDLE;
+                }
+                else {
+                    dev->int_state = XBEE_INT_STATE_DATA;
+                }
+                break;
+            case XBEE_INT_STATE_DATA:
+                while ((pos < len) && (dev->rx_count < dev->int_size)) {
+                    dev->int_cksum += data[pos];
+                    dev->rx_buf[dev->rx_count++] = data[pos++];
+                }
+                if (dev->rx_count == dev->int_size) {
+                    dev->int_state = XBEE_INT_STATE_CKSUM;
+                }
+                break;
+            case XBEE_INT_STATE_CKSUM:
+                dev->int_state = XBEE_INT_STATE_IDLE;
+                if ((uint8_t)(dev->int_cksum + data[pos++]) != 0xff) {
+                    DEBUG("xbee: Received frame with incorrect checksum, "
+                          "dropping it\n");
+                    break;
+                }
+                switch (dev->rx_buf[0]) {
+                    case API_ID_RX_SHORT_ADDR:
+                    case API_ID_RX_LONG_ADDR:
+                        _rx_data(dev);
+                        break;
+                    case API_ID_AT_RESP:
+                        _rx_at_resp(dev);
+                        break;
+                    default:
+                        /* other frames are not used by this driver */
+                        break;
+                }
+                break;
+            default:
+                /* this should never be the case */
+                dev->int_state = XBEE_INT_STATE_IDLE;
+                break;
+        }
+    }
+}
+
+static void _rx_process(xbee_t *dev)
+{
+    char buf[RX_CHUNK_SIZE];
+    unsigned irq;
+    unsigned len;
+
+    do {
+        irq = disableIRQ();
+        len = ringbuffer_get(&(dev->rx_rb), buf, sizeof(buf));
+        restoreIRQ(irq);
+        _rx_parse(dev, (uint8_t *)buf, len);
+    } while (len == sizeof(buf));
 }
 
 /*
@@ -159,61 +431,21 @@ static void _rx_cb(void *arg, char c)
     xbee_t *dev = (xbee_t *)arg;
     msg_t msg;
 
-    switch (dev->int_state) {
-        case XBEE_INT_STATE_IDLE:
-            /* check for beginning of new data frame */
-            if (c == API_START_DELIMITER) {
-                dev->int_state = XBEE_INT_STATE_SIZE1;
-            }
-            break;
-        case XBEE_INT_STATE_SIZE1:
-            dev->int_size = ((uint16_t)c) << 8;
-            dev->int_state = XBEE_INT_STATE_SIZE2;
-            break;
-        case XBEE_INT_STATE_SIZE2:
-            dev->int_size += (uint8_t)c;
-            dev->int_state = XBEE_INT_STATE_TYPE;
-            break;
-        case XBEE_INT_STATE_TYPE:
-            if (c == API_ID_RX_SHORT_ADDR || c == API_ID_RX_LONG_ADDR) {
-                /* in case old data was not processed, ignore incoming data */
-                if (dev->rx_count != 0) {
-                    dev->int_state = XBEE_INT_STATE_IDLE;
-                    return;
-                }
-                dev->rx_limit = dev->int_size + 1;
-                dev->rx_buf[dev->rx_count++] = (uint8_t)c;
-                dev->int_state = XBEE_INT_STATE_RX;
-            }
-            else if (c == API_ID_AT_RESP) {
-                dev->resp_limit = dev->int_size;
-                dev->int_state = XBEE_INT_STATE_RESP;
-            }
-            else {
-                dev->int_state = XBEE_INT_STATE_IDLE;
-            }
-            break;
-        case XBEE_INT_STATE_RESP:
-            dev->resp_buf[dev->resp_count++] = (uint8_t)c;
-            if (dev->resp_count == dev->resp_limit) {
-                /* here we ignore the checksum to prevent deadlocks */
-                mutex_unlock(&(dev->resp_lock));
-                dev->int_state = XBEE_INT_STATE_IDLE;
-            }
-            break;
-        case XBEE_INT_STATE_RX:
-            dev->rx_buf[dev->rx_count++] = (uint8_t)c;
-            if (dev->rx_count == dev->rx_limit) {
-                /* packet is complete */
-                msg.type = GNRC_NETDEV_MSG_TYPE_EVENT;
-                msg.content.value = ISR_EVENT_RX_DONE;
-                msg_send_int(&msg, dev->mac_pid);
-                dev->int_state = XBEE_INT_STATE_IDLE;
-            }
-            break;
-        default:
-            /* this should never be the case */
-            break;
+    /* on overflow the byte is dropped and the frame fails its checksum */
+    if (ringbuffer_full(&(dev->rx_rb))) {
+        return;
+    }
+    ringbuffer_add_one(&(dev->rx_rb), c);
+
+    /* wake up a thread waiting for an AT response */
+    if (dev->at_pid != KERNEL_PID_UNDEF) {
+        thread_flags_set(dev->at_pid, AT_FLAG_RX_DATA);
+    }
+    /* have the driver's thread parse the data, one event at a time */
+    if (!dev->rx_event && (dev->mac_pid != KERNEL_PID_UNDEF)) {
+        msg.type = GNRC_NETDEV_MSG_TYPE_EVENT;
+        msg.content.value = ISR_EVENT_RX_DATA;
+        dev->rx_event = (msg_send_int(&msg, dev->mac_pid) > 0);
     }
 }
 
@@ -242,28 +474,21 @@ static int _get_addr_short(xbee_t *dev, uint8_t *val, size_t len)
 
 static int _get_addr_long(xbee_t *dev, uint8_t *val, size_t len)
 {
-    uint8_t cmd[2];
-    resp_t resp;
+    /* read 4 high byte - AT command: SH, next 4 byte - AT command: SL */
+    uint8_t cmd_sh[2] = { 'S', 'H' };
+    uint8_t cmd_sl[2] = { 'S', 'L' };
+    uint8_t *cmds[2] = { cmd_sh, cmd_sl };
+    const uint8_t sizes[2] = { 2, 2 };
+    resp_t resp[2];
 
     if (len < 8) {
         return -EOVERFLOW;
     }
 
-    /* read 4 high byte - AT command: SH*/
-    cmd[0] = 'S';
-    cmd[1] = 'H';
-    _api_at_cmd(dev, cmd, 2, &resp);
-    if (resp.status == 0) {
-        memcpy(val, resp.data, 4);
-    }
-    else {
-        return -ECANCELED;
-    }
-    /* read next 4 byte - AT command: SL */
-    cmd[1] = 'L';
-    _api_at_cmd(dev, cmd, 2, &resp);
-    if (resp.status == 0) {
-        memcpy(val + 4, resp.data, 4);
+    _api_at_cmds(dev, cmds, sizes, 2, resp);
+    if ((resp[0].status == 0) && (resp[1].status == 0)) {
+        memcpy(val, resp[0].data, 4);
+        memcpy(val + 4, resp[1].data, 4);
         return 8;
     }
     return -ECANCELED;
@@ -409,7 +634,13 @@ static int _set_proto(xbee_t *dev, uint8_t *val, size_t len)
 int xbee_init(xbee_t *dev, uart_t uart, uint32_t baudrate,
               gpio_t reset_pin, gpio_t sleep_pin)
 {
-    uint8_t tmp[2];
+    uint8_t cmd_my[4] = { 'M', 'Y', 0, 0 };
+    uint8_t cmd_ch[3] = { 'C', 'H', XBEE_DEFAULT_CHANNEL };
+    uint8_t cmd_id[4] = { 'I', 'D', (uint8_t)(XBEE_DEFAULT_PANID >> 8),
+                          (uint8_t)(XBEE_DEFAULT_PANID & 0xff) };
+    uint8_t *cmds[3] = { cmd_my, cmd_ch, cmd_id };
+    const uint8_t sizes[3] = { 4, 3, 4 };
+    resp_t resp[3];
 
     /* check device and bus parameters */
     if (dev == NULL) {
@@ -428,11 +659,17 @@ int xbee_init(xbee_t *dev, uart_t uart, uint32_t baudrate,
     dev->addr_flags = 0;
     dev->proto = XBEE_DEFAULT_PROTOCOL;
     dev->options = 0;
-    /* initialize buffers and locks*/
+    /* initialize buffers and locks, RX events are sent once the driver's
+     * thread is running */
+    dev->mac_pid = KERNEL_PID_UNDEF;
     mutex_init(&(dev->tx_lock));
-    mutex_init(&(dev->resp_lock));
-    dev->resp_limit = 1;    /* needs to be greater then 0 initially */
+    dev->at_pid = KERNEL_PID_UNDEF;
+    ringbuffer_init(&(dev->rx_rb), dev->rx_mem, sizeof(dev->rx_mem));
+    dev->rx_event = 0;
+    dev->int_state = XBEE_INT_STATE_IDLE;
     dev->rx_count = 0;
+    memset(dev->at, 0, sizeof(dev->at));
+    dev->at_id = 0;
     /* initialize UART and GPIO pins */
     if (uart_init(uart, baudrate, _rx_cb, _tx_cb, dev) < 0) {
         DEBUG("xbee: Error initializing UART\n");
@@ -473,15 +710,14 @@ int xbee_init(xbee_t *dev, uart_t uart, uint32_t baudrate,
 
     /* load long address (we can not set it, its read only for Xbee devices) */
     _get_addr_long(dev, dev->addr_long.uint8, 8);
-    /* set default channel */
-    _set_addr(dev, &((dev->addr_long).uint8[6]), 2);
-    tmp[1] = 0;
-    tmp[0] = XBEE_DEFAULT_CHANNEL;
-    _set_channel(dev, tmp, 2);
-    /* set default PAN ID */
-    tmp[1] = (uint8_t)(XBEE_DEFAULT_PANID >> 8);
-    tmp[0] = (uint8_t)(XBEE_DEFAULT_PANID & 0xff);
-    _set_panid(dev, tmp, 2);
+    /* set short address, default channel and default PAN ID, all commands are
+     * in flight at the same time */
+    cmd_my[2] = dev->addr_long.uint8[6];
+    cmd_my[3] = dev->addr_long.uint8[7];
+    _api_at_cmds(dev, cmds, sizes, 3, resp);
+    if (resp[0].status == 0) {
+        memcpy(dev->addr_short, &(cmd_my[2]), 2);
+    }
 
     DEBUG("xbee: Initialization successful\n");
     return 0;
@@ -679,78 +915,15 @@ static int _set(gnrc_netdev_t *netdev, netopt_t opt, void *value, size_t value_l
 static void _isr_event(gnrc_netdev_t *netdev, uint32_t event_type)
 {
     xbee_t *dev = (xbee_t *)netdev;
-    gnrc_pktsnip_t *pkt_head;
-    gnrc_pktsnip_t *pkt;
-    gnrc_netif_hdr_t *hdr;
-    size_t pos;
-    size_t addr_len;
-    uint8_t cksum = 0;
-
-    /* check device */
-    if (dev == NULL) {
-        return;
-    }
-    /* check rx callback and event type */
-    if (event_type != ISR_EVENT_RX_DONE || dev->event_cb == NULL) {
-        dev->rx_count = 0;
-        return;
-    }
 
-    /* read address length */
-    if (dev->rx_buf[0] == API_ID_RX_SHORT_ADDR) {
-        addr_len = 2;
-    }
-    else {
-        addr_len = 8;
-    }
-
-    /* check checksum for correctness */
-    for (int i = 0; i < dev->rx_limit; i++) {
-        cksum += dev->rx_buf[i];
-    }
-    if (cksum != 0xff) {
-        DEBUG("xbee: Received packet with incorrect checksum, dropping it\n");
-        dev->rx_count = 0;
-        return;
-    }
-
-    /* allocate and fill interface header */
-    pkt_head = gnrc_pktbuf_add(NULL, NULL,
-                               sizeof(gnrc_netif_hdr_t) + (2 * addr_len),
-                               GNRC_NETTYPE_NETIF);
-    if (pkt_head == NULL) {
-        DEBUG("xbee: Error allocating netif header in packet buffer on RX\n");
-        dev->rx_count = 0;
-        return;
-    }
-    hdr = (gnrc_netif_hdr_t *)pkt_head->data;
-    hdr->src_l2addr_len = (uint8_t)addr_len;
-    hdr->dst_l2addr_len = (uint8_t)addr_len;
-    hdr->if_pid = dev->mac_pid;
-    hdr->rssi = dev->rx_buf[2 + addr_len];
-    hdr->lqi = 0;
-    gnrc_netif_hdr_set_src_addr(hdr, &(dev->rx_buf[1]), addr_len);
-    if (addr_len == 2) {
-        gnrc_netif_hdr_set_dst_addr(hdr, dev->addr_short, 2);
-    }
-    else {
-        gnrc_netif_hdr_set_dst_addr(hdr, dev->addr_long.uint8, 8);
-    }
-    pos = 3 + addr_len;
-    /* allocate and copy payload */
-    pkt = gnrc_pktbuf_add(pkt_head, &(dev->rx_buf[pos]), dev->rx_limit - pos - 1,
-                          dev->proto);
-    if (pkt == NULL) {
-        DEBUG("xbee: Error allocating payload in packet buffer on RX\n");
-        gnrc_pktbuf_release(pkt_head);
-        dev->rx_count = 0;
+    /* check device and event type */
+    if (dev == NULL || event_type != ISR_EVENT_RX_DATA) {
         return;
     }
 
-    /* pass on the received packet */
-    dev->event_cb(NETDEV_EVENT_RX_COMPLETE, pkt);
-    /* reset RX byte counter to enable receiving of the next packet */
-    dev->rx_count = 0;
+    /* data arriving from now on triggers a new event */
+    dev->rx_event = 0;
+    _rx_process(dev);
 }
 
 /*
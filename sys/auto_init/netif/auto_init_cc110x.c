@@ -23,6 +23,9 @@
 #include "net/gnrc/gnrc_netdev2.h"
 #include "cc110x/gnrc_netdev2_cc110x.h"
 #include "net/gnrc.h"
+#ifdef MODULE_GNRC_LPL
+#include "net/gnrc/lpl.h"
+#endif
 
 #include "cc110x.h"
 #include "cc110x_params.h"
@@ -55,8 +58,13 @@ void auto_init_cc110x(void)
         }
         else {
             gnrc_netdev2_cc110x_init(&_gnrc_netdev2_devs[i], &cc110x_devs[i]);
+#ifdef MODULE_GNRC_LPL
+            res = gnrc_lpl_init(_stacks[i], CC110X_MAC_STACKSIZE,
+                    CC110X_MAC_PRIO, "cc110x", &_gnrc_netdev2_devs[i], NULL);
+#else
             res = gnrc_netdev2_init(_stacks[i], CC110X_MAC_STACKSIZE,
                     CC110X_MAC_PRIO, "cc110x", &_gnrc_netdev2_devs[i]);
+#endif
             if (res < 0) {
                 DEBUG("Error starting gnrc_cc110x thread for CC110X!");
             }
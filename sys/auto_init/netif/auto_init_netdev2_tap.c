@@ -24,6 +24,9 @@
 
 #include "netdev2_tap.h"
 #include "net/gnrc/gnrc_netdev2_eth.h"
+#ifdef MODULE_GNRC_LPL
+#include "net/gnrc/lpl.h"
+#endif
 
 extern netdev2_tap_t netdev2_tap;
 
@@ -44,8 +47,13 @@ void auto_init_netdev2_tap(void)
 {
     gnrc_netdev2_eth_init(&_gnrc_netdev2_tap, (netdev2_t*)&netdev2_tap);
 
+#ifdef MODULE_GNRC_LPL
+    gnrc_lpl_init(_netdev2_eth_stack, TAP_MAC_STACKSIZE,
+            TAP_MAC_PRIO, "gnrc_netdev2_tap", &_gnrc_netdev2_tap, NULL);
+#else
     gnrc_netdev2_init(_netdev2_eth_stack, TAP_MAC_STACKSIZE,
             TAP_MAC_PRIO, "gnrc_netdev2_tap", &_gnrc_netdev2_tap);
+#endif
 }
 
 #else
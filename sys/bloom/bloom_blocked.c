@@ -0,0 +1,83 @@
+/**
+ * Blocked Bloom filter implementation
+ *
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ *
+ * @file
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "bloom.h"
+#include "bitfield.h"
+
+#define BLOCK_BYTES (BLOOM_BLOCK_BITS / CHAR_BIT)
+
+/**
+ * @brief Hash @p buf once and return the block it maps to, @p h1 and @p h2
+ *        are set to the double hashing parameters within that block
+ */
+static uint8_t *get_block(const bloom_blocked_t *bloom, const uint8_t *buf,
+                          size_t len, uint32_t *h1, uint32_t *h2)
+{
+    uint64_t hash = bloom->hash(buf, len);
+
+    *h1 = (uint32_t)hash;
+    /* odd step, so the k probes are distinct within a power of 2 block */
+    *h2 = (uint32_t)(hash >> 32) | 1;
+
+    /* map the high bits of h1 to the block without a division */
+    size_t block = (size_t)(((uint64_t)*h1 * bloom->blocks) >> 32);
+    return &bloom->a[block * BLOCK_BYTES];
+}
+
+void bloom_blocked_init(bloom_blocked_t *bloom, size_t size, uint8_t *bitfield,
+                        hashfp64_t hash, size_t k)
+{
+    bloom->blocks = size / BLOOM_BLOCK_BITS;
+    bloom->a = bitfield;
+    bloom->hash = hash;
+    bloom->k = k;
+}
+
+void bloom_blocked_del(bloom_blocked_t *bloom)
+{
+    if (bloom->a) {
+        memset(bloom->a, 0, bloom->blocks * BLOCK_BYTES);
+    }
+    bloom->a = NULL;
+    bloom->blocks = 0;
+    bloom->hash = NULL;
+    bloom->k = 0;
+}
+
+void bloom_blocked_add(bloom_blocked_t *bloom, const uint8_t *buf, size_t len)
+{
+    uint32_t h1, h2;
+    uint8_t *block = get_block(bloom, buf, len, &h1, &h2);
+
+    for (size_t n = 0; n < bloom->k; n++) {
+        bf_set(block, h1 & (BLOOM_BLOCK_BITS - 1));
+        h1 += h2;
+    }
+}
+
+bool bloom_blocked_check(bloom_blocked_t *bloom, const uint8_t *buf, size_t len)
+{
+    uint32_t h1, h2;
+    uint8_t *block = get_block(bloom, buf, len, &h1, &h2);
+
+    for (size_t n = 0; n < bloom->k; n++) {
+        if (!bf_isset(block, h1 & (BLOOM_BLOCK_BITS - 1))) {
+            return false;
+        }
+        h1 += h2;
+    }
+
+    return true;
+}
@@ -0,0 +1,129 @@
+/**
+ * Counting Bloom filter implementation
+ *
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "bloom.h"
+
+#define COUNTER_MAX (0xf)
+
+/**
+ * @brief Index of the @p n-th counter, @p h1 and @p h2 are the double hashing
+ *        parameters
+ */
+static inline size_t counter_idx(const bloom_counting_t *bloom, uint32_t h1,
+                                 uint32_t h2, size_t n)
+{
+    uint32_t g = h1 + n * h2;
+
+    /* map g to [0, m) without a division */
+    return (size_t)(((uint64_t)g * bloom->m) >> 32);
+}
+
+static inline unsigned counter_get(const uint8_t *c, size_t idx)
+{
+    return (c[idx / 2] >> ((idx & 1) * 4)) & COUNTER_MAX;
+}
+
+static inline void counter_inc(uint8_t *c, size_t idx)
+{
+    c[idx / 2] += 1 << ((idx & 1) * 4);
+}
+
+static inline void counter_dec(uint8_t *c, size_t idx)
+{
+    c[idx / 2] -= 1 << ((idx & 1) * 4);
+}
+
+static void get_hashes(const bloom_counting_t *bloom, const uint8_t *buf, size_t len,
+                       uint32_t *h1, uint32_t *h2)
+{
+    uint64_t hash = bloom->hash(buf, len);
+
+    *h1 = (uint32_t)hash;
+    *h2 = (uint32_t)(hash >> 32) | 1;
+}
+
+void bloom_counting_init(bloom_counting_t *bloom, size_t size, uint8_t *counters,
+                         hashfp64_t hash, size_t k)
+{
+    bloom->m = size;
+    bloom->c = counters;
+    bloom->hash = hash;
+    bloom->k = k;
+}
+
+void bloom_counting_del(bloom_counting_t *bloom)
+{
+    if (bloom->c) {
+        memset(bloom->c, 0, BLOOM_COUNTING_BYTES(bloom->m));
+    }
+    bloom->c = NULL;
+    bloom->m = 0;
+    bloom->hash = NULL;
+    bloom->k = 0;
+}
+
+void bloom_counting_add(bloom_counting_t *bloom, const uint8_t *buf, size_t len)
+{
+    uint32_t h1, h2;
+
+    get_hashes(bloom, buf, len, &h1, &h2);
+
+    for (size_t n = 0; n < bloom->k; n++) {
+        size_t idx = counter_idx(bloom, h1, h2, n);
+
+        if (counter_get(bloom->c, idx) < COUNTER_MAX) {
+            counter_inc(bloom->c, idx);
+        }
+    }
+}
+
+bool bloom_counting_remove(bloom_counting_t *bloom, const uint8_t *buf, size_t len)
+{
+    uint32_t h1, h2;
+
+    get_hashes(bloom, buf, len, &h1, &h2);
+
+    /* only touch the counters if all of them are set */
+    for (size_t n = 0; n < bloom->k; n++) {
+        if (!counter_get(bloom->c, counter_idx(bloom, h1, h2, n))) {
+            return false;
+        }
+    }
+
+    for (size_t n = 0; n < bloom->k; n++) {
+        size_t idx = counter_idx(bloom, h1, h2, n);
+
+        /* a saturated counter lost track of its count, keep it */
+        if (counter_get(bloom->c, idx) < COUNTER_MAX) {
+            counter_dec(bloom->c, idx);
+        }
+    }
+
+    return true;
+}
+
+bool bloom_counting_check(bloom_counting_t *bloom, const uint8_t *buf, size_t len)
+{
+    uint32_t h1, h2;
+
+    get_hashes(bloom, buf, len, &h1, &h2);
+
+    for (size_t n = 0; n < bloom->k; n++) {
+        if (!counter_get(bloom->c, counter_idx(bloom, h1, h2, n))) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -17,6 +17,7 @@
 
 #include "byteorder.h"
 
+#include <errno.h>
 #include <inttypes.h>
 #include <math.h>
 #include <stdint.h>
@@ -81,6 +82,11 @@
 /* Extra defines not related to the protocol itself */
 #define CBOR_STREAM_PRINT_BUFFERSIZE 1024 /* bytes */
 
+/* Maximum nesting depth of containers handled by cbor_read_skip() */
+#ifndef CBOR_READER_MAX_DEPTH
+#define CBOR_READER_MAX_DEPTH   (16)
+#endif
+
 /* Array size */
 #define MAX_TIMESTRING_LENGTH   (21)
 
@@ -785,6 +791,818 @@ bool cbor_at_end(const cbor_stream_t *s, size_t offset)
     return s ? offset >= s->pos - 1 : true;
 }
 
+/* BEGIN: Streaming writer */
+
+/**
+ * Encode an item head into @p out, only return its length if @p out is NULL
+ */
+static size_t put_head(unsigned char *out, unsigned char major_type, uint64_t val)
+{
+    unsigned char additional_info = uint_additional_info(val);
+    unsigned char bytes_follow = uint_bytes_follow(additional_info);
+
+    if (out) {
+        out[0] = major_type | additional_info;
+
+        for (int i = bytes_follow; i > 0; --i) {
+            out[i] = val & 0xff;
+            val >>= 8;
+        }
+    }
+
+    return bytes_follow + 1;
+}
+
+void cbor_writer_init(cbor_writer_t *writer, unsigned char *buffer, size_t size,
+                      cbor_writer_next_chunk_t next_chunk, void *arg)
+{
+    if (!writer) {
+        return;
+    }
+
+    writer->data = buffer;
+    writer->size = buffer ? size : 0;
+    writer->pos = 0;
+    writer->total = 0;
+    writer->next_chunk = next_chunk;
+    writer->arg = arg;
+}
+
+/**
+ * Copy @p length bytes from @p src into the writer, requesting new chunks as needed
+ */
+static size_t writer_put(cbor_writer_t *w, const unsigned char *src, size_t length)
+{
+    size_t left = length;
+
+    if (w->size - w->pos >= length) {
+        memcpy(&w->data[w->pos], src, length);
+        w->pos += length;
+        return length;
+    }
+
+    while (left) {
+        if (w->pos >= w->size) {
+            if (!w->next_chunk || (w->next_chunk(w) < 0) || !w->size) {
+                /* an empty chunk would be requested over and over again */
+                return 0;
+            }
+
+            w->total += w->pos;
+            w->pos = 0;
+            continue;
+        }
+
+        size_t n = w->size - w->pos;
+
+        if (n > left) {
+            n = left;
+        }
+
+        memcpy(&w->data[w->pos], src, n);
+        w->pos += n;
+        src += n;
+        left -= n;
+    }
+
+    return length;
+}
+
+/**
+ * Write the initial byte and the argument of an item of major type @p major_type
+ */
+static size_t writer_put_head(cbor_writer_t *w, unsigned char major_type, uint64_t val)
+{
+    unsigned char tmp[9];
+    size_t len = put_head(NULL, major_type, val);
+
+    /* encode in place unless the head straddles a chunk boundary */
+    if (w->size - w->pos >= len) {
+        w->pos += put_head(&w->data[w->pos], major_type, val);
+        return len;
+    }
+
+    put_head(tmp, major_type, val);
+    return writer_put(w, tmp, len);
+}
+
+size_t cbor_write_uint64_t(cbor_writer_t *writer, uint64_t val)
+{
+    return writer_put_head(writer, CBOR_UINT, val);
+}
+
+size_t cbor_write_int64_t(cbor_writer_t *writer, int64_t val)
+{
+    if (val >= 0) {
+        return writer_put_head(writer, CBOR_UINT, val);
+    }
+
+    return writer_put_head(writer, CBOR_NEGINT, -1 - val);
+}
+
+size_t cbor_write_bool(cbor_writer_t *writer, bool val)
+{
+    unsigned char byte = val ? CBOR_TRUE : CBOR_FALSE;
+    return writer_put(writer, &byte, 1);
+}
+
+#ifndef CBOR_NO_FLOAT
+size_t cbor_write_float(cbor_writer_t *writer, float val)
+{
+    unsigned char buf[5];
+    uint32_t encoded_val = htonf(val);
+
+    buf[0] = CBOR_FLOAT32;
+    memcpy(&buf[1], &encoded_val, 4);
+    return writer_put(writer, buf, sizeof(buf));
+}
+#endif /* CBOR_NO_FLOAT */
+
+static size_t writer_put_bytes(cbor_writer_t *w, unsigned char major_type, const void *data,
+                               size_t length)
+{
+    size_t head = writer_put_head(w, major_type, length);
+
+    if (!head || (length && !writer_put(w, data, length))) {
+        return 0;
+    }
+
+    return head + length;
+}
+
+size_t cbor_write_byte_string(cbor_writer_t *writer, const void *val, size_t length)
+{
+    return writer_put_bytes(writer, CBOR_BYTES, val, length);
+}
+
+size_t cbor_write_unicode_string(cbor_writer_t *writer, const char *val, size_t length)
+{
+    return writer_put_bytes(writer, CBOR_TEXT, val, length);
+}
+
+size_t cbor_write_array(cbor_writer_t *writer, size_t array_length)
+{
+    return writer_put_head(writer, CBOR_ARRAY, array_length);
+}
+
+size_t cbor_write_map(cbor_writer_t *writer, size_t map_length)
+{
+    return writer_put_head(writer, CBOR_MAP, map_length);
+}
+
+size_t cbor_write_array_indefinite(cbor_writer_t *writer)
+{
+    unsigned char byte = CBOR_ARRAY | CBOR_VAR_FOLLOWS;
+    return writer_put(writer, &byte, 1);
+}
+
+size_t cbor_write_map_indefinite(cbor_writer_t *writer)
+{
+    unsigned char byte = CBOR_MAP | CBOR_VAR_FOLLOWS;
+    return writer_put(writer, &byte, 1);
+}
+
+size_t cbor_write_stream_tag(cbor_writer_t *writer, uint64_t tag)
+{
+    return writer_put_head(writer, CBOR_TAG, tag);
+}
+
+size_t cbor_write_stream_break(cbor_writer_t *writer)
+{
+    unsigned char byte = CBOR_BREAK;
+    return writer_put(writer, &byte, 1);
+}
+
+#ifdef MODULE_GNRC_PKTBUF
+/**
+ * Chunk callback of cbor_pktbuf_writer_t: append a new snip to the chain
+ */
+static int pktbuf_next_chunk(cbor_writer_t *writer)
+{
+    cbor_pktbuf_writer_t *pw = writer->arg;
+    gnrc_pktsnip_t *snip = gnrc_pktbuf_add(NULL, NULL, pw->chunk_size, GNRC_NETTYPE_UNDEF);
+
+    if (!snip) {
+        return -ENOMEM;
+    }
+
+    pw->tail->next = snip;
+    pw->tail = snip;
+    writer->data = snip->data;
+    writer->size = snip->size;
+    return 0;
+}
+
+int cbor_pktbuf_writer_init(cbor_pktbuf_writer_t *pw, size_t chunk_size)
+{
+    if (!chunk_size) {
+        return -EINVAL;
+    }
+
+    pw->chunk_size = chunk_size;
+    pw->head = gnrc_pktbuf_add(NULL, NULL, chunk_size, GNRC_NETTYPE_UNDEF);
+
+    if (!pw->head) {
+        return -ENOMEM;
+    }
+
+    pw->tail = pw->head;
+    cbor_writer_init(&pw->writer, pw->head->data, pw->head->size, pktbuf_next_chunk, pw);
+    return 0;
+}
+
+gnrc_pktsnip_t *cbor_pktbuf_writer_finish(cbor_pktbuf_writer_t *pw)
+{
+    gnrc_pktsnip_t *head = pw->head;
+
+    /* new snips are only requested for actual data, so only the head can be empty */
+    if (pw->writer.pos == 0) {
+        gnrc_pktbuf_release(head);
+        head = NULL;
+    }
+    else if (pw->writer.pos < pw->tail->size) {
+        gnrc_pktbuf_realloc_data(pw->tail, pw->writer.pos);
+    }
+
+    pw->head = NULL;
+    pw->tail = NULL;
+    return head;
+}
+#endif /* MODULE_GNRC_PKTBUF */
+
+/* END: Streaming writer */
+
+/* BEGIN: Pull parser */
+
+void cbor_reader_init(cbor_reader_t *reader, const void *data, size_t size)
+{
+    if (!reader) {
+        return;
+    }
+
+    reader->data = data;
+    reader->size = data ? size : 0;
+    reader->pos = 0;
+}
+
+size_t cbor_read_next(cbor_reader_t *reader, cbor_item_t *item)
+{
+    if (!reader || !item || cbor_reader_at_end(reader)) {
+        return 0;
+    }
+
+    const unsigned char *in = &reader->data[reader->pos];
+    size_t avail = reader->size - reader->pos;
+    unsigned char major_type = in[0] & CBOR_TYPE_MASK;
+    unsigned char additional_info = in[0] & CBOR_INFO_MASK;
+    unsigned char bytes_follow = uint_bytes_follow(additional_info);
+    size_t consumed = bytes_follow + 1;
+    uint64_t val = additional_info;
+
+    if (consumed > avail) {
+        return 0;
+    }
+
+    /* decode the argument byte by byte: no alignment or byte order assumptions */
+    if (bytes_follow) {
+        val = 0;
+        for (unsigned i = 1; i <= bytes_follow; i++) {
+            val = (val << 8) | in[i];
+        }
+    }
+    else if (additional_info > CBOR_UINT64_FOLLOWS) {
+        /* reserved values (28-30) or indefinite length */
+        if ((additional_info != CBOR_VAR_FOLLOWS) || (major_type == CBOR_UINT)
+            || (major_type == CBOR_NEGINT) || (major_type == CBOR_TAG)) {
+            return 0;
+        }
+    }
+
+    item->indefinite = (additional_info == CBOR_VAR_FOLLOWS);
+
+    switch (major_type) {
+        case CBOR_UINT:
+            item->type = CBOR_ITEM_UINT;
+            item->value.uint = val;
+            break;
+
+        case CBOR_NEGINT:
+            if (val > INT64_MAX) {
+                return 0;
+            }
+            item->type = CBOR_ITEM_NEGINT;
+            item->value.sint = -1 - (int64_t)val;
+            break;
+
+        case CBOR_BYTES:
+        case CBOR_TEXT:
+            item->type = (major_type == CBOR_BYTES) ? CBOR_ITEM_BYTES : CBOR_ITEM_TEXT;
+            if (item->indefinite) {
+                /* chunks follow as separate items, terminated by a break */
+                item->value.str.ptr = NULL;
+                item->value.str.len = 0;
+                break;
+            }
+            if (val > avail - consumed) {
+                return 0;
+            }
+            item->value.str.ptr = &in[consumed];
+            item->value.str.len = (size_t)val;
+            consumed += (size_t)val;
+            break;
+
+        case CBOR_ARRAY:
+            item->type = CBOR_ITEM_ARRAY;
+            item->value.uint = item->indefinite ? 0 : val;
+            break;
+
+        case CBOR_MAP:
+            item->type = CBOR_ITEM_MAP;
+            item->value.uint = item->indefinite ? 0 : val;
+            break;
+
+        case CBOR_TAG:
+            item->type = CBOR_ITEM_TAG;
+            item->value.uint = val;
+            break;
+
+        default: /* CBOR_7 */
+            item->indefinite = false;
+            switch (in[0]) {
+                case CBOR_FALSE:
+                case CBOR_TRUE:
+                    item->type = CBOR_ITEM_BOOL;
+                    item->value.boolean = (in[0] == CBOR_TRUE);
+                    break;
+
+                case CBOR_NULL:
+                    item->type = CBOR_ITEM_NULL;
+                    break;
+
+                case CBOR_UNDEFINED:
+                    item->type = CBOR_ITEM_UNDEFINED;
+                    break;
+
+                case CBOR_BREAK:
+                    item->type = CBOR_ITEM_BREAK;
+                    break;
+
+#ifndef CBOR_NO_FLOAT
+                case CBOR_FLOAT16:
+                    item->type = CBOR_ITEM_FLOAT;
+                    item->value.fp = decode_float_half((unsigned char *)&in[1]);
+                    break;
+
+                case CBOR_FLOAT32: {
+                    union {
+                        float f;
+                        uint32_t i;
+                    } u = { .i = (uint32_t)val };
+                    item->type = CBOR_ITEM_FLOAT;
+                    item->value.fp = u.f;
+                    break;
+                }
+
+                case CBOR_FLOAT64: {
+                    union {
+                        double d;
+                        uint64_t i;
+                    } u = { .i = val };
+                    item->type = CBOR_ITEM_FLOAT;
+                    item->value.fp = u.d;
+                    break;
+                }
+#endif /* CBOR_NO_FLOAT */
+
+                default:
+                    /* unsupported simple value */
+                    return 0;
+            }
+            break;
+    }
+
+    reader->pos += consumed;
+    return consumed;
+}
+
+/**
+ * Skip the next item, @p depth limits the nesting of containers
+ */
+static size_t reader_skip(cbor_reader_t *reader, unsigned depth)
+{
+    size_t start = reader->pos;
+    cbor_item_t item;
+
+    if (!cbor_read_next(reader, &item) || (depth > CBOR_READER_MAX_DEPTH)) {
+        goto error;
+    }
+
+    switch (item.type) {
+        case CBOR_ITEM_BREAK:
+            /* a break is never a complete item on its own */
+            goto error;
+
+        case CBOR_ITEM_TAG:
+            if (!reader_skip(reader, depth + 1)) {
+                goto error;
+            }
+            break;
+
+        case CBOR_ITEM_BYTES:
+        case CBOR_ITEM_TEXT:
+        case CBOR_ITEM_ARRAY:
+        case CBOR_ITEM_MAP:
+            if (item.indefinite) {
+                while (!cbor_reader_at_end(reader) && (reader->data[reader->pos] != CBOR_BREAK)) {
+                    if (!reader_skip(reader, depth + 1)) {
+                        goto error;
+                    }
+                }
+                if (cbor_reader_at_end(reader)) {
+                    goto error;
+                }
+                reader->pos++;  /* the break */
+            }
+            else if ((item.type == CBOR_ITEM_ARRAY) || (item.type == CBOR_ITEM_MAP)) {
+                uint64_t count = item.value.uint;
+
+                if (item.type == CBOR_ITEM_MAP) {
+                    count *= 2;
+                }
+
+                while (count--) {
+                    if (!reader_skip(reader, depth + 1)) {
+                        goto error;
+                    }
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return reader->pos - start;
+
+error:
+    reader->pos = start;
+    return 0;
+}
+
+size_t cbor_read_skip(cbor_reader_t *reader)
+{
+    if (!reader) {
+        return 0;
+    }
+
+    return reader_skip(reader, 0);
+}
+
+/* END: Pull parser */
+
+/* BEGIN: Struct serialization */
+
+static uint64_t load_uint(const void *member, size_t size)
+{
+    switch (size) {
+        case 1:
+            return *(const uint8_t *)member;
+        case 2:
+            return *(const uint16_t *)member;
+        case 4:
+            return *(const uint32_t *)member;
+        default:
+            return *(const uint64_t *)member;
+    }
+}
+
+static int64_t load_int(const void *member, size_t size)
+{
+    switch (size) {
+        case 1:
+            return *(const int8_t *)member;
+        case 2:
+            return *(const int16_t *)member;
+        case 4:
+            return *(const int32_t *)member;
+        default:
+            return *(const int64_t *)member;
+    }
+}
+
+static void store_uint(void *member, size_t size, uint64_t val)
+{
+    switch (size) {
+        case 1:
+            *(uint8_t *)member = val;
+            break;
+        case 2:
+            *(uint16_t *)member = val;
+            break;
+        case 4:
+            *(uint32_t *)member = val;
+            break;
+        default:
+            *(uint64_t *)member = val;
+            break;
+    }
+}
+
+/**
+ * Length of the zero terminated string in @p member, bounded by the array size
+ */
+static size_t text_len(const char *member, size_t size)
+{
+    const char *end = size ? memchr(member, '\0', size - 1) : member;
+
+    return end ? (size_t)(end - member) : size - 1;
+}
+
+static size_t field_max_size(const cbor_field_t *field)
+{
+    size_t len = put_head(NULL, CBOR_TEXT, field->key_len) + field->key_len;
+
+    switch (field->type) {
+        case CBOR_FIELD_UINT:
+        case CBOR_FIELD_INT:
+            return len + 1 + field->size;
+        case CBOR_FIELD_BOOL:
+            return len + 1;
+#ifndef CBOR_NO_FLOAT
+        case CBOR_FIELD_FLOAT:
+            return len + 5;
+#endif /* CBOR_NO_FLOAT */
+        case CBOR_FIELD_TEXT:
+            return field->size ? len + put_head(NULL, CBOR_TEXT, field->size - 1) + field->size - 1
+                   : len + 1;
+        default: /* CBOR_FIELD_BYTES */
+            return len + put_head(NULL, CBOR_BYTES, field->size) + field->size;
+    }
+}
+
+/**
+ * Encode one map entry into @p out, only return its length if @p out is NULL
+ */
+static size_t encode_field(unsigned char *out, const cbor_field_t *field, const void *val)
+{
+    const unsigned char *member = (const unsigned char *)val + field->offset;
+    size_t pos = put_head(out, CBOR_TEXT, field->key_len);
+    size_t len;
+
+    if (out) {
+        memcpy(&out[pos], field->key, field->key_len);
+    }
+    pos += field->key_len;
+
+    unsigned char *dst = out ? &out[pos] : NULL;
+
+    switch (field->type) {
+        case CBOR_FIELD_UINT:
+            return pos + put_head(dst, CBOR_UINT, load_uint(member, field->size));
+
+        case CBOR_FIELD_INT: {
+            int64_t i = load_int(member, field->size);
+
+            if (i >= 0) {
+                return pos + put_head(dst, CBOR_UINT, i);
+            }
+            return pos + put_head(dst, CBOR_NEGINT, -1 - i);
+        }
+
+        case CBOR_FIELD_BOOL:
+            if (dst) {
+                dst[0] = *(const bool *)member ? CBOR_TRUE : CBOR_FALSE;
+            }
+            return pos + 1;
+
+#ifndef CBOR_NO_FLOAT
+        case CBOR_FIELD_FLOAT:
+            if (dst) {
+                uint32_t encoded_val = htonf(*(const float *)member);
+                dst[0] = CBOR_FLOAT32;
+                memcpy(&dst[1], &encoded_val, 4);
+            }
+            return pos + 5;
+#endif /* CBOR_NO_FLOAT */
+
+        case CBOR_FIELD_TEXT:
+            len = text_len((const char *)member, field->size);
+            pos += put_head(dst, CBOR_TEXT, len);
+            break;
+
+        default: /* CBOR_FIELD_BYTES */
+            len = field->size;
+            pos += put_head(dst, CBOR_BYTES, len);
+            break;
+    }
+
+    if (out) {
+        memcpy(&out[pos], member, len);
+    }
+
+    return pos + len;
+}
+
+static size_t encode_struct(unsigned char *out, const cbor_schema_t *schema, const void *val)
+{
+    size_t pos = put_head(out, CBOR_MAP, schema->num);
+
+    for (unsigned i = 0; i < schema->num; i++) {
+        pos += encode_field(out ? &out[pos] : NULL, &schema->fields[i], val);
+    }
+
+    return pos;
+}
+
+size_t cbor_struct_max_size(const cbor_schema_t *schema)
+{
+    if (!schema) {
+        return 0;
+    }
+
+    size_t size = put_head(NULL, CBOR_MAP, schema->num);
+
+    for (unsigned i = 0; i < schema->num; i++) {
+        size += field_max_size(&schema->fields[i]);
+    }
+
+    return size;
+}
+
+size_t cbor_serialize_struct(cbor_stream_t *s, const cbor_schema_t *schema, const void *val)
+{
+    if (!s || !schema || !val) {
+        return 0;
+    }
+
+    size_t room = s->size - s->pos;
+
+    /* if the worst case does not fit, a dry run tells whether the actual data does */
+    if ((room < cbor_struct_max_size(schema)) && (room < encode_struct(NULL, schema, val))) {
+        return 0;
+    }
+
+    size_t written = encode_struct(&s->data[s->pos], schema, val);
+    s->pos += written;
+    return written;
+}
+
+static int decode_field(const cbor_field_t *field, void *val, const cbor_item_t *item)
+{
+    unsigned char *member = (unsigned char *)val + field->offset;
+    unsigned bits = 8 * field->size;
+
+    switch (field->type) {
+        case CBOR_FIELD_UINT:
+            if ((item->type != CBOR_ITEM_UINT)
+                || ((bits < 64) && (item->value.uint >> bits))) {
+                return -1;
+            }
+            store_uint(member, field->size, item->value.uint);
+            return 0;
+
+        case CBOR_FIELD_INT: {
+            int64_t i;
+
+            if ((item->type == CBOR_ITEM_UINT) && (item->value.uint <= INT64_MAX)) {
+                i = item->value.uint;
+            }
+            else if (item->type == CBOR_ITEM_NEGINT) {
+                i = item->value.sint;
+            }
+            else {
+                return -1;
+            }
+            if ((bits < 64) && ((i >= (1LL << (bits - 1))) || (i < -(1LL << (bits - 1))))) {
+                return -1;
+            }
+            /* two's complement: storing the low bits keeps the sign */
+            store_uint(member, field->size, (uint64_t)i);
+            return 0;
+        }
+
+        case CBOR_FIELD_BOOL:
+            if (item->type != CBOR_ITEM_BOOL) {
+                return -1;
+            }
+            *(bool *)member = item->value.boolean;
+            return 0;
+
+#ifndef CBOR_NO_FLOAT
+        case CBOR_FIELD_FLOAT:
+            if (item->type != CBOR_ITEM_FLOAT) {
+                return -1;
+            }
+            *(float *)member = (float)item->value.fp;
+            return 0;
+#endif /* CBOR_NO_FLOAT */
+
+        case CBOR_FIELD_TEXT:
+            if ((item->type != CBOR_ITEM_TEXT) || item->indefinite
+                || (item->value.str.len >= field->size)) {
+                return -1;
+            }
+            memcpy(member, item->value.str.ptr, item->value.str.len);
+            member[item->value.str.len] = '\0';
+            return 0;
+
+        default: /* CBOR_FIELD_BYTES */
+            if ((item->type != CBOR_ITEM_BYTES) || item->indefinite
+                || (item->value.str.len != field->size)) {
+                return -1;
+            }
+            memcpy(member, item->value.str.ptr, field->size);
+            return 0;
+    }
+}
+
+/**
+ * Find the field for @p key, trying @p hint first as entries usually come in
+ * schema order
+ */
+static const cbor_field_t *find_field(const cbor_schema_t *schema, const cbor_item_t *key,
+                                      unsigned *hint)
+{
+    for (unsigned n = 0; n < schema->num; n++) {
+        unsigned i = (*hint + n) % schema->num;
+        const cbor_field_t *field = &schema->fields[i];
+
+        if ((field->key_len == key->value.str.len)
+            && (memcmp(field->key, key->value.str.ptr, field->key_len) == 0)) {
+            *hint = i + 1;
+            return field;
+        }
+    }
+
+    return NULL;
+}
+
+size_t cbor_deserialize_struct(const cbor_stream_t *stream, size_t offset,
+                               const cbor_schema_t *schema, void *val)
+{
+    if (!stream || !schema || !val || (offset >= stream->pos)) {
+        return 0;
+    }
+
+    cbor_reader_t reader;
+    cbor_item_t item;
+    uint64_t entries;
+    bool indefinite;
+    unsigned hint = 0;
+
+    cbor_reader_init(&reader, &stream->data[offset], stream->pos - offset);
+
+    if (!cbor_read_next(&reader, &item) || (item.type != CBOR_ITEM_MAP)) {
+        return 0;
+    }
+
+    entries = item.value.uint;
+    indefinite = item.indefinite;
+
+    while (indefinite || entries--) {
+        size_t key_pos = reader.pos;
+
+        if (!cbor_read_next(&reader, &item)) {
+            return 0;
+        }
+
+        if (item.type == CBOR_ITEM_BREAK) {
+            if (!indefinite) {
+                return 0;
+            }
+            break;
+        }
+
+        const cbor_field_t *field = NULL;
+
+        if ((item.type == CBOR_ITEM_TEXT) && !item.indefinite) {
+            field = find_field(schema, &item, &hint);
+        }
+        else {
+            /* keys of other types may be nested items */
+            reader.pos = key_pos;
+            if (!cbor_read_skip(&reader)) {
+                return 0;
+            }
+        }
+
+        if (!field) {
+            if (!cbor_read_skip(&reader)) {
+                return 0;
+            }
+            continue;
+        }
+
+        if (!cbor_read_next(&reader, &item) || (decode_field(field, val, &item) < 0)) {
+            return 0;
+        }
+    }
+
+    return reader.pos;
+}
+
+/* END: Struct serialization */
+
 #ifndef CBOR_NO_PRINT
 /* BEGIN: Printers */
 void cbor_stream_print(const cbor_stream_t *stream)
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   C++11 future drop in replacement
+ *
+ * @}
+ */
+
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "riot/future.hpp"
+
+using namespace std;
+
+namespace riot {
+
+namespace {
+
+const char* errc_str(future_errc ec) {
+  switch (ec) {
+    case future_errc::broken_promise:
+      return "Broken promise.";
+    case future_errc::future_already_retrieved:
+      return "Future already retrieved.";
+    case future_errc::promise_already_satisfied:
+      return "Promise already satisfied.";
+    case future_errc::no_state:
+      return "No associated state.";
+  }
+  return "Unknown future error.";
+}
+
+} // namespace <anonymous>
+
+future_error::future_error(future_errc ec)
+    : logic_error(errc_str(ec)), m_code{ec} {
+  // nop
+}
+
+namespace detail {
+
+namespace {
+
+static_assert(RIOT_FUTURE_POOL_SIZE <= 32,
+              "The state pool supports at most 32 slots.");
+
+using slot = aligned_storage<RIOT_FUTURE_STATE_SIZE>::type;
+
+// bit n is set if slot n is in use, only accessed with interrupts disabled
+slot slots[RIOT_FUTURE_POOL_SIZE];
+uint32_t slots_used = 0;
+
+struct timeout {
+  xtimer_t timer;
+  kernel_pid_t pid;
+  volatile bool expired;
+};
+
+void timeout_cb(void* arg) {
+  auto t = static_cast<timeout*>(arg);
+  t->expired = true;
+  thread_wakeup(t->pid);
+}
+
+} // namespace <anonymous>
+
+void* shared_state_base::operator new(size_t size) {
+  if (size > RIOT_FUTURE_STATE_SIZE) {
+    throw bad_alloc();
+  }
+  unsigned state = disableIRQ();
+  for (unsigned i = 0; i < RIOT_FUTURE_POOL_SIZE; ++i) {
+    if (!(slots_used & (1ul << i))) {
+      slots_used |= (1ul << i);
+      restoreIRQ(state);
+      return &slots[i];
+    }
+  }
+  restoreIRQ(state);
+  throw bad_alloc();
+}
+
+void shared_state_base::operator delete(void* ptr) noexcept {
+  unsigned i = static_cast<slot*>(ptr) - slots;
+  unsigned state = disableIRQ();
+  slots_used &= ~(1ul << i);
+  restoreIRQ(state);
+}
+
+shared_state_base::shared_state_base() noexcept
+    : m_has_value{false}, m_deferred{false}, m_ref_count{1}, m_ready{false},
+      m_retrieved{false}, m_waiter{KERNEL_PID_UNDEF} {
+  // nop
+}
+
+shared_state_base::~shared_state_base() {
+  // nop
+}
+
+void shared_state_base::retrieve() {
+  if (m_retrieved) {
+    throw future_error(future_errc::future_already_retrieved);
+  }
+  m_retrieved = true;
+}
+
+void shared_state_base::wait() {
+  if (m_deferred) {
+    m_deferred = false;
+    run_deferred();
+  }
+  unsigned state = disableIRQ();
+  while (!m_ready) {
+    m_waiter = sched_active_pid;
+    sched_set_status((tcb_t*)sched_active_thread, STATUS_SLEEPING);
+    restoreIRQ(state);
+    thread_yield_higher();
+    state = disableIRQ();
+  }
+  m_waiter = KERNEL_PID_UNDEF;
+  restoreIRQ(state);
+}
+
+future_status shared_state_base::wait_for(uint32_t usec) {
+  if (m_deferred) {
+    return future_status::deferred;
+  }
+  if (m_ready) {
+    return future_status::ready;
+  }
+  timeout t;
+  t.timer.callback = timeout_cb;
+  t.timer.arg = &t;
+  t.pid = sched_active_pid;
+  t.expired = false;
+  xtimer_set(&t.timer, usec);
+  unsigned state = disableIRQ();
+  // the callback only wakes us once we sleep, so check it with irqs disabled
+  while (!m_ready && !t.expired) {
+    m_waiter = sched_active_pid;
+    sched_set_status((tcb_t*)sched_active_thread, STATUS_SLEEPING);
+    restoreIRQ(state);
+    thread_yield_higher();
+    state = disableIRQ();
+  }
+  m_waiter = KERNEL_PID_UNDEF;
+  restoreIRQ(state);
+  xtimer_remove(&t.timer);
+  return m_ready ? future_status::ready : future_status::timeout;
+}
+
+void shared_state_base::set_exception(exception_ptr ptr) {
+  check_unsatisfied();
+  m_exception = ptr;
+  make_ready();
+}
+
+void shared_state_base::abandon() noexcept {
+  if (!m_ready) {
+    m_exception = make_exception_ptr(future_error(future_errc::broken_promise));
+    make_ready();
+  }
+  release();
+}
+
+void shared_state_base::check_unsatisfied() const {
+  if (m_ready) {
+    throw future_error(future_errc::promise_already_satisfied);
+  }
+}
+
+void shared_state_base::make_ready() noexcept {
+  unsigned state = disableIRQ();
+  m_ready = true;
+  tcb_t* waiter = nullptr;
+  if (m_waiter != KERNEL_PID_UNDEF) {
+    waiter = (tcb_t*)sched_threads[m_waiter];
+  }
+  if (waiter && waiter->status == STATUS_SLEEPING) {
+    sched_set_status(waiter, STATUS_PENDING);
+    restoreIRQ(state);
+    sched_switch(waiter->priority);
+  } else {
+    restoreIRQ(state);
+  }
+}
+
+void shared_state_base::wait_result() {
+  wait();
+  if (m_exception) {
+    rethrow_exception(m_exception);
+  }
+}
+
+} // namespace detail
+
+} // namespace riot
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   Utilities shared by the lock-free queues
+ *
+ * @}
+ */
+
+#ifndef RIOT_QUEUE_UTIL_HPP
+#define RIOT_QUEUE_UTIL_HPP
+
+#include <cstddef>
+
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+
+namespace riot {
+namespace detail {
+
+/**
+ * Lets a single thread sleep until a condition holds. Other than
+ * riot::condition_variable it may be notified from interrupt context,
+ * because the condition is checked with interrupts disabled right before
+ * the thread goes to sleep.
+ */
+class single_waiter {
+ public:
+  constexpr single_waiter() noexcept : m_pid{KERNEL_PID_UNDEF} {}
+
+  single_waiter(const single_waiter&) = delete;
+  single_waiter& operator=(const single_waiter&) = delete;
+
+  /**
+   * Sleeps until `pred()` returns true, pred is called with interrupts
+   * disabled.
+   */
+  template <class Predicate>
+  void wait(Predicate pred) {
+    unsigned state = disableIRQ();
+    while (!pred()) {
+      m_pid = sched_active_pid;
+      sched_set_status((tcb_t*)sched_active_thread, STATUS_SLEEPING);
+      restoreIRQ(state);
+      thread_yield_higher();
+      state = disableIRQ();
+    }
+    m_pid = KERNEL_PID_UNDEF;
+    restoreIRQ(state);
+  }
+
+  /**
+   * Wakes up the waiting thread, if any.
+   */
+  void notify() noexcept {
+    if (m_pid == KERNEL_PID_UNDEF) {
+      return;
+    }
+    unsigned state = disableIRQ();
+    tcb_t* waiter = nullptr;
+    if (m_pid != KERNEL_PID_UNDEF) {
+      waiter = (tcb_t*)sched_threads[m_pid];
+    }
+    if (waiter && waiter->status == STATUS_SLEEPING) {
+      sched_set_status(waiter, STATUS_PENDING);
+      restoreIRQ(state);
+      sched_switch(waiter->priority);
+    } else {
+      restoreIRQ(state);
+    }
+  }
+
+ private:
+  volatile kernel_pid_t m_pid;
+};
+
+/**
+ * True if `N` is a power of two.
+ */
+constexpr bool is_pow2(size_t N) { return N && !(N & (N - 1)); }
+
+} // namespace detail
+} // namespace riot
+
+#endif // RIOT_QUEUE_UTIL_HPP
@@ -0,0 +1,604 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   C++11 future, promise, packaged_task and async drop in replacement
+ * @see     <a href="http://en.cppreference.com/w/cpp/thread/future">
+ *            std::future
+ *          </a>
+ *
+ * The shared state of a future and its promise is not allocated on the heap
+ * but taken from a static pool of RIOT_FUTURE_POOL_SIZE slots of
+ * RIOT_FUTURE_STATE_SIZE bytes. Creating a promise throws std::bad_alloc if
+ * the pool is exhausted. Differences to the standard:
+ *
+ * - there is no shared_future, a future can only be waited on by one thread
+ * - async() can also run the task on a riot::thread_pool
+ *
+ * @}
+ */
+
+#ifndef RIOT_FUTURE_HPP
+#define RIOT_FUTURE_HPP
+
+#include "kernel_types.h"
+
+#include <new>
+#include <tuple>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <utility>
+#include <exception>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+#include "riot/thread.hpp"
+#include "riot/thread_pool.hpp"
+
+#include "riot/detail/thread_util.hpp"
+
+/**
+ * @brief Number of shared states available to futures
+ */
+#ifndef RIOT_FUTURE_POOL_SIZE
+#define RIOT_FUTURE_POOL_SIZE (8)
+#endif
+
+/**
+ * @brief Size of a shared state slot in bytes
+ *
+ * Has to hold the result and, for deferred tasks, the function and its
+ * arguments.
+ */
+#ifndef RIOT_FUTURE_STATE_SIZE
+#define RIOT_FUTURE_STATE_SIZE (16 * sizeof(void*))
+#endif
+
+namespace riot {
+
+enum class future_status {
+  ready,
+  timeout,
+  deferred
+};
+
+enum class launch {
+  async = 1,
+  deferred = 2
+};
+
+enum class future_errc {
+  broken_promise = 1,
+  future_already_retrieved,
+  promise_already_satisfied,
+  no_state
+};
+
+/**
+ * @brief Exception thrown on misuse of futures and promises
+ * @see   <a href="http://en.cppreference.com/w/cpp/thread/future_error">
+ *          std::future_error
+ *        </a>
+ */
+class future_error : public std::logic_error {
+ public:
+  explicit future_error(future_errc ec);
+  inline future_errc code() const noexcept { return m_code; }
+
+ private:
+  future_errc m_code;
+};
+
+template <class T>
+class future;
+
+namespace detail {
+
+/**
+ * State shared by a future and its promise, allocated from the state pool.
+ */
+class shared_state_base {
+ public:
+  shared_state_base() noexcept;
+  virtual ~shared_state_base();
+
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr) noexcept;
+
+  inline void acquire() noexcept { ++m_ref_count; }
+  inline void release() noexcept {
+    if (--m_ref_count == 0) {
+      delete this;
+    }
+  }
+
+  /**
+   * Marks the future as retrieved, throws if it was retrieved before.
+   */
+  void retrieve();
+
+  void wait();
+  future_status wait_for(uint32_t usec);
+
+  void set_exception(std::exception_ptr ptr);
+
+  /**
+   * Stores a broken_promise error if no result was set and releases the
+   * reference of the promise.
+   */
+  void abandon() noexcept;
+
+ protected:
+  /**
+   * Throws if a result was set before.
+   */
+  void check_unsatisfied() const;
+  /**
+   * Wakes up the waiting thread.
+   */
+  void make_ready() noexcept;
+  /**
+   * Waits for the result and rethrows a stored exception.
+   */
+  void wait_result();
+  inline bool has_value() const noexcept { return m_has_value; }
+
+  virtual void run_deferred() noexcept {}
+
+  bool m_has_value;
+  bool m_deferred;
+
+ private:
+  std::atomic<unsigned> m_ref_count;
+  volatile bool m_ready;
+  bool m_retrieved;
+  kernel_pid_t m_waiter;
+  std::exception_ptr m_exception;
+};
+
+template <class T>
+class shared_state : public shared_state_base {
+ public:
+  ~shared_state() {
+    if (has_value()) {
+      reinterpret_cast<T*>(&m_storage)->~T();
+    }
+  }
+  template <class U>
+  void set_value(U&& value) {
+    check_unsatisfied();
+    new (&m_storage) T(std::forward<U>(value));
+    m_has_value = true;
+    make_ready();
+  }
+  T take() {
+    wait_result();
+    return std::move(*reinterpret_cast<T*>(&m_storage));
+  }
+
+ private:
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage;
+};
+
+template <class T>
+class shared_state<T&> : public shared_state_base {
+ public:
+  void set_value(T& value) {
+    check_unsatisfied();
+    m_ptr = &value;
+    m_has_value = true;
+    make_ready();
+  }
+  T& take() {
+    wait_result();
+    return *m_ptr;
+  }
+
+ private:
+  T* m_ptr;
+};
+
+template <>
+class shared_state<void> : public shared_state_base {
+ public:
+  void set_value() {
+    check_unsatisfied();
+    m_has_value = true;
+    make_ready();
+  }
+  void take() { wait_result(); }
+};
+
+/**
+ * Creates a shared state of type `State` in the state pool.
+ */
+template <class State, class... Ts>
+State* make_state(Ts&&... args) {
+  static_assert(sizeof(State) <= RIOT_FUTURE_STATE_SIZE,
+                "Shared state too large, increase RIOT_FUTURE_STATE_SIZE.");
+  return new State(std::forward<Ts>(args)...);
+}
+
+/**
+ * Calls `f(args...)` and stores the result or exception in `state`.
+ */
+template <class R>
+struct state_setter {
+  template <class F, class... Ts>
+  static void run(shared_state<R>* state, F& f, Ts&&... args) {
+    try {
+      state->set_value(f(std::forward<Ts>(args)...));
+    }
+    catch (...) {
+      state->set_exception(std::current_exception());
+    }
+  }
+};
+
+template <>
+struct state_setter<void> {
+  template <class F, class... Ts>
+  static void run(shared_state<void>* state, F& f, Ts&&... args) {
+    try {
+      f(std::forward<Ts>(args)...);
+      state->set_value();
+    }
+    catch (...) {
+      state->set_exception(std::current_exception());
+    }
+  }
+};
+
+/**
+ * Shared state of a deferred async(), stores the function and its arguments
+ * and runs them in the thread that waits for the result.
+ */
+template <class R, class Tuple>
+class deferred_state : public shared_state<R> {
+ public:
+  template <class... Ts>
+  deferred_state(Ts&&... args) : m_func_and_args(std::forward<Ts>(args)...) {
+    this->m_deferred = true;
+  }
+
+ protected:
+  void run_deferred() noexcept override {
+    // 0 is the function, the arguments follow
+    call(get_indices<std::tuple_size<Tuple>::value, 1>());
+  }
+
+ private:
+  template <long... Is>
+  void call(int_list<Is...>) noexcept {
+    state_setter<R>::run(this, std::get<0>(m_func_and_args),
+                         std::get<Is>(m_func_and_args)...);
+  }
+
+  Tuple m_func_and_args;
+};
+
+/**
+ * Gives access to the private constructor of future.
+ */
+struct future_access {
+  template <class T>
+  static future<T> make(shared_state<T>* state);
+};
+
+template <class Rep, class Period>
+uint32_t to_usec(const std::chrono::duration<Rep, Period>& d) {
+  using namespace std::chrono;
+  if (d <= d.zero()) {
+    return 0;
+  }
+  constexpr duration<long double, std::micro> max
+    = microseconds(std::numeric_limits<uint32_t>::max());
+  if (d >= max) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+  auto us = duration_cast<microseconds>(d);
+  if (us < d) {
+    ++us;
+  }
+  return static_cast<uint32_t>(us.count());
+}
+
+} // namespace detail
+
+/**
+ * @brief C++11 compliant implementation of future, waiting with a timeout is
+ *        done with xtimer
+ * @see   <a href="http://en.cppreference.com/w/cpp/thread/future">
+ *          std::future
+ *        </a>
+ */
+template <class T>
+class future {
+  friend struct detail::future_access;
+
+ public:
+  inline future() noexcept : m_state{nullptr} {}
+  inline future(future&& other) noexcept : m_state{other.m_state} {
+    other.m_state = nullptr;
+  }
+  inline ~future() {
+    if (m_state) {
+      m_state->release();
+    }
+  }
+  future(const future&) = delete;
+  future& operator=(const future&) = delete;
+  inline future& operator=(future&& other) noexcept {
+    std::swap(m_state, other.m_state);
+    return *this;
+  }
+
+  inline bool valid() const noexcept { return m_state != nullptr; }
+
+  /**
+   * @brief Waits for the result and returns it, the future is no longer
+   *        valid afterwards
+   */
+  T get() {
+    check_valid();
+    future tmp(std::move(*this));
+    return tmp.m_state->take();
+  }
+
+  inline void wait() const {
+    check_valid();
+    m_state->wait();
+  }
+
+  template <class Rep, class Period>
+  future_status wait_for(const std::chrono::duration<Rep, Period>& rel_time)
+    const {
+    check_valid();
+    return m_state->wait_for(detail::to_usec(rel_time));
+  }
+
+ private:
+  inline explicit future(detail::shared_state<T>* state) : m_state{state} {
+    m_state->retrieve();
+    m_state->acquire();
+  }
+  inline void check_valid() const {
+    if (!m_state) {
+      throw future_error(future_errc::no_state);
+    }
+  }
+
+  detail::shared_state<T>* m_state;
+};
+
+namespace detail {
+
+template <class T>
+future<T> future_access::make(shared_state<T>* state) {
+  return future<T>(state);
+}
+
+} // namespace detail
+
+/**
+ * @brief C++11 compliant implementation of promise
+ * @see   <a href="http://en.cppreference.com/w/cpp/thread/promise">
+ *          std::promise
+ *        </a>
+ */
+template <class T>
+class promise {
+ public:
+  inline promise() : m_state{detail::make_state<detail::shared_state<T>>()} {}
+  inline promise(promise&& other) noexcept : m_state{other.m_state} {
+    other.m_state = nullptr;
+  }
+  inline ~promise() {
+    if (m_state) {
+      m_state->abandon();
+    }
+  }
+  promise(const promise&) = delete;
+  promise& operator=(const promise&) = delete;
+  inline promise& operator=(promise&& other) noexcept {
+    promise tmp(std::move(other));
+    swap(tmp);
+    return *this;
+  }
+
+  inline void swap(promise& other) noexcept {
+    std::swap(m_state, other.m_state);
+  }
+
+  inline future<T> get_future() {
+    check_valid();
+    return detail::future_access::make(m_state);
+  }
+
+  template <class... Us>
+  void set_value(Us&&... value) {
+    check_valid();
+    m_state->set_value(std::forward<Us>(value)...);
+  }
+
+  inline void set_exception(std::exception_ptr ptr) {
+    check_valid();
+    m_state->set_exception(ptr);
+  }
+
+ private:
+  inline void check_valid() const {
+    if (!m_state) {
+      throw future_error(future_errc::no_state);
+    }
+  }
+
+  detail::shared_state<T>* m_state;
+};
+
+/**
+ * @brief C++11 compliant implementation of packaged_task
+ * @see   <a href="http://en.cppreference.com/w/cpp/thread/packaged_task">
+ *          std::packaged_task
+ *        </a>
+ */
+template <class Signature>
+class packaged_task;
+
+template <class R, class... Args>
+class packaged_task<R(Args...)> {
+ public:
+  inline packaged_task() noexcept : m_state{nullptr} {}
+  template <class F,
+            class = typename std::enable_if<!std::is_same<
+              typename std::decay<F>::type, packaged_task>::value>::type>
+  explicit packaged_task(F&& f)
+      : m_func(std::forward<F>(f)),
+        m_state{detail::make_state<detail::shared_state<R>>()} {
+    // nop
+  }
+  inline packaged_task(packaged_task&& other) noexcept
+      : m_func(std::move(other.m_func)), m_state{other.m_state} {
+    other.m_state = nullptr;
+  }
+  inline ~packaged_task() {
+    if (m_state) {
+      m_state->abandon();
+    }
+  }
+  packaged_task(const packaged_task&) = delete;
+  packaged_task& operator=(const packaged_task&) = delete;
+  inline packaged_task& operator=(packaged_task&& other) noexcept {
+    packaged_task tmp(std::move(other));
+    swap(tmp);
+    return *this;
+  }
+
+  inline bool valid() const noexcept { return m_state != nullptr; }
+
+  inline void swap(packaged_task& other) noexcept {
+    std::swap(m_func, other.m_func);
+    std::swap(m_state, other.m_state);
+  }
+
+  inline future<R> get_future() {
+    check_valid();
+    return detail::future_access::make(m_state);
+  }
+
+  void operator()(Args... args) {
+    check_valid();
+    detail::state_setter<R>::run(m_state, m_func, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Abandons the current state and creates a new one
+   */
+  inline void reset() {
+    check_valid();
+    packaged_task tmp(std::move(m_func));
+    swap(tmp);
+  }
+
+ private:
+  inline void check_valid() const {
+    if (!m_state) {
+      throw future_error(future_errc::no_state);
+    }
+  }
+
+  std::function<R(Args...)> m_func;
+  detail::shared_state<R>* m_state;
+};
+
+/**
+ * @brief Runs `f(args...)` in a new riot::thread (launch::async) or in the
+ *        thread calling get() or wait() on the result (launch::deferred)
+ */
+template <class F, class... Args>
+future<typename std::result_of<typename std::decay<F>::type(
+  typename std::decay<Args>::type...)>::type>
+async(launch policy, F&& f, Args&&... args) {
+  using result = typename std::result_of<typename std::decay<F>::type(
+    typename std::decay<Args>::type...)>::type;
+  if (policy == launch::deferred) {
+    using tuple = std::tuple<typename std::decay<F>::type,
+                             typename std::decay<Args>::type...>;
+    auto s = detail::make_state<detail::deferred_state<result, tuple>>(
+      std::forward<F>(f), std::forward<Args>(args)...);
+    auto res = detail::future_access::make<result>(s);
+    s->release();
+    return res;
+  }
+  // the reference from make_state is owned by the new thread
+  auto s = detail::make_state<detail::shared_state<result>>();
+  auto res = detail::future_access::make(s);
+  try {
+    thread t([s](typename std::decay<F>::type& f,
+                 typename std::decay<Args>::type&... args) {
+      detail::state_setter<result>::run(s, f, args...);
+      s->release();
+    }, std::forward<F>(f), std::forward<Args>(args)...);
+    t.detach();
+  }
+  catch (...) {
+    s->release();
+    throw;
+  }
+  return res;
+}
+
+/**
+ * @brief Runs `f(args...)` in a new riot::thread
+ */
+template <class F, class... Args,
+          class = typename std::enable_if<
+            !std::is_same<typename std::decay<F>::type, launch>::value
+            && !std::is_same<typename std::decay<F>::type,
+                             thread_pool>::value>::type>
+future<typename std::result_of<typename std::decay<F>::type(
+  typename std::decay<Args>::type...)>::type>
+async(F&& f, Args&&... args) {
+  return async(launch::async, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Runs `f(args...)` on one of the workers of `pool`
+ */
+template <class F, class... Args>
+future<typename std::result_of<typename std::decay<F>::type(
+  typename std::decay<Args>::type...)>::type>
+async(thread_pool& pool, F&& f, Args&&... args) {
+  using result = typename std::result_of<typename std::decay<F>::type(
+    typename std::decay<Args>::type...)>::type;
+  // the reference from make_state is owned by the task
+  auto s = detail::make_state<detail::shared_state<result>>();
+  auto res = detail::future_access::make(s);
+  try {
+    pool.submit([s](typename std::decay<F>::type& f,
+                    typename std::decay<Args>::type&... args) {
+      detail::state_setter<result>::run(s, f, args...);
+      s->release();
+    }, std::forward<F>(f), std::forward<Args>(args)...);
+  }
+  catch (...) {
+    s->release();
+    throw;
+  }
+  return res;
+}
+
+} // namespace riot
+
+#endif // RIOT_FUTURE_HPP
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   Lock-free bounded multiple producer, single consumer queue
+ *
+ * @}
+ */
+
+#ifndef RIOT_MPSC_QUEUE_HPP
+#define RIOT_MPSC_QUEUE_HPP
+
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "riot/mutex.hpp"
+#include "riot/condition_variable.hpp"
+
+#include "riot/detail/queue_util.hpp"
+
+namespace riot {
+
+/**
+ * @brief Bounded queue of `N` elements of type `T` for any number of
+ *        producers and one consumer
+ *
+ * Every slot carries a sequence number that tells whether it is free, being
+ * written or ready to be read, so producers only contend on claiming a
+ * position with a compare-and-swap. Elements become visible to the consumer
+ * in the order their positions were claimed.
+ *
+ * Producers may be interrupt service routines as long as they only use the
+ * non-blocking try_* functions. Producers that block in push() wait on a
+ * riot::condition_variable, so the consumer has to be a thread. The
+ * blocking pop functions can be woken up from interrupt context.
+ *
+ * @tparam T  element type, may be move-only
+ * @tparam N  capacity, has to be a power of two
+ */
+template <class T, size_t N>
+class mpsc_queue {
+  static_assert(detail::is_pow2(N), "Capacity has to be a power of two.");
+
+ public:
+  mpsc_queue() noexcept : m_enqueue_pos{0}, m_dequeue_pos{0}, m_blocked{0} {
+    for (size_t i = 0; i < N; ++i) {
+      m_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+  ~mpsc_queue() {
+    while (ready(m_dequeue_pos)) {
+      element(m_dequeue_pos)->~T();
+      ++m_dequeue_pos;
+    }
+  }
+
+  mpsc_queue(const mpsc_queue&) = delete;
+  mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+  static constexpr size_t capacity() noexcept { return N; }
+
+  /**
+   * @brief True if the next element is not ready, only meaningful for the
+   *        consumer
+   */
+  inline bool empty() const noexcept { return !ready(m_dequeue_pos); }
+
+  /**
+   * @brief Constructs an element in place at the end of the queue
+   *
+   * @return false if the queue is full
+   */
+  template <class... Ts>
+  bool try_emplace(Ts&&... args) {
+    size_t pos;
+    if (claim(1, pos) == 0) {
+      return false;
+    }
+    new (element(pos)) T(std::forward<Ts>(args)...);
+    publish(pos);
+    m_not_empty.notify();
+    return true;
+  }
+  inline bool try_push(const T& value) { return try_emplace(value); }
+  inline bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  /**
+   * @brief Moves as many elements of [first, last) into the queue as fit
+   *
+   * The positions for all elements are claimed at once, so the elements
+   * stay together.
+   *
+   * @return the number of elements moved
+   */
+  template <class ForwardIt>
+  size_t try_push(ForwardIt first, ForwardIt last) {
+    size_t wanted = 0;
+    for (auto it = first; it != last && wanted < N; ++it) {
+      ++wanted;
+    }
+    size_t pos;
+    size_t n = claim(wanted, pos);
+    for (size_t i = 0; i < n; ++i, ++first) {
+      new (element(pos + i)) T(std::move(*first));
+      publish(pos + i);
+    }
+    if (n > 0) {
+      m_not_empty.notify();
+    }
+    return n;
+  }
+
+  /**
+   * @brief Moves the first element to `out`
+   *
+   * @return false if the queue is empty
+   */
+  bool try_pop(T& out) { return try_pop(&out, 1) == 1; }
+
+  /**
+   * @brief Moves up to `max` elements to `out`
+   *
+   * @return the number of elements moved
+   */
+  template <class OutputIt>
+  size_t try_pop(OutputIt out, size_t max) {
+    size_t n = 0;
+    for (; n < max && ready(m_dequeue_pos); ++n, ++out) {
+      T* elem = element(m_dequeue_pos);
+      *out = std::move(*elem);
+      elem->~T();
+      // mark the slot free for the next round
+      m_slots[m_dequeue_pos & (N - 1)].seq.store(m_dequeue_pos + N,
+                                                 std::memory_order_release);
+      ++m_dequeue_pos;
+    }
+    // pairs with the increment in push(), either we see the blocked
+    // producer or it sees the freed slot
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (n > 0 && m_blocked.load() > 0) {
+      // a producer holds the mutex until it sleeps in wait()
+      { lock_guard<mutex> lk(m_mtx); }
+      m_not_full.notify_one();
+    }
+    return n;
+  }
+
+  /**
+   * @brief Waits for free space and moves `value` into the queue
+   */
+  void push(T&& value) {
+    if (try_push(std::move(value))) {
+      return;
+    }
+    unique_lock<mutex> lk(m_mtx);
+    ++m_blocked;
+    while (!try_push(std::move(value))) {
+      m_not_full.wait(lk);
+    }
+    --m_blocked;
+  }
+  inline void push(const T& value) { push(T(value)); }
+
+  /**
+   * @brief Waits for an element and moves it to `out`
+   */
+  void pop(T& out) {
+    m_not_empty.wait([this] { return !empty(); });
+    try_pop(out);
+  }
+
+  /**
+   * @brief Waits for at least one element and moves up to `max` elements to
+   *        `out`
+   *
+   * @return the number of elements moved
+   */
+  template <class OutputIt>
+  size_t pop(OutputIt out, size_t max) {
+    m_not_empty.wait([this] { return !empty(); });
+    return try_pop(out, max);
+  }
+
+ private:
+  struct slot {
+    std::atomic<size_t> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  inline T* element(size_t pos) noexcept {
+    return reinterpret_cast<T*>(&m_slots[pos & (N - 1)].storage);
+  }
+
+  inline bool ready(size_t pos) const noexcept {
+    return m_slots[pos & (N - 1)].seq.load(std::memory_order_acquire)
+           == pos + 1;
+  }
+
+  inline void publish(size_t pos) noexcept {
+    m_slots[pos & (N - 1)].seq.store(pos + 1, std::memory_order_release);
+  }
+
+  /**
+   * Claims up to `wanted` consecutive free positions, the first one is
+   * stored in `pos`. Slots are freed in order, so if the last one is free
+   * all are.
+   */
+  size_t claim(size_t wanted, size_t& pos) {
+    size_t n = wanted;
+    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (n > 0) {
+      size_t last = pos + n - 1;
+      size_t seq = m_slots[last & (N - 1)].seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - last);
+      if (diff < 0) {
+        // not yet freed by the consumer, try fewer
+        --n;
+        continue;
+      }
+      if (diff == 0
+          && m_enqueue_pos.compare_exchange_weak(pos, pos + n,
+                                                 std::memory_order_relaxed)) {
+        return n;
+      }
+      // another producer was faster, start over at the new position
+      pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      n = wanted;
+    }
+    return 0;
+  }
+
+  slot m_slots[N];
+  std::atomic<size_t> m_enqueue_pos;
+  // only accessed by the consumer
+  size_t m_dequeue_pos;
+  std::atomic<unsigned> m_blocked;
+  detail::single_waiter m_not_empty;
+  mutex m_mtx;
+  condition_variable m_not_full;
+};
+
+} // namespace riot
+
+#endif // RIOT_MPSC_QUEUE_HPP
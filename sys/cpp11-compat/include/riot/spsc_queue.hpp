@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   Lock-free bounded single producer, single consumer queue
+ *
+ * @}
+ */
+
+#ifndef RIOT_SPSC_QUEUE_HPP
+#define RIOT_SPSC_QUEUE_HPP
+
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "riot/detail/queue_util.hpp"
+
+namespace riot {
+
+/**
+ * @brief Bounded queue of `N` elements of type `T` for exactly one producer
+ *        and one consumer
+ *
+ * Elements are moved into and out of a fixed array, the queue never
+ * allocates. Either side may be an interrupt service routine as long as it
+ * only uses the non-blocking try_* functions. The blocking functions must
+ * be called from a thread, they can be woken up from interrupt context.
+ *
+ * @tparam T  element type, may be move-only
+ * @tparam N  capacity, has to be a power of two
+ */
+template <class T, size_t N>
+class spsc_queue {
+  static_assert(detail::is_pow2(N), "Capacity has to be a power of two.");
+
+ public:
+  inline spsc_queue() noexcept : m_head{0}, m_tail{0} {}
+  ~spsc_queue() {
+    size_t tail = m_tail.load(std::memory_order_acquire);
+    for (size_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i) {
+      slot(i)->~T();
+    }
+  }
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  static constexpr size_t capacity() noexcept { return N; }
+
+  inline size_t size() const noexcept {
+    return m_tail.load(std::memory_order_acquire)
+           - m_head.load(std::memory_order_acquire);
+  }
+  inline bool empty() const noexcept { return size() == 0; }
+  inline bool full() const noexcept { return size() == N; }
+
+  /**
+   * @brief Constructs an element in place at the end of the queue
+   *
+   * @return false if the queue is full
+   */
+  template <class... Ts>
+  bool try_emplace(Ts&&... args) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == N) {
+      return false;
+    }
+    new (slot(tail)) T(std::forward<Ts>(args)...);
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_not_empty.notify();
+    return true;
+  }
+  inline bool try_push(const T& value) { return try_emplace(value); }
+  inline bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  /**
+   * @brief Moves as many elements of [first, last) into the queue as fit
+   *
+   * @return the number of elements moved
+   */
+  template <class InputIt>
+  size_t try_push(InputIt first, InputIt last) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t free = N - (tail - m_head.load(std::memory_order_acquire));
+    size_t n = 0;
+    for (; first != last && n < free; ++first, ++n) {
+      new (slot(tail + n)) T(std::move(*first));
+    }
+    if (n > 0) {
+      // publish all elements at once
+      m_tail.store(tail + n, std::memory_order_release);
+      m_not_empty.notify();
+    }
+    return n;
+  }
+
+  /**
+   * @brief Moves the first element to `out`
+   *
+   * @return false if the queue is empty
+   */
+  bool try_pop(T& out) { return try_pop(&out, 1) == 1; }
+
+  /**
+   * @brief Moves up to `max` elements to `out`
+   *
+   * @return the number of elements moved
+   */
+  template <class OutputIt>
+  size_t try_pop(OutputIt out, size_t max) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t used = m_tail.load(std::memory_order_acquire) - head;
+    size_t n = 0;
+    for (; n < used && n < max; ++n, ++out) {
+      T* elem = slot(head + n);
+      *out = std::move(*elem);
+      elem->~T();
+    }
+    if (n > 0) {
+      m_head.store(head + n, std::memory_order_release);
+      m_not_full.notify();
+    }
+    return n;
+  }
+
+  /**
+   * @brief Waits for free space and moves `value` into the queue
+   */
+  void push(T&& value) {
+    m_not_full.wait([this] { return !full(); });
+    try_emplace(std::move(value));
+  }
+  inline void push(const T& value) { push(T(value)); }
+
+  /**
+   * @brief Waits for an element and moves it to `out`
+   */
+  void pop(T& out) {
+    m_not_empty.wait([this] { return !empty(); });
+    try_pop(out);
+  }
+
+  /**
+   * @brief Waits for at least one element and moves up to `max` elements to
+   *        `out`
+   *
+   * @return the number of elements moved
+   */
+  template <class OutputIt>
+  size_t pop(OutputIt out, size_t max) {
+    m_not_empty.wait([this] { return !empty(); });
+    return try_pop(out, max);
+  }
+
+ private:
+  inline T* slot(size_t pos) noexcept {
+    return reinterpret_cast<T*>(&m_slots[pos & (N - 1)]);
+  }
+
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type m_slots[N];
+  // m_head is only written by the consumer, m_tail by the producer
+  std::atomic<size_t> m_head;
+  std::atomic<size_t> m_tail;
+  detail::single_waiter m_not_empty;
+  detail::single_waiter m_not_full;
+};
+
+} // namespace riot
+
+#endif // RIOT_SPSC_QUEUE_HPP
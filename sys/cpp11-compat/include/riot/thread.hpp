@@ -27,6 +27,7 @@
 #include "time.h"
 #include "thread.h"
 #include "kernel_internal.h"
+#include "attributes.h"
 
 #include <tuple>
 #include <atomic>
@@ -35,6 +36,8 @@
 #include <exception>
 #include <stdexcept>
 #include <functional>
+#include <new>
+#include <system_error>
 #include <type_traits>
 
 #include "riot/mutex.hpp"
@@ -47,18 +50,59 @@ namespace riot {
 
 namespace {
 constexpr kernel_pid_t thread_uninitialized = -1;
-constexpr size_t stack_size = THREAD_STACKSIZE_MAIN;
 }
 
+/**
+ * @brief Maximum number of unused thread stacks kept for reuse
+ */
+#ifndef RIOT_THREAD_STACK_POOL_SIZE
+#define RIOT_THREAD_STACK_POOL_SIZE (4)
+#endif
+
+/**
+ * @brief Header of a heap block holding the stack of a thread
+ *
+ * The block is allocated as one piece of memory: this header followed by
+ * `stack_size` bytes of stack. The function and arguments of the thread are
+ * constructed at the start of the stack region, the rest is passed to
+ * thread_create(). Blocks are recycled by the stack pool once the thread
+ * finished and its riot::thread was joined or detached.
+ */
 struct thread_data {
-  thread_data() : ref_count{2}, joining_thread{thread_uninitialized} {
+  thread_data(size_t size)
+      : ref_count{2}, joining_thread{thread_uninitialized}, finished{false},
+        stack_size{size}, next{nullptr} {
     // nop
   }
+  inline char* stack() noexcept { return reinterpret_cast<char*>(this + 1); }
   std::atomic<unsigned> ref_count;
   kernel_pid_t joining_thread;
-  char stack[stack_size];
+  bool finished;
+  size_t stack_size;
+  thread_data* next;
 };
 
+namespace detail {
+
+/**
+ * Takes a block with at least `stack_size` bytes of stack from the pool or
+ * allocates a new one.
+ */
+thread_data* stack_pool_acquire(size_t stack_size);
+
+/**
+ * Returns a block that is no longer referenced to the pool.
+ */
+void stack_pool_release(thread_data* ptr) noexcept;
+
+/**
+ * Wakes up a joining thread, drops the reference of the running thread on
+ * `ptr` and ends the thread.
+ */
+NORETURN void thread_exit(thread_data* ptr) noexcept;
+
+} // namespace detail
+
 /**
  * This deleter prevents our thread data from being destroyed if the thread
  * object is destroyed before the thread had a chance to run
@@ -66,11 +110,52 @@ struct thread_data {
 struct thread_data_deleter {
   void operator()(thread_data* ptr) {
     if (--ptr->ref_count == 0) {
-      delete ptr;
+      detail::stack_pool_release(ptr);
     }
   }
 };
 
+/**
+ * @brief Stack size, priority and name of a thread created by riot::thread
+ *
+ * The setters return the object itself, so they can be chained:
+ * @code
+ * riot::thread t(riot::thread_attributes{}.stack_size(512).priority(5), f);
+ * @endcode
+ */
+class thread_attributes {
+ public:
+  inline thread_attributes() noexcept
+      : m_stack_size{THREAD_STACKSIZE_MAIN},
+        m_priority{THREAD_PRIORITY_MAIN - 1},
+        m_name{"riot_cpp_thread"} {
+    // nop
+  }
+
+  inline thread_attributes& stack_size(size_t size) noexcept {
+    m_stack_size = size;
+    return *this;
+  }
+  inline size_t stack_size() const noexcept { return m_stack_size; }
+
+  inline thread_attributes& priority(uint8_t prio) noexcept {
+    m_priority = prio;
+    return *this;
+  }
+  inline uint8_t priority() const noexcept { return m_priority; }
+
+  inline thread_attributes& name(const char* name) noexcept {
+    m_name = name;
+    return *this;
+  }
+  inline const char* name() const noexcept { return m_name; }
+
+ private:
+  size_t m_stack_size;
+  uint8_t m_priority;
+  const char* m_name;
+};
+
 /**
  * @brief implementation of thread::id
  * @see   <a href="http://en.cppreference.com/w/cpp/thread/thread/id">
@@ -163,8 +248,16 @@ class thread {
   using native_handle_type = kernel_pid_t;
 
   inline thread() noexcept : m_handle{thread_uninitialized} {}
+  template <class F, class... Args,
+            class = typename std::enable_if<!std::is_same<
+              typename std::decay<F>::type, thread_attributes>::value>::type>
+  explicit thread(F&& f, Args&&... args)
+      : thread(thread_attributes{}, std::forward<F>(f),
+               std::forward<Args>(args)...) {
+    // nop
+  }
   template <class F, class... Args>
-  explicit thread(F&& f, Args&&... args);
+  thread(const thread_attributes& attr, F&& f, Args&&... args);
   ~thread();
 
   thread(const thread&) = delete;
@@ -198,41 +291,57 @@ void swap(thread& lhs, thread& rhs) noexcept;
 
 template <class Tuple>
 void* thread_proxy(void* vp) {
-  { // without this scope, the objects here are not cleaned up corrctly
-    std::unique_ptr<Tuple> p(static_cast<Tuple*>(vp));
-    auto tmp = std::get<0>(*p);
-    std::unique_ptr<thread_data, thread_data_deleter> data{tmp};
-    // create indices for the arguments, 0 is thread_data and 1 is the function
-    auto indices = detail::get_indices<std::tuple_size<Tuple>::value, 2>();
-    try {
-      detail::apply_args(std::get<1>(*p), indices, *p);
-    }
-    catch (...) {
-      // nop
-    }
-    if (data->joining_thread != thread_uninitialized) {
-      thread_wakeup(data->joining_thread);
-    }
+  auto p = static_cast<Tuple*>(vp);
+  thread_data* data = std::get<0>(*p);
+  // create indices for the arguments, 0 is thread_data and 1 is the function
+  auto indices = detail::get_indices<std::tuple_size<Tuple>::value, 2>();
+  try {
+    detail::apply_args(std::get<1>(*p), indices, *p);
   }
-  // some riot cleanup code
-  sched_task_exit();
-  return nullptr;
+  catch (...) {
+    // nop
+  }
+  // the tuple lives on the stack block, destroy it before handing it back
+  p->~Tuple();
+  detail::thread_exit(data);
 }
 
 template <class F, class... Args>
-thread::thread(F&& f, Args&&... args)
-    : m_data{new thread_data} {
+thread::thread(const thread_attributes& attr, F&& f, Args&&... args)
+    : m_handle{thread_uninitialized} {
   using namespace std;
   using func_and_args = tuple
     <thread_data*, typename decay<F>::type, typename decay<Args>::type...>;
-  std::unique_ptr<func_and_args> p(
-    new func_and_args(m_data.get(), forward<F>(f), forward<Args>(args)...));
+  // the tuple is placed at the (aligned) start of the stack region
+  constexpr size_t align = alignof(func_and_args);
+  constexpr size_t offset
+    = (sizeof(thread_data) + align - 1) / align * align - sizeof(thread_data);
+  constexpr size_t used = offset + sizeof(func_and_args);
+  if (attr.stack_size() <= used + THREAD_STACKSIZE_MINIMUM) {
+    throw std::system_error(make_error_code(errc::invalid_argument),
+                            "Stack size too small.");
+  }
+  m_data.reset(detail::stack_pool_acquire(attr.stack_size()));
+  func_and_args* p;
+  try {
+    p = new (m_data->stack() + offset)
+      func_and_args(m_data.get(), forward<F>(f), forward<Args>(args)...);
+  }
+  catch (...) {
+    // the thread never ran, so drop its reference as well
+    --m_data->ref_count;
+    throw;
+  }
   m_handle = thread_create(
-    m_data->stack, stack_size, THREAD_PRIORITY_MAIN - 1, 0, // CREATE_WOUT_YIELD
-    &thread_proxy<func_and_args>, p.get(), "riot_cpp_thread");
-  if (m_handle >= 0) {
-    p.release();
-  } else {
+    m_data->stack() + used, m_data->stack_size - used, attr.priority(),
+    0, // CREATE_WOUT_YIELD
+    &thread_proxy<func_and_args>, p, attr.name());
+  if (m_handle < 0) {
+    p->~func_and_args();
+    // the thread never ran, so drop its reference as well
+    --m_data->ref_count;
+    m_data.reset();
+    m_handle = thread_uninitialized;
     throw std::system_error(
       std::make_error_code(std::errc::resource_unavailable_try_again),
         "Failed to create thread.");
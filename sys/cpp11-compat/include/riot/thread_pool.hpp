@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   Fixed size pool of worker threads
+ *
+ * @}
+ */
+
+#ifndef RIOT_THREAD_POOL_HPP
+#define RIOT_THREAD_POOL_HPP
+
+#include <list>
+#include <queue>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include "riot/mutex.hpp"
+#include "riot/thread.hpp"
+#include "riot/condition_variable.hpp"
+
+namespace riot {
+
+/**
+ * @brief Runs submitted tasks on a fixed number of worker threads
+ *
+ * The workers are created with the given attributes when the pool is
+ * constructed and live as long as the pool. The destructor runs all queued
+ * tasks before it joins the workers.
+ */
+class thread_pool {
+ public:
+  explicit thread_pool(size_t num_threads,
+                       const thread_attributes& attr = thread_attributes{});
+  ~thread_pool();
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /**
+   * @brief Queues `f(args...)` to be run by one of the workers
+   */
+  template <class F, class... Args>
+  void submit(F&& f, Args&&... args) {
+    push(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Blocks until all submitted tasks are done
+   */
+  void wait();
+
+  inline size_t size() const noexcept { return m_workers.size(); }
+
+ private:
+  void push(std::function<void()> task);
+  void run();
+  void stop();
+
+  mutex m_mtx;
+  condition_variable m_work;
+  condition_variable m_idle;
+  std::queue<std::function<void()>, std::list<std::function<void()>>> m_tasks;
+  unsigned m_busy;
+  bool m_stop;
+  std::vector<thread> m_workers;
+};
+
+} // namespace riot
+
+#endif // RIOT_THREAD_POOL_HPP
@@ -18,6 +18,8 @@
  * @}
  */
 
+#include "irq.h"
+#include "sched.h"
 #include "vtimer.h"
 
 #include <cerrno>
@@ -29,6 +31,81 @@ using namespace std;
 
 namespace riot {
 
+namespace detail {
+
+namespace {
+// unused stack blocks, only accessed with interrupts disabled
+thread_data* free_stacks = nullptr;
+unsigned free_stacks_num = 0;
+
+thread_data* pop_surplus() noexcept {
+  unsigned state = disableIRQ();
+  thread_data* res = nullptr;
+  if (free_stacks_num > RIOT_THREAD_STACK_POOL_SIZE) {
+    res = free_stacks;
+    free_stacks = res->next;
+    --free_stacks_num;
+  }
+  restoreIRQ(state);
+  return res;
+}
+
+void destroy(thread_data* ptr) noexcept {
+  ptr->~thread_data();
+  ::operator delete(ptr);
+}
+} // namespace <anonymous>
+
+thread_data* stack_pool_acquire(size_t stack_size) {
+  // exiting threads can not free their own stack, trim the pool here
+  while (thread_data* surplus = pop_surplus()) {
+    destroy(surplus);
+  }
+  unsigned state = disableIRQ();
+  for (thread_data** it = &free_stacks; *it; it = &(*it)->next) {
+    thread_data* res = *it;
+    if (res->stack_size >= stack_size) {
+      *it = res->next;
+      --free_stacks_num;
+      restoreIRQ(state);
+      size_t size = res->stack_size;
+      res->~thread_data();
+      return new (res) thread_data(size);
+    }
+  }
+  restoreIRQ(state);
+  void* mem = ::operator new(sizeof(thread_data) + stack_size);
+  return new (mem) thread_data(stack_size);
+}
+
+void stack_pool_release(thread_data* ptr) noexcept {
+  unsigned state = disableIRQ();
+  ptr->next = free_stacks;
+  free_stacks = ptr;
+  ++free_stacks_num;
+  restoreIRQ(state);
+  if (thread_data* surplus = pop_surplus()) {
+    destroy(surplus);
+  }
+}
+
+void thread_exit(thread_data* ptr) noexcept {
+  // interrupts stay disabled, so nobody can reuse this stack before we left it
+  (void) disableIRQ();
+  ptr->finished = true;
+  if (ptr->joining_thread != thread_uninitialized) {
+    sched_set_status((tcb_t*) thread_get(ptr->joining_thread), STATUS_PENDING);
+  }
+  if (--ptr->ref_count == 0) {
+    ptr->next = free_stacks;
+    free_stacks = ptr;
+    ++free_stacks_num;
+  }
+  sched_task_exit();
+}
+
+} // namespace detail
+
 thread::~thread() {
   if (joinable()) {
     terminate();
@@ -41,12 +118,18 @@ void thread::join() {
                        "Joining this leads to a deadlock.");
   }
   if (joinable()) {
-    auto status = thread_getstatus(m_handle);
-    if (status != STATUS_NOT_FOUND && status != STATUS_STOPPED) {
+    unsigned state = disableIRQ();
+    if (!m_data->finished) {
       m_data->joining_thread = sched_active_pid;
-      thread_sleep();
+      sched_set_status((tcb_t*) sched_active_thread, STATUS_SLEEPING);
+      restoreIRQ(state);
+      thread_yield_higher();
+    } else {
+      restoreIRQ(state);
     }
     m_handle = thread_uninitialized;
+    // hand the stack back to the pool
+    m_data.reset();
   } else {
     throw system_error(make_error_code(errc::invalid_argument),
                        "Can not join an unjoinable thread.");
@@ -57,6 +140,8 @@ void thread::join() {
 void thread::detach() {
   if (joinable()) {
     m_handle = thread_uninitialized;
+    // the thread returns its stack to the pool when it ends
+    m_data.reset();
   } else {
     throw system_error(make_error_code(errc::invalid_argument),
                        "Can not detach an unjoinable thread.");
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   Fixed size pool of worker threads
+ *
+ * @}
+ */
+
+#include "riot/thread_pool.hpp"
+
+using namespace std;
+
+namespace riot {
+
+thread_pool::thread_pool(size_t num_threads, const thread_attributes& attr)
+    : m_busy{0}, m_stop{false} {
+  m_workers.reserve(num_threads);
+  try {
+    for (size_t i = 0; i < num_threads; ++i) {
+      m_workers.emplace_back(attr, [this] { run(); });
+    }
+  }
+  catch (...) {
+    stop();
+    throw;
+  }
+}
+
+thread_pool::~thread_pool() { stop(); }
+
+void thread_pool::stop() {
+  {
+    lock_guard<mutex> lk(m_mtx);
+    m_stop = true;
+  }
+  m_work.notify_all();
+  for (auto& t : m_workers) {
+    t.join();
+  }
+}
+
+void thread_pool::wait() {
+  unique_lock<mutex> lk(m_mtx);
+  m_idle.wait(lk, [this] { return m_tasks.empty() && m_busy == 0; });
+}
+
+void thread_pool::push(function<void()> task) {
+  {
+    lock_guard<mutex> lk(m_mtx);
+    m_tasks.push(move(task));
+  }
+  m_work.notify_one();
+}
+
+void thread_pool::run() {
+  unique_lock<mutex> lk(m_mtx);
+  while (true) {
+    m_work.wait(lk, [this] { return m_stop || !m_tasks.empty(); });
+    if (m_tasks.empty()) {
+      // m_stop is set and nothing is left to do
+      return;
+    }
+    auto task = move(m_tasks.front());
+    m_tasks.pop();
+    ++m_busy;
+    lk.unlock();
+    try {
+      task();
+    }
+    catch (...) {
+      // nop
+    }
+    lk.lock();
+    --m_busy;
+    if (m_tasks.empty() && m_busy == 0) {
+      m_idle.notify_all();
+    }
+  }
+}
+
+} // namespace riot
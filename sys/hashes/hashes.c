@@ -111,6 +111,18 @@ uint32_t one_at_a_time_hash(const uint8_t *buf, size_t len)
     return hash;
 }
 
+uint64_t fnv1a_64_hash(const uint8_t *buf, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ull; /* offset basis */
+
+    for (size_t i = 0; i < len; i++) {
+        hash ^= buf[i];
+        hash *= 0x100000001b3ull;   /* FNV prime */
+    }
+
+    return hash;
+}
+
 uint16_t fletcher16(const uint8_t *data, size_t bytes)
 {
     uint16_t sum1 = 0xff, sum2 = 0xff;
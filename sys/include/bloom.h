@@ -228,6 +228,157 @@ void bloom_add(bloom_t *bloom, const uint8_t *buf, size_t len);
  */
 bool bloom_check(bloom_t *bloom, const uint8_t *buf, size_t len);
 
+/**
+ * @brief 64 bit hash function of the blocked and counting filters
+ */
+typedef uint64_t (*hashfp64_t)(const uint8_t *, size_t len);
+
+#ifndef BLOOM_BLOCK_BITS
+/**
+ * @brief Number of bits in a block of a @ref bloom_blocked_t, must be a
+ *        power of 2
+ *
+ * One block should fit into a cache line (or a few bus words on MCUs
+ * without cache).
+ */
+#define BLOOM_BLOCK_BITS    (512U)
+#endif
+
+/**
+ * @brief Blocked Bloom filter
+ *
+ * All k bits of an element are set within a single block that is selected
+ * by the hash. The k bit indices are derived from a single 64 bit hash by
+ * double hashing (g_i = h1 + i * h2), so every operation hashes the
+ * element once and touches one block only. This costs a slightly higher
+ * false positive rate than bloom_t for the same number of bits.
+ */
+typedef struct {
+    /** number of blocks in the bloom array */
+    size_t blocks;
+    /** number of bits set per element */
+    size_t k;
+    /** the bloom array */
+    uint8_t *a;
+    /** the hash function */
+    hashfp64_t hash;
+} bloom_blocked_t;
+
+/**
+ * @brief Initialize a blocked Bloom filter.
+ * @param bloom             bloom_blocked_t to initialize
+ * @param size              size of the bloom filter in bits, rounded down to
+ *                          a multiple of BLOOM_BLOCK_BITS
+ * @param bitfield          underlying bitfield of the bloom filter
+ * @param hash              64 bit hash function, e.g. fnv1a_64_hash()
+ * @param k                 number of bits set per element
+ * @pre     @p size MUST be at least BLOOM_BLOCK_BITS.
+ * @pre     @p bitfield MUST be large enough to hold @p size bits and MUST be
+ *          zeroed.
+ */
+void bloom_blocked_init(bloom_blocked_t *bloom, size_t size, uint8_t *bitfield,
+                        hashfp64_t hash, size_t k);
+
+/**
+ * @brief Delete a blocked Bloom filter.
+ * @param bloom The condemned
+ */
+void bloom_blocked_del(bloom_blocked_t *bloom);
+
+/**
+ * @brief Add a string to a blocked Bloom filter.
+ * @param bloom  Bloom filter
+ * @param buf    string to add
+ * @param len    the length of the string @p buf
+ */
+void bloom_blocked_add(bloom_blocked_t *bloom, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Determine if a string is in a blocked Bloom filter.
+ * @param bloom  Bloom filter
+ * @param buf    string to check
+ * @param len    the length of the string @p buf
+ * @return       false if string does not exist in the filter
+ * @return       true if string is may be in the filter
+ */
+bool bloom_blocked_check(bloom_blocked_t *bloom, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Number of bytes needed for a counting Bloom filter of @p size
+ *        counters
+ */
+#define BLOOM_COUNTING_BYTES(size)  (((size) + 1) / 2)
+
+/**
+ * @brief Counting Bloom filter
+ *
+ * Uses 4 bit counters instead of bits, so elements can be removed again.
+ * Counters saturate at 15 and are never decremented from there, this keeps
+ * the filter free of false negatives. Indices are derived from a single 64
+ * bit hash by double hashing, like for bloom_blocked_t.
+ */
+typedef struct {
+    /** number of counters */
+    size_t m;
+    /** number of counters per element */
+    size_t k;
+    /** the counters, two per byte */
+    uint8_t *c;
+    /** the hash function */
+    hashfp64_t hash;
+} bloom_counting_t;
+
+/**
+ * @brief Initialize a counting Bloom filter.
+ * @param bloom             bloom_counting_t to initialize
+ * @param size              number of counters
+ * @param counters          underlying counter array
+ * @param hash              64 bit hash function, e.g. fnv1a_64_hash()
+ * @param k                 number of counters per element
+ * @pre     @p counters MUST hold BLOOM_COUNTING_BYTES(@p size) bytes and MUST
+ *          be zeroed.
+ */
+void bloom_counting_init(bloom_counting_t *bloom, size_t size, uint8_t *counters,
+                         hashfp64_t hash, size_t k);
+
+/**
+ * @brief Delete a counting Bloom filter.
+ * @param bloom The condemned
+ */
+void bloom_counting_del(bloom_counting_t *bloom);
+
+/**
+ * @brief Add a string to a counting Bloom filter.
+ * @param bloom  Bloom filter
+ * @param buf    string to add
+ * @param len    the length of the string @p buf
+ */
+void bloom_counting_add(bloom_counting_t *bloom, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Remove a string from a counting Bloom filter.
+ *
+ * Removing a string that was never added may remove other strings as well,
+ * unless the filter can tell that the string is not in it.
+ *
+ * @param bloom  Bloom filter
+ * @param buf    string to remove
+ * @param len    the length of the string @p buf
+ * @return       false if string does not exist in the filter (nothing changed)
+ * @return       true if string was removed
+ */
+bool bloom_counting_remove(bloom_counting_t *bloom, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Determine if a string is in a counting Bloom filter.
+ * @param bloom  Bloom filter
+ * @param buf    string to check
+ * @param len    the length of the string @p buf
+ * @return       false if string does not exist in the filter
+ * @return       true if string is may be in the filter
+ */
+bool bloom_counting_check(bloom_counting_t *bloom, const uint8_t *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -94,6 +94,22 @@
  * -  24-31: (Reserved)      - No support
  * - 32-255: (Unassigned)    - No support
  *
+ * @par Streaming writer and pull parser
+ * Besides the offset based API operating on a single contiguous
+ * @ref cbor_stream_t there is
+ * - a streaming writer (@ref cbor_writer_t) that emits CBOR into a chain of
+ *   memory chunks which are requested on demand (e.g. packet buffer snips,
+ *   cf. cbor_pktbuf_writer_init()), so data can be serialized directly into
+ *   its final location, and
+ * - a pull parser (@ref cbor_reader_t) that walks the encoded items and
+ *   returns borrowed pointers to byte and text strings instead of copying
+ *   them out.
+ *
+ * @par Struct serialization
+ * Structs can be described once by a static table of field descriptors
+ * (@ref cbor_schema_t) and are then serialized as a map keyed by the member
+ * names with cbor_serialize_struct() and cbor_deserialize_struct().
+ *
  * @todo API for Indefinite-Length Byte Strings and Text Strings
  *       (see https://tools.ietf.org/html/rfc7049#section-2.2.2)
  */
@@ -107,6 +123,7 @@
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -114,6 +131,10 @@
 #include <time.h>
 #endif /* CBOR_NO_CTIME */
 
+#ifdef MODULE_GNRC_PKTBUF
+#include "net/gnrc/pktbuf.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -642,6 +663,460 @@ bool cbor_at_break(const cbor_stream_t *stream, size_t offset);
  */
 bool cbor_at_end(const cbor_stream_t *stream, size_t offset);
 
+/**
+ * @brief Streaming writer forward declaration
+ */
+typedef struct cbor_writer_t cbor_writer_t;
+
+/**
+ * @brief Callback to request the next chunk of memory for a @ref cbor_writer_t
+ *
+ * Called when the current chunk is full and more data needs to be written.
+ * While called, cbor_writer_t::data and cbor_writer_t::pos still describe the
+ * (full) current chunk. The callback must set cbor_writer_t::data and
+ * cbor_writer_t::size to the new chunk and must not touch any other member.
+ *
+ * @param[in, out] writer   The writer requesting memory
+ *
+ * @return 0 on success
+ * @return negative value if no more memory is available
+ *
+ * @note An empty chunk is treated like an error.
+ */
+typedef int (*cbor_writer_next_chunk_t)(cbor_writer_t *writer);
+
+/**
+ * @brief Streaming CBOR writer
+ *
+ * Writes CBOR items into a chain of memory chunks. Items may span chunk
+ * borders.
+ *
+ * @code
+ * cbor_writer_t writer;
+ * cbor_writer_init(&writer, buffer, sizeof(buffer), NULL, NULL);
+ * cbor_write_map(&writer, 1);
+ * cbor_write_unicode_string(&writer, "temp", 4);
+ * cbor_write_int64_t(&writer, 23);
+ * @endcode
+ *
+ * @note If a write function fails (returns 0) the data written so far is
+ *       incomplete and must be discarded.
+ */
+struct cbor_writer_t {
+    unsigned char *data;                /**< current chunk */
+    size_t size;                        /**< size of the current chunk */
+    size_t pos;                         /**< index of the next free byte in the current chunk */
+    size_t total;                       /**< number of bytes written into previous chunks */
+    cbor_writer_next_chunk_t next_chunk;/**< chunk request callback, may be NULL */
+    void *arg;                          /**< user defined argument for @p next_chunk */
+};
+
+/**
+ * @brief Initialize a streaming writer
+ *
+ * @param[out] writer       The writer to initialize
+ * @param[in] buffer        The first chunk, may be NULL if @p next_chunk is given
+ * @param[in] size          Size of @p buffer
+ * @param[in] next_chunk    Callback to request further chunks, NULL to
+ *                          only use @p buffer
+ * @param[in] arg           User defined argument, stored in cbor_writer_t::arg
+ */
+void cbor_writer_init(cbor_writer_t *writer, unsigned char *buffer, size_t size,
+                      cbor_writer_next_chunk_t next_chunk, void *arg);
+
+/**
+ * @brief Get the total number of bytes written by @p writer
+ *
+ * @param[in] writer    The writer
+ *
+ * @return Number of bytes written over all chunks
+ */
+static inline size_t cbor_writer_len(const cbor_writer_t *writer)
+{
+    return writer->total + writer->pos;
+}
+
+/**
+ * @brief Write an unsigned 64 bit value
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] val           The value to write
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_uint64_t(cbor_writer_t *writer, uint64_t val);
+
+/**
+ * @brief Write a signed 64 bit value
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] val           The value to write
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_int64_t(cbor_writer_t *writer, int64_t val);
+
+/**
+ * @brief Write a boolean value
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] val           The value to write
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_bool(cbor_writer_t *writer, bool val);
+
+#ifndef CBOR_NO_FLOAT
+/**
+ * @brief Write a single precision floating point value
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] val           The value to write
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_float(cbor_writer_t *writer, float val);
+#endif /* CBOR_NO_FLOAT */
+
+/**
+ * @brief Write a byte string
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] val           The bytes to write
+ * @param[in] length        Number of bytes in @p val
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_byte_string(cbor_writer_t *writer, const void *val, size_t length);
+
+/**
+ * @brief Write a unicode (text) string
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] val           The string to write
+ * @param[in] length        Length of @p val in bytes
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_unicode_string(cbor_writer_t *writer, const char *val, size_t length);
+
+/**
+ * @brief Write the head of an array of length @p array_length
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] array_length  Number of items that follow
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_array(cbor_writer_t *writer, size_t array_length);
+
+/**
+ * @brief Write the head of a map of length @p map_length
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] map_length    Number of key/value pairs that follow
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_map(cbor_writer_t *writer, size_t map_length);
+
+/**
+ * @brief Write the head of an array of indefinite length
+ *
+ * Terminate the array with cbor_write_stream_break().
+ *
+ * @param[in, out] writer   The writer
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_array_indefinite(cbor_writer_t *writer);
+
+/**
+ * @brief Write the head of a map of indefinite length
+ *
+ * Terminate the map with cbor_write_stream_break().
+ *
+ * @param[in, out] writer   The writer
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_map_indefinite(cbor_writer_t *writer);
+
+/**
+ * @brief Write a semantic tag
+ *
+ * @param[in, out] writer   The writer
+ * @param[in] tag           The tag to write
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_stream_tag(cbor_writer_t *writer, uint64_t tag);
+
+/**
+ * @brief Write a break symbol to terminate an indefinite length item
+ *
+ * @param[in, out] writer   The writer
+ *
+ * @return Number of bytes written, 0 on error
+ */
+size_t cbor_write_stream_break(cbor_writer_t *writer);
+
+#ifdef MODULE_GNRC_PKTBUF
+/**
+ * @brief Streaming writer emitting into packet buffer snips
+ */
+typedef struct {
+    cbor_writer_t writer;               /**< the writer to pass to cbor_write_*() */
+    gnrc_pktsnip_t *head;               /**< first snip of the written data */
+    gnrc_pktsnip_t *tail;               /**< snip currently written to */
+    size_t chunk_size;                  /**< size of each allocated snip */
+} cbor_pktbuf_writer_t;
+
+/**
+ * @brief Initialize a writer that emits directly into packet buffer snips
+ *
+ * Snips of @p chunk_size bytes are allocated on demand and chained via
+ * gnrc_pktsnip_t::next in the order the data was written, so the result can
+ * be used as payload of an outgoing packet without further copying.
+ *
+ * @param[out] pw           The packet buffer writer to initialize
+ * @param[in] chunk_size    Size of each snip
+ *
+ * @return 0 on success
+ * @return -EINVAL if @p chunk_size is 0
+ * @return -ENOMEM if the first snip could not be allocated
+ */
+int cbor_pktbuf_writer_init(cbor_pktbuf_writer_t *pw, size_t chunk_size);
+
+/**
+ * @brief Finish writing and shrink the last snip to the written data
+ *
+ * @param[in, out] pw   The packet buffer writer
+ *
+ * @return The chain of snips containing the CBOR data
+ * @return NULL if no data was written
+ */
+gnrc_pktsnip_t *cbor_pktbuf_writer_finish(cbor_pktbuf_writer_t *pw);
+#endif /* MODULE_GNRC_PKTBUF */
+
+/**
+ * @brief Types of items returned by the pull parser
+ */
+typedef enum {
+    CBOR_ITEM_UINT,             /**< unsigned integer, value.uint */
+    CBOR_ITEM_NEGINT,           /**< negative integer, value.sint */
+    CBOR_ITEM_BYTES,            /**< byte string, value.str */
+    CBOR_ITEM_TEXT,             /**< text string, value.str */
+    CBOR_ITEM_ARRAY,            /**< array head, value.uint holds the length */
+    CBOR_ITEM_MAP,              /**< map head, value.uint holds the number of pairs */
+    CBOR_ITEM_TAG,              /**< semantic tag, value.uint holds the tag */
+    CBOR_ITEM_BOOL,             /**< boolean, value.boolean */
+    CBOR_ITEM_NULL,             /**< null */
+    CBOR_ITEM_UNDEFINED,        /**< undefined */
+    CBOR_ITEM_FLOAT,            /**< floating point number, value.fp */
+    CBOR_ITEM_BREAK,            /**< end of an indefinite length item */
+} cbor_item_type_t;
+
+/**
+ * @brief A CBOR item as returned by the pull parser
+ *
+ * Strings are not copied: value.str points into the parsed buffer
+ * and is only valid as long as the buffer is.
+ */
+typedef struct {
+    cbor_item_type_t type;      /**< type of the item */
+    bool indefinite;            /**< item has indefinite length */
+    union {
+        uint64_t uint;          /**< value of unsigned integers, lengths and tags */
+        int64_t sint;           /**< value of negative integers */
+        bool boolean;           /**< value of booleans */
+#ifndef CBOR_NO_FLOAT
+        double fp;              /**< value of floating point numbers */
+#endif
+        struct {
+            const unsigned char *ptr;   /**< borrowed pointer to the string data */
+            size_t len;                 /**< length of the string in bytes */
+        } str;                  /**< value of byte and text strings */
+    } value;                    /**< value of the item, depending on @p type */
+} cbor_item_t;
+
+/**
+ * @brief Pull parser (cursor) over CBOR encoded data
+ *
+ * @code
+ * cbor_reader_t reader;
+ * cbor_item_t item;
+ * cbor_reader_init(&reader, pkt->data, pkt->size);
+ * while (cbor_read_next(&reader, &item)) {
+ *     ...
+ * }
+ * @endcode
+ */
+typedef struct {
+    const unsigned char *data;  /**< the encoded data */
+    size_t size;                /**< size of @p data */
+    size_t pos;                 /**< offset of the next item */
+} cbor_reader_t;
+
+/**
+ * @brief Initialize a pull parser
+ *
+ * @param[out] reader   The reader to initialize
+ * @param[in] data      The CBOR encoded data
+ * @param[in] size      Size of @p data
+ */
+void cbor_reader_init(cbor_reader_t *reader, const void *data, size_t size);
+
+/**
+ * @brief Read the next item
+ *
+ * For arrays, maps and tags only the head is consumed, the contained items
+ * are returned by the following calls.
+ *
+ * @param[in, out] reader   The reader
+ * @param[out] item         The item read
+ *
+ * @return Number of bytes consumed
+ * @return 0 at the end of the data or if the data is malformed
+ */
+size_t cbor_read_next(cbor_reader_t *reader, cbor_item_t *item);
+
+/**
+ * @brief Skip the next item including all nested items
+ *
+ * @param[in, out] reader   The reader
+ *
+ * @return Number of bytes skipped
+ * @return 0 at the end of the data or if the data is malformed
+ */
+size_t cbor_read_skip(cbor_reader_t *reader);
+
+/**
+ * @brief Whether @p reader reached the end of its data
+ *
+ * @param[in] reader    The reader
+ *
+ * @return True if there are no more items
+ */
+static inline bool cbor_reader_at_end(const cbor_reader_t *reader)
+{
+    return reader->pos >= reader->size;
+}
+
+/**
+ * @brief Types of struct members described by a @ref cbor_field_t
+ */
+typedef enum {
+    CBOR_FIELD_UINT,            /**< uint8_t to uint64_t, encoded as unsigned integer */
+    CBOR_FIELD_INT,             /**< int8_t to int64_t, encoded as (negative) integer */
+    CBOR_FIELD_BOOL,            /**< bool */
+#ifndef CBOR_NO_FLOAT
+    CBOR_FIELD_FLOAT,           /**< float, encoded as single precision float */
+#endif /* CBOR_NO_FLOAT */
+    CBOR_FIELD_TEXT,            /**< char array holding a zero terminated string */
+    CBOR_FIELD_BYTES,           /**< fixed size uint8_t array, encoded as byte string */
+} cbor_field_type_t;
+
+/**
+ * @brief Descriptor of a single struct member, encoded as one map entry
+ *
+ * Use CBOR_FIELD() to create descriptors, the map key is the member name.
+ * The width of integer fields is taken from the size of the member.
+ */
+typedef struct {
+    const char *key;            /**< map key, encoded as text string */
+    uint8_t key_len;            /**< length of @p key without the terminator */
+    uint8_t type;               /**< type of the member, see @ref cbor_field_type_t */
+    uint16_t offset;            /**< offset of the member within the struct */
+    uint16_t size;              /**< size of the member in bytes */
+} cbor_field_t;
+
+/**
+ * @brief Describe member @p member of struct type @p type as field of type
+ *        @p field_type (one of @ref cbor_field_type_t)
+ */
+#define CBOR_FIELD(type, member, field_type) \
+    { #member, sizeof(#member) - 1, field_type, offsetof(type, member), \
+      sizeof(((type *)0)->member) }
+
+/**
+ * @brief Schema of a struct: a static table of field descriptors
+ *
+ * Basic usage:
+ * @code
+ * typedef struct {
+ *     uint16_t seq;
+ *     int32_t temp;
+ *     char name[8];
+ * } record_t;
+ *
+ * static const cbor_field_t record_fields[] = {
+ *     CBOR_FIELD(record_t, seq, CBOR_FIELD_UINT),
+ *     CBOR_FIELD(record_t, temp, CBOR_FIELD_INT),
+ *     CBOR_FIELD(record_t, name, CBOR_FIELD_TEXT),
+ * };
+ * static const cbor_schema_t record_schema = CBOR_SCHEMA(record_fields);
+ *
+ * cbor_serialize_struct(&stream, &record_schema, &record);
+ * @endcode
+ */
+typedef struct {
+    const cbor_field_t *fields; /**< field descriptors, in encoding order */
+    uint8_t num;                /**< number of entries in @p fields */
+} cbor_schema_t;
+
+/**
+ * @brief Create a @ref cbor_schema_t from the array @p fields
+ */
+#define CBOR_SCHEMA(fields) { fields, sizeof(fields) / sizeof(fields[0]) }
+
+/**
+ * @brief Maximum number of bytes cbor_serialize_struct() produces for
+ *        @p schema
+ *
+ * Can be used to dimension buffers for serialized structs.
+ *
+ * @param[in] schema    The schema
+ *
+ * @return Maximum encoded size in bytes
+ */
+size_t cbor_struct_max_size(const cbor_schema_t *schema);
+
+/**
+ * @brief Serialize the struct @p val as map with one entry per field of
+ *        @p schema
+ *
+ * If @p stream has room for cbor_struct_max_size() bytes the struct is
+ * encoded in one pass without any further capacity checks.
+ *
+ * @param[out] stream   The destination stream
+ * @param[in] schema    The schema of @p val
+ * @param[in] val       The struct to serialize
+ *
+ * @return Number of bytes written to @p stream
+ * @return 0 if @p stream is too small, @p stream is left unchanged then
+ */
+size_t cbor_serialize_struct(cbor_stream_t *stream, const cbor_schema_t *schema,
+                             const void *val);
+
+/**
+ * @brief Deserialize a map from @p stream into the struct @p val
+ *
+ * Entries are matched to the fields of @p schema by their key, in any
+ * order. Entries with unknown or non-text keys are skipped, fields without
+ * an entry keep their value.
+ *
+ * @param[in] stream    The stream to deserialize
+ * @param[in] offset    The offset within the stream
+ * @param[in] schema    The schema of @p val
+ * @param[out] val      The struct to deserialize into
+ *
+ * @return Number of deserialized bytes from @p stream
+ * @return 0 if the map is malformed or a value does not fit its field
+ */
+size_t cbor_deserialize_struct(const cbor_stream_t *stream, size_t offset,
+                               const cbor_schema_t *schema, void *val);
+
 #ifdef __cplusplus
 }
 #endif
@@ -160,6 +160,21 @@ uint32_t rotating_hash(const uint8_t *buf, size_t len);
  */
 uint32_t one_at_a_time_hash(const uint8_t *buf, size_t len);
 
+/**
+ * @brief 64 bit FNV-1a hash
+ *
+ * found on
+ * http://www.isthe.com/chongo/tech/comp/fnv/index.html
+ *
+ * Meant for users that derive several indices from a single hash value,
+ * e.g. the blocked and counting Bloom filters.
+ *
+ * @param buf input buffer to hash
+ * @param len length of buffer
+ * @return 64 bit sized hash
+ */
+uint64_t fnv1a_64_hash(const uint8_t *buf, size_t len);
+
 /**
  * @brief Fletcher's 16 bit checksum
  *
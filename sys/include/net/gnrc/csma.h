@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_csma   CSMA/CA MAC layer
+ * @ingroup     net_gnrc
+ * @brief       Unslotted CSMA/CA with link layer ACKs and retransmissions in
+ *              software, for IEEE 802.15.4 radios without hardware support
+ *
+ * Outgoing packets are queued per neighbor and the neighbors are served
+ * round robin, so a neighbor that does not acknowledge does not hold back
+ * the frames to all others. Every frame is sent after a random backoff of
+ * up to 2^BE - 1 unit backoff periods and, if enabled, a clear channel
+ * assessment. A busy channel increases BE up to the maximum until the
+ * number of backoffs is exhausted.
+ *
+ * If the device supports @ref NETOPT_RAWMODE, the MAC builds and parses the
+ * IEEE 802.15.4 headers itself: unicast frames request an ACK, are
+ * retransmitted if none arrives in time and received frames requesting an
+ * ACK are acknowledged. In raw mode the device is expected to
+ *
+ * - send the snips following the netif header as the complete frame and only
+ *   append the FCS
+ * - pass every received frame without FCS as first snip of the packet,
+ *   optionally followed by a netif header carrying LQI and RSSI
+ *
+ * Without raw mode, the device builds the headers and frames are sent once.
+ *
+ * The outcome of every frame is reported with a message of type
+ * @ref GNRC_CSMA_MSG_TYPE_TX_STATUS to the thread that handed the frame to
+ * the MAC layer with @ref gnrc_netapi_send(). Upper layers that do not care
+ * ignore it like any other unknown message type.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Interface definition for the CSMA/CA MAC layer
+ */
+
+#ifndef GNRC_CSMA_H_
+#define GNRC_CSMA_H_
+
+#include <stdint.h>
+
+#include "kernel.h"
+#include "msg.h"
+#include "net/gnrc/netdev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Set the default message queue size for CSMA layers
+ */
+#ifndef GNRC_CSMA_MSG_QUEUE_SIZE
+#define GNRC_CSMA_MSG_QUEUE_SIZE        (8U)
+#endif
+
+/**
+ * @brief   Number of CSMA layers that can run at the same time
+ */
+#ifndef GNRC_CSMA_NUMOF
+#define GNRC_CSMA_NUMOF                 (1U)
+#endif
+
+/**
+ * @brief   Number of frames a CSMA layer can queue in total
+ */
+#ifndef GNRC_CSMA_QUEUE_SIZE
+#define GNRC_CSMA_QUEUE_SIZE            (8U)
+#endif
+
+/**
+ * @brief   Number of neighbors with frames queued at the same time
+ */
+#ifndef GNRC_CSMA_NEIGHBOR_NUMOF
+#define GNRC_CSMA_NEIGHBOR_NUMOF        (4U)
+#endif
+
+/**
+ * @brief   Number of frames queued for a single neighbor
+ */
+#ifndef GNRC_CSMA_NEIGHBOR_QUEUE_LEN
+#define GNRC_CSMA_NEIGHBOR_QUEUE_LEN    (4U)
+#endif
+
+/**
+ * @brief   Number of neighbors remembered for duplicate detection
+ */
+#ifndef GNRC_CSMA_DUP_NUMOF
+#define GNRC_CSMA_DUP_NUMOF             (4U)
+#endif
+
+/**
+ * @brief   Unit backoff period in microseconds (20 symbols at 2.4 GHz)
+ */
+#ifndef GNRC_CSMA_UNIT_BACKOFF_US
+#define GNRC_CSMA_UNIT_BACKOFF_US       (320U)
+#endif
+
+/**
+ * @name    Default parameters
+ * @{
+ */
+#ifndef GNRC_CSMA_MIN_BE
+#define GNRC_CSMA_MIN_BE                (3U)    /**< initial backoff
+                                                 *   exponent */
+#endif
+#ifndef GNRC_CSMA_MAX_BE
+#define GNRC_CSMA_MAX_BE                (5U)    /**< maximum backoff
+                                                 *   exponent */
+#endif
+#ifndef GNRC_CSMA_MAX_BACKOFFS
+#define GNRC_CSMA_MAX_BACKOFFS          (4U)    /**< backoffs before a
+                                                 *   frame is dropped */
+#endif
+#ifndef GNRC_CSMA_MAX_RETRIES
+#define GNRC_CSMA_MAX_RETRIES           (3U)    /**< retransmissions of
+                                                 *   unacknowledged frames */
+#endif
+#ifndef GNRC_CSMA_ACK_WAIT_US
+#define GNRC_CSMA_ACK_WAIT_US           (2000U) /**< time to wait for an ACK
+                                                 *   after sending */
+#endif
+/** @} */
+
+/**
+ * @name    Parameter flags
+ * @{
+ */
+#define GNRC_CSMA_FLAGS_CCA             (0x01)  /**< assess the channel
+                                                 *   before sending */
+#define GNRC_CSMA_FLAGS_BACKOFF         (0x02)  /**< random backoff before
+                                                 *   sending */
+#define GNRC_CSMA_FLAGS_ACK             (0x04)  /**< request ACKs for
+                                                 *   unicast frames */
+/** @} */
+
+/**
+ * @name    Message types
+ * @{
+ */
+#define GNRC_CSMA_MSG_TYPE_BACKOFF      (0x0240)    /**< backoff expired */
+#define GNRC_CSMA_MSG_TYPE_ACK_TIMEOUT  (0x0241)    /**< no ACK in time */
+#define GNRC_CSMA_MSG_TYPE_TX_STATUS    (0x0242)    /**< status of a frame,
+                                                     *   see
+                                                     *   @ref gnrc_csma_tx_status() */
+/** @} */
+
+/**
+ * @brief   Outcome of a frame
+ */
+typedef enum {
+    GNRC_CSMA_TX_OK = 0,            /**< sent, and acknowledged if requested */
+    GNRC_CSMA_TX_NOACK,             /**< no ACK after all retransmissions */
+    GNRC_CSMA_TX_CHANNEL_BUSY,      /**< channel busy on every backoff */
+    GNRC_CSMA_TX_QUEUE_FULL,        /**< dropped, no room in the queue */
+    GNRC_CSMA_TX_ERROR,             /**< the device failed to send */
+} gnrc_csma_tx_status_t;
+
+/**
+ * @brief   Parameters of a CSMA layer
+ *
+ * @ref NETOPT_CSMA_RETRIES and @ref NETOPT_RETRANS change
+ * gnrc_csma_params_t::max_backoffs and gnrc_csma_params_t::max_retries,
+ * @ref NETOPT_CSMA toggles @ref GNRC_CSMA_FLAGS_CCA together with
+ * @ref GNRC_CSMA_FLAGS_BACKOFF and @ref NETOPT_AUTOACK toggles
+ * @ref GNRC_CSMA_FLAGS_ACK at run time.
+ */
+typedef struct {
+    uint32_t ack_wait;              /**< time to wait for an ACK in
+                                     *   microseconds */
+    uint8_t flags;                  /**< parameter flags */
+    uint8_t min_be;                 /**< initial backoff exponent */
+    uint8_t max_be;                 /**< maximum backoff exponent */
+    uint8_t max_backoffs;           /**< backoffs before dropping a frame */
+    uint8_t max_retries;            /**< retransmissions of a frame */
+} gnrc_csma_params_t;
+
+/**
+ * @brief   Default parameters
+ */
+#define GNRC_CSMA_PARAMS_DEFAULT    { GNRC_CSMA_ACK_WAIT_US,                \
+                                      GNRC_CSMA_FLAGS_CCA |                 \
+                                      GNRC_CSMA_FLAGS_BACKOFF |             \
+                                      GNRC_CSMA_FLAGS_ACK,                  \
+                                      GNRC_CSMA_MIN_BE, GNRC_CSMA_MAX_BE,   \
+                                      GNRC_CSMA_MAX_BACKOFFS,               \
+                                      GNRC_CSMA_MAX_RETRIES }
+
+/**
+ * @brief   Builds the content of a @ref GNRC_CSMA_MSG_TYPE_TX_STATUS message
+ *
+ * @param[in] status    outcome of the frame
+ * @param[in] tx        number of transmissions
+ * @param[in] seq       sequence number of the frame, 0 without raw mode
+ */
+#define GNRC_CSMA_TX_STATUS(status, tx, seq) \
+    ((uint32_t)(status) | ((uint32_t)(tx) << 8) | ((uint32_t)(seq) << 16))
+
+/**
+ * @brief   Get the outcome from a @ref GNRC_CSMA_MSG_TYPE_TX_STATUS message
+ *
+ * @param[in] msg   the message
+ *
+ * @return  outcome of the frame
+ */
+static inline gnrc_csma_tx_status_t gnrc_csma_tx_status(const msg_t *msg)
+{
+    return (gnrc_csma_tx_status_t)(msg->content.value & 0xff);
+}
+
+/**
+ * @brief   Get the number of transmissions from a
+ *          @ref GNRC_CSMA_MSG_TYPE_TX_STATUS message
+ *
+ * @param[in] msg   the message
+ *
+ * @return  number of transmissions, 0 if the frame was never sent
+ */
+static inline uint8_t gnrc_csma_tx_count(const msg_t *msg)
+{
+    return (uint8_t)((msg->content.value >> 8) & 0xff);
+}
+
+/**
+ * @brief   Get the sequence number from a @ref GNRC_CSMA_MSG_TYPE_TX_STATUS
+ *          message
+ *
+ * @param[in] msg   the message
+ *
+ * @return  sequence number of the frame
+ */
+static inline uint8_t gnrc_csma_tx_seq(const msg_t *msg)
+{
+    return (uint8_t)((msg->content.value >> 16) & 0xff);
+}
+
+/**
+ * @brief   Initialize an instance of the CSMA layer
+ *
+ * The initialization starts a new thread that connects to the given netdev
+ * device and starts a link layer event loop.
+ *
+ * @param[in] stack         stack for the control thread
+ * @param[in] stacksize     size of *stack*
+ * @param[in] priority      priority for the thread housing the CSMA instance
+ * @param[in] name          name of the thread housing the CSMA instance
+ * @param[in] dev           netdev device, needs to be already initialized
+ * @param[in] params        parameters, copied, NULL for the defaults
+ *
+ * @return                  PID of CSMA thread on success
+ * @return                  -EINVAL if creation of thread fails
+ * @return                  -ENODEV if *dev* is invalid
+ * @return                  -ENOMEM if @ref GNRC_CSMA_NUMOF layers are running
+ */
+kernel_pid_t gnrc_csma_init(char *stack, int stacksize, char priority,
+                            const char *name, gnrc_netdev_t *dev,
+                            const gnrc_csma_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_CSMA_H_ */
+/** @} */
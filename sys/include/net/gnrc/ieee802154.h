@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_ieee802154 IEEE 802.15.4 header codec
+ * @ingroup     net_gnrc
+ * @brief       Conversion between IEEE 802.15.4 MAC headers and
+ *              @ref net_gnrc_netif_hdr
+ *
+ * Data frame headers only differ in the sequence number as long as the
+ * destination and the device configuration stay the same. Every device
+ * keeps a small cache of complete headers per destination, so sending a
+ * frame to a known destination copies the header and patches the sequence
+ * number.
+ *
+ * @{
+ *
+ * @file
+ * @brief       IEEE 802.15.4 header codec definitions
+ */
+
+#ifndef GNRC_IEEE802154_H_
+#define GNRC_IEEE802154_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net/ieee802154.h"
+#include "net/gnrc/pkt.h"
+#include "net/gnrc/netif/hdr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of cached headers per device
+ */
+#ifndef GNRC_IEEE802154_HDR_CACHE_SIZE
+#define GNRC_IEEE802154_HDR_CACHE_SIZE  (4U)
+#endif
+
+/**
+ * @name    Header options
+ * @{
+ */
+#define GNRC_IEEE802154_OPT_ACK_REQ     (0x01)  /**< request ACKs for unicast
+                                                 *   frames */
+#define GNRC_IEEE802154_OPT_USE_SRC_PAN (0x02)  /**< send the source PAN ID
+                                                 *   instead of compressing
+                                                 *   it */
+/** @} */
+
+/**
+ * @brief   Device configuration a header is built from
+ */
+typedef struct {
+    uint16_t pan;                   /**< PAN ID */
+    uint8_t opts;                   /**< header options */
+    uint8_t src_len;                /**< source address length, 2 or 8 */
+    uint8_t src[8];                 /**< source address, copied into the
+                                     *   frame as is */
+} gnrc_ieee802154_cfg_t;
+
+/**
+ * @brief   Complete header for one destination
+ */
+typedef struct {
+    uint8_t hdr[IEEE802154_MAX_HDR_LEN];    /**< header with sequence
+                                             *   number 0 */
+    uint8_t dst[8];                         /**< destination as given in the
+                                             *   netif header */
+    uint8_t dst_len;                        /**< destination length, 0 if
+                                             *   unused */
+    uint8_t len;                            /**< header length */
+} gnrc_ieee802154_tmpl_t;
+
+/**
+ * @brief   Per device header cache
+ *
+ * Zero initialize it, the cache flushes itself when the configuration it
+ * is used with changes.
+ */
+typedef struct {
+    gnrc_ieee802154_cfg_t cfg;      /**< configuration of the entries */
+    gnrc_ieee802154_tmpl_t tmpl[GNRC_IEEE802154_HDR_CACHE_SIZE]; /**< headers */
+    uint8_t next;                   /**< entry to replace next */
+} gnrc_ieee802154_hdr_cache_t;
+
+/**
+ * @brief   Build the MAC header of a data frame
+ *
+ * Broadcast and multicast frames are sent to the short broadcast address
+ * and never request ACKs.
+ *
+ * @param[in,out] cache header cache of the device
+ * @param[in] cfg       current device configuration
+ * @param[in] netif     netif header of the packet to send
+ * @param[in] seq       sequence number
+ * @param[out] buf      buffer of at least @ref IEEE802154_MAX_HDR_LEN bytes
+ *
+ * @return  length of the header
+ * @return  0 if the destination address length is not supported
+ */
+size_t gnrc_ieee802154_build_hdr(gnrc_ieee802154_hdr_cache_t *cache,
+                                 const gnrc_ieee802154_cfg_t *cfg,
+                                 const gnrc_netif_hdr_t *netif,
+                                 uint8_t seq, uint8_t *buf);
+
+/**
+ * @brief   Get the length of a MAC header
+ *
+ * @param[in] mhr       MAC header, at least the frame control field
+ *
+ * @return  length of the header
+ * @return  0 if the addressing modes are invalid
+ */
+size_t gnrc_ieee802154_get_hdr_len(const uint8_t *mhr);
+
+/**
+ * @brief   Parse a MAC header into a netif header
+ *
+ * @param[in] mhr       MAC header
+ * @param[in] len       number of valid bytes in @p mhr
+ *
+ * @return  snip holding the netif header, the interface, LQI and RSSI are
+ *          left for the caller to fill in
+ * @return  NULL if the header is invalid, truncated or the packet buffer is
+ *          full
+ */
+gnrc_pktsnip_t *gnrc_ieee802154_make_netif_hdr(const uint8_t *mhr, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_IEEE802154_H_ */
+/** @} */
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_lpl    Low power listening MAC layer
+ * @ingroup     net_gnrc
+ * @brief       Duty cycled MAC layer for @ref drivers_netdev_netdev2 devices
+ *              in the style of X-MAC and ContikiMAC
+ *
+ * The layer replaces @ref net_gnrc_netdev2 for a device and keeps the radio
+ * asleep (@ref NETOPT_STATE_SLEEP) most of the time. Every
+ * gnrc_lpl_params_t::interval it wakes up (@ref NETOPT_STATE_IDLE) and
+ * listens for gnrc_lpl_params_t::listen. The window is extended as long as
+ * frames arrive.
+ *
+ * A frame is sent as strobe: it is repeated every gnrc_lpl_params_t::gap
+ * until the receiver acknowledges it, for at most one interval plus one
+ * listen window. Broadcast frames are strobed for the whole time and never
+ * acknowledged, receivers drop the copies. The time an ACK arrived tells when
+ * the neighbor wakes up, so later frames to it are only strobed around its
+ * next wake up. If the neighbor misses that short strobe, its phase is
+ * forgotten and the frame is strobed once more for the whole time.
+ *
+ * All nodes of a network need to run this layer with the same interval. Every
+ * frame starts with a two byte header of this layer, ACKs are frames of this
+ * layer only. The device is expected to drop unicast frames for other nodes,
+ * as netdev2_tap and cc110x do. With an interval of 0 the radio stays on
+ * and frames are sent once, which gives a baseline to compare energy and
+ * latency with.
+ *
+ * On native, netdev2_tap drops all frames while sleeping, so the layer
+ * can be tried out between native instances. gnrc_lpl_get_stats() reports
+ * the time the radio was on and the latency of the frames sent.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Interface definition for the low power listening MAC layer
+ */
+
+#ifndef GNRC_LPL_H_
+#define GNRC_LPL_H_
+
+#include <stdint.h>
+
+#include "kernel.h"
+#include "net/gnrc/gnrc_netdev2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Set the default message queue size for LPL layers
+ */
+#ifndef GNRC_LPL_MSG_QUEUE_SIZE
+#define GNRC_LPL_MSG_QUEUE_SIZE     (8U)
+#endif
+
+/**
+ * @brief   Number of LPL layers that can run at the same time
+ */
+#ifndef GNRC_LPL_NUMOF
+#define GNRC_LPL_NUMOF              (1U)
+#endif
+
+/**
+ * @brief   Number of frames a LPL layer can queue
+ */
+#ifndef GNRC_LPL_QUEUE_SIZE
+#define GNRC_LPL_QUEUE_SIZE         (4U)
+#endif
+
+/**
+ * @brief   Number of neighbors whose wake up phase is remembered
+ */
+#ifndef GNRC_LPL_PHASE_NUMOF
+#define GNRC_LPL_PHASE_NUMOF        (4U)
+#endif
+
+/**
+ * @brief   Number of neighbors remembered for duplicate detection
+ */
+#ifndef GNRC_LPL_DUP_NUMOF
+#define GNRC_LPL_DUP_NUMOF          (4U)
+#endif
+
+/**
+ * @name    Default parameters
+ * @{
+ */
+#ifndef GNRC_LPL_INTERVAL_US
+#define GNRC_LPL_INTERVAL_US        (125000U)   /**< wake up interval */
+#endif
+#ifndef GNRC_LPL_LISTEN_US
+#define GNRC_LPL_LISTEN_US          (10000U)    /**< listen window */
+#endif
+#ifndef GNRC_LPL_GAP_US
+#define GNRC_LPL_GAP_US             (4000U)     /**< time between strobes */
+#endif
+#ifndef GNRC_LPL_GUARD_US
+#define GNRC_LPL_GUARD_US           (4000U)     /**< strobe this early before
+                                                 *   a known wake up */
+#endif
+/** @} */
+
+/**
+ * @name    Message types
+ * @{
+ */
+#define GNRC_LPL_MSG_TYPE_WAKEUP    (0x0250)    /**< start of a listen window */
+#define GNRC_LPL_MSG_TYPE_LISTEN    (0x0251)    /**< end of a listen window */
+#define GNRC_LPL_MSG_TYPE_STROBE    (0x0252)    /**< next strobe is due */
+/** @} */
+
+/**
+ * @brief   Parameters of a LPL layer
+ *
+ * gnrc_lpl_params_t::gap must be shorter than gnrc_lpl_params_t::listen
+ * minus the time on air of a frame, otherwise the strobes can fall between
+ * two listen windows.
+ */
+typedef struct {
+    uint32_t interval;      /**< wake up interval in microseconds, 0 keeps
+                             *   the radio on */
+    uint32_t listen;        /**< listen window in microseconds */
+    uint32_t gap;           /**< time between two strobes in microseconds,
+                             *   the sender listens for the ACK meanwhile */
+    uint32_t guard;         /**< strobe this long before the known wake up
+                             *   of a neighbor in microseconds */
+} gnrc_lpl_params_t;
+
+/**
+ * @brief   Default parameters
+ */
+#define GNRC_LPL_PARAMS_DEFAULT     { GNRC_LPL_INTERVAL_US,     \
+                                      GNRC_LPL_LISTEN_US,       \
+                                      GNRC_LPL_GAP_US,          \
+                                      GNRC_LPL_GUARD_US }
+
+/**
+ * @brief   Energy and latency statistics of a LPL layer
+ */
+typedef struct {
+    uint64_t uptime;        /**< time since initialization in microseconds */
+    uint64_t radio_on;      /**< time the radio was on in microseconds */
+    uint64_t latency_sum;   /**< sum of the latencies of the sent frames in
+                             *   microseconds */
+    uint32_t latency_min;   /**< lowest latency of a sent frame */
+    uint32_t latency_max;   /**< highest latency of a sent frame */
+    uint32_t tx;            /**< frames sent */
+    uint32_t tx_failed;     /**< unicast frames never acknowledged */
+    uint32_t strobes;       /**< transmissions including all strobes */
+    uint32_t rx;            /**< frames received, without duplicates */
+    uint32_t wakeups;       /**< listen windows */
+} gnrc_lpl_stats_t;
+
+/**
+ * @brief   Initialize an instance of the LPL layer
+ *
+ * The initialization starts a new thread that connects to the given netdev2
+ * device and starts a duty cycled link layer event loop. It is used instead
+ * of gnrc_netdev2_init().
+ *
+ * @param[in] stack         stack for the control thread
+ * @param[in] stacksize     size of *stack*
+ * @param[in] priority      priority for the thread housing the LPL instance
+ * @param[in] name          name of the thread housing the LPL instance
+ * @param[in] gnrc_netdev2  netdev2 device with its gnrc adapter
+ * @param[in] params        parameters, copied, NULL for the defaults
+ *
+ * @return                  PID of LPL thread on success
+ * @return                  -EINVAL if creation of thread fails
+ * @return                  -ENODEV if *gnrc_netdev2* is invalid
+ * @return                  -ENOMEM if @ref GNRC_LPL_NUMOF layers are running
+ */
+kernel_pid_t gnrc_lpl_init(char *stack, int stacksize, char priority,
+                           const char *name, gnrc_netdev2_t *gnrc_netdev2,
+                           const gnrc_lpl_params_t *params);
+
+/**
+ * @brief   Get the statistics of a LPL layer
+ *
+ * @param[in] pid       PID of the LPL layer
+ * @param[out] stats    the statistics up to now
+ *
+ * @return  0 on success
+ * @return  -ENODEV if *pid* is no LPL layer
+ */
+int gnrc_lpl_get_stats(kernel_pid_t pid, gnrc_lpl_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_LPL_H_ */
+/** @} */
@@ -15,6 +15,8 @@
  *              module with a basic set of commands to communicate with its
  *              neighboring modules. In this model every module runs in its own
  *              thread and communication is done using the @ref net_gnrc_netapi.
+ *              With @ref net_gnrc_single_thread several modules share one
+ *              thread instead.
  *
  * @{
  *
@@ -319,6 +319,14 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
  */
 #define GNRC_RPL_LIFETIME_UPDATE_STEP (2)
 
+/**
+ * @brief Time in milliseconds the lifetime update may be delayed to share a
+ *        wakeup with other timers
+ */
+#ifndef GNRC_RPL_LIFETIME_UPDATE_SLACK
+#define GNRC_RPL_LIFETIME_UPDATE_SLACK (500)
+#endif
+
 /**
  *  @name   Global / Local instance id masks
  *  @see <a href="https://tools.ietf.org/html/rfc6550#section-5.1">
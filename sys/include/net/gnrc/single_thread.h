@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_single_thread Single thread mode
+ * @ingroup     net_gnrc
+ * @brief       Runs several GNRC layers in one shared thread
+ *
+ * @details     By default every GNRC layer runs in its own thread with its own
+ *              stack and message queue. With `USEMODULE += gnrc_single_thread`
+ *              the layers that support it (@ref net_gnrc_ipv6,
+ *              @ref net_gnrc_sixlowpan, @ref net_gnrc_udp and
+ *              @ref net_gnrc_rpl) register a handler with this module instead
+ *              of starting a thread.
+ *
+ *              Packets that are passed to such a layer via @ref net_gnrc_netapi
+ *              are put into a shared run-to-completion event queue. The shared
+ *              thread handles one event after the other by calling the
+ *              handler of the target layer directly. A packet passed between
+ *              two layers in the shared thread therefore costs no context
+ *              switch and no message.
+ *
+ *              The target layer of an event is found by the
+ *              @ref gnrc_nettype_t the layer registered. For
+ *              gnrc_netapi_send() and gnrc_netapi_receive() to the shared
+ *              thread's PID, and for GNRC_NETAPI_MSG_TYPE_SND and
+ *              GNRC_NETAPI_MSG_TYPE_RCV messages sent to it directly, the
+ *              type of the packet's first snip that is not a netif header is
+ *              used (see gnrc_single_thread_post_pkt()). A packet is always
+ *              handled by exactly one layer and released if there is none.
+ *
+ *              All other messages (e.g. timer events) sent to the shared
+ *              thread are passed to the handlers of all layers, so their
+ *              message types must be unique. Get and set requests are replied
+ *              with -ENOTSUP.
+ *
+ *              The network interface threads (e.g. @ref net_gnrc_netdev2) are
+ *              not affected.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Definitions for the GNRC single thread mode
+ */
+
+#ifndef GNRC_SINGLE_THREAD_H_
+#define GNRC_SINGLE_THREAD_H_
+
+#include "kernel_types.h"
+#include "msg.h"
+#include "thread.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pkt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Default stack size to use for the shared thread
+ */
+#ifndef GNRC_SINGLE_THREAD_STACK_SIZE
+#define GNRC_SINGLE_THREAD_STACK_SIZE   (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Priority of the shared thread
+ */
+#ifndef GNRC_SINGLE_THREAD_PRIO
+#define GNRC_SINGLE_THREAD_PRIO         (THREAD_PRIORITY_MAIN - 3)
+#endif
+
+/**
+ * @brief   Default message queue size for the shared thread
+ */
+#ifndef GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE
+#define GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE   (8U)
+#endif
+
+/**
+ * @brief   Number of packet events the shared thread can queue
+ *
+ * @note    Must be a power of two.
+ */
+#ifndef GNRC_SINGLE_THREAD_EVENT_NUMOF
+#define GNRC_SINGLE_THREAD_EVENT_NUMOF  (16U)
+#endif
+
+/**
+ * @brief   @ref core_msg type to wake up the shared thread for queued events
+ */
+#define GNRC_SINGLE_THREAD_MSG_TYPE_EVENT   (0x0230)
+
+/**
+ * @brief   A layer running in the shared thread
+ */
+typedef struct gnrc_single_thread_layer {
+    /**
+     * @brief next element in list
+     *
+     * @internal
+     */
+    struct gnrc_single_thread_layer *next;
+    gnrc_nettype_t type;        /**< type of packets the layer handles */
+    /**
+     * @brief   Handles a message for the layer
+     *
+     * Called with the @ref net_gnrc_netapi message types
+     * GNRC_NETAPI_MSG_TYPE_RCV and GNRC_NETAPI_MSG_TYPE_SND for packets and
+     * with any other message the shared thread receives.
+     */
+    void (*handler)(msg_t *msg);
+} gnrc_single_thread_layer_t;
+
+/**
+ * @brief   Static initializer for a @ref gnrc_single_thread_layer_t
+ *
+ * @param[in] type      type of packets the layer handles
+ * @param[in] handler   message handler of the layer
+ */
+#define GNRC_SINGLE_THREAD_LAYER(type, handler) { NULL, type, handler }
+
+/**
+ * @brief   The PID of the shared thread, KERNEL_PID_UNDEF if not started
+ */
+extern kernel_pid_t gnrc_single_thread_pid;
+
+/**
+ * @brief   Adds a layer to the shared thread, starts the thread if needed
+ *
+ * @param[in] layer     the layer to add
+ *
+ * @return  The PID of the shared thread
+ * @return  a negative errno on thread creation error
+ */
+kernel_pid_t gnrc_single_thread_add(gnrc_single_thread_layer_t *layer);
+
+/**
+ * @brief   Queues a packet for the layer of the given type
+ *
+ * @param[in] type      type of the target layer
+ * @param[in] cmd       GNRC_NETAPI_MSG_TYPE_RCV or GNRC_NETAPI_MSG_TYPE_SND
+ * @param[in] pkt       the packet
+ *
+ * @return  1 if the packet was queued
+ * @return  0 if the event queue is full
+ * @return  -1 if no layer of type @p type was added
+ */
+int gnrc_single_thread_post(gnrc_nettype_t type, uint16_t cmd,
+                            gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Queues a packet for the layer its headers belong to
+ *
+ * The target layer is the one of the type of the first snip of @p pkt that
+ * is not of type GNRC_NETTYPE_NETIF, e.g. IPv6 for a neighbor solicitation
+ * that is passed down with the interface to send it over.
+ *
+ * @param[in] cmd       GNRC_NETAPI_MSG_TYPE_RCV or GNRC_NETAPI_MSG_TYPE_SND
+ * @param[in] pkt       the packet
+ *
+ * @return  1 if the packet was queued
+ * @return  0 if the event queue is full
+ * @return  -1 if no layer for the packet was added
+ */
+int gnrc_single_thread_post_pkt(uint16_t cmd, gnrc_pktsnip_t *pkt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_SINGLE_THREAD_H_ */
+/** @} */
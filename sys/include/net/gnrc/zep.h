@@ -35,6 +35,7 @@
 #include "byteorder.h"
 #include "kernel_types.h"
 #include "net/ipv6/addr.h"
+#include "net/gnrc/ieee802154.h"
 #include "net/gnrc/nettype.h"
 #include "thread.h"
 
@@ -104,6 +105,8 @@ extern "C" {
 #define GNRC_ZEP_FLAGS_SRC_ADDR_LONG    (0x0002)    /**< send data using long source address */
 #define GNRC_ZEP_FLAGS_DST_ADDR_LONG    (0x0004)    /**< send data using long destination address */
 #define GNRC_ZEP_FLAGS_USE_SRC_PAN      (0x0008)    /**< do not compress source PAN ID */
+#define GNRC_ZEP_FLAGS_RAWMODE          (0x0010)    /**< send and receive frames
+                                                     *   with the MAC header */
 /**
  * @}
  */
@@ -198,6 +201,8 @@ typedef struct {
     le_uint16_t pan;                /**< the device's PAN ID */
     uint16_t flags;                 /**< the device's option flags */
     uint32_t seq;                   /**< the current sequence number for frames */
+    gnrc_ieee802154_hdr_cache_t hdr_cache;  /**< MAC headers for the last
+                                             *   destinations */
     ipv6_addr_t dst;                /**< destination IPv6 address */
     uint16_t src_port;              /**< source UDP port */
     uint16_t dst_port;              /**< destination UDP port */
@@ -177,6 +177,12 @@ typedef enum {
      */
     NETOPT_DEVICE_TYPE,
 
+    /**
+     * @brief   get the packet and byte counters of a device as
+     *          @ref netstats_t
+     */
+    NETOPT_STATS,
+
     /* add more options if needed */
 
     /**
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    net_netstats Packet statistics
+ * @ingroup     net
+ * @brief       Packet and byte counters of network devices
+ * @{
+ *
+ * @file
+ * @brief       Definition of the counters read with @ref NETOPT_STATS
+ */
+
+#ifndef NETSTATS_H_
+#define NETSTATS_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Packet and byte counters of a network device
+ *
+ * The counters start at 0 when the device is initialized and wrap around.
+ */
+typedef struct {
+    uint32_t tx_unicast_count;      /**< unicast frames handed to the device */
+    uint32_t tx_mcast_count;        /**< multicast and broadcast frames handed
+                                     *   to the device */
+    uint32_t tx_bytes;              /**< bytes handed to the device */
+    uint32_t rx_count;              /**< frames received */
+    uint32_t rx_bytes;              /**< bytes received */
+} netstats_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NETSTATS_H_ */
+/** @} */
@@ -23,6 +23,8 @@
 #ifndef __PS_H
 #define __PS_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,6 +34,21 @@ extern "C" {
  */
 void ps(void);
 
+#if defined(MODULE_SCHEDSTATISTICS) || defined(DOXYGEN)
+/**
+ * @brief Periodically print the CPU usage of all active threads to stdout.
+ *
+ * Every line shows the share of the last interval a thread was running, its
+ * approximate stack high-water mark (see thread_measure_stack_free_cached())
+ * and the current and peak fill level of its message queue. The time spent
+ * in interrupt service routines is printed below.
+ *
+ * @param[in] interval  sampling interval in microseconds
+ * @param[in] rounds    number of intervals to print
+ */
+void ps_top(uint32_t interval, unsigned rounds);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -128,6 +128,26 @@ int tsrb_get_one(tsrb_t *rb);
  */
 int tsrb_get(tsrb_t *rb, char *dst, size_t n);
 
+/**
+ * @brief       Get the contiguous readable region of the ringbuffer
+ *
+ * Allows to read bytes in place. The readable part wraps at most once, so a
+ * second call after tsrb_get_commit() yields the rest.
+ *
+ * @param[in]   rb      Ringbuffer to operate on
+ * @param[out]  region  start of the oldest byte
+ * @return      nr of bytes that can be read from @p region
+ */
+unsigned tsrb_get_region(const tsrb_t *rb, char **region);
+
+/**
+ * @brief       Remove bytes read from the region returned by
+ *              tsrb_get_region()
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   nr of bytes read, at most the size of the region
+ */
+void tsrb_get_commit(tsrb_t *rb, unsigned n);
+
 /**
  * @brief       Add a byte to ringbuffer
  * @param[in]   rb  Ringbuffer to operate on
@@ -146,6 +166,24 @@ int tsrb_add_one(tsrb_t *rb, char c);
  */
 int tsrb_add(tsrb_t *rb, const char *src, size_t n);
 
+/**
+ * @brief       Get the contiguous free region of the ringbuffer
+ *
+ * Allows to write bytes in place, e.g. by a driver.
+ *
+ * @param[in]   rb      Ringbuffer to operate on
+ * @param[out]  region  position of the next byte to add
+ * @return      nr of bytes that can be written to @p region
+ */
+unsigned tsrb_add_region(const tsrb_t *rb, char **region);
+
+/**
+ * @brief       Add bytes written to the region returned by tsrb_add_region()
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   nr of bytes written, at most the size of the region
+ */
+void tsrb_add_commit(tsrb_t *rb, unsigned n);
+
 #ifdef __cplusplus
 }
 #endif
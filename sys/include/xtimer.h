@@ -30,6 +30,9 @@
 
 #include <stdint.h>
 #include "msg.h"
+#ifdef MODULE_THREAD_FLAGS
+#include "thread_flags.h"
+#endif
 #include "periph/timer.h"
 #include "timex.h"
 
@@ -62,6 +65,8 @@ typedef struct xtimer {
     timer_callback_t callback;  /**< callback function to call when timer
                                      expires */
     void *arg;                  /**< argument to pass to callback function */
+    uint32_t slack;             /**< microseconds the callback may be delayed
+                                     to share a wakeup with other timers */
 } xtimer_t;
 
 /**
@@ -187,6 +192,21 @@ void xtimer_usleep_until(uint32_t *last_wakeup, uint32_t usecs);
  */
 void xtimer_set_msg(xtimer_t *timer, uint32_t offset, msg_t *msg, kernel_pid_t target_pid);
 
+/**
+ * @brief Set a timer that sends a message and may be delayed by up to
+ *        @p slack microseconds
+ *
+ * See xtimer_set_slack().
+ *
+ * @param[in] timer         timer struct to work with
+ * @param[in] offset        microseconds from now
+ * @param[in] slack         microseconds the message may be delayed
+ * @param[in] msg           ptr to msg that will be sent
+ * @param[in] target_pid    pid the message will be sent to
+ */
+void xtimer_set_msg_slack(xtimer_t *timer, uint32_t offset, uint32_t slack,
+                          msg_t *msg, kernel_pid_t target_pid);
+
 /**
  * @brief Set a timer that sends a message, 64bit version
  *
@@ -245,6 +265,25 @@ void xtimer_set_wakeup64(xtimer_t *timer, uint64_t offset, kernel_pid_t pid);
  */
 void xtimer_set(xtimer_t *timer, uint32_t offset);
 
+/**
+ * @brief Set a timer that may be delayed to share a wakeup with other timers
+ *
+ * Like xtimer_set(), but the callback may run up to @p slack microseconds
+ * after @p offset. xtimer wakes up at the earliest deadline of all pending
+ * timers and fires every timer that is due by then, so timers that expire
+ * close to each other cost only one interrupt.
+ *
+ * Slack is ignored if the deadline falls into the next period of the
+ * low-level timer and for timers that are more than one 32bit period in
+ * the future.
+ *
+ * @param[in] timer     the timer structure to use
+ * @param[in] offset    time in microseconds from now specifying that timer's
+ *                      earliest callback's execution time
+ * @param[in] slack     time in microseconds the execution may be delayed
+ */
+void xtimer_set_slack(xtimer_t *timer, uint32_t offset, uint32_t slack);
+
 /**
  * @brief remove a timer
  *
@@ -257,6 +296,16 @@ void xtimer_set(xtimer_t *timer, uint32_t offset);
  */
 int xtimer_remove(xtimer_t *timer);
 
+#if defined(MODULE_XTIMER_STATS) || defined(DOXYGEN)
+/**
+ * @brief   Number of low-level timer interrupts handled by xtimer so far
+ *
+ * Allows to measure how well timers are coalesced, see xtimer_set_slack().
+ * Only available with `USEMODULE += xtimer_stats`.
+ */
+extern volatile uint32_t xtimer_isr_count;
+#endif
+
 /**
  * @brief receive a message blocking but with timeout
  *
@@ -279,6 +328,34 @@ int xtimer_msg_receive_timeout(msg_t *msg, uint32_t us);
  */
 int xtimer_msg_receive_timeout64(msg_t *msg, uint64_t us);
 
+#if defined(MODULE_THREAD_FLAGS) || defined(DOXYGEN)
+/**
+ * @brief wait for any of the given thread flags but with timeout
+ *
+ * @see thread_flags_wait_any()
+ *
+ * @param[in]   mask    flags to wait for, must not contain THREAD_FLAG_TIMEOUT
+ * @param[in]   us      timeout in microseconds relative
+ *
+ * @return      the flags of @p mask that were set, they are cleared
+ * @return      0 on timeout
+ */
+thread_flags_t xtimer_thread_flags_wait_any(thread_flags_t mask, uint32_t us);
+
+/**
+ * @brief wait for all of the given thread flags but with timeout
+ *
+ * @see thread_flags_wait_all()
+ *
+ * @param[in]   mask    flags to wait for, must not contain THREAD_FLAG_TIMEOUT
+ * @param[in]   us      timeout in microseconds relative
+ *
+ * @return      @p mask, the flags are cleared
+ * @return      0 on timeout, no flags are cleared
+ */
+thread_flags_t xtimer_thread_flags_wait_all(thread_flags_t mask, uint32_t us);
+#endif
+
 /**
  * @brief xtimer backoff value
  *
@@ -423,7 +500,7 @@ static inline uint32_t _mask(uint32_t val)
  * @brief xtimer internal stuff
  * @internal
  */
-int _xtimer_set_absolute(xtimer_t *timer, uint32_t target);
+int _xtimer_set_absolute(xtimer_t *timer, uint32_t target, uint32_t slack);
 void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset);
 void _xtimer_sleep(uint32_t offset, uint32_t long_offset);
 static inline void xtimer_spin_until(uint32_t value);
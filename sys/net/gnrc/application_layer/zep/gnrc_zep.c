@@ -27,6 +27,7 @@
 #include "net/ipv6/addr.h"
 #include "net/gnrc/ipv6/hdr.h"
 #include "net/gnrc.h"
+#include "net/gnrc/ieee802154.h"
 #include "net/gnrc/udp.h"
 #include "periph/cpuid.h"
 #include "random.h"
@@ -82,11 +83,8 @@ static size_t _zep_hdr_fill(gnrc_zep_t *dev, gnrc_zep_hdr_t *hdr,
 /* Event handlers for ISR events */
 static void _rx_started_event(gnrc_zep_t *dev);
 
-/* IEEE 802.15.4 helper functions: TODO: generalize add to (gnrc_)ieee802154 */
-static size_t _make_data_frame_hdr(gnrc_zep_t *dev, uint8_t *buf,
-                                   gnrc_netif_hdr_t *hdr);
-static size_t _get_frame_hdr_len(uint8_t *mhr);
-gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr);
+/* IEEE 802.15.4 helper functions */
+static void _hdr_cfg(const gnrc_zep_t *dev, gnrc_ieee802154_cfg_t *cfg);
 static uint16_t _calc_fcs(uint16_t fcs, const uint8_t *frame, uint8_t frame_len);
 
 kernel_pid_t gnrc_zep_init(gnrc_zep_t *dev, uint16_t src_port, ipv6_addr_t *dst,
@@ -211,6 +209,7 @@ static int _send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
     size_t payload_len = gnrc_pkt_len(pkt->next), hdr_len, mhr_offset;
     uint8_t mhr[IEEE802154_MAX_HDR_LEN], *data;
     uint16_t fcs = 0;
+    gnrc_ieee802154_cfg_t cfg;
 
     if ((netdev == NULL) || (netdev->driver != &_zep_driver)) {
         DEBUG("zep: wrong device on sending\n");
@@ -218,14 +217,25 @@ static int _send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
         return -ENODEV;
     }
 
-    /* create 802.15.4 header */
-    hdr_len = _make_data_frame_hdr(dev, mhr, (gnrc_netif_hdr_t *)pkt->data);
-
-    if (hdr_len == 0) {
-        DEBUG("zep: error on frame creation\n");
-        gnrc_pktbuf_release(pkt);
-        return -ENOMSG;
+    if (dev->flags & GNRC_ZEP_FLAGS_RAWMODE) {
+        /* the MAC header is part of the payload */
+        hdr_len = 0;
     }
+    else {
+        /* create 802.15.4 header */
+        _hdr_cfg(dev, &cfg);
+        hdr_len = gnrc_ieee802154_build_hdr(&dev->hdr_cache, &cfg,
+                                            (gnrc_netif_hdr_t *)pkt->data,
+                                            (uint8_t)dev->seq, mhr);
+
+        if (hdr_len == 0) {
+            DEBUG("zep: error on frame creation\n");
+            gnrc_pktbuf_release(pkt);
+            return -ENOMSG;
+        }
+    }
+
+    dev->seq++;
 
     new_pkt = _zep_hdr_build(dev, hdr_len + payload_len + IEEE802154_FCS_LEN, false);
 
@@ -434,6 +444,14 @@ static int _get(gnrc_netdev_t *netdev, netopt_t opt, void *value, size_t max_len
             _set_flag_ptr(value, dev->flags, GNRC_ZEP_FLAGS_AUTOACK);
             return sizeof(uint16_t);
 
+        case NETOPT_RAWMODE:
+            if (max_len < sizeof(netopt_enable_t)) {
+                return -EOVERFLOW;
+            }
+
+            _set_flag_ptr(value, dev->flags, GNRC_ZEP_FLAGS_RAWMODE);
+            return sizeof(netopt_enable_t);
+
         default:
             return -ENOTSUP;
     }
@@ -542,6 +560,20 @@ static int _set(gnrc_netdev_t *netdev, netopt_t opt, void *value, size_t value_l
             _set_flag_ptr(value, dev->flags, GNRC_ZEP_FLAGS_AUTOACK);
             return sizeof(uint16_t);
 
+        case NETOPT_RAWMODE:
+            if (value_len < sizeof(netopt_enable_t)) {
+                return -EOVERFLOW;
+            }
+
+            if (*((netopt_enable_t *)value) == NETOPT_ENABLE) {
+                dev->flags |= GNRC_ZEP_FLAGS_RAWMODE;
+            }
+            else {
+                dev->flags &= ~GNRC_ZEP_FLAGS_RAWMODE;
+            }
+
+            return sizeof(netopt_enable_t);
+
         default:
             return -ENOTSUP;
     }
@@ -732,17 +764,41 @@ static gnrc_pktsnip_t *_create_received(gnrc_zep_t *dev, gnrc_pktsnip_t *pkt,
 
     pkt = gnrc_pktbuf_remove_snip(pkt, pkt);    /* remove FCS */
 
-    mhr_len = _get_frame_hdr_len(pkt->data);
+    if (dev->flags & GNRC_ZEP_FLAGS_RAWMODE) {
+        /* pass the frame as is, the netif header only carries the LQI */
+        netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+
+        if (netif == NULL) {
+            gnrc_pktbuf_release(pkt);
+            return NULL;
+        }
+
+        ((gnrc_netif_hdr_t *)netif->data)->if_pid = dev->mac_pid;
+        ((gnrc_netif_hdr_t *)netif->data)->lqi = lqi;
+        LL_APPEND(pkt, netif);
+
+        return pkt;
+    }
+
+    mhr_len = gnrc_ieee802154_get_hdr_len(pkt->data);
 
-    if (mhr_len == 0) {
+    if ((mhr_len == 0) || (mhr_len > pkt->size)) {
         return NULL;
     }
 
     mhr = gnrc_pktbuf_mark(pkt, mhr_len, GNRC_NETTYPE_UNDEF);
 
+    if (mhr == NULL) {
+        return NULL;
+    }
+
     /* TODO: send ACK */
 
-    netif = _make_netif_hdr(mhr->data);
+    netif = gnrc_ieee802154_make_netif_hdr(mhr->data, mhr->size);
+
+    if (netif == NULL) {
+        return NULL;
+    }
 
     pkt = gnrc_pktbuf_remove_snip(pkt, mhr);
 
@@ -872,191 +928,24 @@ static void _rx_started_event(gnrc_zep_t *dev)
     }
 }
 
-/* TODO: Generalize and move all below to ieee802154 */
-static size_t _make_data_frame_hdr(gnrc_zep_t *dev, uint8_t *buf,
-                                   gnrc_netif_hdr_t *hdr)
+static void _hdr_cfg(const gnrc_zep_t *dev, gnrc_ieee802154_cfg_t *cfg)
 {
-    int pos = 0;
-
-    /* we are building a data frame here */
-    buf[0] = IEEE802154_FCF_TYPE_DATA;
-    buf[1] = 0x88;      /* use short src and dst addresses as starting point */
-
-    /* if AUTOACK is enabled, then we also expect ACKs for this packet */
+    cfg->pan = (uint16_t)(dev->pan.u8[0] | (dev->pan.u8[1] << 8));
+    cfg->opts = 0;
     if (dev->flags & GNRC_ZEP_FLAGS_AUTOACK) {
-        buf[0] |= IEEE802154_FCF_ACK_REQ;
-    }
-
-    /* fill in destination PAN ID */
-    pos = 3;
-    buf[pos++] = dev->pan.u8[0];
-    buf[pos++] = dev->pan.u8[1];
-
-    /* fill in destination address */
-    if (hdr->flags &
-        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
-        buf[pos++] = 0xff;
-        buf[pos++] = 0xff;
-    }
-    else if (hdr->dst_l2addr_len == 2) {
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-        buf[pos++] = dst_addr[1];
-        buf[pos++] = dst_addr[0];
+        cfg->opts |= GNRC_IEEE802154_OPT_ACK_REQ;
     }
-    else if (hdr->dst_l2addr_len == 8) {
-        buf[1] |= 0x04;
-        uint8_t *dst_addr = gnrc_netif_hdr_get_dst_addr(hdr);
-
-        for (int i = 7;  i >= 0; i--) {
-            buf[pos++] = dst_addr[i];
-        }
-    }
-    else {
-        /* unsupported address length */
-        return 0;
-    }
-
-    /* fill in source PAN ID (if applicable) */
     if (dev->flags & GNRC_ZEP_FLAGS_USE_SRC_PAN) {
-        buf[pos++] = dev->pan.u8[0];
-        buf[pos++] = dev->pan.u8[1];
+        cfg->opts |= GNRC_IEEE802154_OPT_USE_SRC_PAN;
     }
-    else {
-        buf[0] |= IEEE802154_FCF_PAN_COMP;
-    }
-
-    /* fill in source address */
     if (dev->flags & GNRC_ZEP_FLAGS_SRC_ADDR_LONG) {
-        buf[1] |= 0x40;
-        memcpy(&(buf[pos]), &dev->eui64, 8);
-        pos += 8;
+        cfg->src_len = 8;
+        memcpy(cfg->src, &dev->eui64, 8);
     }
     else {
-        memcpy(&(buf[pos]), &dev->addr, 2);
-        pos += 2;
+        cfg->src_len = 2;
+        memcpy(cfg->src, &dev->addr, 2);
     }
-
-    /* set sequence number */
-    buf[2] = dev->seq++;
-    /* return actual header length */
-    return pos;
-}
-
-static size_t _get_frame_hdr_len(uint8_t *mhr)
-{
-    uint8_t tmp;
-    size_t len = 3;
-
-    /* figure out address sizes */
-    tmp = (mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
-
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        len += 4;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        len += 10;
-    }
-    else if (tmp != IEEE802154_FCF_DST_ADDR_VOID) {
-        return 0;
-    }
-
-    tmp = (mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK);
-
-    if (tmp == IEEE802154_FCF_SRC_ADDR_VOID) {
-        return len;
-    }
-    else {
-        if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-            len += 2;
-        }
-
-        if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-            return (len + 2);
-        }
-        else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-            return (len + 8);
-        }
-    }
-
-    return 0;
-}
-
-gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr)
-{
-    uint8_t tmp;
-    uint8_t *addr;
-    uint8_t src_len, dst_len;
-    gnrc_pktsnip_t *snip;
-    gnrc_netif_hdr_t *hdr;
-
-    /* figure out address sizes */
-    tmp = mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK;
-
-    if (tmp == IEEE802154_FCF_SRC_ADDR_SHORT) {
-        src_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_SRC_ADDR_LONG) {
-        src_len = 8;
-    }
-    else if (tmp == 0) {
-        src_len = 0;
-    }
-    else {
-        return NULL;
-    }
-
-    tmp = mhr[1] & IEEE802154_FCF_DST_ADDR_MASK;
-
-    if (tmp == IEEE802154_FCF_DST_ADDR_SHORT) {
-        dst_len = 2;
-    }
-    else if (tmp == IEEE802154_FCF_DST_ADDR_LONG) {
-        dst_len = 8;
-    }
-    else if (tmp == 0) {
-        dst_len = 0;
-    }
-    else {
-        return NULL;
-    }
-
-    /* allocate space for header */
-    snip = gnrc_pktbuf_add(NULL, NULL, sizeof(gnrc_netif_hdr_t) + src_len + dst_len,
-                           GNRC_NETTYPE_NETIF);
-
-    if (snip == NULL) {
-        return NULL;
-    }
-
-    /* fill header */
-    hdr = (gnrc_netif_hdr_t *)snip->data;
-    gnrc_netif_hdr_init(hdr, src_len, dst_len);
-
-    if (dst_len > 0) {
-        tmp = 5 + dst_len;
-        addr = gnrc_netif_hdr_get_dst_addr(hdr);
-
-        for (int i = 0; i < dst_len; i++) {
-            addr[i] = mhr[5 + (dst_len - i) - 1];
-        }
-    }
-    else {
-        tmp = 3;
-    }
-
-    if (!(mhr[0] & IEEE802154_FCF_PAN_COMP)) {
-        tmp += 2;
-    }
-
-    if (src_len > 0) {
-        addr = gnrc_netif_hdr_get_src_addr(hdr);
-
-        for (int i = 0; i < src_len; i++) {
-            addr[i] = mhr[tmp + (src_len - i) - 1];
-        }
-    }
-
-    return snip;
 }
 
 static uint16_t _calc_fcs(uint16_t fcs, const uint8_t *frame, uint8_t frame_len)
@@ -0,0 +1,821 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ * @ingroup     net_gnrc_csma
+ * @file
+ * @brief       Implementation of the CSMA/CA MAC layer
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kernel.h"
+#include "msg.h"
+#include "random.h"
+#include "thread.h"
+#include "utlist.h"
+#include "xtimer.h"
+#include "net/ieee802154.h"
+#include "net/gnrc.h"
+#include "net/gnrc/csma.h"
+#include "net/gnrc/ieee802154.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if ENABLE_DEBUG
+/* For PRIu16 etc. */
+#include <inttypes.h>
+#endif
+
+/**
+ * @brief   Length of an ACK frame without FCS
+ */
+#define ACK_LEN             (3U)
+
+/**
+ * @brief   States of the frame in flight
+ */
+enum {
+    STATE_IDLE = 0,         /**< nothing to send */
+    STATE_BACKOFF,          /**< waiting for the backoff to expire */
+    STATE_WAIT_ACK,         /**< sent, waiting for the ACK */
+};
+
+/**
+ * @brief   Queued frame
+ */
+typedef struct entry {
+    struct entry *next;             /**< next frame to the same neighbor */
+    gnrc_pktsnip_t *pkt;            /**< the frame */
+    kernel_pid_t sender;            /**< thread the status is reported to */
+} _entry_t;
+
+/**
+ * @brief   Neighbor with frames queued
+ */
+typedef struct {
+    _entry_t *queue;                /**< queued frames, NULL if unused */
+    uint8_t addr[8];                /**< address as in the netif header */
+    uint8_t addr_len;               /**< address length */
+    uint8_t len;                    /**< number of frames queued */
+} _neighbor_t;
+
+/**
+ * @brief   Last sequence number received from a neighbor
+ */
+typedef struct {
+    uint8_t addr[8];                /**< address as in the netif header */
+    uint8_t addr_len;               /**< address length, 0 if unused */
+    uint8_t seq;                    /**< last sequence number */
+} _dup_t;
+
+/**
+ * @brief   State of a CSMA layer
+ */
+typedef struct {
+    gnrc_netdev_t *dev;                     /**< the device */
+    kernel_pid_t pid;                       /**< PID of the layer */
+    gnrc_csma_params_t params;              /**< current parameters */
+    gnrc_ieee802154_cfg_t cfg;              /**< header configuration */
+    gnrc_ieee802154_hdr_cache_t hdr_cache;  /**< headers for the last
+                                             *   neighbors */
+    _entry_t entries[GNRC_CSMA_QUEUE_SIZE]; /**< queue entries */
+    _entry_t *free;                         /**< unused queue entries */
+    _neighbor_t neighbors[GNRC_CSMA_NEIGHBOR_NUMOF];  /**< TX queues */
+    _neighbor_t *cur;                       /**< neighbor of the frame in
+                                             *   flight */
+    _dup_t dups[GNRC_CSMA_DUP_NUMOF];       /**< duplicate detection */
+    xtimer_t timer;                         /**< backoff and ACK timer */
+    msg_t timer_msg;                        /**< message of the timer */
+    gnrc_nettype_t proto;                   /**< protocol of received
+                                             *   payloads */
+    uint8_t addr[2];                        /**< short address as in the
+                                             *   netif header */
+    uint8_t addr_long[8];                   /**< long address as in the
+                                             *   netif header */
+    uint8_t raw;                            /**< device is in raw mode */
+    uint8_t state;                          /**< state of the frame in
+                                             *   flight */
+    uint8_t seq;                            /**< next sequence number */
+    uint8_t tx_seq;                         /**< sequence number in flight */
+    uint8_t nb;                             /**< backoffs of the frame */
+    uint8_t be;                             /**< current backoff exponent */
+    uint8_t tx;                             /**< transmissions of the frame */
+    uint8_t timer_gen;                      /**< tells stale timer messages
+                                             *   apart */
+    uint8_t timer_pending;                  /**< timer message did not fit
+                                             *   into the queue */
+    uint8_t rr;                             /**< next neighbor to serve */
+    uint8_t dup_next;                       /**< duplicate entry to replace
+                                             *   next */
+} _csma_t;
+
+static _csma_t _csma[GNRC_CSMA_NUMOF];
+
+static const uint8_t _bcast[] = { 0xff, 0xff };
+
+static void _next(_csma_t *csma);
+
+static _csma_t *_get_csma(kernel_pid_t pid)
+{
+    for (unsigned i = 0; i < GNRC_CSMA_NUMOF; i++) {
+        if ((_csma[i].dev != NULL) && (_csma[i].pid == pid)) {
+            return &_csma[i];
+        }
+    }
+    return NULL;
+}
+
+static inline int _is_bcast(gnrc_netif_hdr_t *hdr)
+{
+    return (hdr->dst_l2addr_len == sizeof(_bcast)) &&
+           (memcmp(gnrc_netif_hdr_get_dst_addr(hdr), _bcast,
+                   sizeof(_bcast)) == 0);
+}
+
+/**
+ * @brief   Read the device configuration the headers are built from
+ */
+static void _refresh(_csma_t *csma)
+{
+    gnrc_netdev_t *dev = csma->dev;
+    uint16_t val;
+    uint64_t addr_long;
+
+    if (dev->driver->get(dev, NETOPT_NID, &val, sizeof(val)) > 0) {
+        csma->cfg.pan = val;
+    }
+    if (dev->driver->get(dev, NETOPT_ADDRESS, &val, sizeof(val)) > 0) {
+        memcpy(csma->addr, &val, sizeof(csma->addr));
+    }
+    if (dev->driver->get(dev, NETOPT_ADDRESS_LONG, &addr_long,
+                         sizeof(addr_long)) > 0) {
+        memcpy(csma->addr_long, &addr_long, sizeof(csma->addr_long));
+    }
+    if (dev->driver->get(dev, NETOPT_SRC_LEN, &val, sizeof(val)) > 0) {
+        csma->cfg.src_len = (val == 8) ? 8 : 2;
+    }
+    if (dev->driver->get(dev, NETOPT_PROTO, &csma->proto,
+                         sizeof(csma->proto)) < 0) {
+        csma->proto = GNRC_NETTYPE_UNDEF;
+    }
+    /* addresses are transmitted in reverse byte order */
+    for (unsigned i = 0; i < csma->cfg.src_len; i++) {
+        csma->cfg.src[i] = (csma->cfg.src_len == 8)
+                           ? csma->addr_long[7 - i] : csma->addr[1 - i];
+    }
+    csma->cfg.opts = (csma->params.flags & GNRC_CSMA_FLAGS_ACK)
+                     ? GNRC_IEEE802154_OPT_ACK_REQ : 0;
+}
+
+/**
+ * @brief   (Re)start the timer, a message of the previous run still queued
+ *          is told apart by its generation
+ */
+static void _set_timer(_csma_t *csma, uint16_t type, uint32_t offset)
+{
+    xtimer_remove(&csma->timer);
+    csma->timer_pending = 0;
+    csma->timer_msg.type = type;
+    csma->timer_msg.content.value = ++csma->timer_gen;
+    if (offset == 0) {
+        /* with the queue full the event loop delivers the message itself */
+        if (msg_send_to_self(&csma->timer_msg) != 1) {
+            csma->timer_pending = 1;
+        }
+        return;
+    }
+    xtimer_set_msg(&csma->timer, offset, &csma->timer_msg, csma->pid);
+}
+
+static void _publish(kernel_pid_t pid, gnrc_csma_tx_status_t status,
+                     uint8_t tx, uint8_t seq)
+{
+    msg_t msg;
+
+    if (!pid_is_valid(pid)) {
+        return;
+    }
+    msg.type = GNRC_CSMA_MSG_TYPE_TX_STATUS;
+    msg.content.value = GNRC_CSMA_TX_STATUS(status, tx, seq);
+    msg_try_send(&msg, pid);
+}
+
+/**
+ * @brief   Dequeue the frame in flight and continue with the next one
+ */
+static void _finish(_csma_t *csma, gnrc_csma_tx_status_t status)
+{
+    _neighbor_t *n = csma->cur;
+    _entry_t *entry = n->queue;
+
+    DEBUG("csma: frame done with status %i after %u transmissions\n",
+          (int)status, (unsigned)csma->tx);
+    xtimer_remove(&csma->timer);
+    LL_DELETE(n->queue, entry);
+    n->len--;
+    gnrc_pktbuf_release(entry->pkt);
+    LL_PREPEND(csma->free, entry);
+    _publish(entry->sender, status, csma->tx, csma->tx_seq);
+    csma->cur = NULL;
+    csma->state = STATE_IDLE;
+    _next(csma);
+}
+
+static void _transmit(_csma_t *csma)
+{
+    gnrc_pktsnip_t *pkt = csma->cur->queue->pkt;
+    int ack_req = 0;
+
+    if (csma->raw) {
+        ack_req = (((uint8_t *)pkt->next->data)[0] & IEEE802154_FCF_ACK_REQ);
+    }
+    csma->tx++;
+    /* keep the frame for retransmissions, the device releases it */
+    gnrc_pktbuf_hold(pkt, 1);
+    if (csma->dev->driver->send_data(csma->dev, pkt) < 0) {
+        DEBUG("csma: device failed to send\n");
+        _finish(csma, GNRC_CSMA_TX_ERROR);
+        return;
+    }
+    if (ack_req) {
+        csma->state = STATE_WAIT_ACK;
+        _set_timer(csma, GNRC_CSMA_MSG_TYPE_ACK_TIMEOUT,
+                   csma->params.ack_wait);
+        return;
+    }
+    _finish(csma, GNRC_CSMA_TX_OK);
+}
+
+static void _backoff(_csma_t *csma)
+{
+    uint32_t periods = 0;
+
+    csma->state = STATE_BACKOFF;
+    if (csma->params.flags & GNRC_CSMA_FLAGS_BACKOFF) {
+        periods = genrand_uint32() & ((1UL << csma->be) - 1);
+    }
+    _set_timer(csma, GNRC_CSMA_MSG_TYPE_BACKOFF,
+               periods * GNRC_CSMA_UNIT_BACKOFF_US);
+}
+
+static void _backoff_expired(_csma_t *csma)
+{
+    netopt_enable_t clear;
+
+    if (csma->params.flags & GNRC_CSMA_FLAGS_CCA) {
+        /* devices without CCA are assumed to have a clear channel */
+        if ((csma->dev->driver->get(csma->dev, NETOPT_IS_CHANNEL_CLR, &clear,
+                                    sizeof(clear)) > 0) &&
+            (clear == NETOPT_DISABLE)) {
+            DEBUG("csma: channel busy\n");
+            if (++csma->nb > csma->params.max_backoffs) {
+                _finish(csma, GNRC_CSMA_TX_CHANNEL_BUSY);
+                return;
+            }
+            if (csma->be < csma->params.max_be) {
+                csma->be++;
+            }
+            _backoff(csma);
+            return;
+        }
+    }
+    _transmit(csma);
+}
+
+static void _ack_timeout(_csma_t *csma)
+{
+    DEBUG("csma: no ACK for %u\n", (unsigned)csma->tx_seq);
+    if (csma->tx > csma->params.max_retries) {
+        _finish(csma, GNRC_CSMA_TX_NOACK);
+        return;
+    }
+    csma->nb = 0;
+    csma->be = csma->params.min_be;
+    _backoff(csma);
+}
+
+/**
+ * @brief   Put the MAC header in front of the payload of a frame
+ */
+static int _add_hdr(_csma_t *csma, _entry_t *entry)
+{
+    gnrc_pktsnip_t *pkt, *mhr;
+    uint8_t buf[IEEE802154_MAX_HDR_LEN];
+    size_t len;
+
+    pkt = gnrc_pktbuf_start_write(entry->pkt);
+    if (pkt == NULL) {
+        return -ENOBUFS;
+    }
+    entry->pkt = pkt;
+    len = gnrc_ieee802154_build_hdr(&csma->hdr_cache, &csma->cfg, pkt->data,
+                                    csma->seq, buf);
+    if (len == 0) {
+        return -ENOMSG;
+    }
+    mhr = gnrc_pktbuf_add(pkt->next, buf, len, GNRC_NETTYPE_UNDEF);
+    if (mhr == NULL) {
+        return -ENOBUFS;
+    }
+    pkt->next = mhr;
+    csma->tx_seq = csma->seq++;
+    return 0;
+}
+
+/**
+ * @brief   Start the next frame, serving the neighbors round robin
+ */
+static void _next(_csma_t *csma)
+{
+    for (unsigned i = 0; i < GNRC_CSMA_NEIGHBOR_NUMOF; i++) {
+        _neighbor_t *n = &csma->neighbors[(csma->rr + i) %
+                                          GNRC_CSMA_NEIGHBOR_NUMOF];
+
+        if (n->queue == NULL) {
+            continue;
+        }
+        csma->rr = (csma->rr + i + 1) % GNRC_CSMA_NEIGHBOR_NUMOF;
+        csma->cur = n;
+        csma->nb = 0;
+        csma->be = csma->params.min_be;
+        csma->tx = 0;
+        csma->tx_seq = 0;
+        if (csma->raw && (_add_hdr(csma, n->queue) < 0)) {
+            DEBUG("csma: unable to build MAC header\n");
+            _finish(csma, GNRC_CSMA_TX_ERROR);
+            return;
+        }
+        _backoff(csma);
+        return;
+    }
+}
+
+static void _enqueue(_csma_t *csma, gnrc_pktsnip_t *pkt, kernel_pid_t sender)
+{
+    gnrc_netif_hdr_t *netif;
+    const uint8_t *dst;
+    uint8_t dst_len;
+    _neighbor_t *n = NULL;
+    _entry_t *entry;
+
+    if (pkt->type != GNRC_NETTYPE_NETIF) {
+        DEBUG("csma: first header is not generic netif header\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    netif = pkt->data;
+    if (netif->flags &
+        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
+        dst = _bcast;
+        dst_len = sizeof(_bcast);
+    }
+    else {
+        dst = gnrc_netif_hdr_get_dst_addr(netif);
+        dst_len = netif->dst_l2addr_len;
+    }
+    for (unsigned i = 0; i < GNRC_CSMA_NEIGHBOR_NUMOF; i++) {
+        _neighbor_t *tmp = &csma->neighbors[i];
+
+        if (tmp->queue == NULL) {
+            if (n == NULL) {
+                n = tmp;
+            }
+        }
+        else if ((tmp->addr_len == dst_len) &&
+                 (memcmp(tmp->addr, dst, dst_len) == 0)) {
+            n = tmp;
+            break;
+        }
+    }
+    if ((n == NULL) || (dst_len > sizeof(n->addr)) || (csma->free == NULL) ||
+        (n->len >= GNRC_CSMA_NEIGHBOR_QUEUE_LEN)) {
+        DEBUG("csma: queue full, dropping packet\n");
+        gnrc_pktbuf_release(pkt);
+        _publish(sender, GNRC_CSMA_TX_QUEUE_FULL, 0, 0);
+        return;
+    }
+    if (n->queue == NULL) {
+        memcpy(n->addr, dst, dst_len);
+        n->addr_len = dst_len;
+    }
+    entry = csma->free;
+    LL_DELETE(csma->free, entry);
+    entry->pkt = pkt;
+    entry->sender = sender;
+    entry->next = NULL;
+    LL_APPEND(n->queue, entry);
+    n->len++;
+    if (csma->state == STATE_IDLE) {
+        _next(csma);
+    }
+}
+
+static void _send_ack(_csma_t *csma, uint8_t seq)
+{
+    gnrc_pktsnip_t *ack, *netif;
+    uint8_t frame[ACK_LEN] = { IEEE802154_FCF_TYPE_ACK, 0, seq };
+
+    ack = gnrc_pktbuf_add(NULL, frame, sizeof(frame), GNRC_NETTYPE_UNDEF);
+    if (ack == NULL) {
+        return;
+    }
+    netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    if (netif == NULL) {
+        gnrc_pktbuf_release(ack);
+        return;
+    }
+    netif->next = ack;
+    /* ACKs are sent right away, without backoff */
+    csma->dev->driver->send_data(csma->dev, netif);
+}
+
+static int _is_dup(_csma_t *csma, gnrc_netif_hdr_t *netif, uint8_t seq)
+{
+    uint8_t *src = gnrc_netif_hdr_get_src_addr(netif);
+    _dup_t *dup;
+
+    for (unsigned i = 0; i < GNRC_CSMA_DUP_NUMOF; i++) {
+        dup = &csma->dups[i];
+        if ((dup->addr_len == netif->src_l2addr_len) &&
+            (memcmp(dup->addr, src, dup->addr_len) == 0)) {
+            if (dup->seq == seq) {
+                return 1;
+            }
+            dup->seq = seq;
+            return 0;
+        }
+    }
+    if (netif->src_l2addr_len > sizeof(dup->addr)) {
+        return 0;
+    }
+    dup = &csma->dups[csma->dup_next];
+    csma->dup_next = (csma->dup_next + 1) % GNRC_CSMA_DUP_NUMOF;
+    memcpy(dup->addr, src, netif->src_l2addr_len);
+    dup->addr_len = netif->src_l2addr_len;
+    dup->seq = seq;
+    return 0;
+}
+
+static int _for_us(_csma_t *csma, gnrc_netif_hdr_t *netif)
+{
+    uint8_t *dst = gnrc_netif_hdr_get_dst_addr(netif);
+
+    switch (netif->dst_l2addr_len) {
+        case 2:
+            return (memcmp(dst, _bcast, sizeof(_bcast)) == 0) ||
+                   (memcmp(dst, csma->addr, sizeof(csma->addr)) == 0);
+        case 8:
+            return (memcmp(dst, csma->addr_long, sizeof(csma->addr_long)) == 0);
+        default:
+            return 0;
+    }
+}
+
+static void _dispatch(gnrc_pktsnip_t *pkt)
+{
+    if (!gnrc_netapi_dispatch_receive(pkt->type, GNRC_NETREG_DEMUX_CTX_ALL,
+                                      pkt)) {
+        DEBUG("csma: unable to forward packet of type %i\n", pkt->type);
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+/**
+ * @brief   Handle a raw frame received by the device
+ */
+static void _receive(_csma_t *csma, gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *dev_netif, *netif, *mhr;
+    gnrc_netif_hdr_t *hdr;
+    uint8_t *frame = pkt->data;
+    size_t hdr_len;
+
+    if (pkt->size < ACK_LEN) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    switch (frame[0] & IEEE802154_FCF_TYPE_MASK) {
+        case IEEE802154_FCF_TYPE_ACK:
+            if ((csma->state == STATE_WAIT_ACK) && (frame[2] == csma->tx_seq)) {
+                DEBUG("csma: ACK for %u\n", (unsigned)frame[2]);
+                _finish(csma, GNRC_CSMA_TX_OK);
+            }
+            gnrc_pktbuf_release(pkt);
+            return;
+        case IEEE802154_FCF_TYPE_DATA:
+            break;
+        default:
+            gnrc_pktbuf_release(pkt);
+            return;
+    }
+
+    hdr_len = gnrc_ieee802154_get_hdr_len(frame);
+    if ((hdr_len == 0) || (hdr_len >= pkt->size) ||
+        ((netif = gnrc_ieee802154_make_netif_hdr(frame, hdr_len)) == NULL)) {
+        DEBUG("csma: unable to parse MAC header\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    hdr = netif->data;
+    if (!_for_us(csma, hdr)) {
+        gnrc_pktbuf_release(netif);
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    if ((frame[0] & IEEE802154_FCF_ACK_REQ) && !_is_bcast(hdr)) {
+        _send_ack(csma, frame[2]);
+    }
+    /* the ACK to a retransmission got lost, drop the copy */
+    if (_is_dup(csma, hdr, frame[2])) {
+        DEBUG("csma: dropping duplicate %u\n", (unsigned)frame[2]);
+        gnrc_pktbuf_release(netif);
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+
+    hdr->if_pid = csma->pid;
+    LL_SEARCH_SCALAR(pkt, dev_netif, type, GNRC_NETTYPE_NETIF);
+    if (dev_netif != NULL) {
+        hdr->lqi = ((gnrc_netif_hdr_t *)dev_netif->data)->lqi;
+        hdr->rssi = ((gnrc_netif_hdr_t *)dev_netif->data)->rssi;
+        pkt = gnrc_pktbuf_remove_snip(pkt, dev_netif);
+    }
+    mhr = gnrc_pktbuf_mark(pkt, hdr_len, GNRC_NETTYPE_UNDEF);
+    if (mhr == NULL) {
+        gnrc_pktbuf_release(netif);
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    pkt = gnrc_pktbuf_remove_snip(pkt, mhr);
+    pkt->type = csma->proto;
+    LL_APPEND(pkt, netif);
+    _dispatch(pkt);
+}
+
+/**
+ * @brief   Function called by the device driver on device events
+ *
+ * @param[in] event         type of event
+ * @param[in] data          optional parameter
+ */
+static void _event_cb(gnrc_netdev_event_t event, void *data)
+{
+    _csma_t *csma = _get_csma(thread_getpid());
+
+    DEBUG("csma: event triggered -> %i\n", event);
+    if ((event != NETDEV_EVENT_RX_COMPLETE) || (csma == NULL)) {
+        return;
+    }
+    if (csma->raw) {
+        _receive(csma, (gnrc_pktsnip_t *)data);
+    }
+    else {
+        _dispatch((gnrc_pktsnip_t *)data);
+    }
+}
+
+static void _set_flag(_csma_t *csma, uint8_t flag, netopt_enable_t enable)
+{
+    if (enable == NETOPT_ENABLE) {
+        csma->params.flags |= flag;
+    }
+    else {
+        csma->params.flags &= ~flag;
+    }
+}
+
+/**
+ * @brief   Handle options of the MAC layer itself
+ *
+ * @return  -ENOTSUP for options of the device
+ */
+static int _get(_csma_t *csma, gnrc_netapi_opt_t *opt)
+{
+    uint8_t *val8 = opt->data;
+
+    switch (opt->opt) {
+        case NETOPT_CSMA:
+        case NETOPT_AUTOACK:
+            if (opt->data_len < sizeof(netopt_enable_t)) {
+                return -EOVERFLOW;
+            }
+            if ((opt->opt == NETOPT_AUTOACK) && !csma->raw) {
+                return -ENOTSUP;
+            }
+            *((netopt_enable_t *)opt->data) =
+                (csma->params.flags & ((opt->opt == NETOPT_CSMA)
+                                       ? GNRC_CSMA_FLAGS_BACKOFF
+                                       : GNRC_CSMA_FLAGS_ACK))
+                ? NETOPT_ENABLE : NETOPT_DISABLE;
+            return sizeof(netopt_enable_t);
+        case NETOPT_CSMA_RETRIES:
+            if (opt->data_len < sizeof(uint8_t)) {
+                return -EOVERFLOW;
+            }
+            *val8 = csma->params.max_backoffs;
+            return sizeof(uint8_t);
+        case NETOPT_RETRANS:
+            if (!csma->raw) {
+                return -ENOTSUP;
+            }
+            if (opt->data_len < sizeof(uint8_t)) {
+                return -EOVERFLOW;
+            }
+            *val8 = csma->params.max_retries;
+            return sizeof(uint8_t);
+        default:
+            return -ENOTSUP;
+    }
+}
+
+static int _set(_csma_t *csma, gnrc_netapi_opt_t *opt)
+{
+    uint8_t *val8 = opt->data;
+
+    switch (opt->opt) {
+        case NETOPT_CSMA:
+            if (opt->data_len < sizeof(netopt_enable_t)) {
+                return -EOVERFLOW;
+            }
+            _set_flag(csma, GNRC_CSMA_FLAGS_CCA | GNRC_CSMA_FLAGS_BACKOFF,
+                      *((netopt_enable_t *)opt->data));
+            return sizeof(netopt_enable_t);
+        case NETOPT_AUTOACK:
+            if (!csma->raw) {
+                return -ENOTSUP;
+            }
+            if (opt->data_len < sizeof(netopt_enable_t)) {
+                return -EOVERFLOW;
+            }
+            _set_flag(csma, GNRC_CSMA_FLAGS_ACK,
+                      *((netopt_enable_t *)opt->data));
+            _refresh(csma);
+            return sizeof(netopt_enable_t);
+        case NETOPT_CSMA_RETRIES:
+            if (opt->data_len < sizeof(uint8_t)) {
+                return -EOVERFLOW;
+            }
+            csma->params.max_backoffs = *val8;
+            return sizeof(uint8_t);
+        case NETOPT_RETRANS:
+            if (!csma->raw) {
+                return -ENOTSUP;
+            }
+            if (opt->data_len < sizeof(uint8_t)) {
+                return -EOVERFLOW;
+            }
+            csma->params.max_retries = *val8;
+            return sizeof(uint8_t);
+        default:
+            return -ENOTSUP;
+    }
+}
+
+/**
+ * @brief   Startup code and event loop of the CSMA layer
+ *
+ * @param[in] args          expects a pointer to the layer's state
+ *
+ * @return                  never returns
+ */
+static void *_csma_thread(void *args)
+{
+    _csma_t *csma = (_csma_t *)args;
+    gnrc_netdev_t *dev = csma->dev;
+    gnrc_netapi_opt_t *opt;
+    netopt_enable_t enable = NETOPT_ENABLE;
+    int res;
+    msg_t msg, reply, msg_queue[GNRC_CSMA_MSG_QUEUE_SIZE];
+
+    /* setup the MAC layers message queue */
+    msg_init_queue(msg_queue, GNRC_CSMA_MSG_QUEUE_SIZE);
+    /* save the PID to the device descriptor and register the device */
+    csma->pid = thread_getpid();
+    dev->mac_pid = csma->pid;
+    gnrc_netif_add(dev->mac_pid);
+    /* register the event callback with the device driver */
+    dev->driver->add_event_callback(dev, _event_cb);
+    /* take over header handling and ACKs if the device allows */
+    if (dev->driver->set(dev, NETOPT_RAWMODE, &enable, sizeof(enable)) > 0) {
+        enable = NETOPT_DISABLE;
+        dev->driver->set(dev, NETOPT_AUTOACK, &enable, sizeof(enable));
+        csma->raw = 1;
+    }
+    _refresh(csma);
+    DEBUG("csma: started, raw mode %s\n", csma->raw ? "on" : "off");
+
+    /* start the event loop */
+    while (1) {
+        if (csma->timer_pending) {
+            csma->timer_pending = 0;
+            msg = csma->timer_msg;
+        }
+        else {
+            msg_receive(&msg);
+        }
+        /* dispatch NETDEV, NETAPI and timer messages */
+        switch (msg.type) {
+            case GNRC_NETDEV_MSG_TYPE_EVENT:
+                DEBUG("csma: GNRC_NETDEV_MSG_TYPE_EVENT received\n");
+                dev->driver->isr_event(dev, msg.content.value);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                DEBUG("csma: GNRC_NETAPI_MSG_TYPE_SND received\n");
+                _enqueue(csma, (gnrc_pktsnip_t *)msg.content.ptr,
+                         msg.sender_pid);
+                break;
+            case GNRC_CSMA_MSG_TYPE_BACKOFF:
+                if ((csma->state == STATE_BACKOFF) &&
+                    (msg.content.value == csma->timer_gen)) {
+                    _backoff_expired(csma);
+                }
+                break;
+            case GNRC_CSMA_MSG_TYPE_ACK_TIMEOUT:
+                if ((csma->state == STATE_WAIT_ACK) &&
+                    (msg.content.value == csma->timer_gen)) {
+                    _ack_timeout(csma);
+                }
+                break;
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                DEBUG("csma: GNRC_NETAPI_MSG_TYPE_SET received\n");
+                opt = (gnrc_netapi_opt_t *)msg.content.ptr;
+                res = _set(csma, opt);
+                if (res == -ENOTSUP) {
+                    res = dev->driver->set(dev, opt->opt, opt->data,
+                                           opt->data_len);
+                    /* addresses, PAN ID or protocol may have changed */
+                    _refresh(csma);
+                }
+                DEBUG("csma: response of netdev->set: %i\n", res);
+                reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+                reply.content.value = (uint32_t)res;
+                msg_reply(&msg, &reply);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+                DEBUG("csma: GNRC_NETAPI_MSG_TYPE_GET received\n");
+                opt = (gnrc_netapi_opt_t *)msg.content.ptr;
+                res = _get(csma, opt);
+                if (res == -ENOTSUP) {
+                    res = dev->driver->get(dev, opt->opt, opt->data,
+                                           opt->data_len);
+                }
+                DEBUG("csma: response of netdev->get: %i\n", res);
+                reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+                reply.content.value = (uint32_t)res;
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                DEBUG("csma: Unknown command %" PRIu16 "\n", msg.type);
+                break;
+        }
+    }
+    /* never reached */
+    return NULL;
+}
+
+kernel_pid_t gnrc_csma_init(char *stack, int stacksize, char priority,
+                            const char *name, gnrc_netdev_t *dev,
+                            const gnrc_csma_params_t *params)
+{
+    static const gnrc_csma_params_t defaults = GNRC_CSMA_PARAMS_DEFAULT;
+    _csma_t *csma;
+    kernel_pid_t res;
+
+    /* check if given netdev device is defined and the driver is set */
+    if (dev == NULL || dev->driver == NULL) {
+        return -ENODEV;
+    }
+    for (csma = _csma; csma < &_csma[GNRC_CSMA_NUMOF]; csma++) {
+        if (csma->dev == NULL) {
+            break;
+        }
+    }
+    if (csma == &_csma[GNRC_CSMA_NUMOF]) {
+        return -ENOMEM;
+    }
+    memset(csma, 0, sizeof(_csma_t));
+    csma->dev = dev;
+    csma->params = (params) ? *params : defaults;
+    for (unsigned i = 0; i < GNRC_CSMA_QUEUE_SIZE; i++) {
+        LL_PREPEND(csma->free, &csma->entries[i]);
+    }
+    csma->seq = (uint8_t)genrand_uint32();
+    /* create new CSMA thread */
+    res = thread_create(stack, stacksize, priority, CREATE_STACKTEST,
+                        _csma_thread, (void *)csma, name);
+    if (res <= 0) {
+        csma->dev = NULL;
+        return -EINVAL;
+    }
+    return res;
+}
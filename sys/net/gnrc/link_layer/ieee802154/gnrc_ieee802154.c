@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/ieee802154.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/**
+ * @brief   Position of the sequence number in the MAC header
+ */
+#define SEQ_POS         (2U)
+
+/**
+ * @brief   Position of the destination PAN ID in the MAC header
+ */
+#define DST_PAN_POS     (3U)
+
+static const uint8_t _bcast[] = { 0xff, 0xff };
+
+/**
+ * @brief   Address length for the addressing mode bits of the FCF
+ */
+static inline int _addr_len(uint8_t mode)
+{
+    switch (mode) {
+        case IEEE802154_FCF_DST_ADDR_VOID:
+            return 0;
+        case IEEE802154_FCF_DST_ADDR_SHORT:
+            return 2;
+        case IEEE802154_FCF_DST_ADDR_LONG:
+            return 8;
+        default:
+            return -1;
+    }
+}
+
+static inline int _cfg_equal(const gnrc_ieee802154_cfg_t *a,
+                             const gnrc_ieee802154_cfg_t *b)
+{
+    return (a->pan == b->pan) && (a->opts == b->opts) &&
+           (a->src_len == b->src_len) &&
+           (memcmp(a->src, b->src, a->src_len) == 0);
+}
+
+static size_t _build(gnrc_ieee802154_tmpl_t *tmpl,
+                     const gnrc_ieee802154_cfg_t *cfg, int bcast)
+{
+    uint8_t *buf = tmpl->hdr;
+    size_t pos = DST_PAN_POS;
+
+    /* we are building a data frame here */
+    buf[0] = IEEE802154_FCF_TYPE_DATA;
+    buf[1] = IEEE802154_FCF_VERS_V1;
+    buf[SEQ_POS] = 0;
+    if (!bcast && (cfg->opts & GNRC_IEEE802154_OPT_ACK_REQ)) {
+        buf[0] |= IEEE802154_FCF_ACK_REQ;
+    }
+
+    /* destination PAN ID and address, the address is reversed */
+    buf[pos++] = (uint8_t)(cfg->pan & 0xff);
+    buf[pos++] = (uint8_t)(cfg->pan >> 8);
+    buf[1] |= (tmpl->dst_len == 8) ? IEEE802154_FCF_DST_ADDR_LONG
+                                   : IEEE802154_FCF_DST_ADDR_SHORT;
+    for (int i = tmpl->dst_len - 1; i >= 0; i--) {
+        buf[pos++] = tmpl->dst[i];
+    }
+
+    /* source PAN ID, if applicable */
+    if (cfg->opts & GNRC_IEEE802154_OPT_USE_SRC_PAN) {
+        buf[pos++] = (uint8_t)(cfg->pan & 0xff);
+        buf[pos++] = (uint8_t)(cfg->pan >> 8);
+    }
+    else {
+        buf[0] |= IEEE802154_FCF_PAN_COMP;
+    }
+
+    /* source address */
+    buf[1] |= (cfg->src_len == 8) ? IEEE802154_FCF_SRC_ADDR_LONG
+                                  : IEEE802154_FCF_SRC_ADDR_SHORT;
+    memcpy(&buf[pos], cfg->src, cfg->src_len);
+    pos += cfg->src_len;
+
+    tmpl->len = pos;
+    return pos;
+}
+
+size_t gnrc_ieee802154_build_hdr(gnrc_ieee802154_hdr_cache_t *cache,
+                                 const gnrc_ieee802154_cfg_t *cfg,
+                                 const gnrc_netif_hdr_t *netif,
+                                 uint8_t seq, uint8_t *buf)
+{
+    gnrc_ieee802154_tmpl_t *tmpl;
+    const uint8_t *dst;
+    uint8_t dst_len;
+    int bcast;
+
+    if (netif->flags &
+        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
+        dst = _bcast;
+        dst_len = sizeof(_bcast);
+    }
+    else if ((netif->dst_l2addr_len == 2) || (netif->dst_l2addr_len == 8)) {
+        dst = gnrc_netif_hdr_get_dst_addr((gnrc_netif_hdr_t *)netif);
+        dst_len = netif->dst_l2addr_len;
+    }
+    else {
+        /* unsupported address length */
+        return 0;
+    }
+    bcast = (dst_len == 2) && (memcmp(dst, _bcast, sizeof(_bcast)) == 0);
+
+    /* a changed address, PAN or option invalidates all headers */
+    if (!_cfg_equal(&cache->cfg, cfg)) {
+        DEBUG("ieee802154: configuration changed, flush header cache\n");
+        memset(cache, 0, sizeof(gnrc_ieee802154_hdr_cache_t));
+        cache->cfg = *cfg;
+    }
+
+    for (unsigned i = 0; i < GNRC_IEEE802154_HDR_CACHE_SIZE; i++) {
+        tmpl = &cache->tmpl[i];
+        if ((tmpl->dst_len == dst_len) &&
+            (memcmp(tmpl->dst, dst, dst_len) == 0)) {
+            goto out;
+        }
+    }
+
+    /* miss, replace the entries round robin */
+    tmpl = &cache->tmpl[cache->next];
+    cache->next = (cache->next + 1) % GNRC_IEEE802154_HDR_CACHE_SIZE;
+    memcpy(tmpl->dst, dst, dst_len);
+    tmpl->dst_len = dst_len;
+    _build(tmpl, cfg, bcast);
+
+out:
+    memcpy(buf, tmpl->hdr, tmpl->len);
+    buf[SEQ_POS] = seq;
+    return tmpl->len;
+}
+
+size_t gnrc_ieee802154_get_hdr_len(const uint8_t *mhr)
+{
+    int dst_len = _addr_len(mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
+    int src_len = _addr_len((mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK) >> 4);
+    size_t len = DST_PAN_POS;
+
+    if ((dst_len < 0) || (src_len < 0)) {
+        return 0;
+    }
+    if (dst_len > 0) {
+        len += 2 + dst_len;
+    }
+    if (src_len > 0) {
+        if (!(mhr[0] & IEEE802154_FCF_PAN_COMP) || (dst_len == 0)) {
+            len += 2;
+        }
+        len += src_len;
+    }
+    return len;
+}
+
+gnrc_pktsnip_t *gnrc_ieee802154_make_netif_hdr(const uint8_t *mhr, size_t len)
+{
+    gnrc_pktsnip_t *snip;
+    gnrc_netif_hdr_t *hdr;
+    uint8_t *addr;
+    int dst_len, src_len;
+    size_t hdr_len, pos = DST_PAN_POS;
+
+    if (len < IEEE802154_FCF_LEN) {
+        return NULL;
+    }
+    hdr_len = gnrc_ieee802154_get_hdr_len(mhr);
+    if ((hdr_len == 0) || (hdr_len > len)) {
+        return NULL;
+    }
+    dst_len = _addr_len(mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
+    src_len = _addr_len((mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK) >> 4);
+
+    snip = gnrc_pktbuf_add(NULL, NULL,
+                           sizeof(gnrc_netif_hdr_t) + src_len + dst_len,
+                           GNRC_NETTYPE_NETIF);
+    if (snip == NULL) {
+        return NULL;
+    }
+    hdr = (gnrc_netif_hdr_t *)snip->data;
+    gnrc_netif_hdr_init(hdr, src_len, dst_len);
+
+    /* addresses are transmitted in reverse byte order */
+    if (dst_len > 0) {
+        pos += 2;
+        addr = gnrc_netif_hdr_get_dst_addr(hdr);
+        for (int i = dst_len - 1; i >= 0; i--) {
+            addr[i] = mhr[pos++];
+        }
+    }
+    if (src_len > 0) {
+        if (!(mhr[0] & IEEE802154_FCF_PAN_COMP) || (dst_len == 0)) {
+            pos += 2;
+        }
+        addr = gnrc_netif_hdr_get_src_addr(hdr);
+        for (int i = src_len - 1; i >= 0; i--) {
+            addr[i] = mhr[pos++];
+        }
+    }
+    return snip;
+}
+/** @} */
@@ -0,0 +1,738 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ * @ingroup     net_gnrc_lpl
+ * @file
+ * @brief       Implementation of the low power listening MAC layer
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "irq.h"
+#include "kernel.h"
+#include "msg.h"
+#include "thread.h"
+#include "utlist.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/lpl.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if ENABLE_DEBUG
+/* For PRIu16 etc. */
+#include <inttypes.h>
+#endif
+
+/**
+ * @name    Frame types of the LPL header
+ * @{
+ */
+#define TYPE_DATA           (0x01)  /**< unicast frame, to be acknowledged */
+#define TYPE_BCAST          (0x02)  /**< broadcast frame */
+#define TYPE_ACK            (0x03)  /**< acknowledgement */
+/** @} */
+
+/**
+ * @brief   Maximum length of a link layer address kept by the layer
+ */
+#define ADDR_MAX_LEN        (8U)
+
+/**
+ * @brief   Header put in front of every frame
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t type;                   /**< frame type */
+    uint8_t seq;                    /**< sequence number */
+} _hdr_t;
+
+/**
+ * @brief   States of the frame in flight
+ */
+enum {
+    STATE_IDLE = 0,                 /**< nothing to send */
+    STATE_PHASE,                    /**< waiting for the neighbor to wake up */
+    STATE_STROBE,                   /**< strobing */
+};
+
+/**
+ * @brief   Queued frame
+ */
+typedef struct entry {
+    struct entry *next;             /**< next queued frame */
+    gnrc_pktsnip_t *pkt;            /**< the frame */
+    uint32_t since;                 /**< time the frame was queued */
+} _entry_t;
+
+/**
+ * @brief   Link layer address of a neighbor
+ */
+typedef struct {
+    uint8_t addr[ADDR_MAX_LEN];     /**< address as in the netif header */
+    uint8_t addr_len;               /**< address length, 0 if unused */
+} _addr_t;
+
+/**
+ * @brief   Wake up phase of a neighbor
+ */
+typedef struct {
+    _addr_t addr;                   /**< the neighbor */
+    uint32_t ref;                   /**< the neighbor woke up not before */
+} _phase_t;
+
+/**
+ * @brief   Last sequence number received from a neighbor
+ */
+typedef struct {
+    _addr_t addr;                   /**< the neighbor */
+    uint8_t seq;                    /**< last sequence number */
+} _dup_t;
+
+/**
+ * @brief   Timer telling stale messages apart by their generation
+ */
+typedef struct {
+    xtimer_t timer;                 /**< the timer */
+    msg_t msg;                      /**< message of the timer */
+    uint8_t gen;                    /**< generation of the message */
+} _timer_t;
+
+/**
+ * @brief   State of a LPL layer
+ */
+typedef struct {
+    gnrc_netdev2_t *gnrc_netdev2;           /**< the device */
+    kernel_pid_t pid;                       /**< PID of the layer */
+    gnrc_lpl_params_t params;               /**< parameters */
+    gnrc_lpl_stats_t stats;                 /**< statistics */
+    _entry_t entries[GNRC_LPL_QUEUE_SIZE];  /**< queue entries */
+    _entry_t *free;                         /**< unused queue entries */
+    _entry_t *queue;                        /**< queued frames, the head is
+                                             *   in flight */
+    _phase_t phases[GNRC_LPL_PHASE_NUMOF];  /**< wake up phases */
+    _dup_t dups[GNRC_LPL_DUP_NUMOF];        /**< duplicate detection */
+    _timer_t wakeup;                        /**< start of listen windows */
+    _timer_t listen;                        /**< end of a listen window */
+    _timer_t strobe;                        /**< strobes and phase waits */
+    _addr_t dst;                            /**< destination in flight */
+    uint64_t start;                         /**< initialization time */
+    uint64_t on_since;                      /**< radio switched on at */
+    uint32_t next_wakeup;                   /**< start of the next window */
+    uint32_t strobe_start;                  /**< first strobe of the train */
+    uint32_t strobe_len;                    /**< length of the train */
+    uint8_t state;                          /**< state of the frame in
+                                             *   flight */
+    uint8_t bcast;                          /**< frame in flight is
+                                             *   broadcast */
+    uint8_t locked;                         /**< train aims at a known
+                                             *   phase */
+    uint8_t seq;                            /**< next sequence number */
+    uint8_t tx_seq;                         /**< sequence number in flight */
+    uint8_t on;                             /**< radio is on */
+    uint8_t listening;                      /**< in a listen window */
+    uint8_t active;                         /**< frames arrived in the
+                                             *   current window */
+    uint8_t phase_next;                     /**< phase entry to replace
+                                             *   next */
+    uint8_t dup_next;                       /**< duplicate entry to replace
+                                             *   next */
+} _lpl_t;
+
+static _lpl_t _lpl[GNRC_LPL_NUMOF];
+
+static void _next(_lpl_t *lpl);
+
+static _lpl_t *_get_lpl(kernel_pid_t pid)
+{
+    for (unsigned i = 0; i < GNRC_LPL_NUMOF; i++) {
+        if ((_lpl[i].gnrc_netdev2 != NULL) && (_lpl[i].pid == pid)) {
+            return &_lpl[i];
+        }
+    }
+    return NULL;
+}
+
+static void _set_timer(_lpl_t *lpl, _timer_t *t, uint16_t type,
+                       uint32_t offset)
+{
+    xtimer_remove(&t->timer);
+    t->msg.type = type;
+    t->msg.content.value = ++t->gen;
+    if (offset == 0) {
+        msg_send_to_self(&t->msg);
+        return;
+    }
+    xtimer_set_msg(&t->timer, offset, &t->msg, lpl->pid);
+}
+
+static inline int _addr_equal(const _addr_t *addr, const uint8_t *other,
+                              uint8_t len)
+{
+    return (addr->addr_len == len) && (memcmp(addr->addr, other, len) == 0);
+}
+
+static inline void _addr_set(_addr_t *addr, const uint8_t *other, uint8_t len)
+{
+    memcpy(addr->addr, other, len);
+    addr->addr_len = len;
+}
+
+/**
+ * @brief   Switch the radio on while listening or strobing and off otherwise
+ */
+static void _update_radio(_lpl_t *lpl)
+{
+    netdev2_t *dev = lpl->gnrc_netdev2->dev;
+    netopt_state_t state;
+    uint8_t on = lpl->listening || (lpl->state == STATE_STROBE) ||
+                 (lpl->params.interval == 0);
+    uint64_t now;
+
+    if (on == lpl->on) {
+        return;
+    }
+    state = (on) ? NETOPT_STATE_IDLE : NETOPT_STATE_SLEEP;
+    if (dev->driver->set(dev, NETOPT_STATE, &state, sizeof(state)) < 0) {
+        DEBUG("lpl: unable to switch the radio %s\n", (on) ? "on" : "off");
+        return;
+    }
+    now = xtimer_now64();
+    unsigned irq = disableIRQ();
+    if (on) {
+        lpl->on_since = now;
+    }
+    else {
+        lpl->stats.radio_on += now - lpl->on_since;
+    }
+    lpl->on = on;
+    restoreIRQ(irq);
+}
+
+static _phase_t *_find_phase(_lpl_t *lpl, const uint8_t *addr, uint8_t len)
+{
+    for (unsigned i = 0; i < GNRC_LPL_PHASE_NUMOF; i++) {
+        if (_addr_equal(&lpl->phases[i].addr, addr, len)) {
+            return &lpl->phases[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief   Remember when a neighbor woke up, it acknowledged a strobe now
+ */
+static void _learn_phase(_lpl_t *lpl, uint32_t now)
+{
+    _phase_t *phase = _find_phase(lpl, lpl->dst.addr, lpl->dst.addr_len);
+
+    if (phase == NULL) {
+        phase = &lpl->phases[lpl->phase_next];
+        lpl->phase_next = (lpl->phase_next + 1) % GNRC_LPL_PHASE_NUMOF;
+        phase->addr = lpl->dst;
+    }
+    /* it heard the last strobe, so it woke up at most one gap before */
+    phase->ref = now - lpl->params.gap;
+}
+
+static void _finish(_lpl_t *lpl, int acked)
+{
+    _entry_t *entry = lpl->queue;
+    uint32_t latency = xtimer_now() - entry->since;
+
+    DEBUG("lpl: frame %u done after %" PRIu32 " us, %s\n",
+          (unsigned)lpl->tx_seq, latency, (acked) ? "ok" : "no ACK");
+    xtimer_remove(&lpl->strobe.timer);
+    LL_DELETE(lpl->queue, entry);
+    gnrc_pktbuf_release(entry->pkt);
+    LL_PREPEND(lpl->free, entry);
+
+    unsigned irq = disableIRQ();
+    if (acked) {
+        lpl->stats.tx++;
+        lpl->stats.latency_sum += latency;
+        if ((lpl->stats.tx == 1) || (latency < lpl->stats.latency_min)) {
+            lpl->stats.latency_min = latency;
+        }
+        if (latency > lpl->stats.latency_max) {
+            lpl->stats.latency_max = latency;
+        }
+    }
+    else {
+        lpl->stats.tx_failed++;
+    }
+    restoreIRQ(irq);
+
+    lpl->state = STATE_IDLE;
+    _update_radio(lpl);
+    _next(lpl);
+}
+
+/**
+ * @brief   Send the frame in flight once more
+ */
+static void _strobe(_lpl_t *lpl)
+{
+    gnrc_pktsnip_t *pkt = lpl->queue->pkt;
+    uint32_t now = xtimer_now();
+    _phase_t *phase;
+
+    if (lpl->state != STATE_STROBE) {
+        lpl->state = STATE_STROBE;
+        lpl->strobe_start = now;
+        _update_radio(lpl);
+    }
+    else if ((now - lpl->strobe_start) >= lpl->strobe_len) {
+        if (!lpl->locked) {
+            /* broadcast frames are done, unicast frames failed */
+            _finish(lpl, lpl->bcast);
+            return;
+        }
+        /* the neighbor was not where we expected it, strobe once more for
+         * the whole interval */
+        DEBUG("lpl: lost the phase of the neighbor\n");
+        phase = _find_phase(lpl, lpl->dst.addr, lpl->dst.addr_len);
+        if (phase != NULL) {
+            phase->addr.addr_len = 0;
+        }
+        lpl->locked = 0;
+        lpl->strobe_start = now;
+        lpl->strobe_len = lpl->params.interval + lpl->params.listen;
+    }
+    lpl->stats.strobes++;
+    /* keep the frame for the next strobe, the adapter releases it */
+    gnrc_pktbuf_hold(pkt, 1);
+    if (lpl->gnrc_netdev2->send(lpl->gnrc_netdev2, pkt) < 0) {
+        DEBUG("lpl: device failed to send\n");
+    }
+    if (lpl->params.interval == 0) {
+        /* nobody sleeps, the frame is sent once */
+        _finish(lpl, 1);
+        return;
+    }
+    _set_timer(lpl, &lpl->strobe, GNRC_LPL_MSG_TYPE_STROBE, lpl->params.gap);
+}
+
+/**
+ * @brief   Put the LPL header in front of the payload of a frame
+ */
+static int _add_hdr(_lpl_t *lpl, _entry_t *entry)
+{
+    gnrc_pktsnip_t *pkt, *hdr;
+    gnrc_netif_hdr_t *netif;
+    _hdr_t data;
+
+    pkt = gnrc_pktbuf_start_write(entry->pkt);
+    if (pkt == NULL) {
+        return -ENOBUFS;
+    }
+    entry->pkt = pkt;
+    netif = pkt->data;
+    lpl->bcast = (netif->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                                  GNRC_NETIF_HDR_FLAGS_MULTICAST)) ||
+                 (netif->dst_l2addr_len == 0) ||
+                 (netif->dst_l2addr_len > ADDR_MAX_LEN);
+    if (!lpl->bcast) {
+        _addr_set(&lpl->dst, gnrc_netif_hdr_get_dst_addr(netif),
+                  netif->dst_l2addr_len);
+    }
+    data.type = (lpl->bcast) ? TYPE_BCAST : TYPE_DATA;
+    data.seq = lpl->seq;
+    /* adapters derive the link layer protocol from the snip following the
+     * netif header, so the header takes the type of the payload */
+    hdr = gnrc_pktbuf_add(pkt->next, &data, sizeof(data),
+                          (pkt->next) ? pkt->next->type : GNRC_NETTYPE_UNDEF);
+    if (hdr == NULL) {
+        return -ENOBUFS;
+    }
+    pkt->next = hdr;
+    lpl->tx_seq = lpl->seq++;
+    return 0;
+}
+
+/**
+ * @brief   Start the next queued frame
+ */
+static void _next(_lpl_t *lpl)
+{
+    _phase_t *phase;
+    uint32_t now, until;
+
+    if (lpl->queue == NULL) {
+        return;
+    }
+    if (_add_hdr(lpl, lpl->queue) < 0) {
+        DEBUG("lpl: unable to add header\n");
+        _finish(lpl, 0);
+        return;
+    }
+    lpl->locked = 0;
+    lpl->strobe_len = lpl->params.interval + lpl->params.listen;
+    phase = (lpl->bcast) ? NULL
+            : _find_phase(lpl, lpl->dst.addr, lpl->dst.addr_len);
+    if ((phase == NULL) || (lpl->params.interval == 0)) {
+        _strobe(lpl);
+        return;
+    }
+    /* strobe shortly before the neighbor wakes up the next time */
+    now = xtimer_now();
+    until = lpl->params.interval -
+            ((now - phase->ref) % lpl->params.interval);
+    lpl->locked = 1;
+    lpl->strobe_len = 2 * (lpl->params.guard + lpl->params.gap);
+    if (until <= lpl->params.guard) {
+        _strobe(lpl);
+        return;
+    }
+    lpl->state = STATE_PHASE;
+    _set_timer(lpl, &lpl->strobe, GNRC_LPL_MSG_TYPE_STROBE,
+               until - lpl->params.guard);
+}
+
+static void _enqueue(_lpl_t *lpl, gnrc_pktsnip_t *pkt)
+{
+    _entry_t *entry;
+
+    if (pkt->type != GNRC_NETTYPE_NETIF) {
+        DEBUG("lpl: first header is not generic netif header\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    if (lpl->free == NULL) {
+        DEBUG("lpl: queue full, dropping packet\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    entry = lpl->free;
+    LL_DELETE(lpl->free, entry);
+    entry->pkt = pkt;
+    entry->since = xtimer_now();
+    entry->next = NULL;
+    LL_APPEND(lpl->queue, entry);
+    if (lpl->state == STATE_IDLE) {
+        _next(lpl);
+    }
+}
+
+static void _send_ack(_lpl_t *lpl, gnrc_netif_hdr_t *hdr, uint8_t seq)
+{
+    gnrc_pktsnip_t *ack, *netif;
+    _hdr_t data = { TYPE_ACK, seq };
+
+    ack = gnrc_pktbuf_add(NULL, &data, sizeof(data), GNRC_NETTYPE_UNDEF);
+    if (ack == NULL) {
+        return;
+    }
+    netif = gnrc_netif_hdr_build(NULL, 0, gnrc_netif_hdr_get_src_addr(hdr),
+                                 hdr->src_l2addr_len);
+    if (netif == NULL) {
+        gnrc_pktbuf_release(ack);
+        return;
+    }
+    netif->next = ack;
+    lpl->gnrc_netdev2->send(lpl->gnrc_netdev2, netif);
+}
+
+static int _is_dup(_lpl_t *lpl, gnrc_netif_hdr_t *netif, uint8_t seq)
+{
+    uint8_t *src = gnrc_netif_hdr_get_src_addr(netif);
+    _dup_t *dup;
+
+    for (unsigned i = 0; i < GNRC_LPL_DUP_NUMOF; i++) {
+        dup = &lpl->dups[i];
+        if (_addr_equal(&dup->addr, src, netif->src_l2addr_len)) {
+            if (dup->seq == seq) {
+                return 1;
+            }
+            dup->seq = seq;
+            return 0;
+        }
+    }
+    if (netif->src_l2addr_len > ADDR_MAX_LEN) {
+        return 0;
+    }
+    dup = &lpl->dups[lpl->dup_next];
+    lpl->dup_next = (lpl->dup_next + 1) % GNRC_LPL_DUP_NUMOF;
+    _addr_set(&dup->addr, src, netif->src_l2addr_len);
+    dup->seq = seq;
+    return 0;
+}
+
+static void _receive(_lpl_t *lpl, gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *netif, *lpl_hdr;
+    gnrc_netif_hdr_t *hdr;
+    _hdr_t *data = pkt->data;
+
+    LL_SEARCH_SCALAR(pkt, netif, type, GNRC_NETTYPE_NETIF);
+    if ((netif == NULL) || (pkt == netif) || (pkt->size < sizeof(_hdr_t))) {
+        DEBUG("lpl: dropping frame without LPL header\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    hdr = netif->data;
+    /* keep listening while there is traffic */
+    lpl->active = 1;
+
+    switch (data->type) {
+        case TYPE_ACK:
+            if ((lpl->state == STATE_STROBE) && !lpl->bcast &&
+                (data->seq == lpl->tx_seq) &&
+                _addr_equal(&lpl->dst, gnrc_netif_hdr_get_src_addr(hdr),
+                            hdr->src_l2addr_len)) {
+                _learn_phase(lpl, xtimer_now());
+                _finish(lpl, 1);
+            }
+            gnrc_pktbuf_release(pkt);
+            return;
+        case TYPE_DATA:
+            _send_ack(lpl, hdr, data->seq);
+            break;
+        case TYPE_BCAST:
+            break;
+        default:
+            gnrc_pktbuf_release(pkt);
+            return;
+    }
+    /* strobes of broadcast frames and frames whose ACK got lost */
+    if (_is_dup(lpl, hdr, data->seq)) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    lpl->stats.rx++;
+
+    lpl_hdr = gnrc_pktbuf_mark(pkt, sizeof(_hdr_t), GNRC_NETTYPE_UNDEF);
+    if (lpl_hdr == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    pkt = gnrc_pktbuf_remove_snip(pkt, lpl_hdr);
+    if (!gnrc_netapi_dispatch_receive(pkt->type, GNRC_NETREG_DEMUX_CTX_ALL,
+                                      pkt)) {
+        DEBUG("lpl: unable to forward packet of type %i\n", pkt->type);
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+/**
+ * @brief   Start a listen window and schedule the next one
+ */
+static void _wakeup(_lpl_t *lpl)
+{
+    uint32_t now = xtimer_now();
+
+    /* keep the rhythm even if the message was late */
+    lpl->next_wakeup += lpl->params.interval;
+    if ((int32_t)(lpl->next_wakeup - now) <= 0) {
+        lpl->next_wakeup = now + lpl->params.interval;
+    }
+    _set_timer(lpl, &lpl->wakeup, GNRC_LPL_MSG_TYPE_WAKEUP,
+               lpl->next_wakeup - now);
+
+    lpl->stats.wakeups++;
+    lpl->listening = 1;
+    lpl->active = 0;
+    _update_radio(lpl);
+    _set_timer(lpl, &lpl->listen, GNRC_LPL_MSG_TYPE_LISTEN,
+               lpl->params.listen);
+}
+
+static void _listen_end(_lpl_t *lpl)
+{
+    if (lpl->active) {
+        lpl->active = 0;
+        _set_timer(lpl, &lpl->listen, GNRC_LPL_MSG_TYPE_LISTEN,
+                   lpl->params.listen);
+        return;
+    }
+    lpl->listening = 0;
+    _update_radio(lpl);
+}
+
+/**
+ * @brief   Function called by the device driver on device events
+ *
+ * @param[in] dev       the device
+ * @param[in] event     type of event
+ * @param[in] data      optional parameter
+ */
+static void _event_cb(netdev2_t *dev, netdev2_event_t event, void *data)
+{
+    (void)data;
+    _lpl_t *lpl = (_lpl_t *)dev->isr_arg;
+
+    if (event == NETDEV2_EVENT_ISR) {
+        msg_t msg;
+
+        msg.type = NETDEV2_MSG_TYPE_EVENT;
+        msg.content.ptr = (void *)lpl;
+        if (msg_send(&msg, lpl->pid) <= 0) {
+            puts("gnrc_lpl: possibly lost interrupt.");
+        }
+    }
+    else if (event == NETDEV2_EVENT_RX_COMPLETE) {
+        gnrc_pktsnip_t *pkt = lpl->gnrc_netdev2->recv(lpl->gnrc_netdev2);
+
+        if (pkt) {
+            _receive(lpl, pkt);
+        }
+    }
+    else {
+        DEBUG("lpl: unhandled event %u\n", event);
+    }
+}
+
+/**
+ * @brief   Startup code and event loop of the LPL layer
+ *
+ * @param[in] args          expects a pointer to the layer's state
+ *
+ * @return                  never returns
+ */
+static void *_lpl_thread(void *args)
+{
+    _lpl_t *lpl = (_lpl_t *)args;
+    netdev2_t *dev = lpl->gnrc_netdev2->dev;
+    gnrc_netapi_opt_t *opt;
+    int res;
+    msg_t msg, reply, msg_queue[GNRC_LPL_MSG_QUEUE_SIZE];
+
+    /* setup the MAC layers message queue */
+    msg_init_queue(msg_queue, GNRC_LPL_MSG_QUEUE_SIZE);
+    lpl->pid = thread_getpid();
+    lpl->gnrc_netdev2->pid = lpl->pid;
+    /* register the event callback with the device driver */
+    dev->event_callback = _event_cb;
+    dev->isr_arg = (void *)lpl;
+    /* register the device to the network stack */
+    gnrc_netif_add(lpl->pid);
+    /* initialize low-level driver, the radio starts on */
+    dev->driver->init(dev);
+    lpl->on = 1;
+    lpl->start = xtimer_now64();
+    lpl->on_since = lpl->start;
+    if (lpl->params.interval > 0) {
+        lpl->next_wakeup = xtimer_now();
+        _wakeup(lpl);
+    }
+    DEBUG("lpl: started, interval %" PRIu32 " us\n", lpl->params.interval);
+
+    /* start the event loop */
+    while (1) {
+        msg_receive(&msg);
+        /* dispatch NETDEV2, NETAPI and timer messages */
+        switch (msg.type) {
+            case NETDEV2_MSG_TYPE_EVENT:
+                DEBUG("lpl: NETDEV2_MSG_TYPE_EVENT received\n");
+                dev->driver->isr(dev);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                DEBUG("lpl: GNRC_NETAPI_MSG_TYPE_SND received\n");
+                _enqueue(lpl, (gnrc_pktsnip_t *)msg.content.ptr);
+                break;
+            case GNRC_LPL_MSG_TYPE_WAKEUP:
+                if (msg.content.value == lpl->wakeup.gen) {
+                    _wakeup(lpl);
+                }
+                break;
+            case GNRC_LPL_MSG_TYPE_LISTEN:
+                if (lpl->listening && (msg.content.value == lpl->listen.gen)) {
+                    _listen_end(lpl);
+                }
+                break;
+            case GNRC_LPL_MSG_TYPE_STROBE:
+                if ((lpl->state != STATE_IDLE) &&
+                    (msg.content.value == lpl->strobe.gen)) {
+                    _strobe(lpl);
+                }
+                break;
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                opt = (gnrc_netapi_opt_t *)msg.content.ptr;
+                DEBUG("lpl: GNRC_NETAPI_MSG_TYPE_SET received\n");
+                res = dev->driver->set(dev, opt->opt, opt->data, opt->data_len);
+                DEBUG("lpl: response of netdev->set: %i\n", res);
+                reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+                reply.content.value = (uint32_t)res;
+                msg_reply(&msg, &reply);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+                opt = (gnrc_netapi_opt_t *)msg.content.ptr;
+                DEBUG("lpl: GNRC_NETAPI_MSG_TYPE_GET received\n");
+                res = dev->driver->get(dev, opt->opt, opt->data, opt->data_len);
+                DEBUG("lpl: response of netdev->get: %i\n", res);
+                reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+                reply.content.value = (uint32_t)res;
+                msg_reply(&msg, &reply);
+                break;
+            default:
+                DEBUG("lpl: Unknown command %" PRIu16 "\n", msg.type);
+                break;
+        }
+    }
+    /* never reached */
+    return NULL;
+}
+
+kernel_pid_t gnrc_lpl_init(char *stack, int stacksize, char priority,
+                           const char *name, gnrc_netdev2_t *gnrc_netdev2,
+                           const gnrc_lpl_params_t *params)
+{
+    static const gnrc_lpl_params_t defaults = GNRC_LPL_PARAMS_DEFAULT;
+    _lpl_t *lpl;
+    kernel_pid_t res;
+
+    /* check if given netdev2 device is defined and the adapter is set */
+    if ((gnrc_netdev2 == NULL) || (gnrc_netdev2->dev == NULL) ||
+        (gnrc_netdev2->send == NULL) || (gnrc_netdev2->recv == NULL)) {
+        return -ENODEV;
+    }
+    for (lpl = _lpl; lpl < &_lpl[GNRC_LPL_NUMOF]; lpl++) {
+        if (lpl->gnrc_netdev2 == NULL) {
+            break;
+        }
+    }
+    if (lpl == &_lpl[GNRC_LPL_NUMOF]) {
+        return -ENOMEM;
+    }
+    memset(lpl, 0, sizeof(_lpl_t));
+    lpl->gnrc_netdev2 = gnrc_netdev2;
+    lpl->params = (params) ? *params : defaults;
+    for (unsigned i = 0; i < GNRC_LPL_QUEUE_SIZE; i++) {
+        LL_PREPEND(lpl->free, &lpl->entries[i]);
+    }
+    /* create new LPL thread */
+    res = thread_create(stack, stacksize, priority, CREATE_STACKTEST,
+                        _lpl_thread, (void *)lpl, name);
+    if (res <= 0) {
+        lpl->gnrc_netdev2 = NULL;
+        return -EINVAL;
+    }
+    return res;
+}
+
+int gnrc_lpl_get_stats(kernel_pid_t pid, gnrc_lpl_stats_t *stats)
+{
+    _lpl_t *lpl = _get_lpl(pid);
+    uint64_t now = xtimer_now64();
+
+    if (lpl == NULL) {
+        return -ENODEV;
+    }
+    unsigned irq = disableIRQ();
+    *stats = lpl->stats;
+    stats->uptime = now - lpl->start;
+    if (lpl->on) {
+        stats->radio_on += now - lpl->on_since;
+    }
+    restoreIRQ(irq);
+    return 0;
+}
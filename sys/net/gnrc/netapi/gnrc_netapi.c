@@ -23,6 +23,9 @@
 #include "net/gnrc/netreg.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/netapi.h"
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -62,6 +65,12 @@ static inline int _get_set(kernel_pid_t pid, uint16_t type,
 static inline int _snd_rcv(kernel_pid_t pid, uint16_t type, gnrc_pktsnip_t *pkt)
 {
     msg_t msg;
+#ifdef MODULE_GNRC_SINGLE_THREAD
+    if (pid == gnrc_single_thread_pid) {
+        /* the PID does not tell the layer, use the packet's headers */
+        return gnrc_single_thread_post_pkt(type, pkt);
+    }
+#endif
     /* set the outgoing message's fields */
     msg.type = type;
     msg.content.ptr = (void *)pkt;
@@ -74,6 +83,20 @@ static inline int _snd_rcv(kernel_pid_t pid, uint16_t type, gnrc_pktsnip_t *pkt)
     return ret;
 }
 
+static inline int _snd_rcv_entry(gnrc_nettype_t type, kernel_pid_t pid,
+                                 uint16_t cmd, gnrc_pktsnip_t *pkt)
+{
+#ifdef MODULE_GNRC_SINGLE_THREAD
+    if (pid == gnrc_single_thread_pid) {
+        /* find the layer in the shared thread by the registered type */
+        return gnrc_single_thread_post(type, cmd, pkt);
+    }
+#else
+    (void)type;
+#endif
+    return _snd_rcv(pid, cmd, pkt);
+}
+
 int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
                          uint16_t cmd, gnrc_pktsnip_t *pkt)
 {
@@ -85,7 +108,7 @@ int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
         gnrc_pktbuf_hold(pkt, numof - 1);
 
         while (sendto) {
-            if (_snd_rcv(sendto->pid, cmd, pkt) < 1) {
+            if (_snd_rcv_entry(type, sendto->pid, cmd, pkt) < 1) {
                 /* unable to dispatch packet */
                 gnrc_pktbuf_release(pkt);
             }
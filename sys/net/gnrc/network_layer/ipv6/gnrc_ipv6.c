@@ -33,17 +33,22 @@
 #include "net/gnrc/ipv6/whitelist.h"
 
 #include "net/gnrc/ipv6.h"
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
 #define _MAX_L2_ADDR_LEN    (8U)
 
+#ifndef MODULE_GNRC_SINGLE_THREAD
 #if ENABLE_DEBUG
 static char _stack[GNRC_IPV6_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
 static char _stack[GNRC_IPV6_STACK_SIZE];
 #endif
+#endif
 
 #ifdef MODULE_FIB
 #include "net/fib.h"
@@ -74,8 +79,15 @@ static void _dispatch_rcv_pkt(gnrc_nettype_t type, uint32_t demux_ctx,
  * prep_hdr: prepare header for sending (call to _fill_ipv6_hdr()), otherwise
  * assume it is already prepared */
 static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr);
+/* Handles a message for IPv6 */
+static void _handle_msg(msg_t *msg);
+#ifdef MODULE_GNRC_SINGLE_THREAD
+static gnrc_single_thread_layer_t _layer = GNRC_SINGLE_THREAD_LAYER(GNRC_NETTYPE_IPV6,
+                                                                    _handle_msg);
+#else
 /* Main event loop for IPv6 */
 static void *_event_loop(void *args);
+#endif
 
 /* Handles encapsulated IPv6 packets: http://tools.ietf.org/html/rfc2473 */
 static void _decapsulate(gnrc_pktsnip_t *pkt);
@@ -83,8 +95,19 @@ static void _decapsulate(gnrc_pktsnip_t *pkt);
 kernel_pid_t gnrc_ipv6_init(void)
 {
     if (gnrc_ipv6_pid == KERNEL_PID_UNDEF) {
+#ifdef MODULE_GNRC_SINGLE_THREAD
+        static gnrc_netreg_entry_t me_reg;
+
+        gnrc_ipv6_pid = gnrc_single_thread_add(&_layer);
+
+        /* register interest in all IPv6 packets */
+        me_reg.demux_ctx = GNRC_NETREG_DEMUX_CTX_ALL;
+        me_reg.pid = gnrc_ipv6_pid;
+        gnrc_netreg_register(GNRC_NETTYPE_IPV6, &me_reg);
+#else
         gnrc_ipv6_pid = thread_create(_stack, sizeof(_stack), GNRC_IPV6_PRIO,
                                       CREATE_STACKTEST, _event_loop, NULL, "ipv6");
+#endif
     }
 
 #ifdef MODULE_FIB
@@ -153,123 +176,129 @@ void gnrc_ipv6_demux(kernel_pid_t iface, gnrc_pktsnip_t *pkt, uint8_t nh)
 }
 
 /* internal functions */
-static void *_event_loop(void *args)
+static void _handle_msg(msg_t *msg)
 {
-    msg_t msg, reply, msg_q[GNRC_IPV6_MSG_QUEUE_SIZE];
-    gnrc_netreg_entry_t me_reg;
-
-    (void)args;
-    msg_init_queue(msg_q, GNRC_IPV6_MSG_QUEUE_SIZE);
-
-    me_reg.demux_ctx = GNRC_NETREG_DEMUX_CTX_ALL;
-    me_reg.pid = thread_getpid();
+    msg_t reply;
 
-    /* register interest in all IPv6 packets */
-    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &me_reg);
+    switch (msg->type) {
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_RCV received\n");
+            _receive((gnrc_pktsnip_t *)msg->content.ptr);
+            break;
 
-    /* preinitialize ACK */
-    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+        case GNRC_NETAPI_MSG_TYPE_SND:
+            DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_SND received\n");
+            _send((gnrc_pktsnip_t *)msg->content.ptr, true);
+            break;
 
-    /* start event loop */
-    while (1) {
-        DEBUG("ipv6: waiting for incoming message.\n");
-        msg_receive(&msg);
+        case GNRC_NETAPI_MSG_TYPE_GET:
+        case GNRC_NETAPI_MSG_TYPE_SET:
+            DEBUG("ipv6: reply to unsupported get/set\n");
+            reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+            reply.content.value = -ENOTSUP;
+            msg_reply(msg, &reply);
+            break;
 
-        switch (msg.type) {
-            case GNRC_NETAPI_MSG_TYPE_RCV:
-                DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_RCV received\n");
-                _receive((gnrc_pktsnip_t *)msg.content.ptr);
-                break;
+#ifdef MODULE_GNRC_NDP
+        case GNRC_NDP_MSG_RTR_TIMEOUT:
+            DEBUG("ipv6: Router timeout received\n");
+            ((gnrc_ipv6_nc_t *)msg->content.ptr)->flags &= ~GNRC_IPV6_NC_IS_ROUTER;
+            break;
 
-            case GNRC_NETAPI_MSG_TYPE_SND:
-                DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_SND received\n");
-                _send((gnrc_pktsnip_t *)msg.content.ptr, true);
-                break;
+        case GNRC_NDP_MSG_ADDR_TIMEOUT:
+            DEBUG("ipv6: Router advertisement timer event received\n");
+            gnrc_ipv6_netif_remove_addr(KERNEL_PID_UNDEF,
+                                        (ipv6_addr_t *)msg->content.ptr);
+            break;
 
-            case GNRC_NETAPI_MSG_TYPE_GET:
-            case GNRC_NETAPI_MSG_TYPE_SET:
-                DEBUG("ipv6: reply to unsupported get/set\n");
-                reply.content.value = -ENOTSUP;
-                msg_reply(&msg, &reply);
-                break;
+        case GNRC_NDP_MSG_NBR_SOL_RETRANS:
+            DEBUG("ipv6: Neigbor solicitation retransmission timer event received\n");
+            gnrc_ndp_retrans_nbr_sol((gnrc_ipv6_nc_t *)msg->content.ptr);
+            break;
 
-#ifdef MODULE_GNRC_NDP
-            case GNRC_NDP_MSG_RTR_TIMEOUT:
-                DEBUG("ipv6: Router timeout received\n");
-                ((gnrc_ipv6_nc_t *)msg.content.ptr)->flags &= ~GNRC_IPV6_NC_IS_ROUTER;
-                break;
-
-            case GNRC_NDP_MSG_ADDR_TIMEOUT:
-                DEBUG("ipv6: Router advertisement timer event received\n");
-                gnrc_ipv6_netif_remove_addr(KERNEL_PID_UNDEF,
-                                            (ipv6_addr_t *)msg.content.ptr);
-                break;
-
-            case GNRC_NDP_MSG_NBR_SOL_RETRANS:
-                DEBUG("ipv6: Neigbor solicitation retransmission timer event received\n");
-                gnrc_ndp_retrans_nbr_sol((gnrc_ipv6_nc_t *)msg.content.ptr);
-                break;
-
-            case GNRC_NDP_MSG_NC_STATE_TIMEOUT:
-                DEBUG("ipv6: Neigbor cache state timeout received\n");
-                gnrc_ndp_state_timeout((gnrc_ipv6_nc_t *)msg.content.ptr);
-                break;
+        case GNRC_NDP_MSG_NC_STATE_TIMEOUT:
+            DEBUG("ipv6: Neigbor cache state timeout received\n");
+            gnrc_ndp_state_timeout((gnrc_ipv6_nc_t *)msg->content.ptr);
+            break;
 #endif
 #ifdef MODULE_GNRC_NDP_ROUTER
-            case GNRC_NDP_MSG_RTR_ADV_RETRANS:
-                DEBUG("ipv6: Router advertisement retransmission event received\n");
-                gnrc_ndp_router_retrans_rtr_adv((gnrc_ipv6_netif_t *)msg.content.ptr);
-                break;
-            case GNRC_NDP_MSG_RTR_ADV_DELAY:
-                DEBUG("ipv6: Delayed router advertisement event received\n");
-                gnrc_ndp_router_send_rtr_adv((gnrc_ipv6_nc_t *)msg.content.ptr);
-                break;
+        case GNRC_NDP_MSG_RTR_ADV_RETRANS:
+            DEBUG("ipv6: Router advertisement retransmission event received\n");
+            gnrc_ndp_router_retrans_rtr_adv((gnrc_ipv6_netif_t *)msg->content.ptr);
+            break;
+        case GNRC_NDP_MSG_RTR_ADV_DELAY:
+            DEBUG("ipv6: Delayed router advertisement event received\n");
+            gnrc_ndp_router_send_rtr_adv((gnrc_ipv6_nc_t *)msg->content.ptr);
+            break;
 #endif
 #ifdef MODULE_GNRC_NDP_HOST
-            case GNRC_NDP_MSG_RTR_SOL_RETRANS:
-                DEBUG("ipv6: Router solicitation retransmission event received\n");
-                gnrc_ndp_host_retrans_rtr_sol((gnrc_ipv6_netif_t *)msg.content.ptr);
-                break;
+        case GNRC_NDP_MSG_RTR_SOL_RETRANS:
+            DEBUG("ipv6: Router solicitation retransmission event received\n");
+            gnrc_ndp_host_retrans_rtr_sol((gnrc_ipv6_netif_t *)msg->content.ptr);
+            break;
 #endif
 #ifdef MODULE_GNRC_SIXLOWPAN_ND
-            case GNRC_SIXLOWPAN_ND_MSG_MC_RTR_SOL:
-                DEBUG("ipv6: Multicast router solicitation event received\n");
-                gnrc_sixlowpan_nd_mc_rtr_sol((gnrc_ipv6_netif_t *)msg.content.ptr);
-                break;
-            case GNRC_SIXLOWPAN_ND_MSG_UC_RTR_SOL:
-                DEBUG("ipv6: Unicast router solicitation event received\n");
-                gnrc_sixlowpan_nd_uc_rtr_sol((gnrc_ipv6_nc_t *)msg.content.ptr);
-                break;
-            case GNRC_SIXLOWPAN_ND_MSG_DELETE_CTX:
-                DEBUG("ipv6: Delete 6LoWPAN context event received\n");
-                gnrc_sixlowpan_ctx_remove(((((gnrc_sixlowpan_ctx_t *)msg.content.ptr)->flags_id) &
-                                           GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK));
-                break;
+        case GNRC_SIXLOWPAN_ND_MSG_MC_RTR_SOL:
+            DEBUG("ipv6: Multicast router solicitation event received\n");
+            gnrc_sixlowpan_nd_mc_rtr_sol((gnrc_ipv6_netif_t *)msg->content.ptr);
+            break;
+        case GNRC_SIXLOWPAN_ND_MSG_UC_RTR_SOL:
+            DEBUG("ipv6: Unicast router solicitation event received\n");
+            gnrc_sixlowpan_nd_uc_rtr_sol((gnrc_ipv6_nc_t *)msg->content.ptr);
+            break;
+        case GNRC_SIXLOWPAN_ND_MSG_DELETE_CTX:
+            DEBUG("ipv6: Delete 6LoWPAN context event received\n");
+            gnrc_sixlowpan_ctx_remove(((((gnrc_sixlowpan_ctx_t *)msg->content.ptr)->flags_id) &
+                                       GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK));
+            break;
 #endif
 #ifdef MODULE_GNRC_SIXLOWPAN_ND_ROUTER
-            case GNRC_SIXLOWPAN_ND_MSG_ABR_TIMEOUT:
-                DEBUG("ipv6: border router timeout event received\n");
-                gnrc_sixlowpan_nd_router_abr_remove(
-                        (gnrc_sixlowpan_nd_router_abr_t *)msg.content.ptr);
-                break;
-            case GNRC_SIXLOWPAN_ND_MSG_AR_TIMEOUT:
-                DEBUG("ipv6: address registration timeout received\n");
-                gnrc_sixlowpan_nd_router_gc_nc((gnrc_ipv6_nc_t *)msg.content.ptr);
-                break;
-            case GNRC_NDP_MSG_RTR_ADV_SIXLOWPAN_DELAY:
-                DEBUG("ipv6: Delayed router advertisement event received\n");
-                gnrc_ipv6_nc_t *nc_entry = (gnrc_ipv6_nc_t *)msg.content.ptr;
-                gnrc_ndp_internal_send_rtr_adv(nc_entry->iface, NULL,
-                                               &(nc_entry->ipv6_addr), false);
-                break;
+        case GNRC_SIXLOWPAN_ND_MSG_ABR_TIMEOUT:
+            DEBUG("ipv6: border router timeout event received\n");
+            gnrc_sixlowpan_nd_router_abr_remove(
+                    (gnrc_sixlowpan_nd_router_abr_t *)msg->content.ptr);
+            break;
+        case GNRC_SIXLOWPAN_ND_MSG_AR_TIMEOUT:
+            DEBUG("ipv6: address registration timeout received\n");
+            gnrc_sixlowpan_nd_router_gc_nc((gnrc_ipv6_nc_t *)msg->content.ptr);
+            break;
+        case GNRC_NDP_MSG_RTR_ADV_SIXLOWPAN_DELAY:
+            DEBUG("ipv6: Delayed router advertisement event received\n");
+            gnrc_ipv6_nc_t *nc_entry = (gnrc_ipv6_nc_t *)msg->content.ptr;
+            gnrc_ndp_internal_send_rtr_adv(nc_entry->iface, NULL,
+                                           &(nc_entry->ipv6_addr), false);
+            break;
 #endif
-            default:
-                break;
-        }
+        default:
+            break;
+    }
+}
+
+#ifndef MODULE_GNRC_SINGLE_THREAD
+static void *_event_loop(void *args)
+{
+    msg_t msg, msg_q[GNRC_IPV6_MSG_QUEUE_SIZE];
+    gnrc_netreg_entry_t me_reg;
+
+    (void)args;
+    msg_init_queue(msg_q, GNRC_IPV6_MSG_QUEUE_SIZE);
+
+    me_reg.demux_ctx = GNRC_NETREG_DEMUX_CTX_ALL;
+    me_reg.pid = thread_getpid();
+
+    /* register interest in all IPv6 packets */
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &me_reg);
+
+    /* start event loop */
+    while (1) {
+        DEBUG("ipv6: waiting for incoming message.\n");
+        msg_receive(&msg);
+        _handle_msg(&msg);
     }
 
     return NULL;
 }
+#endif
 
 static void _send_to_iface(kernel_pid_t iface, gnrc_pktsnip_t *pkt)
 {
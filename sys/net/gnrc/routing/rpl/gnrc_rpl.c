@@ -21,16 +21,22 @@
 #include "mutex.h"
 
 #include "net/gnrc/rpl.h"
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+#ifndef MODULE_GNRC_SINGLE_THREAD
 static char _stack[GNRC_RPL_STACK_SIZE];
+static msg_t _msg_q[GNRC_RPL_MSG_QUEUE_SIZE];
+#endif
 kernel_pid_t gnrc_rpl_pid = KERNEL_PID_UNDEF;
 static uint32_t _lt_time = GNRC_RPL_LIFETIME_UPDATE_STEP * SEC_IN_USEC;
+static uint32_t _lt_slack = GNRC_RPL_LIFETIME_UPDATE_SLACK * MS_IN_USEC;
 static xtimer_t _lt_timer;
 static msg_t _lt_msg = { .type = GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE };
-static msg_t _msg_q[GNRC_RPL_MSG_QUEUE_SIZE];
 static gnrc_netreg_entry_t _me_reg;
 static mutex_t _inst_id_mutex = MUTEX_INIT;
 static uint8_t _instance_id;
@@ -42,16 +48,26 @@ gnrc_rpl_parent_t gnrc_rpl_parents[GNRC_RPL_PARENTS_NUMOF];
 static void _update_lifetime(void);
 static void _dao_handle_send(gnrc_rpl_dodag_t *dodag);
 static void _receive(gnrc_pktsnip_t *pkt);
+static void _handle_msg(msg_t *msg);
+#ifdef MODULE_GNRC_SINGLE_THREAD
+static gnrc_single_thread_layer_t _layer = GNRC_SINGLE_THREAD_LAYER(GNRC_NETTYPE_ICMPV6,
+                                                                    _handle_msg);
+#else
 static void *_event_loop(void *args);
+#endif
 
 kernel_pid_t gnrc_rpl_init(kernel_pid_t if_pid)
 {
     /* check if RPL was initialized before */
     if (gnrc_rpl_pid == KERNEL_PID_UNDEF) {
         _instance_id = 0;
+#ifdef MODULE_GNRC_SINGLE_THREAD
+        gnrc_rpl_pid = gnrc_single_thread_add(&_layer);
+#else
         /* start the event loop */
         gnrc_rpl_pid = thread_create(_stack, sizeof(_stack), GNRC_RPL_PRIO, CREATE_STACKTEST,
                 _event_loop, NULL, "RPL");
+#endif
 
         if (gnrc_rpl_pid == KERNEL_PID_UNDEF) {
             DEBUG("RPL: could not start the event loop\n");
@@ -64,7 +80,7 @@ kernel_pid_t gnrc_rpl_init(kernel_pid_t if_pid)
         gnrc_netreg_register(GNRC_NETTYPE_ICMPV6, &_me_reg);
 
         gnrc_rpl_of_manager_init();
-        xtimer_set_msg(&_lt_timer, _lt_time, &_lt_msg, gnrc_rpl_pid);
+        xtimer_set_msg_slack(&_lt_timer, _lt_time, _lt_slack, &_lt_msg, gnrc_rpl_pid);
     }
 
     /* register all_RPL_nodes multicast address */
@@ -151,76 +167,84 @@ static void _receive(gnrc_pktsnip_t *icmpv6)
     gnrc_pktbuf_release(icmpv6);
 }
 
+static void _handle_msg(msg_t *msg)
+{
+    msg_t reply;
+    trickle_t *trickle;
+    gnrc_rpl_dodag_t *dodag;
+
+    /* preinitialize ACK */
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+
+    switch (msg->type) {
+        case GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE:
+            DEBUG("RPL: GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE received\n");
+            _update_lifetime();
+            break;
+        case GNRC_RPL_MSG_TYPE_TRICKLE_INTERVAL:
+            DEBUG("RPL: GNRC_RPL_MSG_TYPE_TRICKLE_INTERVAL received\n");
+            trickle = (trickle_t *) msg->content.ptr;
+            if (trickle && (trickle->callback.func != NULL)) {
+                trickle_interval(trickle);
+            }
+            break;
+        case GNRC_RPL_MSG_TYPE_TRICKLE_CALLBACK:
+            DEBUG("RPL: GNRC_RPL_MSG_TYPE_TRICKLE_CALLBACK received\n");
+            trickle = (trickle_t *) msg->content.ptr;
+            if (trickle && (trickle->callback.func != NULL)) {
+                trickle_callback(trickle);
+            }
+            break;
+        case GNRC_RPL_MSG_TYPE_DAO_HANDLE:
+            DEBUG("RPL: GNRC_RPL_MSG_TYPE_DAO_HANDLE received\n");
+            dodag = (gnrc_rpl_dodag_t *) msg->content.ptr;
+            if (dodag && (dodag->state != 0)) {
+                _dao_handle_send(dodag);
+            }
+            break;
+        case GNRC_RPL_MSG_TYPE_CLEANUP_HANDLE:
+            DEBUG("RPL: GNRC_RPL_MSG_TYPE_CLEANUP received\n");
+            dodag = (gnrc_rpl_dodag_t *) msg->content.ptr;
+            if (dodag && (dodag->state != 0) && (dodag->parents == NULL)
+                && (dodag->my_rank == GNRC_RPL_INFINITE_RANK)) {
+                /* no parents - delete this DODAG */
+                gnrc_rpl_dodag_remove(dodag);
+            }
+            break;
+        case GNRC_NETAPI_MSG_TYPE_RCV:
+            DEBUG("RPL: GNRC_NETAPI_MSG_TYPE_RCV received\n");
+            _receive((gnrc_pktsnip_t *)msg->content.ptr);
+            break;
+        case GNRC_NETAPI_MSG_TYPE_SND:
+        case GNRC_NETAPI_MSG_TYPE_GET:
+        case GNRC_NETAPI_MSG_TYPE_SET:
+            DEBUG("RPL: reply to unsupported recv/get/set\n");
+            reply.content.value = -ENOTSUP;
+            msg_reply(msg, &reply);
+            break;
+        default:
+            break;
+    }
+}
+
+#ifndef MODULE_GNRC_SINGLE_THREAD
 static void *_event_loop(void *args)
 {
-    msg_t msg, reply;
+    msg_t msg;
 
     (void)args;
     msg_init_queue(_msg_q, GNRC_RPL_MSG_QUEUE_SIZE);
 
-    /* preinitialize ACK */
-    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
-
-    trickle_t *trickle;
-    gnrc_rpl_dodag_t *dodag;
     /* start event loop */
     while (1) {
         DEBUG("RPL: waiting for incoming message.\n");
         msg_receive(&msg);
-
-        switch (msg.type) {
-            case GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE:
-                DEBUG("RPL: GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE received\n");
-                _update_lifetime();
-                break;
-            case GNRC_RPL_MSG_TYPE_TRICKLE_INTERVAL:
-                DEBUG("RPL: GNRC_RPL_MSG_TYPE_TRICKLE_INTERVAL received\n");
-                trickle = (trickle_t *) msg.content.ptr;
-                if (trickle && (trickle->callback.func != NULL)) {
-                    trickle_interval(trickle);
-                }
-                break;
-            case GNRC_RPL_MSG_TYPE_TRICKLE_CALLBACK:
-                DEBUG("RPL: GNRC_RPL_MSG_TYPE_TRICKLE_CALLBACK received\n");
-                trickle = (trickle_t *) msg.content.ptr;
-                if (trickle && (trickle->callback.func != NULL)) {
-                    trickle_callback(trickle);
-                }
-                break;
-            case GNRC_RPL_MSG_TYPE_DAO_HANDLE:
-                DEBUG("RPL: GNRC_RPL_MSG_TYPE_DAO_HANDLE received\n");
-                dodag = (gnrc_rpl_dodag_t *) msg.content.ptr;
-                if (dodag && (dodag->state != 0)) {
-                    _dao_handle_send(dodag);
-                }
-                break;
-            case GNRC_RPL_MSG_TYPE_CLEANUP_HANDLE:
-                DEBUG("RPL: GNRC_RPL_MSG_TYPE_CLEANUP received\n");
-                dodag = (gnrc_rpl_dodag_t *) msg.content.ptr;
-                if (dodag && (dodag->state != 0) && (dodag->parents == NULL)
-                    && (dodag->my_rank == GNRC_RPL_INFINITE_RANK)) {
-                    /* no parents - delete this DODAG */
-                    gnrc_rpl_dodag_remove(dodag);
-                }
-                break;
-            case GNRC_NETAPI_MSG_TYPE_RCV:
-                DEBUG("RPL: GNRC_NETAPI_MSG_TYPE_RCV received\n");
-                _receive((gnrc_pktsnip_t *)msg.content.ptr);
-                break;
-            case GNRC_NETAPI_MSG_TYPE_SND:
-            case GNRC_NETAPI_MSG_TYPE_GET:
-            case GNRC_NETAPI_MSG_TYPE_SET:
-                DEBUG("RPL: reply to unsupported recv/get/set\n");
-                reply.content.value = -ENOTSUP;
-                msg_reply(&msg, &reply);
-                break;
-            default:
-                break;
-        }
+        _handle_msg(&msg);
     }
 
     return NULL;
 }
+#endif
 
 void _update_lifetime(void)
 {
@@ -242,7 +266,7 @@ void _update_lifetime(void)
             }
         }
     }
-    xtimer_set_msg(&_lt_timer, _lt_time, &_lt_msg, gnrc_rpl_pid);
+    xtimer_set_msg_slack(&_lt_timer, _lt_time, _lt_slack, &_lt_msg, gnrc_rpl_pid);
 }
 
 void gnrc_rpl_delay_dao(gnrc_rpl_dodag_t *dodag)
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_single_thread
+ * @{
+ *
+ * @file
+ *
+ * @}
+ */
+
+#include <errno.h>
+
+#include "cib.h"
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+#include "utlist.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "net/gnrc/single_thread.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+typedef struct {
+    gnrc_single_thread_layer_t *layer;
+    gnrc_pktsnip_t *pkt;
+    uint16_t cmd;
+} _event_t;
+
+#if ENABLE_DEBUG
+static char _stack[GNRC_SINGLE_THREAD_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
+#else
+static char _stack[GNRC_SINGLE_THREAD_STACK_SIZE];
+#endif
+
+kernel_pid_t gnrc_single_thread_pid = KERNEL_PID_UNDEF;
+
+static gnrc_single_thread_layer_t *_layers;
+static _event_t _events[GNRC_SINGLE_THREAD_EVENT_NUMOF];
+static cib_t _events_cib = CIB_INIT(GNRC_SINGLE_THREAD_EVENT_NUMOF);
+
+static void _handle_events(void)
+{
+    while (1) {
+        unsigned state = disableIRQ();
+        int idx = cib_get(&_events_cib);
+
+        if (idx < 0) {
+            restoreIRQ(state);
+            return;
+        }
+
+        _event_t ev = _events[idx];
+        restoreIRQ(state);
+
+        msg_t msg;
+        msg.sender_pid = gnrc_single_thread_pid;
+        msg.type = ev.cmd;
+        msg.content.ptr = (char *)ev.pkt;
+
+        ev.layer->handler(&msg);
+    }
+}
+
+static void *_event_loop(void *args)
+{
+    msg_t msg, reply, msg_q[GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE];
+
+    (void)args;
+    msg_init_queue(msg_q, GNRC_SINGLE_THREAD_MSG_QUEUE_SIZE);
+
+    /* preinitialize ACK */
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+    reply.content.value = (uint32_t)-ENOTSUP;
+
+    while (1) {
+        msg_receive(&msg);
+
+        switch (msg.type) {
+            case GNRC_SINGLE_THREAD_MSG_TYPE_EVENT:
+                break;
+
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                DEBUG("single_thread: reply to unsupported get/set\n");
+                msg_reply(&msg, &reply);
+                break;
+
+            case GNRC_NETAPI_MSG_TYPE_RCV:
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                /* packets sent with plain messages (e.g. delayed by a timer)
+                 * go to exactly one layer, like those passed via netapi */
+                if (gnrc_single_thread_post_pkt(msg.type,
+                                                (gnrc_pktsnip_t *)msg.content.ptr) < 1) {
+                    DEBUG("single_thread: dropping packet\n");
+                    gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+                }
+                break;
+
+            default:
+                DEBUG("single_thread: pass message of type 0x%04x to all "
+                      "layers\n", msg.type);
+                for (gnrc_single_thread_layer_t *layer = _layers; layer;
+                     layer = layer->next) {
+                    layer->handler(&msg);
+                }
+                break;
+        }
+
+        /* events queued while the wake up message could not be queued are
+         * handled here too */
+        _handle_events();
+    }
+
+    return NULL;
+}
+
+kernel_pid_t gnrc_single_thread_add(gnrc_single_thread_layer_t *layer)
+{
+    unsigned state = disableIRQ();
+    LL_PREPEND(_layers, layer);
+    restoreIRQ(state);
+
+    if (gnrc_single_thread_pid == KERNEL_PID_UNDEF) {
+        gnrc_single_thread_pid = thread_create(_stack, sizeof(_stack),
+                                               GNRC_SINGLE_THREAD_PRIO,
+                                               CREATE_STACKTEST, _event_loop,
+                                               NULL, "gnrc");
+    }
+
+    return gnrc_single_thread_pid;
+}
+
+int gnrc_single_thread_post(gnrc_nettype_t type, uint16_t cmd,
+                            gnrc_pktsnip_t *pkt)
+{
+    gnrc_single_thread_layer_t *layer;
+    int idx;
+
+    LL_SEARCH_SCALAR(_layers, layer, type, type);
+
+    if (layer == NULL) {
+        DEBUG("single_thread: no layer for type %d\n", (int)type);
+        return -1;
+    }
+
+    unsigned state = disableIRQ();
+
+    if ((idx = cib_put(&_events_cib)) < 0) {
+        restoreIRQ(state);
+        DEBUG("single_thread: event queue is full\n");
+        return 0;
+    }
+
+    _events[idx].layer = layer;
+    _events[idx].pkt = pkt;
+    _events[idx].cmd = cmd;
+
+    restoreIRQ(state);
+
+    if (sched_active_pid != gnrc_single_thread_pid) {
+        /* the shared thread handles all queued events after every message, so
+         * losing this one to a full message queue is fine */
+        msg_t msg;
+        msg.type = GNRC_SINGLE_THREAD_MSG_TYPE_EVENT;
+        msg_try_send(&msg, gnrc_single_thread_pid);
+    }
+
+    return 1;
+}
+
+int gnrc_single_thread_post_pkt(uint16_t cmd, gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *snip = pkt;
+
+    /* packets passed down to a layer may start with a netif header */
+    while ((snip != NULL) && (snip->type == GNRC_NETTYPE_NETIF)) {
+        snip = snip->next;
+    }
+
+    if (snip == NULL) {
+        DEBUG("single_thread: packet has no layer to go to\n");
+        return -1;
+    }
+
+    return gnrc_single_thread_post(snip->type, cmd, pkt);
+}
@@ -40,10 +40,6 @@
 static mutex_t mtx_iib_access = MUTEX_INIT;
 static iib_base_entry_t *iib_base_entry_head = NULL;
 
-#if (NHDP_METRIC == NHDP_LMT_DAT)
-static const double const_dat = (((double)DAT_CONSTANT) / DAT_MAXIMUM_LOSS);
-#endif
-
 /* Internal function prototypes */
 static void rem_link_set_entry(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry);
 static void cleanup_link_sets(void);
@@ -60,6 +56,8 @@ static int update_two_hop_set(iib_base_entry_t *base_entry, iib_link_set_entry_t
 static int add_two_hop_entry(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry,
                              nhdp_addr_t *th_addr, timex_t *now, uint64_t val_time);
 static void rem_two_hop_entry(iib_base_entry_t *base_entry, iib_two_hop_set_entry_t *th_entry);
+static void rem_link_two_hop_entries(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry);
+static void insert_two_hop_entry(iib_base_entry_t *base_entry, iib_two_hop_set_entry_t *th_entry);
 
 static void wr_update_ls_status(iib_base_entry_t *base_entry,
                                 iib_link_set_entry_t *ls_elt, timex_t *now);
@@ -70,9 +68,12 @@ static void rem_not_heard_nb_tuple(iib_link_set_entry_t *ls_entry, timex_t *now)
 static inline timex_t get_max_timex(timex_t time_one, timex_t time_two);
 static iib_link_tuple_status_t get_tuple_status(iib_link_set_entry_t *ls_entry, timex_t *now);
 
+static void lt_timer_queue_update(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry);
+static void lt_timer_queue_remove(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry);
+
 #if (NHDP_METRIC == NHDP_LMT_DAT)
-static void queue_rem(uint8_t *queue);
-static uint16_t queue_sum(uint8_t *queue);
+static void queue_set(uint8_t *queue, uint16_t *sum, uint8_t pos, uint8_t value);
+static void queue_advance(iib_link_set_entry_t *ls_entry);
 static void dat_metric_refresh(void);
 #endif
 
@@ -91,6 +92,7 @@ int iib_register_if(kernel_pid_t pid)
 
     new_entry->if_pid = pid;
     new_entry->link_set_head = NULL;
+    new_entry->lt_timer_queue_head = NULL;
     new_entry->two_hop_set_head = NULL;
     LL_PREPEND(iib_base_entry_head, new_entry);
 
@@ -108,7 +110,9 @@ iib_link_set_entry_t *iib_process_hello(kernel_pid_t if_pid, nib_entry_t *nb_elt
     mutex_lock(&mtx_iib_access);
 
     /* Remove link tuple addresses that are included in the Removed Addr List */
-    cleanup_link_sets();
+    if (nib_rem_list_pending()) {
+        cleanup_link_sets();
+    }
 
     LL_FOREACH(iib_base_entry_head, base_elt) {
         /* Find the link set and two hop set for the interface */
@@ -213,11 +217,13 @@ void iib_fill_wr_addresses(kernel_pid_t if_pid, struct rfc5444_writer *wr)
 void iib_update_lt_status(timex_t *now)
 {
     iib_base_entry_t *base_elt;
-    iib_link_set_entry_t *ls_elt, *ls_tmp;
 
     LL_FOREACH(iib_base_entry_head, base_elt) {
-        LL_FOREACH_SAFE(base_elt->link_set_head, ls_elt, ls_tmp) {
-            wr_update_ls_status(base_elt, ls_elt, now);
+        /* The queue is sorted, so only the tuples at its head can be due */
+        while (base_elt->lt_timer_queue_head
+               && (timex_cmp(base_elt->lt_timer_queue_head->next_change, *now) != 1)) {
+            /* Either removes the tuple or requeues it with a later next_change */
+            wr_update_ls_status(base_elt, base_elt->lt_timer_queue_head, now);
         }
     }
 }
@@ -252,9 +258,12 @@ void iib_process_metric_msg(iib_link_set_entry_t *ls_entry, uint64_t int_time)
     if (ls_entry->last_seq_no == 0) {
         timex_t now, i_time;
         vtimer_now(&now);
-        i_time = timex_from_uint64(int_time * MS_IN_USEC * DAT_HELLO_TIMEOUT_FACTOR);
-        ls_entry->dat_received[0]++;
-        ls_entry->dat_total[0]++;
+        i_time = timex_from_uint64(int_time * MS_IN_USEC * DAT_HELLO_TIMEOUT_FACTOR_NUM
+                                   / DAT_HELLO_TIMEOUT_FACTOR_DEN);
+        queue_set(ls_entry->dat_received, &ls_entry->dat_received_sum, ls_entry->dat_q_pos,
+                  ls_entry->dat_received[ls_entry->dat_q_pos] + 1);
+        queue_set(ls_entry->dat_total, &ls_entry->dat_total_sum, ls_entry->dat_q_pos,
+                  ls_entry->dat_total[ls_entry->dat_q_pos] + 1);
         ls_entry->dat_time = timex_add(now, i_time);
     }
 #else
@@ -276,8 +285,8 @@ void iib_process_metric_pckt(iib_link_set_entry_t *ls_entry, uint32_t metric_out
 #elif (NHDP_METRIC == NHDP_LMT_DAT)
     /* Metric packet processing */
     if (ls_entry->last_seq_no == 0) {
-        ls_entry->dat_received[0] = 1;
-        ls_entry->dat_total[0] = 1;
+        queue_set(ls_entry->dat_received, &ls_entry->dat_received_sum, ls_entry->dat_q_pos, 1);
+        queue_set(ls_entry->dat_total, &ls_entry->dat_total_sum, ls_entry->dat_q_pos, 1);
     }
     /* Don't add values to the queue for duplicate packets */
     else if (seq_no != ls_entry->last_seq_no) {
@@ -288,8 +297,11 @@ void iib_process_metric_pckt(iib_link_set_entry_t *ls_entry, uint32_t metric_out
         else {
             seq_diff = seq_no - ls_entry->last_seq_no;
         }
-        ls_entry->dat_total[0] += (seq_diff > NHDP_SEQNO_RESTART_DETECT) ? 1 : seq_diff;
-        ls_entry->dat_received[0]++;
+        queue_set(ls_entry->dat_total, &ls_entry->dat_total_sum, ls_entry->dat_q_pos,
+                  ls_entry->dat_total[ls_entry->dat_q_pos]
+                  + ((seq_diff > NHDP_SEQNO_RESTART_DETECT) ? 1 : seq_diff));
+        queue_set(ls_entry->dat_received, &ls_entry->dat_received_sum, ls_entry->dat_q_pos,
+                  ls_entry->dat_received[ls_entry->dat_q_pos] + 1);
     }
 
     ls_entry->last_seq_no = seq_no;
@@ -299,7 +311,7 @@ void iib_process_metric_pckt(iib_link_set_entry_t *ls_entry, uint32_t metric_out
         timex_t now, i_time;
         vtimer_now(&now);
         i_time = timex_from_uint64(rfc5444_timetlv_decode(ls_entry->hello_interval)
-                * MS_IN_USEC * DAT_HELLO_TIMEOUT_FACTOR);
+                * MS_IN_USEC * DAT_HELLO_TIMEOUT_FACTOR_NUM / DAT_HELLO_TIMEOUT_FACTOR_DEN);
         ls_entry->dat_time = timex_add(now, i_time);
     }
 
@@ -379,18 +391,8 @@ static void cleanup_link_sets(void)
                 }
             }
 
-            /* Remove link tuples with empty address list */
+            /* Remove link tuples with empty address list (including their two hop entries) */
             if (!ls_elt->address_list_head) {
-                if (ls_elt->last_status == IIB_LT_STATUS_SYM) {
-                    /* Remove all two hop entries for the corresponding link tuple */
-                    iib_two_hop_set_entry_t *th_elt, *th_tmp;
-                    LL_FOREACH_SAFE(base_elt->two_hop_set_head, th_elt, th_tmp) {
-                        if (th_elt->ls_elt == ls_elt) {
-                            rem_two_hop_entry(base_elt, th_elt);
-                        }
-                    }
-                }
-
                 rem_link_set_entry(base_elt, ls_elt);
             }
         }
@@ -514,6 +516,8 @@ static iib_link_set_entry_t *update_link_set(iib_base_entry_t *base_entry, nib_e
         }
     }
 
+    lt_timer_queue_update(base_entry, matching_lt);
+
     return matching_lt;
 }
 
@@ -546,6 +550,8 @@ static void wr_update_ls_status(iib_base_entry_t *base_entry,
             ls_elt->nb_elt = NULL;
             ls_elt->last_status = IIB_LT_STATUS_UNKNOWN;
         }
+
+        lt_timer_queue_update(base_entry, ls_elt);
     }
     else if ((ls_elt->last_status == IIB_LT_STATUS_HEARD)
              && (timex_cmp(ls_elt->heard_time, *now) != 1)) {
@@ -553,6 +559,7 @@ static void wr_update_ls_status(iib_base_entry_t *base_entry,
         rem_not_heard_nb_tuple(ls_elt, now);
         ls_elt->nb_elt = NULL;
         ls_elt->last_status = IIB_LT_STATUS_UNKNOWN;
+        lt_timer_queue_update(base_entry, ls_elt);
     }
 }
 
@@ -572,6 +579,9 @@ static iib_link_set_entry_t *add_default_link_set_entry(iib_base_entry_t *base_e
     }
 
     new_entry->address_list_head = NULL;
+    new_entry->tq_prev = NULL;
+    new_entry->tq_next = NULL;
+    new_entry->th_head = NULL;
     reset_link_set_entry(new_entry, now, val_time);
     LL_PREPEND(base_entry->link_set_head, new_entry);
 
@@ -600,6 +610,9 @@ static void reset_link_set_entry(iib_link_set_entry_t *ls_entry, timex_t *now, u
 #if (NHDP_METRIC == NHDP_LMT_DAT)
     memset(ls_entry->dat_received, 0, NHDP_Q_MEM_LENGTH);
     memset(ls_entry->dat_total, 0, NHDP_Q_MEM_LENGTH);
+    ls_entry->dat_received_sum = 0;
+    ls_entry->dat_total_sum = 0;
+    ls_entry->dat_q_pos = 0;
     ls_entry->dat_time.microseconds = 0;
     ls_entry->dat_time.seconds = 0;
     ls_entry->hello_interval = 0;
@@ -614,6 +627,8 @@ static void reset_link_set_entry(iib_link_set_entry_t *ls_entry, timex_t *now, u
  */
 static void rem_link_set_entry(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry)
 {
+    rem_link_two_hop_entries(base_entry, ls_entry);
+    lt_timer_queue_remove(base_entry, ls_entry);
     LL_DELETE(base_entry->link_set_head, ls_entry);
     release_link_tuple_addresses(ls_entry);
     free(ls_entry);
@@ -644,18 +659,18 @@ static int update_two_hop_set(iib_base_entry_t *base_entry, iib_link_set_entry_t
         iib_two_hop_set_entry_t *ths_elt, *ths_tmp;
         nhdp_addr_t *addr_elt;
 
-        /* Loop through all the two hop tuples of the two hop set */
-        LL_FOREACH_SAFE(base_entry->two_hop_set_head, ths_elt, ths_tmp) {
-            if (timex_cmp(ths_elt->exp_time, *now) != 1) {
-                /* Entry is expired, remove it */
+        /* Remove expired entries (the two hop set is sorted by expiration time) */
+        while (base_entry->two_hop_set_head
+               && (timex_cmp(base_entry->two_hop_set_head->exp_time, *now) != 1)) {
+            rem_two_hop_entry(base_entry, base_entry->two_hop_set_head);
+        }
+
+        /* Loop through the two hop tuples of the link tuple */
+        LL_FOREACH_SAFE2(ls_entry->th_head, ths_elt, ths_tmp, ls_next) {
+            if (ths_elt->th_nb_addr->in_tmp_table &
+                (NHDP_ADDR_TMP_TH_REM_LIST | NHDP_ADDR_TMP_TH_SYM_LIST)) {
                 rem_two_hop_entry(base_entry, ths_elt);
             }
-            else if (ths_elt->ls_elt == ls_entry) {
-                if (ths_elt->th_nb_addr->in_tmp_table &
-                    (NHDP_ADDR_TMP_TH_REM_LIST | NHDP_ADDR_TMP_TH_SYM_LIST)) {
-                    rem_two_hop_entry(base_entry, ths_elt);
-                }
-            }
         }
 
         /* Add a new entry for every signaled symmetric neighbor address */
@@ -702,21 +717,67 @@ static int add_two_hop_entry(iib_base_entry_t *base_entry, iib_link_set_entry_t
         new_entry->metric_out = NHDP_METRIC_UNKNOWN;
     }
 
-    LL_PREPEND(base_entry->two_hop_set_head, new_entry);
+    insert_two_hop_entry(base_entry, new_entry);
+    LL_PREPEND2(ls_entry->th_head, new_entry, ls_next);
 
     return 0;
 }
 
+/**
+ * Insert a 2-Hop Tuple into the 2-Hop Set keeping it sorted by expiration time
+ */
+static void insert_two_hop_entry(iib_base_entry_t *base_entry, iib_two_hop_set_entry_t *th_entry)
+{
+    iib_two_hop_set_entry_t *pos = NULL;
+
+    if (base_entry->two_hop_set_head) {
+        /* Walk back from the tail, new entries usually expire last */
+        pos = base_entry->two_hop_set_head->prev;
+
+        while (timex_cmp(pos->exp_time, th_entry->exp_time) == 1) {
+            if (pos == base_entry->two_hop_set_head) {
+                pos = NULL;
+                break;
+            }
+            pos = pos->prev;
+        }
+    }
+
+    if (!pos) {
+        DL_PREPEND(base_entry->two_hop_set_head, th_entry);
+    }
+    else if (!pos->next) {
+        DL_APPEND(base_entry->two_hop_set_head, th_entry);
+    }
+    else {
+        th_entry->prev = pos;
+        th_entry->next = pos->next;
+        pos->next->prev = th_entry;
+        pos->next = th_entry;
+    }
+}
+
 /**
  * Remove a given 2-Hop Tuple
  */
 static void rem_two_hop_entry(iib_base_entry_t *base_entry, iib_two_hop_set_entry_t *th_entry)
 {
-    LL_DELETE(base_entry->two_hop_set_head, th_entry);
+    DL_DELETE(base_entry->two_hop_set_head, th_entry);
+    LL_DELETE2(th_entry->ls_elt->th_head, th_entry, ls_next);
     nhdp_decrement_addr_usage(th_entry->th_nb_addr);
     free(th_entry);
 }
 
+/**
+ * Remove all 2-Hop Tuples of a given link tuple
+ */
+static void rem_link_two_hop_entries(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry)
+{
+    while (ls_entry->th_head) {
+        rem_two_hop_entry(base_entry, ls_entry->th_head);
+    }
+}
+
 /**
  * Remove all corresponding two hop entries for a given link tuple that lost symmetry status.
  * Additionally reset the neighbor tuple's symmmetry flag (for the neighbor tuple this link
@@ -726,14 +787,8 @@ static void rem_two_hop_entry(iib_base_entry_t *base_entry, iib_two_hop_set_entr
 static void update_nb_tuple_symmetry(iib_base_entry_t *base_entry,
                                      iib_link_set_entry_t *ls_entry, timex_t *now)
 {
-    iib_two_hop_set_entry_t *th_elt, *th_tmp;
-
     /* First remove all two hop entries for the corresponding link tuple */
-    LL_FOREACH_SAFE(base_entry->two_hop_set_head, th_elt, th_tmp) {
-        if (th_elt->ls_elt == ls_entry) {
-            rem_two_hop_entry(base_entry, th_elt);
-        }
-    }
+    rem_link_two_hop_entries(base_entry, ls_entry);
 
     /* Afterwards check the neighbor tuple containing the link tuple's addresses */
     if ((ls_entry->nb_elt != NULL) && (ls_entry->nb_elt->symmetric == 1)) {
@@ -814,77 +869,140 @@ static inline timex_t get_max_timex(timex_t time_one, timex_t time_two)
     return time_two;
 }
 
-#if (NHDP_METRIC == NHDP_LMT_DAT)
 /**
- * Sum all elements in the queue
+ * Get the time of the next possible L_STATUS change (or expiration) of a link tuple
  */
-static uint16_t queue_sum(uint8_t *queue)
+static timex_t get_next_status_change(iib_link_set_entry_t *ls_entry)
 {
-    uint16_t sum = 0;
+    timex_t next = ls_entry->exp_time;
 
-    for (int i = 0; i < NHDP_Q_MEM_LENGTH; i++) {
-        sum += queue[i];
+    if ((ls_entry->last_status == IIB_LT_STATUS_SYM)
+        && (timex_cmp(ls_entry->sym_time, next) == -1)) {
+        next = ls_entry->sym_time;
+    }
+    else if ((ls_entry->last_status == IIB_LT_STATUS_HEARD)
+             && (timex_cmp(ls_entry->heard_time, next) == -1)) {
+        next = ls_entry->heard_time;
     }
 
-    return sum;
+    return next;
 }
 
 /**
- * Remove the oldest element in the queue
+ * (Re)insert a link tuple into the status timer queue according to its next status change
  */
-static void queue_rem(uint8_t *queue)
+static void lt_timer_queue_update(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry)
 {
-    uint8_t temp;
-    uint8_t prev_value = queue[0];
+    iib_link_set_entry_t *pos = NULL;
+
+    lt_timer_queue_remove(base_entry, ls_entry);
+    ls_entry->next_change = get_next_status_change(ls_entry);
+
+    if (base_entry->lt_timer_queue_head) {
+        /* Walk back from the tail, refreshed tuples usually change last */
+        pos = base_entry->lt_timer_queue_head->tq_prev;
 
-    /* Clear spot for a new element */
-    queue[0] = 0;
+        while (timex_cmp(pos->next_change, ls_entry->next_change) == 1) {
+            if (pos == base_entry->lt_timer_queue_head) {
+                pos = NULL;
+                break;
+            }
+            pos = pos->tq_prev;
+        }
+    }
+
+    if (!pos) {
+        DL_PREPEND2(base_entry->lt_timer_queue_head, ls_entry, tq_prev, tq_next);
+    }
+    else if (!pos->tq_next) {
+        DL_APPEND2(base_entry->lt_timer_queue_head, ls_entry, tq_prev, tq_next);
+    }
+    else {
+        ls_entry->tq_prev = pos;
+        ls_entry->tq_next = pos->tq_next;
+        pos->tq_next->tq_prev = ls_entry;
+        pos->tq_next = ls_entry;
+    }
+}
 
-    /* Shift elements */
-    for (int i = 1; i < NHDP_Q_MEM_LENGTH; i++) {
-        temp = queue[i];
-        queue[i] = prev_value;
-        prev_value = temp;
+/**
+ * Remove a link tuple from the status timer queue if it is queued
+ */
+static void lt_timer_queue_remove(iib_base_entry_t *base_entry, iib_link_set_entry_t *ls_entry)
+{
+    if (ls_entry->tq_prev) {
+        DL_DELETE2(base_entry->lt_timer_queue_head, ls_entry, tq_prev, tq_next);
+        ls_entry->tq_prev = NULL;
+        ls_entry->tq_next = NULL;
     }
 }
 
+#if (NHDP_METRIC == NHDP_LMT_DAT)
+/**
+ * Set the element at the given position of a queue and keep the queue's sum up to date
+ */
+static void queue_set(uint8_t *queue, uint16_t *sum, uint8_t pos, uint8_t value)
+{
+    *sum = *sum - queue[pos] + value;
+    queue[pos] = value;
+}
+
+/**
+ * Remove the oldest element from both DAT queues of a link tuple and make its
+ * slot the new (empty) newest element
+ */
+static void queue_advance(iib_link_set_entry_t *ls_entry)
+{
+    /* The slot after the newest element holds the oldest one */
+    uint8_t pos = (ls_entry->dat_q_pos + 1) % NHDP_Q_MEM_LENGTH;
+
+    queue_set(ls_entry->dat_received, &ls_entry->dat_received_sum, pos, 0);
+    queue_set(ls_entry->dat_total, &ls_entry->dat_total_sum, pos, 0);
+    ls_entry->dat_q_pos = pos;
+}
+
 /**
  * Update DAT metric values for all Link Tuples
+ *
+ * Uses fixed-point arithmetic with DAT_FRAC_BITS fractional bits instead of
+ * floating point math, as most targets lack an FPU.
  */
 static void dat_metric_refresh(void)
 {
     iib_base_entry_t *base_elt;
     iib_link_set_entry_t *ls_elt;
-    uint32_t metric_temp;
-    double sum_total, sum_rcvd, loss;
+    uint32_t metric_temp, sum_total, sum_rcvd, loss;
 
     LL_FOREACH(iib_base_entry_head, base_elt) {
         LL_FOREACH(base_elt->link_set_head, ls_elt) {
-            sum_rcvd = queue_sum(ls_elt->dat_received);
-            sum_total = queue_sum(ls_elt->dat_total);
+            sum_rcvd = ((uint32_t)ls_elt->dat_received_sum) << DAT_FRAC_BITS;
+            sum_total = ls_elt->dat_total_sum;
             metric_temp = ls_elt->metric_in;
 
             if ((ls_elt->hello_interval != 0) && (ls_elt->lost_hellos > 0)) {
-                /* Compute lost time proportion */
-                loss = (((double)ls_elt->hello_interval) * ((double)ls_elt->lost_hellos))
-                        / DAT_MEMORY_LENGTH;
-                if (loss >= 1.0) {
-                    sum_rcvd = 0.0;
+                /* Compute lost time proportion (in units of 1 / DAT_MEMORY_LENGTH) */
+                loss = ((uint32_t)ls_elt->hello_interval) * ls_elt->lost_hellos;
+                if (loss >= DAT_MEMORY_LENGTH) {
+                    sum_rcvd = 0;
                 }
                 else {
-                    sum_rcvd *= (1.0 - loss);
+                    sum_rcvd = (sum_rcvd * (DAT_MEMORY_LENGTH - loss)) / DAT_MEMORY_LENGTH;
                 }
             }
 
-            if (sum_rcvd < 1.0) {
+            if (sum_rcvd < (1 << DAT_FRAC_BITS)) {
                 ls_elt->metric_in = NHDP_METRIC_MAXIMUM;
             }
             else {
-                loss = sum_total / sum_rcvd;
-                if (loss > DAT_MAXIMUM_LOSS) {
-                    loss = DAT_MAXIMUM_LOSS;
+                uint32_t bitrate_factor = ls_elt->rx_bitrate / DAT_MINIMUM_BITRATE;
+
+                /* Fixed-point quotient of expected and received packets */
+                loss = (sum_total << (2 * DAT_FRAC_BITS)) / sum_rcvd;
+                if (loss > (DAT_MAXIMUM_LOSS << DAT_FRAC_BITS)) {
+                    loss = DAT_MAXIMUM_LOSS << DAT_FRAC_BITS;
                 }
-                ls_elt->metric_in = (const_dat * loss) / (ls_elt->rx_bitrate / DAT_MINIMUM_BITRATE);
+                ls_elt->metric_in = ((DAT_CONSTANT / DAT_MAXIMUM_LOSS) >> DAT_FRAC_BITS) * loss
+                                    / (bitrate_factor ? bitrate_factor : 1);
                 if (ls_elt->metric_in > NHDP_METRIC_MAXIMUM) {
                     ls_elt->metric_in = NHDP_METRIC_MAXIMUM;
                 }
@@ -915,8 +1033,7 @@ static void dat_metric_refresh(void)
                 }
             }
 
-            queue_rem(ls_elt->dat_received);
-            queue_rem(ls_elt->dat_total);
+            queue_advance(ls_elt);
         }
     }
 }
@@ -53,11 +53,18 @@ typedef struct iib_link_set_entry_t {
     timex_t exp_time;                           /**< Time at which entry expires */
     nib_entry_t *nb_elt;                        /**< Pointer to corresponding nb tuple */
     enum iib_link_tuple_status_t last_status;   /**< Last processed status of link tuple */
+    timex_t next_change;                        /**< Time of the next possible status change */
+    struct iib_link_set_entry_t *tq_prev;       /**< Previous tuple in the status timer queue */
+    struct iib_link_set_entry_t *tq_next;       /**< Next tuple in the status timer queue */
+    struct iib_two_hop_set_entry_t *th_head;    /**< 2-hop tuples reached via this link tuple */
     uint32_t metric_in;                         /**< Metric value for incoming link */
     uint32_t metric_out;                        /**< Metric value for outgoing link */
 #if (NHDP_METRIC == NHDP_LMT_DAT)
     uint8_t dat_received[NHDP_Q_MEM_LENGTH];    /**< Queue for containing sums of rcvd packets */
     uint8_t dat_total[NHDP_Q_MEM_LENGTH];       /**< Queue for containing sums of xpctd packets */
+    uint16_t dat_received_sum;                  /**< Sum of all elements in dat_received */
+    uint16_t dat_total_sum;                     /**< Sum of all elements in dat_total */
+    uint8_t dat_q_pos;                          /**< Position of the newest element in the queues */
     timex_t dat_time;                           /**< Time next HELLO is expected */
     uint8_t hello_interval;                     /**< Encoded HELLO interval value */
     uint8_t lost_hellos;                        /**< Lost HELLO count after last received HELLO */
@@ -76,7 +83,9 @@ typedef struct iib_two_hop_set_entry_t {
     timex_t exp_time;                           /**< Time at which entry expires */
     uint32_t metric_in;                         /**< Metric value for incoming link */
     uint32_t metric_out;                        /**< Metric value for outgoing link */
+    struct iib_two_hop_set_entry_t *prev;       /**< Pointer to previous list entry */
     struct iib_two_hop_set_entry_t *next;       /**< Pointer to next list entry */
+    struct iib_two_hop_set_entry_t *ls_next;    /**< Next 2-hop tuple of the same link tuple */
 } iib_two_hop_set_entry_t;
 
 /**
@@ -85,7 +94,9 @@ typedef struct iib_two_hop_set_entry_t {
 typedef struct iib_base_entry_t {
     kernel_pid_t if_pid;                                /**< PID of the interface */
     struct iib_link_set_entry_t *link_set_head;         /**< Pointer to this if's link tuples */
-    struct iib_two_hop_set_entry_t *two_hop_set_head;   /**< Pointer to this if's 2-hop tuples */
+    struct iib_link_set_entry_t *lt_timer_queue_head;   /**< Link tuples sorted by next_change */
+    struct iib_two_hop_set_entry_t *two_hop_set_head;   /**< This if's 2-hop tuples sorted by
+                                                         *   expiration time */
     struct iib_base_entry_t *next;                      /**< Pointer to next list entry */
 } iib_base_entry_t;
 
@@ -135,6 +146,9 @@ void iib_fill_wr_addresses(kernel_pid_t if_pid, struct rfc5444_writer *wr);
 /**
  * @brief                   Update L_STATUS of all existing Link Tuples
  *
+ * Only Link Tuples whose next status change is due are processed. They are kept
+ * in a timer queue sorted by the time of their next possible status change.
+ *
  * @note
  * If a status change appears the steps described in section 13 of RFC 6130 are executed.
  *
@@ -24,9 +24,21 @@
 #include "nhdp.h"
 #include "nhdp_address.h"
 
+#if (NHDP_ADDR_HASH_SIZE & (NHDP_ADDR_HASH_SIZE - 1)) != 0
+#error "NHDP_ADDR_HASH_SIZE must be a power of 2"
+#endif
+
 /* Internal variables */
 static mutex_t mtx_addr_access = MUTEX_INIT;
 static nhdp_addr_t *nhdp_addr_db_head = NULL;
+static nhdp_addr_t *addr_hash_table[NHDP_ADDR_HASH_SIZE];
+static nhdp_addr_t addr_pool[NHDP_ADDR_POOL_SIZE];
+static nhdp_addr_t *addr_free_list = NULL;
+static uint8_t addr_pool_initialized = 0;
+
+/* Internal function prototypes */
+static void init_addr_pool(void);
+static nhdp_addr_t **get_hash_bucket(uint8_t *addr, size_t addr_size, uint8_t addr_type);
 
 
 /*---------------------------------------------------------------------------*
@@ -35,11 +47,22 @@ static nhdp_addr_t *nhdp_addr_db_head = NULL;
 
 nhdp_addr_t *nhdp_addr_db_get_address(uint8_t *addr, size_t addr_size, uint8_t addr_type)
 {
+    nhdp_addr_t **bucket;
     nhdp_addr_t *addr_elt;
 
+    if (addr_size > NHDP_ADDR_MAX_SIZE) {
+        return NULL;
+    }
+
     mutex_lock(&mtx_addr_access);
 
-    LL_FOREACH(nhdp_addr_db_head, addr_elt) {
+    if (!addr_pool_initialized) {
+        init_addr_pool();
+    }
+
+    bucket = get_hash_bucket(addr, addr_size, addr_type);
+
+    for (addr_elt = *bucket; addr_elt; addr_elt = addr_elt->hash_next) {
         if ((addr_elt->addr_size == addr_size) && (addr_elt->addr_type == addr_type)) {
             if (memcmp(addr_elt->addr, addr, addr_size) == 0) {
                 /* Found a matching entry */
@@ -49,22 +72,16 @@ nhdp_addr_t *nhdp_addr_db_get_address(uint8_t *addr, size_t addr_size, uint8_t a
     }
 
     if (!addr_elt) {
-        /* No matching entry, create a new one */
-        addr_elt = (nhdp_addr_t *) malloc(sizeof(nhdp_addr_t));
+        /* No matching entry, take a new one from the pool */
+        addr_elt = addr_free_list;
 
         if (!addr_elt) {
-            /* Insufficient memory */
+            /* Address storage is full */
+            mutex_unlock(&mtx_addr_access);
             return NULL;
         }
 
-        /* Allocate space for the address */
-        addr_elt->addr = (uint8_t *) malloc(addr_size * sizeof(uint8_t));
-
-        if (!addr_elt->addr) {
-            /* Insufficient memory */
-            free(addr_elt);
-            return NULL;
-        }
+        addr_free_list = addr_elt->next;
 
         memcpy(addr_elt->addr, addr, addr_size);
         addr_elt->addr_size = addr_size;
@@ -72,7 +89,9 @@ nhdp_addr_t *nhdp_addr_db_get_address(uint8_t *addr, size_t addr_size, uint8_t a
         addr_elt->usg_count = 0;
         addr_elt->in_tmp_table = NHDP_ADDR_TMP_NONE;
         addr_elt->tmp_metric_val = NHDP_METRIC_UNKNOWN;
-        LL_PREPEND(nhdp_addr_db_head, addr_elt);
+        addr_elt->hash_next = *bucket;
+        *bucket = addr_elt;
+        DL_PREPEND(nhdp_addr_db_head, addr_elt);
     }
 
     addr_elt->usg_count++;
@@ -91,10 +110,18 @@ void nhdp_decrement_addr_usage(nhdp_addr_t *addr)
         addr->usg_count--;
 
         if (addr->usg_count <= 0) {
-            /* Free address space if address is no longer used */
-            LL_DELETE(nhdp_addr_db_head, addr);
-            free(addr->addr);
-            free(addr);
+            /* Return address to the pool if address is no longer used */
+            nhdp_addr_t **bucket = get_hash_bucket(addr->addr, addr->addr_size,
+                                                   addr->addr_type);
+
+            while (*bucket != addr) {
+                bucket = &(*bucket)->hash_next;
+            }
+
+            *bucket = addr->hash_next;
+            DL_DELETE(nhdp_addr_db_head, addr);
+            addr->next = addr_free_list;
+            addr_free_list = addr;
         }
     }
 
@@ -161,3 +188,35 @@ nhdp_addr_t *nhdp_get_addr_db_head(void)
 {
     return nhdp_addr_db_head;
 }
+
+
+/*------------------------------------------------------------------------------------*/
+/*                                Internal functions                                  */
+/*------------------------------------------------------------------------------------*/
+
+/**
+ * Chain all entries of the address pool into the free list
+ */
+static void init_addr_pool(void)
+{
+    for (unsigned i = 0; i < NHDP_ADDR_POOL_SIZE; i++) {
+        addr_pool[i].next = addr_free_list;
+        addr_free_list = &addr_pool[i];
+    }
+
+    addr_pool_initialized = 1;
+}
+
+/**
+ * Get the hash bucket for the given address (FNV-1a over type and address bytes)
+ */
+static nhdp_addr_t **get_hash_bucket(uint8_t *addr, size_t addr_size, uint8_t addr_type)
+{
+    uint32_t hash = (2166136261u ^ addr_type) * 16777619u;
+
+    for (size_t i = 0; i < addr_size; i++) {
+        hash = (hash ^ addr[i]) * 16777619u;
+    }
+
+    return &addr_hash_table[hash & (NHDP_ADDR_HASH_SIZE - 1)];
+}
@@ -23,17 +23,49 @@
 extern "C" {
 #endif
 
+/**
+ * @name    NHDP address storage configuration
+ *
+ * @{
+ */
+#ifndef NHDP_ADDR_MAX_SIZE
+/** @brief Maximum size in bytes of a stored address (IPv6) */
+#define NHDP_ADDR_MAX_SIZE          (16)
+#endif
+
+#ifndef NHDP_ADDR_POOL_SIZE
+/**
+ * @brief Number of addresses the central address storage can hold
+ *
+ * The storage is allocated statically and does not grow. It holds every
+ * address referenced by the information bases plus the addresses of the HELLO
+ * message currently processed, so it has to be sized for the expected number
+ * of one-hop and two-hop neighbor addresses. When the storage is full,
+ * nhdp_addr_db_get_address() returns NULL and the NHDP reader drops the
+ * HELLO message, releasing all addresses it already referenced.
+ */
+#define NHDP_ADDR_POOL_SIZE         (64)
+#endif
+
+#ifndef NHDP_ADDR_HASH_SIZE
+/** @brief Number of hash buckets used for address lookup (must be a power of 2) */
+#define NHDP_ADDR_HASH_SIZE         (32)
+#endif
+/** @} */
+
 /**
  * @brief   NHDP address representation
  */
 typedef struct nhdp_addr_t {
-    uint8_t *addr;                      /**< Pointer to the address data */
+    uint8_t addr[NHDP_ADDR_MAX_SIZE];   /**< The address data */
     size_t addr_size;                   /**< Size in bytes of the address */
     uint8_t addr_type;                  /**< AF type for the address */
     uint8_t usg_count;                  /**< Usage count in information bases */
     uint8_t in_tmp_table;               /**< Signals usage in a writers temp table */
     uint16_t tmp_metric_val;            /**< Encoded metric value used during HELLO processing */
     struct nhdp_addr_t *next;           /**< Pointer to next address (used in central storage) */
+    struct nhdp_addr_t *prev;           /**< Pointer to previous address (used in central storage) */
+    struct nhdp_addr_t *hash_next;      /**< Pointer to next address in the same hash bucket */
 } nhdp_addr_t;
 
 /**
@@ -75,7 +107,7 @@ typedef struct nhdp_addr_entry_t {
  * @param[in] addr_type     AF type of the given address
  *
  * @return                  Pointer to the NHDP address representation of the given address
- * @return                  NULL on error
+ * @return                  NULL if the address is too long or the address storage is full
  */
 nhdp_addr_t *nhdp_addr_db_get_address(uint8_t *addr, size_t addr_size, uint8_t addr_type);
 
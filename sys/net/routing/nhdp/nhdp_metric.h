@@ -76,14 +76,17 @@ extern "C" {
 #define DAT_MEMORY_LENGTH           (NHDP_Q_MEM_LENGTH)
 /** @brief Time between DAT metric refreshal */
 #define DAT_REFRESH_INTERVAL        (1)
-/** @brief Factor to spread HELLO interval */
-#define DAT_HELLO_TIMEOUT_FACTOR    (1.2)
+/** @brief Factor to spread HELLO interval (1.2 as fraction to avoid floating point math) */
+#define DAT_HELLO_TIMEOUT_FACTOR_NUM    (6)
+#define DAT_HELLO_TIMEOUT_FACTOR_DEN    (5)
 /** @brief Minimal supported bit rate in bps (default value for new links) */
 #define DAT_MINIMUM_BITRATE         (1000)
 /** @brief Maximum allowed loss in expected/rcvd HELLOs (should not be changed) */
 #define DAT_MAXIMUM_LOSS            (8)
 /** @brief Constant value needed for DAT metric computation (should not be changed) */
 #define DAT_CONSTANT                (16777216)
+/** @brief Number of fractional bits used for fixed-point DAT metric computation */
+#define DAT_FRAC_BITS               (8)
 /** @} */
 
 #ifdef __cplusplus
@@ -35,6 +35,7 @@
 static mutex_t mtx_nib_access = MUTEX_INIT;
 static nib_entry_t *nib_entry_head = NULL;
 static nib_lost_address_entry_t *nib_lost_address_entry_head = NULL;
+static uint8_t rem_list_pending = 0;
 
 /* Internal function prototypes */
 static nib_entry_t *add_nib_entry_for_nb_addr_list(void);
@@ -58,6 +59,7 @@ nib_entry_t *nib_process_hello(void)
     mutex_lock(&mtx_nib_access);
 
     vtimer_now(&now);
+    rem_list_pending = 0;
 
     LL_FOREACH_SAFE(nib_entry_head, nib_elt, nib_tmp) {
         nhdp_addr_entry_t *list_elt;
@@ -189,6 +191,11 @@ void nib_reset_nb_entry_sym(nib_entry_t *nib_entry, timex_t *now)
     }
 }
 
+uint8_t nib_rem_list_pending(void)
+{
+    return rem_list_pending;
+}
+
 
 /*------------------------------------------------------------------------------------*/
 /*                                Internal functions                                  */
@@ -249,6 +256,7 @@ static void clear_nb_addresses(nib_entry_t *nib_entry, timex_t *now)
             /* Address is not in the newly received address list of the neighbor */
             /* Add it to the Removed Address List */
             nib_elt->address->in_tmp_table |= NHDP_ADDR_TMP_REM_LIST;
+            rem_list_pending = 1;
             /* Increment usage counter of address in central NHDP address storage */
             nib_elt->address->usg_count++;
 
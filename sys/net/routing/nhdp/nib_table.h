@@ -98,6 +98,18 @@ void nib_set_nb_entry_sym(nib_entry_t *nib_entry);
  */
 void nib_reset_nb_entry_sym(nib_entry_t *nib_entry, timex_t *now);
 
+/**
+ * @brief                   Check whether the last processed HELLO put addresses
+ *                          into the Removed Address List
+ *
+ * @note
+ * Must not be called from outside the NHDP reader's message processing.
+ *
+ * @return                  1 if the Removed Address List is not empty
+ * @return                  0 otherwise
+ */
+uint8_t nib_rem_list_pending(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,7 +16,10 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
+#include "cib.h"
+#include "irq.h"
 #include "thread.h"
 #include "sched.h"
 #include "tcb.h"
@@ -35,7 +38,9 @@ const char *state_names[] = {
     [STATUS_MUTEX_BLOCKED] = "bl mutex",
     [STATUS_RECEIVE_BLOCKED] = "bl rx",
     [STATUS_SEND_BLOCKED] = "bl send",
-    [STATUS_REPLY_BLOCKED] = "bl reply"
+    [STATUS_REPLY_BLOCKED] = "bl reply",
+    [STATUS_FLAG_BLOCKED_ANY] = "bl anyfl",
+    [STATUS_FLAG_BLOCKED_ALL] = "bl allfl"
 };
 
 /**
@@ -56,8 +61,9 @@ void ps(void)
 #ifdef DEVELHELP
            "| stack ( used) | location   "
 #endif
+           "| msgq "
 #ifdef MODULE_SCHEDSTATISTICS
-           "| runtime | switches"
+           "(peak) | runtime | switches"
 #endif
            "\n",
 #ifdef DEVELHELP
@@ -72,6 +78,7 @@ void ps(void)
             int state = p->status;                                                 /* copy state */
             const char *sname = state_names[state];                                /* get state name */
             const char *queued = &queued_name[(int)(state >= STATUS_ON_RUNQUEUE)]; /* get queued flag */
+            unsigned msgq = p->msg_array ? cib_avail(&p->msg_queue) : 0;           /* get queue fill */
 #ifdef DEVELHELP
             int stacksz = p->stack_size;                                           /* get stack size */
             overall_stacksz += stacksz;
@@ -81,6 +88,7 @@ void ps(void)
 #ifdef MODULE_SCHEDSTATISTICS
             double runtime_ticks =  sched_pidlist[i].runtime_ticks / (double) xtimer_now() * 100;
             int switches = sched_pidlist[i].schedules;
+            unsigned msgq_peak = sched_pidlist[i].msg_queue_peak;
 #endif
             printf("\t%3" PRIkernel_pid
 #ifdef DEVELHELP
@@ -90,8 +98,9 @@ void ps(void)
 #ifdef DEVELHELP
                    " | %5i (%5i) | %p "
 #endif
+                   " | %4u"
 #ifdef MODULE_SCHEDSTATISTICS
-                   " | %6.3f%% |  %8d"
+                   " (%4u) | %6.3f%% |  %8d"
 #endif
                    "\n",
                    p->pid,
@@ -102,15 +111,121 @@ void ps(void)
 #ifdef DEVELHELP
                    , p->stack_size, stacksz, p->stack_start
 #endif
+                   , msgq
 #ifdef MODULE_SCHEDSTATISTICS
-                   , runtime_ticks, switches
+                   , msgq_peak, runtime_ticks, switches
 #endif
                   );
         }
     }
 
 #ifdef DEVELHELP
-    printf("\t%5s %-21s|%13s%6s %5i (%5i)\n", "|", "SUM", "|", "|",
+    printf("\t%3s | %-20s | %-8s %.1s | %3s | %5i (%5i)\n", "", "SUM", "", " ", "",
            overall_stacksz, overall_used);
 #endif
 }
+
+#ifdef MODULE_SCHEDSTATISTICS
+/* runtime of every thread and of all ISRs at the start of the interval */
+static unsigned long _last_runtime[KERNEL_PID_LAST + 1];
+static unsigned long _last_isr_ticks;
+static uint32_t _last_sample;
+
+static unsigned long _runtime(kernel_pid_t pid, uint32_t now)
+{
+    schedstat *stat = &sched_pidlist[pid];
+    unsigned long runtime = stat->runtime_ticks;
+
+    /* the running thread is only accounted for when it is switched out */
+    if (pid == sched_active_pid && stat->laststart) {
+        runtime += now - stat->laststart;
+    }
+    return runtime;
+}
+
+static uint32_t _sample(unsigned long *runtime, unsigned long *isr_ticks)
+{
+    unsigned state = disableIRQ();
+    uint32_t now = xtimer_now();
+
+    for (kernel_pid_t i = KERNEL_PID_FIRST; i <= KERNEL_PID_LAST; i++) {
+        runtime[i] = sched_threads[i] ? _runtime(i, now) : 0;
+    }
+    *isr_ticks = sched_isr_ticks;
+    restoreIRQ(state);
+    return now;
+}
+
+void ps_top(uint32_t interval, unsigned rounds)
+{
+    unsigned long runtime[KERNEL_PID_LAST + 1];
+    unsigned long isr_ticks;
+
+    _last_sample = _sample(_last_runtime, &_last_isr_ticks);
+
+    while (rounds--) {
+        xtimer_usleep(interval);
+
+        uint32_t now = _sample(runtime, &isr_ticks);
+        double elapsed = now - _last_sample;
+
+        printf("\tpid | "
+#ifdef DEVELHELP
+               "%-21s| "
+#endif
+               "%-9s| pri |    cpu "
+#ifdef DEVELHELP
+               "| stack (~used) "
+#endif
+               "| msgq (peak)\n",
+#ifdef DEVELHELP
+               "name",
+#endif
+               "state");
+
+        for (kernel_pid_t i = KERNEL_PID_FIRST; i <= KERNEL_PID_LAST; i++) {
+            tcb_t *p = (tcb_t *)sched_threads[i];
+
+            if (p == NULL) {
+                continue;
+            }
+
+            /* a thread that was started during the interval has no baseline */
+            unsigned long delta = runtime[i] >= _last_runtime[i]
+                                  ? runtime[i] - _last_runtime[i] : runtime[i];
+            unsigned msgq = p->msg_array ? cib_avail(&p->msg_queue) : 0;
+            unsigned msgq_size = p->msg_array ? p->msg_queue.mask + 1 : 0;
+
+            printf("\t%3" PRIkernel_pid
+#ifdef DEVELHELP
+                   " | %-20s"
+#endif
+                   " | %-8s | %3i | %5.1f%%"
+#ifdef DEVELHELP
+                   " | %5i (%5i)"
+#endif
+                   " | %2u/%-2u (%2u)\n",
+                   p->pid,
+#ifdef DEVELHELP
+                   p->name,
+#endif
+                   state_names[p->status], p->priority, delta / elapsed * 100
+#ifdef DEVELHELP
+                   /* the cached watermark can miss usage below an untouched
+                    * buffer, hence the ~ */
+                   , p->stack_size,
+                   p->stack_size - (int)thread_measure_stack_free_cached(p)
+#endif
+                   , msgq, msgq_size, sched_pidlist[i].msg_queue_peak);
+        }
+
+        printf("\tisr: %5.1f%% | max %lu us\n\n",
+               (isr_ticks - _last_isr_ticks) / elapsed * 100,
+               sched_isr_max_ticks);
+
+        memcpy(_last_runtime, runtime, sizeof(runtime));
+        _last_isr_ticks = isr_ticks;
+        _last_sample = now;
+    }
+}
+#endif
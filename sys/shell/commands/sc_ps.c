@@ -18,14 +18,40 @@
  * @}
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "ps.h"
 
+#ifdef MODULE_SCHEDSTATISTICS
+#define PS_TOP_INTERVAL_MS  (1000U)
+#define PS_TOP_ROUNDS       (10U)
+#endif
+
 int _ps_handler(int argc, char **argv)
 {
-    (void) argc;
-    (void) argv;
+    if (argc == 1) {
+        ps();
+        return 0;
+    }
+
+#ifdef MODULE_SCHEDSTATISTICS
+    if (strcmp(argv[1], "top") == 0) {
+        uint32_t interval = (argc > 2) ? (uint32_t)atoi(argv[2]) : PS_TOP_INTERVAL_MS;
+        unsigned rounds = (argc > 3) ? (unsigned)atoi(argv[3]) : PS_TOP_ROUNDS;
 
-    ps();
+        if (interval == 0) {
+            puts("ps: interval has to be greater than 0");
+            return 1;
+        }
+        ps_top(interval * 1000, rounds);
+        return 0;
+    }
 
-    return 0;
+    printf("usage: %s [top [interval in ms] [rounds]]\n", argv[0]);
+#else
+    printf("usage: %s\n", argv[0]);
+#endif
+    return 1;
 }
@@ -17,6 +17,8 @@
  * @}
  */
 
+#include <string.h>
+
 #include "tsrb.h"
 
 static void _push(tsrb_t *rb, char c)
@@ -41,12 +43,40 @@ int tsrb_get_one(tsrb_t *rb)
 
 int tsrb_get(tsrb_t *rb, char *dst, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_empty(rb)) {
-        *dst++ = _pop(rb);
-        tmp--;
+    size_t done = 0;
+    char *region;
+
+    /* the filled part wraps at most once */
+    for (int i = 0; i < 2 && done < n; i++) {
+        size_t len = tsrb_get_region(rb, &region);
+        if (len > n - done) {
+            len = n - done;
+        }
+        if (len == 0) {
+            break;
+        }
+        memcpy(dst + done, region, len);
+        tsrb_get_commit(rb, len);
+        done += len;
     }
-    return (n - tmp);
+    return done;
+}
+
+unsigned tsrb_get_region(const tsrb_t *rb, char **region)
+{
+    unsigned reads = rb->reads;
+    unsigned pos = reads & (rb->size - 1);
+    unsigned avail = rb->writes - reads;
+    unsigned till_end = rb->size - pos;
+
+    *region = rb->buf + pos;
+    return (avail < till_end) ? avail : till_end;
+}
+
+void tsrb_get_commit(tsrb_t *rb, unsigned n)
+{
+    assert(n <= tsrb_avail(rb));
+    rb->reads += n;
 }
 
 int tsrb_add_one(tsrb_t *rb, char c)
@@ -62,10 +92,38 @@ int tsrb_add_one(tsrb_t *rb, char c)
 
 int tsrb_add(tsrb_t *rb, const char *src, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_full(rb)) {
-        _push(rb, *src++);
-        tmp--;
+    size_t done = 0;
+    char *region;
+
+    /* the free part wraps at most once */
+    for (int i = 0; i < 2 && done < n; i++) {
+        size_t len = tsrb_add_region(rb, &region);
+        if (len > n - done) {
+            len = n - done;
+        }
+        if (len == 0) {
+            break;
+        }
+        memcpy(region, src + done, len);
+        tsrb_add_commit(rb, len);
+        done += len;
     }
-    return (n - tmp);
+    return done;
+}
+
+unsigned tsrb_add_region(const tsrb_t *rb, char **region)
+{
+    unsigned writes = rb->writes;
+    unsigned pos = writes & (rb->size - 1);
+    unsigned free = rb->size - (writes - rb->reads);
+    unsigned till_end = rb->size - pos;
+
+    *region = rb->buf + pos;
+    return (free < till_end) ? free : till_end;
+}
+
+void tsrb_add_commit(tsrb_t *rb, unsigned n)
+{
+    assert(n <= tsrb_free(rb));
+    rb->writes += n;
 }
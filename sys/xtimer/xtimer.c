@@ -50,6 +50,11 @@ void _xtimer_sleep(uint32_t offset, uint32_t long_offset)
     mutex_lock(&mutex);
     _xtimer_set64(&timer, offset, long_offset);
     mutex_lock(&mutex);
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    /* the timer may have fired before the second lock, which then took the
+     * mutex as owner: release it before the stack frame goes away */
+    mutex_unlock(&mutex);
+#endif
 }
 
 void xtimer_usleep_until(uint32_t *last_wakeup, uint32_t interval) {
@@ -91,8 +96,12 @@ void xtimer_usleep_until(uint32_t *last_wakeup, uint32_t interval) {
         else {
             offset += xtimer_now();
         }
-        _xtimer_set_absolute(&timer, offset);
+        _xtimer_set_absolute(&timer, offset, 0);
         mutex_lock(&mutex);
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+        /* see _xtimer_sleep() */
+        mutex_unlock(&mutex);
+#endif
     }
     else {
         xtimer_spin(offset);
@@ -123,6 +132,13 @@ void xtimer_set_msg(xtimer_t *timer, uint32_t offset, msg_t *msg, kernel_pid_t t
     xtimer_set(timer, offset);
 }
 
+void xtimer_set_msg_slack(xtimer_t *timer, uint32_t offset, uint32_t slack,
+                          msg_t *msg, kernel_pid_t target_pid)
+{
+    _setup_msg(timer, msg, target_pid);
+    xtimer_set_slack(timer, offset, slack);
+}
+
 void xtimer_set_msg64(xtimer_t *timer, uint64_t offset, msg_t *msg, kernel_pid_t target_pid)
 {
     _setup_msg(timer, msg, target_pid);
@@ -187,3 +203,41 @@ int xtimer_msg_receive_timeout64(msg_t *m, uint64_t timeout) {
         return 1;
     }
 }
+
+#ifdef MODULE_THREAD_FLAGS
+static void _callback_timeout_flag(void *arg)
+{
+    thread_flags_set((kernel_pid_t)((intptr_t)arg), THREAD_FLAG_TIMEOUT);
+}
+
+static thread_flags_t _thread_flags_wait_timeout(thread_flags_t mask,
+                                                 uint32_t timeout,
+                                                 thread_flags_t (*wait)(thread_flags_t))
+{
+    xtimer_t t;
+    t.target = t.long_target = 0;
+    t.callback = _callback_timeout_flag;
+    t.arg = (void*) ((intptr_t)sched_active_pid);
+
+    thread_flags_clear(THREAD_FLAG_TIMEOUT);
+    xtimer_set(&t, timeout);
+
+    thread_flags_t res = wait(mask | THREAD_FLAG_TIMEOUT);
+
+    /* the timer might have fired after the flags were set */
+    xtimer_remove(&t);
+    thread_flags_clear(THREAD_FLAG_TIMEOUT);
+
+    return res & ~THREAD_FLAG_TIMEOUT;
+}
+
+thread_flags_t xtimer_thread_flags_wait_any(thread_flags_t mask, uint32_t timeout)
+{
+    return _thread_flags_wait_timeout(mask, timeout, thread_flags_wait_any);
+}
+
+thread_flags_t xtimer_thread_flags_wait_all(thread_flags_t mask, uint32_t timeout)
+{
+    return _thread_flags_wait_timeout(mask, timeout, thread_flags_wait_all);
+}
+#endif
@@ -22,6 +22,10 @@
 #include "xtimer.h"
 #include "irq.h"
 
+#ifdef MODULE_SCHEDSTATISTICS
+#include "sched.h"
+#endif
+
 /* WARNING! enabling this will have side effects and can lead to timer underflows. */
 #define ENABLE_DEBUG 0
 #include "debug.h"
@@ -33,10 +37,17 @@ static volatile uint32_t _long_cnt = 0;
 volatile uint32_t _high_cnt = 0;
 #endif
 
+#ifdef MODULE_XTIMER_STATS
+volatile uint32_t xtimer_isr_count = 0;
+#endif
+
 static xtimer_t *timer_list_head = NULL;
 static xtimer_t *overflow_list_head = NULL;
 static xtimer_t *long_list_head = NULL;
 
+/* time the low-level timer is set to for the current timer list */
+static uint32_t _wakeup;
+
 static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer);
 static void _add_timer_to_long_list(xtimer_t **list_head, xtimer_t *timer);
 static void _shoot(xtimer_t *timer);
@@ -47,6 +58,8 @@ static void _timer_callback(void);
 static void _periph_timer_callback(int chan);
 
 static inline int _this_high_period(uint32_t target);
+static inline uint32_t _deadline(xtimer_t *timer);
+static void _update_wakeup(void);
 
 static inline int _is_set(xtimer_t *timer)
 {
@@ -102,6 +115,7 @@ void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
         if (timer->target < offset) {
             timer->long_target++;
         }
+        timer->slack = 0;
 
         int state = disableIRQ();
         _add_timer_to_long_list(&long_list_head, timer);
@@ -113,7 +127,13 @@ void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
 
 void xtimer_set(xtimer_t *timer, uint32_t offset)
 {
-    DEBUG("timer_set(): offset=%" PRIu32 " now=%" PRIu32 " (%" PRIu32 ")\n", offset, xtimer_now(), _xtimer_now());
+    xtimer_set_slack(timer, offset, 0);
+}
+
+void xtimer_set_slack(xtimer_t *timer, uint32_t offset, uint32_t slack)
+{
+    DEBUG("timer_set(): offset=%" PRIu32 " slack=%" PRIu32 " now=%" PRIu32 " (%" PRIu32 ")\n",
+          offset, slack, xtimer_now(), _xtimer_now());
     if (!timer->callback) {
         DEBUG("timer_set(): timer has no callback.\n");
         return;
@@ -127,14 +147,23 @@ void xtimer_set(xtimer_t *timer, uint32_t offset)
     }
     else {
         uint32_t target = xtimer_now() + offset;
-        _xtimer_set_absolute(timer, target);
+        _xtimer_set_absolute(timer, target, slack);
     }
 }
 
 static void _periph_timer_callback(int chan)
 {
     (void)chan;
+#ifdef MODULE_SCHEDSTATISTICS
+    sched_isr_enter();
+#endif
+#ifdef MODULE_XTIMER_STATS
+    xtimer_isr_count++;
+#endif
     _timer_callback();
+#ifdef MODULE_SCHEDSTATISTICS
+    sched_isr_exit();
+#endif
 }
 
 static void _shoot(xtimer_t *timer)
@@ -157,7 +186,7 @@ static inline void _lltimer_set(uint32_t target)
     timer_set_absolute(XTIMER, XTIMER_CHAN, _mask(target));
 }
 
-int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
+int _xtimer_set_absolute(xtimer_t *timer, uint32_t target, uint32_t slack)
 {
     uint32_t now = xtimer_now();
     int res = 0;
@@ -173,6 +202,7 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
     }
 
     timer->target = target;
+    timer->slack = slack;
     timer->long_target = _long_cnt;
     if (target < now) {
         timer->long_target++;
@@ -192,9 +222,9 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
             DEBUG("timer_set_absolute(): timer will expire in this timer period.\n");
             _add_timer_to_list(&timer_list_head, timer);
 
-            if (timer_list_head == timer) {
-                DEBUG("timer_set_absolute(): timer is new list head. updating lltimer.\n");
-                _lltimer_set(target - XTIMER_OVERHEAD);
+            if ((timer_list_head == timer) || (_deadline(timer) < _wakeup)) {
+                DEBUG("timer_set_absolute(): timer is due before next wakeup. updating lltimer.\n");
+                _update_wakeup();
             }
         }
     }
@@ -248,16 +278,14 @@ int xtimer_remove(xtimer_t *timer)
     unsigned state = disableIRQ();
     int res = 0;
     if (timer_list_head == timer) {
-        uint32_t next;
         timer_list_head = timer->next;
         if (timer_list_head) {
-            /* schedule callback on next timer target time */
-            next = timer_list_head->target - XTIMER_OVERHEAD;
+            /* schedule callback on next wakeup time */
+            _update_wakeup();
         }
         else {
-            next = _mask(0xFFFFFFFF);
+            _lltimer_set(_mask(0xFFFFFFFF));
         }
-        _lltimer_set(next);
     }
     else {
         res = _remove_timer_from_list(&timer_list_head, timer) ||
@@ -298,6 +326,51 @@ static inline int _this_high_period(uint32_t target) {
 #endif
 }
 
+/**
+ * @brief latest time a timer may fire at
+ *
+ * Slack that would move the deadline into the next timer period is ignored.
+ */
+static inline uint32_t _deadline(xtimer_t *timer)
+{
+    uint32_t deadline = timer->target + timer->slack;
+
+    if ((deadline < timer->target) || !_this_high_period(deadline)) {
+        return timer->target;
+    }
+    return deadline;
+}
+
+/**
+ * @brief earliest deadline of all timers in the current timer list
+ *
+ * All timers with a target before that deadline fire in the same interrupt.
+ * The list is sorted by target, so only timers before the earliest deadline
+ * found so far can lower it.
+ */
+static uint32_t _next_deadline(void)
+{
+    uint32_t deadline = _deadline(timer_list_head);
+
+    for (xtimer_t *timer = timer_list_head->next;
+         timer && (timer->target < deadline); timer = timer->next) {
+        uint32_t next = _deadline(timer);
+        if (next < deadline) {
+            deadline = next;
+        }
+    }
+    return deadline;
+}
+
+/**
+ * @brief set the low-level timer to the next deadline of the current list
+ */
+static void _update_wakeup(void)
+{
+    _wakeup = _next_deadline();
+    _lltimer_set(_wakeup - XTIMER_OVERHEAD);
+}
+
 /**
  * @brief compare two timers' target values, return the one with lower value.
  *
@@ -480,8 +553,10 @@ overflow:
     }
 
     if (timer_list_head) {
-        /* schedule callback on next timer target time */
-        next_target = timer_list_head->target - XTIMER_OVERHEAD;
+        /* schedule callback on next deadline, timers due before that are
+         * fired along */
+        _wakeup = _next_deadline();
+        next_target = _wakeup - XTIMER_OVERHEAD;
 
         /* make sure we're not setting a time in the past */
         if (next_target < (_xtimer_now() + XTIMER_ISR_BACKOFF)) {
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Compares the throughput of the CBOR APIs
+ *
+ * Encodes and decodes the same sample with the cbor_stream_t API, the
+ * streaming writer and the pull parser, and a record both by hand and with
+ * the descriptor based struct serialization.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "cbor.h"
+#include "xtimer.h"
+
+#define BENCH_RUNS (1000)
+
+static unsigned char stream_data[128];
+static cbor_stream_t stream = {stream_data, sizeof(stream_data), 0};
+static unsigned char buffer[sizeof(stream_data)];
+
+typedef struct {
+    uint16_t seq;
+    int32_t temp;
+    bool alarm;
+    char name[8];
+    uint8_t addr[4];
+    uint64_t uptime;
+} record_t;
+
+static const cbor_field_t record_fields[] = {
+    CBOR_FIELD(record_t, seq, CBOR_FIELD_UINT),
+    CBOR_FIELD(record_t, temp, CBOR_FIELD_INT),
+    CBOR_FIELD(record_t, alarm, CBOR_FIELD_BOOL),
+    CBOR_FIELD(record_t, name, CBOR_FIELD_TEXT),
+    CBOR_FIELD(record_t, addr, CBOR_FIELD_BYTES),
+    CBOR_FIELD(record_t, uptime, CBOR_FIELD_UINT),
+};
+
+static const cbor_schema_t record_schema = CBOR_SCHEMA(record_fields);
+
+static const record_t record = { 1000, -25, true, "node", { 1, 2, 3, 4 }, 0x100000000llu };
+
+static void serialize_sample(cbor_stream_t *s)
+{
+    cbor_serialize_map(s, 3);
+    cbor_serialize_int(s, 1);
+    cbor_serialize_uint64_t(s, 0x100000000llu);
+    cbor_serialize_int(s, 2);
+    cbor_serialize_int64_t(s, -500);
+    cbor_serialize_int(s, 3);
+    cbor_serialize_array_indefinite(s);
+    cbor_serialize_bool(s, true);
+    cbor_serialize_byte_string(s, "abc");
+    cbor_serialize_unicode_string(s, "Hello, world!");
+    cbor_write_break(s);
+}
+
+static void serialize_record(cbor_stream_t *s, const record_t *r)
+{
+    cbor_serialize_map(s, 6);
+    cbor_serialize_unicode_string(s, "seq");
+    cbor_serialize_int(s, r->seq);
+    cbor_serialize_unicode_string(s, "temp");
+    cbor_serialize_int(s, r->temp);
+    cbor_serialize_unicode_string(s, "alarm");
+    cbor_serialize_bool(s, r->alarm);
+    cbor_serialize_unicode_string(s, "name");
+    cbor_serialize_unicode_string(s, r->name);
+    cbor_serialize_unicode_string(s, "addr");
+    cbor_serialize_byte_stringl(s, (const char *)r->addr, sizeof(r->addr));
+    cbor_serialize_unicode_string(s, "uptime");
+    cbor_serialize_uint64_t(s, r->uptime);
+}
+
+int main(void)
+{
+    cbor_writer_t writer;
+    cbor_reader_t reader;
+    cbor_item_t item;
+    uint32_t start, stream_ser, stream_des, writer_ser, reader_des;
+    uint32_t record_ser, struct_ser, struct_des;
+    uint64_t u64;
+    int64_t i64;
+    bool b;
+    char str[16];
+    size_t len, sample_size, bytes = 0;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        cbor_clear(&stream);
+        serialize_sample(&stream);
+    }
+    stream_ser = xtimer_now() - start;
+    sample_size = stream.pos;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        size_t offset = cbor_deserialize_map(&stream, 0, &len);
+        offset += cbor_deserialize_uint64_t(&stream, offset, &u64);
+        offset += cbor_deserialize_uint64_t(&stream, offset, &u64);
+        offset += cbor_deserialize_uint64_t(&stream, offset, &u64);
+        offset += cbor_deserialize_int64_t(&stream, offset, &i64);
+        offset += cbor_deserialize_uint64_t(&stream, offset, &u64);
+        offset += cbor_deserialize_array_indefinite(&stream, offset);
+        offset += cbor_deserialize_bool(&stream, offset, &b);
+        /* strings are copied out of the stream */
+        offset += cbor_deserialize_byte_string(&stream, offset, str, sizeof(str));
+        offset += cbor_deserialize_unicode_string(&stream, offset, str, sizeof(str));
+        bytes += offset + cbor_at_break(&stream, offset);
+    }
+    stream_des = xtimer_now() - start;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        cbor_writer_init(&writer, buffer, sizeof(buffer), NULL, NULL);
+        cbor_write_map(&writer, 3);
+        cbor_write_uint64_t(&writer, 1);
+        cbor_write_uint64_t(&writer, 0x100000000llu);
+        cbor_write_uint64_t(&writer, 2);
+        cbor_write_int64_t(&writer, -500);
+        cbor_write_uint64_t(&writer, 3);
+        cbor_write_array_indefinite(&writer);
+        cbor_write_bool(&writer, true);
+        cbor_write_byte_string(&writer, "abc", 3);
+        cbor_write_unicode_string(&writer, "Hello, world!", 13);
+        cbor_write_stream_break(&writer);
+    }
+    writer_ser = xtimer_now() - start;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        cbor_reader_init(&reader, buffer, cbor_writer_len(&writer));
+        while (cbor_read_next(&reader, &item)) {}
+        bytes += reader.pos;
+    }
+    reader_des = xtimer_now() - start;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        cbor_clear(&stream);
+        serialize_record(&stream, &record);
+    }
+    record_ser = xtimer_now() - start;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        cbor_clear(&stream);
+        cbor_serialize_struct(&stream, &record_schema, &record);
+    }
+    struct_ser = xtimer_now() - start;
+
+    start = xtimer_now();
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        record_t out;
+        bytes += cbor_deserialize_struct(&stream, 0, &record_schema, &out);
+    }
+    struct_des = xtimer_now() - start;
+
+    printf("\ncbor throughput (%u runs, %u bytes each):\n", BENCH_RUNS, (unsigned)sample_size);
+    printf("  stream serialize:   %" PRIu32 " us\n", stream_ser);
+    printf("  stream deserialize: %" PRIu32 " us\n", stream_des);
+    printf("  writer:             %" PRIu32 " us\n", writer_ser);
+    printf("  reader:             %" PRIu32 " us\n", reader_des);
+    printf("record (%u bytes):\n", (unsigned)stream.pos);
+    printf("  hand-written:       %" PRIu32 " us\n", record_ser);
+    printf("  struct serialize:   %" PRIu32 " us\n", struct_ser);
+    printf("  struct deserialize: %" PRIu32 " us\n", struct_des);
+    (void)bytes;
+
+    return 0;
+}
+
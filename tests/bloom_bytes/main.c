@@ -49,6 +49,51 @@ hashfp_t hashes[BLOOM_HASHF] = {
     (hashfp_t) rotating_hash, (hashfp_t) one_at_a_time_hash,
 };
 
+/* one counter per bit of the other filters: same false positive rate for
+ * four times the memory */
+static bloom_blocked_t bloom_blocked;
+BITFIELD(bf_blocked, BLOOM_BITS);
+static bloom_counting_t bloom_counting;
+static uint8_t counters[BLOOM_COUNTING_BYTES(BLOOM_BITS)];
+
+typedef void (*add_fn_t)(void *filter, const uint8_t *buf, size_t len);
+typedef bool (*check_fn_t)(void *filter, const uint8_t *buf, size_t len);
+
+static void add(void *filter, const uint8_t *buf, size_t len)
+{
+    bloom_add(filter, buf, len);
+}
+
+static bool check(void *filter, const uint8_t *buf, size_t len)
+{
+    return bloom_check(filter, buf, len);
+}
+
+static void add_blocked(void *filter, const uint8_t *buf, size_t len)
+{
+    bloom_blocked_add(filter, buf, len);
+}
+
+static bool check_blocked(void *filter, const uint8_t *buf, size_t len)
+{
+    return bloom_blocked_check(filter, buf, len);
+}
+
+static void add_counting(void *filter, const uint8_t *buf, size_t len)
+{
+    bloom_counting_add(filter, buf, len);
+}
+
+static bool check_counting(void *filter, const uint8_t *buf, size_t len)
+{
+    return bloom_counting_check(filter, buf, len);
+}
+
+static uint32_t ns_per_op(unsigned long us, int ops)
+{
+    return (uint32_t) (((uint64_t) us * 1000) / ops);
+}
+
 static void buf_fill(uint32_t *buf, int len)
 {
     for (int k = 0; k < len; k++) {
@@ -56,15 +101,9 @@ static void buf_fill(uint32_t *buf, int len)
     }
 }
 
-int main(void)
+static void run(const char *name, void *filter, add_fn_t add_fn, check_fn_t check_fn)
 {
-    xtimer_init();
-
-    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
-
-    printf("Testing Bloom filter.\n\n");
-    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) bloom.m,
-           (uint32_t) bloom.k);
+    printf("%s\n", name);
 
     genrand_init(myseed);
 
@@ -73,14 +112,12 @@ int main(void)
     for (int i = 0; i < lenB; i++) {
         buf_fill(buf, BUF_SIZE);
         buf[0] = MAGIC_B;
-        bloom_add(&bloom,
-                  (uint8_t *) buf,
-                  BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
+        add_fn(filter, (uint8_t *) buf, BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
     }
 
     unsigned long t2 = xtimer_now();
-    printf("adding %d elements took %" PRIu32 "ms\n", lenB,
-           (uint32_t) (t2 - t1) / 1000);
+    printf("adding %d elements took %" PRIu32 "ms (%" PRIu32 "ns/op)\n", lenB,
+           (uint32_t) (t2 - t1) / 1000, ns_per_op(t2 - t1, lenB));
 
     int in = 0;
     int not_in = 0;
@@ -91,9 +128,7 @@ int main(void)
         buf_fill(buf, BUF_SIZE);
         buf[0] = MAGIC_A;
 
-        if (bloom_check(&bloom,
-                        (uint8_t *) buf,
-                        BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))) {
+        if (check_fn(filter, (uint8_t *) buf, BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))) {
             in++;
         }
         else {
@@ -102,16 +137,52 @@ int main(void)
     }
 
     unsigned long t4 = xtimer_now();
-    printf("checking %d elements took %" PRIu32 "ms\n", lenA,
-           (uint32_t) (t4 - t3) / 1000);
+    printf("checking %d elements took %" PRIu32 "ms (%" PRIu32 "ns/op)\n", lenA,
+           (uint32_t) (t4 - t3) / 1000, ns_per_op(t4 - t3, lenA));
 
     printf("\n");
     printf("%d elements probably in the filter.\n", in);
     printf("%d elements not in the filter.\n", not_in);
     double false_positive_rate = (double) in / (double) lenA;
-    printf("%f false positive rate.\n", false_positive_rate);
+    printf("%f false positive rate.\n\n", false_positive_rate);
+}
+
+/* the time for generating the elements is included above, measure it alone */
+static void run_baseline(void)
+{
+    genrand_init(myseed);
+
+    unsigned long t1 = xtimer_now();
+
+    for (int i = 0; i < lenA; i++) {
+        buf_fill(buf, BUF_SIZE);
+    }
+
+    unsigned long t2 = xtimer_now();
+    printf("generating %d elements took %" PRIu32 "ms (%" PRIu32 "ns/op)\n\n", lenA,
+           (uint32_t) (t2 - t1) / 1000, ns_per_op(t2 - t1, lenA));
+}
+
+int main(void)
+{
+    xtimer_init();
+
+    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
+    bloom_blocked_init(&bloom_blocked, BLOOM_BITS, bf_blocked, fnv1a_64_hash, BLOOM_HASHF);
+    bloom_counting_init(&bloom_counting, BLOOM_BITS, counters, fnv1a_64_hash, BLOOM_HASHF);
+
+    printf("Testing Bloom filter.\n\n");
+    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) bloom.m,
+           (uint32_t) bloom.k);
+
+    run_baseline();
+    run("bloom_t", &bloom, add, check);
+    run("bloom_blocked_t", &bloom_blocked, add_blocked, check_blocked);
+    run("bloom_counting_t", &bloom_counting, add_counting, check_counting);
 
     bloom_del(&bloom);
+    bloom_blocked_del(&bloom_blocked);
+    bloom_counting_del(&bloom_counting);
     printf("\nAll done!\n");
     return 0;
 }
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief test future, promise, packaged_task and async replacement header
+ *
+ * @}
+ */
+
+#include <cstdio>
+#include <cassert>
+#include <stdexcept>
+
+#include "riot/chrono.hpp"
+#include "riot/future.hpp"
+#include "riot/thread.hpp"
+#include "riot/thread_pool.hpp"
+
+using namespace std;
+using namespace riot;
+
+int main() {
+  puts("\n************ C++ future test ***********");
+
+  assert(sched_num_threads == 2); // main + idle
+
+  puts("Promise set by another thread ...");
+  {
+    promise<int> p;
+    auto f = p.get_future();
+    thread t([&p] { p.set_value(42); });
+    assert(f.get() == 42);
+    assert(!f.valid());
+    t.join();
+  }
+  puts("Done\n");
+
+  puts("Retrieving a future twice ...");
+  {
+    promise<void> p;
+    auto f = p.get_future();
+    try {
+      auto g = p.get_future();
+      assert(false);
+    }
+    catch (const future_error& e) {
+      assert(e.code() == future_errc::future_already_retrieved);
+    }
+    p.set_value();
+    f.get();
+  }
+  puts("Done\n");
+
+  puts("Broken promise ...");
+  {
+    future<int> f;
+    {
+      promise<int> p;
+      f = p.get_future();
+    }
+    try {
+      f.get();
+      assert(false);
+    }
+    catch (const future_error& e) {
+      assert(e.code() == future_errc::broken_promise);
+    }
+  }
+  puts("Done\n");
+
+  puts("Waiting with timeout ...");
+  {
+    promise<int> p;
+    auto f = p.get_future();
+    assert(f.wait_for(chrono::milliseconds(10)) == future_status::timeout);
+    p.set_value(1);
+    assert(f.wait_for(chrono::milliseconds(10)) == future_status::ready);
+    assert(f.get() == 1);
+  }
+  puts("Done\n");
+
+  puts("Packaged task ...");
+  {
+    packaged_task<int(int, int)> task([](int a, int b) { return a * b; });
+    auto f = task.get_future();
+    thread t(move(task), 6, 7);
+    assert(f.get() == 42);
+    t.join();
+  }
+  puts("Done\n");
+
+  puts("Exception in async ...");
+  {
+    auto f = async([]() -> int { throw std::runtime_error("fail"); });
+    try {
+      f.get();
+      assert(false);
+    }
+    catch (const std::runtime_error&) {
+      // expected
+    }
+  }
+  puts("Done\n");
+
+  puts("Deferred async ...");
+  {
+    bool ran = false;
+    auto f = async(launch::deferred, [&ran](int i) {
+      ran = true;
+      return i + 1;
+    }, 1);
+    assert(f.wait_for(chrono::milliseconds(1)) == future_status::deferred);
+    assert(!ran);
+    assert(f.get() == 2);
+    assert(ran);
+  }
+  puts("Done\n");
+
+  puts("Async on a thread pool ...");
+  {
+    thread_pool pool(2, thread_attributes{}
+                          .stack_size(THREAD_STACKSIZE_DEFAULT));
+    future<unsigned> results[4];
+    for (unsigned i = 0; i < 4; ++i) {
+      results[i] = async(pool, [](unsigned j) { return j * j; }, i);
+    }
+    unsigned sum = 0;
+    for (auto& f : results) {
+      sum += f.get();
+    }
+    assert(sum == 0 + 1 + 4 + 9);
+  }
+  puts("Done\n");
+
+  // give the detached async threads the chance to end
+  this_thread::sleep_for(chrono::milliseconds(10));
+  assert(sched_num_threads == 2);
+
+  puts("Bye, bye.");
+  puts("******************************************");
+
+  return 0;
+}
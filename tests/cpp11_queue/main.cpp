@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2016 Hamburg University of Applied Sciences (HAW)
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief test spsc_queue and mpsc_queue
+ *
+ * @}
+ */
+
+#include <memory>
+#include <cstdio>
+#include <cassert>
+
+#include "xtimer.h"
+
+#include "riot/thread.hpp"
+#include "riot/spsc_queue.hpp"
+#include "riot/mpsc_queue.hpp"
+
+using namespace std;
+using namespace riot;
+
+namespace {
+
+constexpr unsigned rounds = 100;
+constexpr uint32_t isr_interval = 1000;
+
+struct record {
+  uint32_t seq;
+  uint32_t value;
+};
+
+spsc_queue<record, 8> isr_queue;
+volatile uint32_t isr_seq;
+xtimer_t isr_timer;
+
+void isr_producer(void*) {
+  record r{isr_seq, isr_seq * 3};
+  if (isr_queue.try_push(r)) {
+    ++isr_seq;
+  }
+  if (isr_seq < rounds) {
+    xtimer_set(&isr_timer, isr_interval);
+  }
+}
+
+} // namespace <anonymous>
+
+int main() {
+  puts("\n************ C++ queue test ***********");
+
+  puts("Move-only elements and batches ...");
+  {
+    spsc_queue<unique_ptr<int>, 4> q;
+    assert(q.empty());
+    for (int i = 0; i < 4; ++i) {
+      assert(q.try_push(unique_ptr<int>(new int(i))));
+    }
+    assert(q.full());
+    assert(!q.try_emplace(new int(4)));
+    unique_ptr<int> out[4];
+    assert(q.try_pop(out, 3) == 3);
+    assert(*out[0] == 0 && *out[2] == 2);
+    assert(q.try_push(out, out + 3) == 3);
+    assert(q.size() == 4);
+    assert(q.try_pop(out[3]));
+    assert(*out[3] == 3);
+  }
+  puts("Done\n");
+
+  puts("Records from an interrupt ...");
+  {
+    isr_seq = 0;
+    isr_timer.callback = isr_producer;
+    isr_timer.arg = nullptr;
+    xtimer_set(&isr_timer, isr_interval);
+    for (uint32_t i = 0; i < rounds; ++i) {
+      record r;
+      isr_queue.pop(r);
+      assert(r.seq == i && r.value == i * 3);
+    }
+  }
+  puts("Done\n");
+
+  puts("Multiple producers ...");
+  {
+    mpsc_queue<unsigned, 4> q;
+    constexpr unsigned per_thread = 50;
+    auto producer = [&q](unsigned base) {
+      for (unsigned i = 0; i < per_thread; ++i) {
+        q.push(base + i);
+      }
+    };
+    auto attr = thread_attributes{}.priority(THREAD_PRIORITY_MAIN + 1);
+    thread t1(attr, producer, 0);
+    thread t2(attr, producer, 1000);
+    unsigned next[2] = { 0, 1000 };
+    unsigned batch[3];
+    for (unsigned received = 0; received < 2 * per_thread;) {
+      size_t n = q.pop(batch, 3);
+      for (size_t i = 0; i < n; ++i) {
+        // every producer's elements arrive in order
+        unsigned& expected = next[batch[i] >= 1000];
+        assert(batch[i] == expected);
+        ++expected;
+      }
+      received += n;
+    }
+    t1.join();
+    t2.join();
+    assert(q.empty());
+  }
+  puts("Done\n");
+
+  puts("Bye, bye.");
+  puts("******************************************");
+
+  return 0;
+}
@@ -26,6 +26,7 @@
 #include "riot/mutex.hpp"
 #include "riot/chrono.hpp"
 #include "riot/thread.hpp"
+#include "riot/thread_pool.hpp"
 #include "riot/condition_variable.hpp"
 
 using namespace std;
@@ -179,6 +180,59 @@ int main() {
 
   assert(sched_num_threads == 2);
 
+  puts("Thread attributes ...");
+  {
+    auto attr = thread_attributes{}
+                  .stack_size(THREAD_STACKSIZE_DEFAULT)
+                  .priority(THREAD_PRIORITY_MAIN - 2)
+                  .name("attr_thread");
+    thread t(attr, [] {
+      tcb_t* me = (tcb_t*)sched_active_thread;
+      assert(me->priority == THREAD_PRIORITY_MAIN - 2);
+      assert(string(me->name) == "attr_thread");
+    });
+    t.join();
+  }
+  puts("Done\n");
+
+  assert(sched_num_threads == 2);
+
+  puts("Reusing the stack of a joined thread ...");
+  {
+    char* first = nullptr;
+    char* second = nullptr;
+    thread t1([&first] { first = ((tcb_t*)sched_active_thread)->stack_start; });
+    t1.join();
+    thread t2([&second] {
+      second = ((tcb_t*)sched_active_thread)->stack_start;
+    });
+    t2.join();
+    assert(first != nullptr && first == second);
+  }
+  puts("Done\n");
+
+  assert(sched_num_threads == 2);
+
+  puts("Thread pool ...");
+  {
+    mutex m;
+    unsigned sum = 0;
+    thread_pool pool(2, thread_attributes{}
+                          .stack_size(THREAD_STACKSIZE_DEFAULT));
+    assert(pool.size() == 2);
+    for (unsigned i = 1; i <= 10; ++i) {
+      pool.submit([&m, &sum](unsigned j) {
+        lock_guard<mutex> lk(m);
+        sum += j;
+      }, i);
+    }
+    pool.wait();
+    assert(sum == 55);
+  }
+  puts("Done\n");
+
+  assert(sched_num_threads == 2);
+
   puts("Bye, bye.");
   puts("******************************************");
 
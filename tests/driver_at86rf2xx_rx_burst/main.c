@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       SPI usage of the at86rf2xx driver for received frames
+ *
+ * Runs the at86rf2xx driver against a model of the radio on the simulated
+ * SPI bus of native. Frames are put into the model's frame buffer and the
+ * driver's interrupt handler uploads them. The test checks that every frame
+ * is read in a single frame buffer access and passed up intact, and prints
+ * the SPI transactions, bytes and bus time per received frame. Build with
+ * RX_BUF=1 to measure the at86rf2xx_rx_buf variant.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "at86rf2xx.h"
+#include "at86rf2xx_registers.h"
+#include "native_bus.h"
+#include "net/gnrc.h"
+#include "net/ieee802154.h"
+
+#define ATRF_SPI        (SPI_0)
+#define ATRF_CS         (0)
+#define ATRF_INT        (1)
+#define ATRF_SLEEP      (2)
+#define ATRF_RESET      (3)
+
+#define FRAMES          (100U)
+#define MHR_LEN         (15U)   /* FCF, seq, dst PAN, short dst, long src */
+#define LQI             (0xa5)
+#define ED              (0x3c)
+
+/* radio model: register file and frame buffer behind the command byte */
+typedef struct {
+    native_spi_dev_t dev;
+    uint8_t regs[0x40];
+    uint8_t fb[1 + AT86RF2XX_MAX_PKT_LENGTH + AT86RF2XX_RX_TRAILER_LEN];
+    uint8_t cmd;
+    unsigned pos;
+    unsigned fb_reads;
+} atrf_model_t;
+
+static atrf_model_t model;
+static at86rf2xx_t dev;
+
+static unsigned received;
+static unsigned corrupt;
+static const uint8_t *expected;
+static size_t expected_len;
+
+static void _reg_write(uint8_t addr, uint8_t value)
+{
+    if (addr == AT86RF2XX_REG__TRX_STATE) {
+        uint8_t state = value & AT86RF2XX_TRX_STATUS_MASK__TRX_STATUS;
+
+        switch (state) {
+            case AT86RF2XX_TRX_STATE__NOP:
+            case AT86RF2XX_TRX_STATE__TX_START:
+                return;
+            case AT86RF2XX_TRX_STATE__FORCE_TRX_OFF:
+                state = AT86RF2XX_STATE_TRX_OFF;
+                break;
+            case AT86RF2XX_TRX_STATE__FORCE_PLL_ON:
+                state = AT86RF2XX_STATE_PLL_ON;
+                break;
+            default:
+                break;
+        }
+        /* state transitions complete immediately */
+        model.regs[AT86RF2XX_REG__TRX_STATUS] = state;
+    }
+    model.regs[addr] = value;
+}
+
+static void _select(native_spi_dev_t *spi_dev)
+{
+    (void)spi_dev;
+    model.pos = 0;
+}
+
+static uint8_t _transfer(native_spi_dev_t *spi_dev, uint8_t mosi)
+{
+    unsigned pos = model.pos++;
+
+    (void)spi_dev;
+    if (pos == 0) {
+        model.cmd = mosi;
+        if (mosi == (AT86RF2XX_ACCESS_FB | AT86RF2XX_ACCESS_READ)) {
+            model.fb_reads++;
+        }
+        /* PHY_STATUS */
+        return model.regs[AT86RF2XX_REG__TRX_STATUS];
+    }
+    if (model.cmd & AT86RF2XX_ACCESS_REG) {
+        uint8_t addr = model.cmd & 0x3f;
+        uint8_t value = model.regs[addr];
+
+        if (pos > 1) {
+            return 0;
+        }
+        if (model.cmd & AT86RF2XX_ACCESS_WRITE) {
+            _reg_write(addr, mosi);
+        }
+        else if (addr == AT86RF2XX_REG__IRQ_STATUS) {
+            /* reading the interrupt status clears it */
+            model.regs[addr] = 0;
+        }
+        return value;
+    }
+    if ((model.cmd & 0xe0) == AT86RF2XX_ACCESS_FB) {
+        /* frame buffer writes are not modelled */
+        if ((model.cmd & AT86RF2XX_ACCESS_WRITE) || ((pos - 1) >= sizeof(model.fb))) {
+            return 0;
+        }
+        return model.fb[pos - 1];
+    }
+    /* SRAM access, the second byte is the address */
+    if (pos == 1) {
+        model.cmd = (model.cmd & AT86RF2XX_ACCESS_WRITE) | mosi;
+        return 0;
+    }
+    if (!(model.cmd & AT86RF2XX_ACCESS_WRITE) &&
+        ((model.cmd & 0x3f) + (pos - 2) < sizeof(model.fb))) {
+        return model.fb[(model.cmd & 0x3f) + (pos - 2)];
+    }
+    return 0;
+}
+
+static void _event_cb(gnrc_netdev_event_t type, void *arg)
+{
+    gnrc_pktsnip_t *pkt = (gnrc_pktsnip_t *)arg;
+
+    if (type != NETDEV_EVENT_RX_COMPLETE) {
+        return;
+    }
+    received++;
+    if ((pkt->size != expected_len) || memcmp(pkt->data, expected, expected_len) ||
+        (pkt->next == NULL) || (pkt->next->type != GNRC_NETTYPE_NETIF) ||
+        (((gnrc_netif_hdr_t *)pkt->next->data)->lqi != LQI)) {
+        corrupt++;
+    }
+    gnrc_pktbuf_release(pkt);
+}
+
+static int _run(uint8_t phr)
+{
+    uint8_t *psdu = &model.fb[1];
+    size_t payload_len = phr - MHR_LEN - IEEE802154_FCS_LEN;
+    const native_bus_stats_t *stats = native_spi_stats(ATRF_SPI);
+
+    /* data frame, PAN ID compression, short destination, long source */
+    memset(model.fb, 0, sizeof(model.fb));
+    model.fb[0] = phr;
+    psdu[0] = IEEE802154_FCF_TYPE_DATA | IEEE802154_FCF_PAN_COMP;
+    psdu[1] = IEEE802154_FCF_DST_ADDR_SHORT | IEEE802154_FCF_SRC_ADDR_LONG;
+    psdu[3] = 0x23;
+    psdu[4] = 0x00;
+    psdu[5] = 0xff;
+    psdu[6] = 0xff;
+    for (unsigned i = 0; i < payload_len; i++) {
+        psdu[MHR_LEN + i] = (uint8_t)i;
+    }
+    psdu[phr] = LQI;
+    psdu[phr + 1] = ED;
+    expected = &psdu[MHR_LEN];
+    expected_len = payload_len;
+
+    received = 0;
+    corrupt = 0;
+    model.fb_reads = 0;
+    native_spi_stats_reset(ATRF_SPI);
+
+    for (unsigned i = 0; i < FRAMES; i++) {
+        psdu[2] = (uint8_t)i;
+        model.regs[AT86RF2XX_REG__IRQ_STATUS] = AT86RF2XX_IRQ_STATUS_MASK__TRX_END;
+        dev.driver->isr_event((gnrc_netdev_t *)&dev, 0);
+    }
+
+    printf("PHR %3u: %u.%02u transactions, %3u bytes, %3u us bus time per frame\n",
+           (unsigned)phr, (unsigned)(stats->transactions / FRAMES),
+           (unsigned)((stats->transactions * 100 / FRAMES) % 100),
+           (unsigned)(stats->bytes / FRAMES),
+           (unsigned)(stats->bus_time / FRAMES / 1000));
+
+    if ((received != FRAMES) || corrupt) {
+        printf("received %u of %u frames, %u corrupt\n", received, FRAMES,
+               corrupt);
+        return -1;
+    }
+    if (model.fb_reads != FRAMES) {
+        printf("%u frame buffer accesses for %u frames\n", model.fb_reads,
+               FRAMES);
+        return -1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int res = 0;
+
+    puts("at86rf2xx RX burst test");
+#ifdef MODULE_AT86RF2XX_RX_BUF
+    puts("frames are uploaded to the driver's RX buffer first");
+#endif
+
+    model.regs[AT86RF2XX_REG__PART_NUM] = AT86RF2XX_PARTNUM;
+    model.regs[AT86RF2XX_REG__TRX_STATUS] = AT86RF2XX_STATE_TRX_OFF;
+    model.dev.cs = ATRF_CS;
+    model.dev.select = _select;
+    model.dev.transfer = _transfer;
+    native_spi_attach(ATRF_SPI, &model.dev);
+
+    if (at86rf2xx_init(&dev, ATRF_SPI, SPI_SPEED_5MHZ, ATRF_CS, ATRF_INT,
+                       ATRF_SLEEP, ATRF_RESET) < 0) {
+        puts("[FAILED] at86rf2xx_init");
+        return 1;
+    }
+    dev.driver->add_event_callback((gnrc_netdev_t *)&dev, _event_cb);
+
+    res |= _run(MHR_LEN + IEEE802154_FCS_LEN + 43);
+    res |= _run(AT86RF2XX_MAX_PKT_LENGTH);
+
+    if (res < 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
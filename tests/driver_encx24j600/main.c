@@ -0,0 +1,495 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Test application for the ENCx24J600 Ethernet driver
+ *
+ * Runs the encx24j600 driver against a model of the device on the simulated
+ * SPI bus of native. Batches of packets are put into the model's receive
+ * ring and read by the driver's interrupt handler, frames are sent back to
+ * back through both halves of the transmit buffer. The test checks the data
+ * of every packet, that the packet counter is read and decremented once per
+ * batch, that no frame is overwritten while it is sent and that the
+ * NETOPT_STATS counters match, and prints the SPI usage per packet.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "encx24j600.h"
+#include "encx24j600_defines.h"
+#include "native_bus.h"
+#include "net/netdev2.h"
+#include "net/netstats.h"
+
+#define ENC_SPI         (SPI_0)
+#define ENC_CS          (0)
+#define ENC_INT         (1)
+
+#define SRAM_SIZE       (0x6000)
+#define RX_HDR_LEN      (8U)        /* next packet pointer, status vector */
+#define RX_CRC_LEN      (4U)
+#define RX_BATCHES      (8U)
+#define RX_BATCH        (4U)
+#define RX_DROP_EVERY   (7U)        /* every 7th packet is not read */
+#define TX_FRAMES       (20U)
+#define ETH_HDR_LEN     (14U)
+#define FRAME_MAX       (1518U)
+
+/* device model: control registers and SRAM behind the SPI opcodes */
+typedef struct {
+    native_spi_dev_t dev;
+    uint8_t regs[0x100];
+    uint8_t sram[SRAM_SIZE];
+    uint8_t op;
+    uint8_t addr;
+    unsigned pos;
+    uint8_t pktcnt;
+    uint16_t rx_wr;                 /* where the next packet is received */
+    unsigned estat_reads;
+    unsigned pktdecs;
+    unsigned pktdec_underflows;
+    unsigned reads_after_pktdec;
+    unsigned tx_started;
+    uint16_t tx_last_start;
+    unsigned tx_same_slot;
+    unsigned tx_busy_bytes;         /* bytes uploaded during a transmission */
+    unsigned tx_clobbered;          /* bytes written into the frame in TX */
+} enc_model_t;
+
+static enc_model_t model;
+static encx24j600_t dev;
+
+static uint8_t buf[FRAME_MAX];
+static uint8_t frame[FRAME_MAX];
+
+static unsigned rx_next;
+static unsigned rx_corrupt;
+static uint32_t rx_count;
+static uint32_t rx_bytes;
+
+static unsigned tx_sent;
+static unsigned tx_corrupt;
+
+static uint16_t _reg(uint8_t addr)
+{
+    return model.regs[addr] | (model.regs[addr + 1] << 8);
+}
+
+static void _reg_put(uint8_t addr, uint16_t value)
+{
+    model.regs[addr] = value & 0xff;
+    model.regs[addr + 1] = value >> 8;
+}
+
+static size_t _rx_len(unsigned i)
+{
+    return 60 + ((i * 97) % 400);
+}
+
+static size_t _tx_frame(unsigned i, uint8_t *data)
+{
+    static const uint8_t mcast[] = { 0x33, 0x33, 0x00, 0x00, 0x00, 0x01 };
+    static const uint8_t ucast[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+    size_t len = ETH_HDR_LEN + 40 + ((i * 53) % 600);
+
+    memcpy(data, (i % 3) ? ucast : mcast, 6);
+    memset(&data[6], 0x02, 6);
+    data[12] = 0x86;
+    data[13] = 0xdd;
+    for (size_t j = ETH_HDR_LEN; j < len; j++) {
+        data[j] = (uint8_t)(i * 7 + j);
+    }
+    return len;
+}
+
+static void _tx_complete(void)
+{
+    uint16_t start = _reg(ETXST);
+    uint16_t len = _reg(ETXLEN);
+
+    /* the frame is taken from SRAM once it is completely sent */
+    if ((len != _tx_frame(tx_sent, frame)) ||
+        memcmp(&model.sram[start], frame, len)) {
+        tx_corrupt++;
+    }
+    tx_sent++;
+    model.regs[ECON1] &= ~TXRTS;
+}
+
+static uint8_t _reg_read(uint8_t addr)
+{
+    uint8_t value = model.regs[addr];
+
+    switch (addr) {
+        case ESTAT:
+            model.estat_reads++;
+            return model.pktcnt;
+        case ESTAT + 1:
+            return (CLKRDY | PHYLNK) >> 8;
+        case EIR:
+            return model.pktcnt ? PKTIF : 0;
+        case ECON1:
+            /* a frame is sent while the driver polls for the first time */
+            if (value & TXRTS) {
+                _tx_complete();
+            }
+            return value;
+        default:
+            return value;
+    }
+}
+
+static void _opcode(uint8_t op)
+{
+    uint16_t start;
+
+    switch (op) {
+        case SETETHRST:
+            memset(model.regs, 0, sizeof(model.regs));
+            model.pktcnt = 0;
+            break;
+        case SETPKTDEC:
+            if (model.pktcnt == 0) {
+                model.pktdec_underflows++;
+            }
+            else {
+                model.pktcnt--;
+            }
+            model.pktdecs++;
+            break;
+        case SETTXRTS:
+            start = _reg(ETXST);
+            if (model.tx_started && (start == model.tx_last_start)) {
+                model.tx_same_slot++;
+            }
+            model.tx_last_start = start;
+            model.tx_started++;
+            model.regs[ECON1] |= TXRTS;
+            break;
+        case RRXDATA:
+            if (model.pktdecs) {
+                model.reads_after_pktdec++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static uint8_t _sram_read(void)
+{
+    uint16_t ptr = _reg(ERXRDPT);
+    uint8_t value = model.sram[ptr++];
+
+    /* reads wrap around inside the receive ring */
+    if (ptr == SRAM_SIZE) {
+        ptr = _reg(ERXST);
+    }
+    _reg_put(ERXRDPT, ptr);
+    return value;
+}
+
+static void _sram_write(uint8_t value)
+{
+    uint16_t ptr = _reg(EGPWRPT);
+
+    if (model.regs[ECON1] & TXRTS) {
+        model.tx_busy_bytes++;
+        if ((ptr >= _reg(ETXST)) && (ptr < _reg(ETXST) + _reg(ETXLEN))) {
+            model.tx_clobbered++;
+        }
+    }
+    model.sram[ptr % SRAM_SIZE] = value;
+    _reg_put(EGPWRPT, ptr + 1);
+}
+
+static void _select(native_spi_dev_t *spi_dev)
+{
+    (void)spi_dev;
+    model.pos = 0;
+}
+
+static uint8_t _transfer(native_spi_dev_t *spi_dev, uint8_t mosi)
+{
+    unsigned pos = model.pos++;
+    uint8_t addr;
+
+    (void)spi_dev;
+    if (pos == 0) {
+        model.op = mosi;
+        _opcode(mosi);
+        return 0;
+    }
+    switch (model.op) {
+        case RRXDATA:
+            return _sram_read();
+        case WGPDATA:
+            _sram_write(mosi);
+            return 0;
+        case RCRU:
+        case WCRU:
+        case BFSU:
+        case BFCU:
+            break;
+        default:
+            return 0;
+    }
+    /* unbanked register access, the second byte is the address */
+    if (pos == 1) {
+        model.addr = mosi;
+        return 0;
+    }
+    addr = model.addr + (pos - 2);
+    switch (model.op) {
+        case RCRU:
+            return _reg_read(addr);
+        case WCRU:
+            model.regs[addr] = mosi;
+            break;
+        case BFSU:
+            model.regs[addr] |= mosi;
+            break;
+        default:
+            model.regs[addr] &= ~mosi;
+            break;
+    }
+    return 0;
+}
+
+static void _sram_put(uint16_t *ptr, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        model.sram[(*ptr)++] = data[i];
+        if (*ptr == SRAM_SIZE) {
+            *ptr = _reg(ERXST);
+        }
+    }
+}
+
+static void _rx_put(unsigned first, unsigned num)
+{
+    for (unsigned i = first; i < first + num; i++) {
+        uint8_t hdr[RX_HDR_LEN] = { 0 };
+        uint16_t frame_len = _rx_len(i) + RX_CRC_LEN;
+        uint32_t next = model.rx_wr + RX_HDR_LEN + frame_len;
+        uint16_t ptr = model.rx_wr;
+
+        /* packets start at even addresses */
+        next = (next + 1) & ~1;
+        if (next >= SRAM_SIZE) {
+            next = next - SRAM_SIZE + _reg(ERXST);
+        }
+        hdr[0] = next & 0xff;
+        hdr[1] = next >> 8;
+        hdr[2] = frame_len & 0xff;
+        hdr[3] = frame_len >> 8;
+        for (unsigned j = 0; j < frame_len; j++) {
+            frame[j] = (uint8_t)(i + j);
+        }
+        _sram_put(&ptr, hdr, sizeof(hdr));
+        _sram_put(&ptr, frame, frame_len);
+        model.rx_wr = next;
+    }
+    model.pktcnt += num;
+}
+
+static void _event_cb(netdev2_t *netdev, netdev2_event_t event, void *arg)
+{
+    unsigned i;
+    int len;
+
+    (void)arg;
+    if (event != NETDEV2_EVENT_RX_COMPLETE) {
+        return;
+    }
+    i = rx_next++;
+    /* leave some packets to the driver to drop */
+    if ((i % RX_DROP_EVERY) == (RX_DROP_EVERY - 1)) {
+        return;
+    }
+    len = netdev->driver->recv(netdev, NULL, 0);
+    if ((len != (int)_rx_len(i)) ||
+        (netdev->driver->recv(netdev, (char *)buf, sizeof(buf)) != len)) {
+        rx_corrupt++;
+        return;
+    }
+    for (int j = 0; j < len; j++) {
+        if (buf[j] != (uint8_t)(i + j)) {
+            rx_corrupt++;
+            return;
+        }
+    }
+    rx_count++;
+    rx_bytes += len;
+}
+
+static int _test_rx(void)
+{
+    const native_bus_stats_t *stats = native_spi_stats(ENC_SPI);
+    netdev2_t *netdev = (netdev2_t *)&dev;
+    int res = 0;
+
+    native_spi_stats_reset(ENC_SPI);
+    model.rx_wr = _reg(ERXST);
+    for (unsigned b = 0; b < RX_BATCHES; b++) {
+        uint16_t tail;
+
+        _rx_put(b * RX_BATCH, RX_BATCH);
+        model.estat_reads = 0;
+        model.pktdecs = 0;
+        model.reads_after_pktdec = 0;
+        netdev->driver->isr(netdev);
+
+        tail = (model.rx_wr == _reg(ERXST)) ? SRAM_SIZE - 2 : model.rx_wr - 2;
+        if (model.pktcnt || (_reg(ERXTAIL) != tail)) {
+            printf("batch %u: %u packets left, ERXTAIL 0x%04x\n", b,
+                   (unsigned)model.pktcnt, (unsigned)_reg(ERXTAIL));
+            res = -1;
+        }
+        /* the counter is read for the batch and once more to find it empty */
+        if ((model.estat_reads != 2) || (model.pktdecs != RX_BATCH) ||
+            model.reads_after_pktdec) {
+            printf("batch %u: PKTCNT read %u times, decremented %u times, "
+                   "%u reads after the first decrement\n", b,
+                   model.estat_reads, model.pktdecs, model.reads_after_pktdec);
+            res = -1;
+        }
+    }
+
+    printf("RX: %u.%02u transactions, %u bytes, %u us bus time per packet\n",
+           (unsigned)(stats->transactions / rx_next),
+           (unsigned)((stats->transactions * 100 / rx_next) % 100),
+           (unsigned)(stats->bytes / rx_next),
+           (unsigned)(stats->bus_time / rx_next / 1000));
+
+    if ((rx_next != RX_BATCHES * RX_BATCH) || rx_corrupt ||
+        model.pktdec_underflows) {
+        printf("%u of %u packets signaled, %u corrupt, %u decrements too many\n",
+               rx_next, RX_BATCHES * RX_BATCH, rx_corrupt,
+               model.pktdec_underflows);
+        res = -1;
+    }
+    return res;
+}
+
+static int _test_tx(netstats_t *expected)
+{
+    const native_bus_stats_t *stats = native_spi_stats(ENC_SPI);
+    netdev2_t *netdev = (netdev2_t *)&dev;
+    int res = 0;
+
+    native_spi_stats_reset(ENC_SPI);
+    for (unsigned i = 0; i < TX_FRAMES; i++) {
+        struct iovec vector[2];
+        size_t len = _tx_frame(i, buf);
+
+        vector[0].iov_base = buf;
+        vector[0].iov_len = ETH_HDR_LEN;
+        vector[1].iov_base = &buf[ETH_HDR_LEN];
+        vector[1].iov_len = len - ETH_HDR_LEN;
+        if (netdev->driver->send(netdev, vector, 2) != (int)len) {
+            printf("sending frame %u failed\n", i);
+            res = -1;
+        }
+        if (buf[0] & 0x01) {
+            expected->tx_mcast_count++;
+        }
+        else {
+            expected->tx_unicast_count++;
+        }
+        expected->tx_bytes += len;
+    }
+    if (model.regs[ECON1] & TXRTS) {
+        _tx_complete();
+    }
+
+    printf("TX: %u.%02u transactions, %u bytes, %u us bus time per frame\n",
+           (unsigned)(stats->transactions / TX_FRAMES),
+           (unsigned)((stats->transactions * 100 / TX_FRAMES) % 100),
+           (unsigned)(stats->bytes / TX_FRAMES),
+           (unsigned)(stats->bus_time / TX_FRAMES / 1000));
+
+    if ((tx_sent != TX_FRAMES) || tx_corrupt) {
+        printf("%u of %u frames sent, %u corrupt\n", tx_sent, TX_FRAMES,
+               tx_corrupt);
+        res = -1;
+    }
+    /* frames are uploaded to one half of the buffer while the other half
+     * is sent */
+    if (model.tx_same_slot || model.tx_clobbered || !model.tx_busy_bytes) {
+        printf("%u frames from the previous slot, %u bytes overwritten "
+               "during TX, %u bytes uploaded during TX\n", model.tx_same_slot,
+               model.tx_clobbered, model.tx_busy_bytes);
+        res = -1;
+    }
+    return res;
+}
+
+static int _test_stats(const netstats_t *expected)
+{
+    netdev2_t *netdev = (netdev2_t *)&dev;
+    netstats_t stats;
+
+    if (netdev->driver->get(netdev, NETOPT_STATS, &stats,
+                            sizeof(stats)) != sizeof(stats)) {
+        puts("NETOPT_STATS not supported");
+        return -1;
+    }
+    printf("stats: TX %u unicast, %u multicast, %u bytes, "
+           "RX %u packets, %u bytes\n", (unsigned)stats.tx_unicast_count,
+           (unsigned)stats.tx_mcast_count, (unsigned)stats.tx_bytes,
+           (unsigned)stats.rx_count, (unsigned)stats.rx_bytes);
+    if (memcmp(&stats, expected, sizeof(stats))) {
+        puts("stats do not match the traffic");
+        return -1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    netdev2_t *netdev = (netdev2_t *)&dev;
+    netstats_t expected;
+    int res = 0;
+
+    puts("encx24j600 driver test");
+
+    model.dev.cs = ENC_CS;
+    model.dev.select = _select;
+    model.dev.transfer = _transfer;
+    native_spi_attach(ENC_SPI, &model.dev);
+
+    encx24j600_setup(&dev, ENC_SPI, ENC_CS, ENC_INT);
+    netdev->event_callback = _event_cb;
+    if (netdev->driver->init(netdev) < 0) {
+        puts("[FAILED] init");
+        return 1;
+    }
+
+    memset(&expected, 0, sizeof(expected));
+    res |= _test_rx();
+    res |= _test_tx(&expected);
+    expected.rx_count = rx_count;
+    expected.rx_bytes = rx_bytes;
+    res |= _test_stats(&expected);
+
+    if (res < 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -19,8 +19,10 @@
  */
 
 #include <stdio.h>
+#include <inttypes.h>
 
 #include "board.h"
+#include "thread.h"
 #include "xtimer.h"
 #include "periph/spi.h"
 #include "periph/gpio.h"
@@ -64,19 +66,28 @@
 #define SPI_SPEED   (SPI_SPEED_10MHZ)
 
 #define WATERMARK_LEVEL 16
+#define SAMPLES_NUMOF   (2 * LIS3DH_FIFO_SIZE)
 
 static volatile int int1_count = 0;
+static kernel_pid_t main_pid;
+static char samples_buf[SAMPLES_NUMOF * sizeof(lis3dh_sample_t)];
 
 static void test_int1(void *arg)
 {
     volatile int *int1_count_ptr = arg;
     ++(*int1_count_ptr);
+    thread_wakeup(main_pid);
 }
 
 int main(void)
 {
     lis3dh_t dev;
-    lis3dh_data_t acc_data;
+    lis3dh_sample_t sample;
+    ringbuffer_t samples;
+    xtimer_t timeout = { 0 };
+
+    main_pid = thread_getpid();
+    ringbuffer_init(&samples, samples_buf, sizeof(samples_buf));
 
     puts("LIS3DH accelerometer driver test application\n");
     printf("Initializing SPI_%i... ", TEST_LIS3DH_SPI);
@@ -125,15 +136,6 @@ int main(void)
         return 1;
     }
 
-    puts("Enable streaming FIFO mode... ");
-    if (lis3dh_set_fifo(&dev, LIS3DH_FIFO_MODE_STREAM, WATERMARK_LEVEL) == 0) {
-        puts("[OK]");
-    }
-    else {
-        puts("[Failed]\n");
-        return 1;
-    }
-
     puts("Enable temperature reading... ");
     if (lis3dh_set_aux_adc(&dev, 1, 1) == 0) {
         puts("[OK]");
@@ -143,17 +145,8 @@ int main(void)
         return 1;
     }
 
-    puts("Set INT1 watermark function... ");
-    if (lis3dh_set_int1(&dev, LIS3DH_CTRL_REG3_I1_WTM_MASK) == 0) {
-        puts("[OK]");
-    }
-    else {
-        puts("[Failed]\n");
-        return 1;
-    }
-
-    puts("Set INT1 callback");
-    if (gpio_init_int(dev.int1, GPIO_NOPULL, GPIO_RISING, test_int1, (void*)&int1_count) == 0) {
+    puts("Enable streaming FIFO mode with INT1 watermark callback... ");
+    if (lis3dh_start_fifo(&dev, WATERMARK_LEVEL, test_int1, (void*)&int1_count) == 0) {
         puts("[OK]");
     }
     else {
@@ -164,30 +157,32 @@ int main(void)
     puts("LIS3DH init done.\n");
 
     while (1) {
-        int fifo_level;
-
-        fifo_level = lis3dh_get_fifo_level(&dev);
+        int16_t temperature;
+        int count;
+
+        /* sleep until the watermark interrupt, with a timeout in case the
+         * interrupt was missed */
+        xtimer_set_wakeup(&timeout, SLEEP * 10, main_pid);
+        thread_sleep();
+        xtimer_remove(&timeout);
+
+        count = lis3dh_read_fifo(&dev, &samples);
+        if (count < 0) {
+            puts("Reading FIFO... ");
+            puts("[Failed]\n");
+            return 1;
+        }
+        if (lis3dh_read_aux_adc3(&dev, &temperature) != 0) {
+            puts("Reading temperature data... ");
+            puts("[Failed]\n");
+            return 1;
+        }
         printf("int1_count = %d\n", int1_count);
-        printf("Reading %d measurements\n", fifo_level);
-        while (fifo_level > 0) {
-            int16_t temperature;
-            int int1;
-            if (lis3dh_read_xyz(&dev, &acc_data) != 0) {
-                puts("Reading acceleration data... ");
-                puts("[Failed]\n");
-            }
-            if (lis3dh_read_aux_adc3(&dev, &temperature) != 0) {
-                puts("Reading temperature data... ");
-                puts("[Failed]\n");
-                return 1;
-            }
-            int1 = gpio_read(dev.int1);
-            printf("X: %6d Y: %6d Z: %6d Temp: %6d, INT1: %08x\n",
-                   acc_data.acc_x, acc_data.acc_y, acc_data.acc_z, temperature, int1);
-            --fifo_level;
+        printf("Read %d measurements in one burst, Temp: %6d\n", count, temperature);
+        while (ringbuffer_get(&samples, (char *)&sample, sizeof(sample))) {
+            printf("%10" PRIu32 " us X: %6d Y: %6d Z: %6d\n", sample.time,
+                   sample.data.acc_x, sample.data.acc_y, sample.data.acc_z);
         }
-
-        xtimer_usleep(SLEEP);
     }
 
     return 0;
@@ -36,11 +36,17 @@
 #include "board.h"
 
 #define SLEEP   (1000 * 1000u)
+#define BATCH   (100 * 1000u)
+#define SAMPLES (32U)
+
+static char samples_buf[SAMPLES * sizeof(mpu9150_sample_t)];
 
 int main(void)
 {
     mpu9150_t dev;
     mpu9150_results_t measurement;
+    mpu9150_sample_t sample;
+    ringbuffer_t samples;
     int32_t temperature;
     int result;
 
@@ -79,6 +85,19 @@ int main(void)
     printf("Compass Y axis factory adjustment: %"PRIu8"\n", dev.conf.compass_y_adj);
     printf("Compass Z axis factory adjustment: %"PRIu8"\n", dev.conf.compass_z_adj);
 
+    printf("\n+-----------FIFO Burst Read-----------+\n");
+    ringbuffer_init(&samples, samples_buf, sizeof(samples_buf));
+    mpu9150_start_fifo(&dev);
+    xtimer_usleep(BATCH);
+    result = mpu9150_read_fifo(&dev, &samples);
+    printf("Read %d samples after %" PRIu32 " us\n", result, (uint32_t)BATCH);
+    while (ringbuffer_get(&samples, (char *)&sample, sizeof(sample))) {
+        printf("%10" PRIu32 " us Accel [milli g] X: %d Y: %d Z: %d "
+               "Gyro [dps] X: %d Y: %d Z: %d\n", sample.time,
+               sample.accel.x_axis, sample.accel.y_axis, sample.accel.z_axis,
+               sample.gyro.x_axis, sample.gyro.y_axis, sample.gyro.z_axis);
+    }
+
     printf("\n+--------Starting Measurements--------+\n");
     while (1) {
         /* Get accel data in milli g */
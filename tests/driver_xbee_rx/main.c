@@ -0,0 +1,453 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Test application for the receive path of the XBee driver
+ *
+ * Runs the xbee driver against a model of the device on a simulated UART of
+ * native. The model answers AT commands in reverse order and hands its
+ * responses to the driver's UART callback in small pieces from a timer, so
+ * frames are split across interrupts. Some responses are lost or corrupted,
+ * the driver has to time out and free their slots. Data frames are fed with
+ * a bad checksum, split into pieces and beyond the capacity of the driver's
+ * ringbuffer.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "native_bus.h"
+#include "thread.h"
+#include "xbee.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+
+#define XBEE_UART       (UART_0)
+
+#define RESP_DELAY      (1000U)     /* from the last command to the responses */
+#define CHUNK_DELAY     (500U)      /* between the pieces of the responses */
+#define CHUNK_LEN       (7U)        /* bytes per piece */
+#define AT_TIMEOUT      (1000U * 1000U)
+
+#define API_START       (0x7e)
+#define API_ID_AT       (0x08)
+#define API_ID_AT_RESP  (0x88)
+#define API_ID_RX_SHORT (0x81)
+#define AT_STATUS_OK    (0x00)
+#define AT_STATUS_INV   (0x02)      /* invalid command */
+
+#define FRAME_OVERHEAD  (4U)        /* start, length and checksum */
+#define RX_HDR_LEN      (5U)        /* API ID, source, RSSI, options */
+#define RX_MAX          (8U)
+
+#define MSG_QUEUE_SIZE  (8U)
+
+/* device model: parses API frames sent by the driver, answers AT commands */
+typedef struct {
+    native_uart_dev_t dev;
+    uint8_t in[XBEE_MAX_PKT_LENGTH];
+    unsigned in_pos;
+    unsigned in_len;
+    uint8_t resp[XBEE_AT_SLOTS][XBEE_MAX_RESP_LENGTH];
+    unsigned resp_len[XBEE_AT_SLOTS];
+    unsigned resp_num;
+    uint8_t out[XBEE_AT_SLOTS * 2 * (XBEE_MAX_RESP_LENGTH + FRAME_OVERHEAD)];
+    unsigned out_len;
+    unsigned out_pos;
+    xtimer_t timer;
+    uint8_t addr_long[8];
+    uint8_t addr_short[2];
+    uint8_t channel;
+    uint8_t panid[2];
+    unsigned lose;                  /* responses to drop */
+    unsigned corrupt;               /* responses to send with bad checksum */
+    unsigned reordered;             /* bursts answered out of order */
+    unsigned bad_frames;            /* frames from the driver with bad checksum */
+} xbee_model_t;
+
+static xbee_model_t model = {
+    .addr_long = { 0x00, 0x13, 0xa2, 0x00, 0x40, 0x8b, 0x1c, 0x5d },
+};
+static xbee_t dev;
+
+static msg_t msg_queue[MSG_QUEUE_SIZE];
+
+static unsigned rx_ids[RX_MAX];
+static unsigned rx_num;
+static unsigned rx_corrupt;
+
+static size_t _frame(uint8_t *buf, const uint8_t *data, size_t len)
+{
+    uint8_t sum = 0;
+
+    buf[0] = API_START;
+    buf[1] = len >> 8;
+    buf[2] = len & 0xff;
+    for (size_t i = 0; i < len; i++) {
+        buf[3 + i] = data[i];
+        sum += data[i];
+    }
+    buf[3 + len] = 0xff - sum;
+    return len + FRAME_OVERHEAD;
+}
+
+static void _deliver(void *arg)
+{
+    unsigned end;
+
+    (void)arg;
+    /* answer the commands of a burst in reverse order */
+    if (model.resp_num > 1) {
+        model.reordered++;
+    }
+    while (model.resp_num) {
+        unsigned i = --model.resp_num;
+        size_t len = _frame(&model.out[model.out_len], model.resp[i],
+                            model.resp_len[i]);
+
+        if (model.corrupt) {
+            model.corrupt--;
+            model.out[model.out_len + len - 1] ^= 0x55;
+        }
+        model.out_len += len;
+    }
+    /* the responses arrive in pieces, frames are split between them */
+    end = model.out_pos + CHUNK_LEN;
+    if (end > model.out_len) {
+        end = model.out_len;
+    }
+    while (model.out_pos < end) {
+        native_uart_input(XBEE_UART, model.out[model.out_pos++]);
+    }
+    if (model.out_pos < model.out_len) {
+        xtimer_set(&model.timer, CHUNK_DELAY);
+    }
+    else {
+        model.out_pos = 0;
+        model.out_len = 0;
+    }
+}
+
+static void _at_cmd(const uint8_t *cmd, unsigned len)
+{
+    uint8_t *resp = model.resp[model.resp_num];
+    unsigned params = len - 4;
+    unsigned n = 5;
+
+    /* API ID, frame ID, command, status, data */
+    resp[0] = API_ID_AT_RESP;
+    resp[1] = cmd[1];
+    resp[2] = cmd[2];
+    resp[3] = cmd[3];
+    resp[4] = AT_STATUS_OK;
+    if (!memcmp(&cmd[2], "SH", 2) && !params) {
+        memcpy(&resp[n], &model.addr_long[0], 4);
+        n += 4;
+    }
+    else if (!memcmp(&cmd[2], "SL", 2) && !params) {
+        memcpy(&resp[n], &model.addr_long[4], 4);
+        n += 4;
+    }
+    else if (!memcmp(&cmd[2], "MY", 2) && (params == 2)) {
+        memcpy(model.addr_short, &cmd[4], 2);
+    }
+    else if (!memcmp(&cmd[2], "MY", 2) && !params) {
+        memcpy(&resp[n], model.addr_short, 2);
+        n += 2;
+    }
+    else if (!memcmp(&cmd[2], "CH", 2) && (params == 1)) {
+        model.channel = cmd[4];
+    }
+    else if (!memcmp(&cmd[2], "CH", 2) && !params) {
+        resp[n++] = model.channel;
+    }
+    else if (!memcmp(&cmd[2], "ID", 2) && (params == 2)) {
+        memcpy(model.panid, &cmd[4], 2);
+    }
+    else if (!memcmp(&cmd[2], "ID", 2) && !params) {
+        memcpy(&resp[n], model.panid, 2);
+        n += 2;
+    }
+    else {
+        resp[4] = AT_STATUS_INV;
+    }
+
+    if (model.lose) {
+        model.lose--;
+        return;
+    }
+    model.resp_len[model.resp_num++] = n;
+    xtimer_set(&model.timer, RESP_DELAY);
+}
+
+static void _write(native_uart_dev_t *uart_dev, uint8_t data)
+{
+    unsigned pos = model.in_pos++;
+    uint8_t sum = 0;
+
+    (void)uart_dev;
+    /* the text of command mode has no start delimiter and is skipped */
+    if (pos == 0) {
+        if (data != API_START) {
+            model.in_pos = 0;
+        }
+        return;
+    }
+    if (pos == 1) {
+        model.in_len = data << 8;
+        return;
+    }
+    if (pos == 2) {
+        model.in_len |= data;
+        if (model.in_len > sizeof(model.in)) {
+            model.bad_frames++;
+            model.in_pos = 0;
+        }
+        return;
+    }
+    if (pos < model.in_len + 3) {
+        model.in[pos - 3] = data;
+        return;
+    }
+    model.in_pos = 0;
+    for (unsigned i = 0; i < model.in_len; i++) {
+        sum += model.in[i];
+    }
+    if ((uint8_t)(sum + data) != 0xff) {
+        model.bad_frames++;
+        return;
+    }
+    if ((model.in[0] == API_ID_AT) && (model.in_len >= 4)) {
+        _at_cmd(model.in, model.in_len);
+    }
+}
+
+static void _event_cb(gnrc_netdev_event_t type, void *arg)
+{
+    gnrc_pktsnip_t *pkt = (gnrc_pktsnip_t *)arg;
+    uint8_t *data = (uint8_t *)pkt->data;
+
+    if (type != NETDEV_EVENT_RX_COMPLETE) {
+        return;
+    }
+    /* every byte of the payload holds the ID of the frame */
+    for (size_t i = 0; i < pkt->size; i++) {
+        if (data[i] != data[0]) {
+            rx_corrupt++;
+            break;
+        }
+    }
+    if (rx_num < RX_MAX) {
+        rx_ids[rx_num] = data[0];
+    }
+    rx_num++;
+    gnrc_pktbuf_release(pkt);
+}
+
+static size_t _rx_frame(uint8_t *buf, uint8_t id, size_t payload_len)
+{
+    uint8_t data[RX_HDR_LEN + XBEE_MAX_PAYLOAD_LENGTH];
+
+    data[0] = API_ID_RX_SHORT;
+    data[1] = 0x12;
+    data[2] = 0x34;
+    data[3] = 0x28;
+    data[4] = 0x00;
+    memset(&data[RX_HDR_LEN], id, payload_len);
+    return _frame(buf, data, RX_HDR_LEN + payload_len);
+}
+
+static void _input(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        native_uart_input(XBEE_UART, data[i]);
+    }
+}
+
+/* handle the events the UART callback sent, like the driver's thread */
+static void _process(void)
+{
+    msg_t msg;
+
+    while (msg_try_receive(&msg) == 1) {
+        if (msg.type == GNRC_NETDEV_MSG_TYPE_EVENT) {
+            dev.driver->isr_event((gnrc_netdev_t *)&dev, msg.content.value);
+        }
+    }
+}
+
+static int _check_rx(const char *name, const unsigned *ids, unsigned num)
+{
+    int res = 0;
+
+    if ((rx_num != num) || rx_corrupt) {
+        res = -1;
+    }
+    for (unsigned i = 0; (i < num) && (i < rx_num) && (i < RX_MAX); i++) {
+        if (rx_ids[i] != ids[i]) {
+            res = -1;
+        }
+    }
+    printf("%s: %u frames received, %u corrupt\n", name, rx_num, rx_corrupt);
+    rx_num = 0;
+    rx_corrupt = 0;
+    return res;
+}
+
+static int _slots_free(void)
+{
+    for (unsigned i = 0; i < XBEE_AT_SLOTS; i++) {
+        if (dev.at[i].frame_id) {
+            printf("AT slot %u still taken\n", i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int _test_init(void)
+{
+    gnrc_netdev_t *netdev = (gnrc_netdev_t *)&dev;
+    uint8_t addr[8];
+
+    if (xbee_init(&dev, XBEE_UART, 9600, GPIO_UNDEF, GPIO_UNDEF) < 0) {
+        puts("xbee_init failed");
+        return -1;
+    }
+    /* SH and SL, then MY, CH and ID are sent back to back */
+    if (memcmp(dev.addr_long.uint8, model.addr_long, 8) ||
+        memcmp(dev.addr_short, &model.addr_long[6], 2) ||
+        memcmp(model.addr_short, &model.addr_long[6], 2) ||
+        (model.channel != XBEE_DEFAULT_CHANNEL) ||
+        (model.panid[0] != (XBEE_DEFAULT_PANID >> 8)) ||
+        (model.panid[1] != (XBEE_DEFAULT_PANID & 0xff))) {
+        puts("configuration does not match the responses");
+        return -1;
+    }
+    if (netdev->driver->get(netdev, NETOPT_ADDRESS_LONG, addr, 8) != 8 ||
+        memcmp(addr, model.addr_long, 8)) {
+        puts("NETOPT_ADDRESS_LONG failed");
+        return -1;
+    }
+    printf("init: %u bursts answered out of order\n", model.reordered);
+    if ((model.reordered < 2) || model.bad_frames || !_slots_free()) {
+        return -1;
+    }
+    return 0;
+}
+
+static int _test_timeout(const char *name, netopt_t opt, unsigned *fault)
+{
+    gnrc_netdev_t *netdev = (gnrc_netdev_t *)&dev;
+    uint8_t value[2];
+    uint32_t start = xtimer_now();
+    uint32_t time;
+    int res;
+
+    /* the response does not arrive, the command fails after the timeout */
+    *fault = 1;
+    res = netdev->driver->get(netdev, opt, value, sizeof(value));
+    time = xtimer_now() - start;
+    printf("%s: get returned %d after %u ms\n", name, res,
+           (unsigned)(time / 1000));
+    if ((res >= 0) || (time < AT_TIMEOUT) || !_slots_free()) {
+        return -1;
+    }
+    /* the next command works again */
+    res = netdev->driver->get(netdev, opt, value, sizeof(value));
+    if (res != sizeof(value)) {
+        printf("%s: get after the timeout returned %d\n", name, res);
+        return -1;
+    }
+    return _slots_free() ? 0 : -1;
+}
+
+static int _test_rx(void)
+{
+    static const unsigned split_ids[] = { 1 };
+    static const unsigned cksum_ids[] = { 3 };
+    static const unsigned overflow_ids[] = { 4, 5, 8 };
+    uint8_t buf[XBEE_MAX_PKT_LENGTH + 1];
+    size_t len;
+    int res = 0;
+
+    /* a frame split into pieces, each handled on its own */
+    len = _rx_frame(buf, 1, 20);
+    _input(buf, 2);
+    _process();
+    _input(&buf[2], 5);
+    _process();
+    _input(&buf[7], len - 7);
+    _process();
+    res |= _check_rx("split frame", split_ids, 1);
+
+    /* a frame with bad checksum followed by a good one */
+    len = _rx_frame(buf, 2, 30);
+    buf[10] ^= 0x01;
+    _input(buf, len);
+    len = _rx_frame(buf, 3, 30);
+    _input(buf, len);
+    _process();
+    res |= _check_rx("bad checksum", cksum_ids, 1);
+
+    /* more data than the ringbuffer holds before the driver runs: the third
+     * frame is cut off and takes the start of the next one with it */
+    len = _rx_frame(buf, 4, 40);
+    _input(buf, len);
+    len = _rx_frame(buf, 5, 90);
+    _input(buf, len);
+    len = _rx_frame(buf, 6, 95);
+    _input(buf, len);
+    _process();
+    len = _rx_frame(buf, 7, 30);
+    _input(buf, len);
+    len = _rx_frame(buf, 8, 30);
+    _input(buf, len);
+    _process();
+    res |= _check_rx("ringbuffer overflow", overflow_ids, 3);
+
+    return res;
+}
+
+int main(void)
+{
+    int res = 0;
+
+    puts("xbee RX test");
+
+    msg_init_queue(msg_queue, MSG_QUEUE_SIZE);
+    model.dev.write = _write;
+    model.timer.callback = _deliver;
+    native_uart_attach(XBEE_UART, &model.dev);
+
+    if (_test_init() < 0) {
+        puts("[FAILED] init");
+        return 1;
+    }
+    res |= _test_timeout("lost response", NETOPT_CHANNEL, &model.lose);
+    res |= _test_timeout("bad checksum", NETOPT_NID, &model.corrupt);
+
+    /* data is handled in this thread from now on */
+    dev.mac_pid = thread_getpid();
+    dev.driver->add_event_callback((gnrc_netdev_t *)&dev, _event_cb);
+    res |= _test_rx();
+
+    if (res < 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
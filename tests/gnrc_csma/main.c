@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Collision test for the CSMA/CA MAC layer
+ *
+ * Three simulated radios share one medium: two senders hand a frame to
+ * their MAC layer at the same time, both addressed to the third radio.
+ * Frames that overlap on the medium are lost for everyone. Every round is
+ * run once as plain ALOHA (CSMA disabled, ACKs and retransmissions only)
+ * and once with CSMA/CA. The random generator is seeded with a constant,
+ * so the backoffs are the same on every run.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "irq.h"
+#include "msg.h"
+#include "random.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/csma.h"
+#include "net/gnrc/netdev.h"
+
+#define SEED            (0x6373u)
+#define ROUNDS          (100U)
+#define PAYLOAD_SIZE    (40U)
+#define RADIO_NUMOF     (3U)
+#define SINK            (0U)
+#define RX_QUEUE_SIZE   (4U)
+#define FRAME_MAX       (127U)
+#define BYTE_US         (32U)       /* 250 kbit/s */
+#define OVERHEAD        (8U)        /* SHR, PHR and FCS */
+#define MSG_QUEUE_SIZE  (16U)
+#define RX_TIMEOUT      (100000U)
+
+/**
+ * @brief   Simulated radio
+ *
+ * @extends gnrc_netdev_t
+ */
+typedef struct {
+    gnrc_netdev_driver_t const *driver;
+    gnrc_netdev_event_cb_t event_cb;
+    kernel_pid_t mac_pid;
+    uint16_t addr;
+    uint8_t raw;
+    uint8_t on_air;
+    uint8_t collided;
+    uint8_t frame[FRAME_MAX];
+    uint8_t frame_len;
+    gnrc_pktsnip_t *rx[RX_QUEUE_SIZE];
+    uint8_t rx_head;
+    uint8_t rx_len;
+} radio_t;
+
+static radio_t radios[RADIO_NUMOF];
+static char stacks[RADIO_NUMOF][THREAD_STACKSIZE_DEFAULT];
+static msg_t _msg_q[MSG_QUEUE_SIZE];
+static uint8_t _payload[PAYLOAD_SIZE];
+static unsigned collisions;
+
+static int _busy(void)
+{
+    for (unsigned i = 0; i < RADIO_NUMOF; i++) {
+        if (radios[i].on_air) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void _deliver(radio_t *src)
+{
+    for (unsigned i = 0; i < RADIO_NUMOF; i++) {
+        radio_t *dst = &radios[i];
+        gnrc_pktsnip_t *pkt;
+        msg_t msg;
+
+        if ((dst == src) || !dst->raw || (dst->rx_len >= RX_QUEUE_SIZE)) {
+            continue;
+        }
+        pkt = gnrc_pktbuf_add(NULL, src->frame, src->frame_len,
+                              GNRC_NETTYPE_UNDEF);
+        if (pkt == NULL) {
+            continue;
+        }
+        unsigned state = disableIRQ();
+        dst->rx[(dst->rx_head + dst->rx_len++) % RX_QUEUE_SIZE] = pkt;
+        restoreIRQ(state);
+        msg.type = GNRC_NETDEV_MSG_TYPE_EVENT;
+        msg.content.value = NETDEV_EVENT_RX_COMPLETE;
+        msg_try_send(&msg, dst->mac_pid);
+    }
+}
+
+static int _send(gnrc_netdev_t *netdev, gnrc_pktsnip_t *pkt)
+{
+    radio_t *dev = (radio_t *)netdev;
+    gnrc_pktsnip_t *snip;
+    size_t len = 0;
+
+    for (snip = pkt->next; snip; snip = snip->next) {
+        if (len + snip->size > FRAME_MAX) {
+            gnrc_pktbuf_release(pkt);
+            return -EOVERFLOW;
+        }
+        memcpy(&dev->frame[len], snip->data, snip->size);
+        len += snip->size;
+    }
+    gnrc_pktbuf_release(pkt);
+    dev->frame_len = len;
+
+    /* frames overlapping on the medium are lost */
+    unsigned state = disableIRQ();
+    dev->collided = 0;
+    for (unsigned i = 0; i < RADIO_NUMOF; i++) {
+        if (radios[i].on_air) {
+            radios[i].collided = 1;
+            dev->collided = 1;
+        }
+    }
+    dev->on_air = 1;
+    restoreIRQ(state);
+    if (dev->collided) {
+        collisions++;
+    }
+    xtimer_usleep((len + OVERHEAD) * BYTE_US);
+    dev->on_air = 0;
+    if (!dev->collided) {
+        _deliver(dev);
+    }
+    return (int)len;
+}
+
+static int _add_cb(gnrc_netdev_t *dev, gnrc_netdev_event_cb_t cb)
+{
+    dev->event_cb = cb;
+    return 0;
+}
+
+static int _rem_cb(gnrc_netdev_t *dev, gnrc_netdev_event_cb_t cb)
+{
+    (void)cb;
+    dev->event_cb = NULL;
+    return 0;
+}
+
+static int _get(gnrc_netdev_t *netdev, netopt_t opt, void *value,
+                size_t max_len)
+{
+    radio_t *dev = (radio_t *)netdev;
+
+    switch (opt) {
+        case NETOPT_ADDRESS:
+        case NETOPT_NID:
+        case NETOPT_SRC_LEN:
+            if (max_len < sizeof(uint16_t)) {
+                return -EOVERFLOW;
+            }
+            *((uint16_t *)value) = (opt == NETOPT_ADDRESS) ? dev->addr :
+                                   (opt == NETOPT_NID) ? 0x0023 : 2;
+            return sizeof(uint16_t);
+        case NETOPT_PROTO:
+            if (max_len < sizeof(gnrc_nettype_t)) {
+                return -EOVERFLOW;
+            }
+            *((gnrc_nettype_t *)value) = GNRC_NETTYPE_UNDEF;
+            return sizeof(gnrc_nettype_t);
+        case NETOPT_IS_CHANNEL_CLR:
+            if (max_len < sizeof(netopt_enable_t)) {
+                return -EOVERFLOW;
+            }
+            *((netopt_enable_t *)value) = _busy() ? NETOPT_DISABLE
+                                                  : NETOPT_ENABLE;
+            return sizeof(netopt_enable_t);
+        default:
+            return -ENOTSUP;
+    }
+}
+
+static int _set(gnrc_netdev_t *netdev, netopt_t opt, void *value,
+                size_t value_len)
+{
+    radio_t *dev = (radio_t *)netdev;
+
+    switch (opt) {
+        case NETOPT_RAWMODE:
+            dev->raw = (*((netopt_enable_t *)value) == NETOPT_ENABLE);
+            return value_len;
+        case NETOPT_AUTOACK:
+            return value_len;
+        default:
+            return -ENOTSUP;
+    }
+}
+
+static void _isr_event(gnrc_netdev_t *netdev, uint32_t event_type)
+{
+    radio_t *dev = (radio_t *)netdev;
+    gnrc_pktsnip_t *pkt;
+
+    if (event_type != NETDEV_EVENT_RX_COMPLETE) {
+        return;
+    }
+    unsigned state = disableIRQ();
+    if (dev->rx_len == 0) {
+        restoreIRQ(state);
+        return;
+    }
+    pkt = dev->rx[dev->rx_head];
+    dev->rx_head = (dev->rx_head + 1) % RX_QUEUE_SIZE;
+    dev->rx_len--;
+    restoreIRQ(state);
+    dev->event_cb(NETDEV_EVENT_RX_COMPLETE, pkt);
+}
+
+static const gnrc_netdev_driver_t _radio_driver = {
+    .send_data = _send,
+    .add_event_callback = _add_cb,
+    .rem_event_callback = _rem_cb,
+    .get = _get,
+    .set = _set,
+    .isr_event = _isr_event,
+};
+
+static void _send_frame(radio_t *src)
+{
+    uint16_t dst = radios[SINK].addr;
+    gnrc_pktsnip_t *payload, *netif;
+
+    payload = gnrc_pktbuf_add(NULL, _payload, sizeof(_payload),
+                              GNRC_NETTYPE_UNDEF);
+    netif = gnrc_netif_hdr_build(NULL, 0, (uint8_t *)&dst, sizeof(dst));
+    if ((payload == NULL) || (netif == NULL)) {
+        puts("error: packet buffer full");
+        return;
+    }
+    netif->next = payload;
+    gnrc_netapi_send(src->mac_pid, netif);
+}
+
+static unsigned _run(const char *name, netopt_enable_t csma)
+{
+    unsigned delivered = 0, noack = 0, busy = 0, tx = 0;
+    uint32_t start;
+    msg_t msg;
+
+    for (unsigned i = 0; i < RADIO_NUMOF; i++) {
+        gnrc_netapi_set(radios[i].mac_pid, NETOPT_CSMA, 0, &csma,
+                        sizeof(csma));
+    }
+    collisions = 0;
+    start = xtimer_now();
+    for (unsigned round = 0; round < ROUNDS; round++) {
+        unsigned pending = 2;
+
+        _send_frame(&radios[1]);
+        _send_frame(&radios[2]);
+        while (pending > 0) {
+            if (xtimer_msg_receive_timeout(&msg, RX_TIMEOUT) < 0) {
+                puts("error: no TX status");
+                return 0;
+            }
+            if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+                delivered++;
+                gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+            }
+            else if (msg.type == GNRC_CSMA_MSG_TYPE_TX_STATUS) {
+                pending--;
+                tx += gnrc_csma_tx_count(&msg);
+                switch (gnrc_csma_tx_status(&msg)) {
+                    case GNRC_CSMA_TX_NOACK:
+                        noack++;
+                        break;
+                    case GNRC_CSMA_TX_CHANNEL_BUSY:
+                        busy++;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+    /* the last frames may still be on their way to the main thread */
+    while (xtimer_msg_receive_timeout(&msg, RX_TIMEOUT) >= 0) {
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+            delivered++;
+            gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+        }
+    }
+    printf("%-6s %3u frames, %3u delivered, %3u no ACK, %3u channel busy, "
+           "%4u transmissions, %4u collisions, %6" PRIu32 " us\n", name,
+           2 * ROUNDS, delivered, noack, busy, tx, collisions,
+           xtimer_now() - start);
+    return delivered;
+}
+
+int main(void)
+{
+    gnrc_netreg_entry_t rx = { NULL, GNRC_NETREG_DEMUX_CTX_ALL,
+                               KERNEL_PID_UNDEF };
+    unsigned aloha;
+
+    puts("CSMA/CA collision test");
+    msg_init_queue(_msg_q, MSG_QUEUE_SIZE);
+    genrand_init(SEED);
+    memset(_payload, 0xa5, sizeof(_payload));
+
+    for (unsigned i = 0; i < RADIO_NUMOF; i++) {
+        radios[i].driver = &_radio_driver;
+        radios[i].addr = 0x0100 + i;
+        gnrc_csma_init(stacks[i], sizeof(stacks[i]), THREAD_PRIORITY_MAIN - 1,
+                       "csma", (gnrc_netdev_t *)&radios[i], NULL);
+    }
+    rx.pid = thread_getpid();
+    gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &rx);
+
+    aloha = _run("aloha", NETOPT_DISABLE);
+    if (_run("csma", NETOPT_ENABLE) > aloha) {
+        puts("SUCCESS");
+    }
+    else {
+        puts("FAILURE");
+    }
+    return 0;
+}
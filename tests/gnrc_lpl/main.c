@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Energy and latency of the low power listening MAC layer
+ *
+ * A node sends frames to a sink over a simulated medium, once with the
+ * radios always on and then with several wake up intervals. For every
+ * interval the test prints the share of time the radios were on and the
+ * latency of the frames, the first frame to the sink is strobed for the
+ * whole interval, later ones make use of the learned phase.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "irq.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/lpl.h"
+
+#define FRAMES          (8U)
+#define FRAME_MAX       (64U)
+#define PAYLOAD_SIZE    (32U)
+#define BYTE_US         (32U)       /* 250 kbit/s */
+#define PERIOD          (330000U)   /* time between two frames */
+#define BCAST           (0xff)
+#define MSG_QUEUE_SIZE  (8U)
+#define RX_TIMEOUT      (400000U)
+
+struct link;
+
+/**
+ * @brief   Simulated radio
+ *
+ * @extends netdev2_t
+ */
+typedef struct {
+    netdev2_t netdev;
+    struct link *link;
+    uint8_t addr;
+    netopt_state_t state;
+    uint8_t rx[FRAME_MAX];
+    uint8_t rx_len;
+} radio_t;
+
+/**
+ * @brief   Node and sink sharing a medium
+ */
+typedef struct link {
+    const char *name;
+    gnrc_lpl_params_t params;
+    radio_t radios[2];
+    gnrc_netdev2_t adapters[2];
+    kernel_pid_t pids[2];
+    char stacks[2][THREAD_STACKSIZE_DEFAULT];
+} link_t;
+
+static link_t links[] = {
+    { .name = "on",     .params = { 0, 0, 0, 0 } },
+    { .name = "50ms",   .params = { 50000, 8000, 3000, 3000 } },
+    { .name = "125ms",  .params = { 125000, 8000, 3000, 3000 } },
+    { .name = "250ms",  .params = { 250000, 8000, 3000, 3000 } },
+};
+
+static msg_t _msg_q[MSG_QUEUE_SIZE];
+static uint8_t _payload[PAYLOAD_SIZE];
+
+static int _send(netdev2_t *netdev, const struct iovec *vector, int count)
+{
+    radio_t *dev = (radio_t *)netdev;
+    link_t *link = dev->link;
+    uint8_t frame[FRAME_MAX];
+    size_t len = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (len + vector[i].iov_len > sizeof(frame)) {
+            return -EOVERFLOW;
+        }
+        memcpy(&frame[len], vector[i].iov_base, vector[i].iov_len);
+        len += vector[i].iov_len;
+    }
+    xtimer_usleep(len * BYTE_US);
+
+    /* only radios that are on at the end of the frame receive it */
+    for (unsigned i = 0; i < 2; i++) {
+        radio_t *dst = &link->radios[i];
+
+        if ((dst == dev) || (dst->state == NETOPT_STATE_SLEEP) ||
+            ((frame[0] != dst->addr) && (frame[0] != BCAST))) {
+            continue;
+        }
+        unsigned state = disableIRQ();
+        if (dst->rx_len > 0) {
+            /* the radio is still busy with the last frame */
+            restoreIRQ(state);
+            continue;
+        }
+        memcpy(dst->rx, frame, len);
+        dst->rx_len = len;
+        restoreIRQ(state);
+        dst->netdev.event_callback(&dst->netdev, NETDEV2_EVENT_ISR,
+                                   dst->netdev.isr_arg);
+    }
+    return (int)len;
+}
+
+static int _recv(netdev2_t *netdev, char *buf, int len)
+{
+    radio_t *dev = (radio_t *)netdev;
+    int res;
+
+    if (buf == NULL) {
+        return dev->rx_len;
+    }
+    unsigned state = disableIRQ();
+    res = (dev->rx_len < len) ? dev->rx_len : len;
+    memcpy(buf, dev->rx, res);
+    dev->rx_len = 0;
+    restoreIRQ(state);
+    return res;
+}
+
+static int _init(netdev2_t *netdev)
+{
+    ((radio_t *)netdev)->state = NETOPT_STATE_IDLE;
+    return 0;
+}
+
+static void _isr(netdev2_t *netdev)
+{
+    if (((radio_t *)netdev)->rx_len > 0) {
+        netdev->event_callback(netdev, NETDEV2_EVENT_RX_COMPLETE, NULL);
+    }
+}
+
+static int _get(netdev2_t *netdev, netopt_t opt, void *value, size_t max_len)
+{
+    (void)netdev;
+    (void)opt;
+    (void)value;
+    (void)max_len;
+    return -ENOTSUP;
+}
+
+static int _set(netdev2_t *netdev, netopt_t opt, void *value, size_t len)
+{
+    radio_t *dev = (radio_t *)netdev;
+
+    if (opt != NETOPT_STATE) {
+        return -ENOTSUP;
+    }
+    dev->state = *((netopt_state_t *)value);
+    return len;
+}
+
+static const netdev2_driver_t _radio_driver = {
+    .send = _send,
+    .recv = _recv,
+    .init = _init,
+    .isr = _isr,
+    .get = _get,
+    .set = _set,
+};
+
+/* frames are destination, source and payload */
+static int _adapter_send(gnrc_netdev2_t *gnrc_netdev2, gnrc_pktsnip_t *pkt)
+{
+    radio_t *dev = (radio_t *)gnrc_netdev2->dev;
+    gnrc_netif_hdr_t *hdr = pkt->data;
+    uint8_t frame[FRAME_MAX];
+    struct iovec vector = { frame, 2 };
+
+    frame[0] = (hdr->dst_l2addr_len == 1) ? *gnrc_netif_hdr_get_dst_addr(hdr)
+                                          : BCAST;
+    frame[1] = dev->addr;
+    for (gnrc_pktsnip_t *snip = pkt->next; snip; snip = snip->next) {
+        if (vector.iov_len + snip->size > sizeof(frame)) {
+            gnrc_pktbuf_release(pkt);
+            return -EOVERFLOW;
+        }
+        memcpy(&frame[vector.iov_len], snip->data, snip->size);
+        vector.iov_len += snip->size;
+    }
+    gnrc_pktbuf_release(pkt);
+    return dev->netdev.driver->send(&dev->netdev, &vector, 1);
+}
+
+static gnrc_pktsnip_t *_adapter_recv(gnrc_netdev2_t *gnrc_netdev2)
+{
+    netdev2_t *dev = gnrc_netdev2->dev;
+    uint8_t frame[FRAME_MAX];
+    gnrc_pktsnip_t *pkt, *netif;
+    int len = dev->driver->recv(dev, (char *)frame, sizeof(frame));
+
+    if (len <= 2) {
+        return NULL;
+    }
+    pkt = gnrc_pktbuf_add(NULL, &frame[2], len - 2, GNRC_NETTYPE_UNDEF);
+    if (pkt == NULL) {
+        return NULL;
+    }
+    netif = gnrc_netif_hdr_build(&frame[1], 1, &frame[0], 1);
+    if (netif == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = thread_getpid();
+    LL_APPEND(pkt, netif);
+    return pkt;
+}
+
+static void _send_frame(link_t *link, uint8_t dst)
+{
+    gnrc_pktsnip_t *payload, *netif;
+
+    payload = gnrc_pktbuf_add(NULL, _payload, sizeof(_payload),
+                              GNRC_NETTYPE_UNDEF);
+    netif = gnrc_netif_hdr_build(NULL, 0, &dst, 1);
+    if ((payload == NULL) || (netif == NULL)) {
+        puts("error: packet buffer full");
+        return;
+    }
+    if (dst == BCAST) {
+        ((gnrc_netif_hdr_t *)netif->data)->flags |= GNRC_NETIF_HDR_FLAGS_BROADCAST;
+    }
+    netif->next = payload;
+    gnrc_netapi_send(link->pids[0], netif);
+}
+
+static unsigned _receive(uint32_t timeout)
+{
+    msg_t msg;
+
+    if (xtimer_msg_receive_timeout(&msg, timeout) < 0) {
+        return 0;
+    }
+    if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+        gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+        return 1;
+    }
+    return 0;
+}
+
+static void _print(const char *who, gnrc_lpl_stats_t *before,
+                   gnrc_lpl_stats_t *after)
+{
+    uint64_t on = after->radio_on - before->radio_on;
+    uint64_t time = after->uptime - before->uptime;
+
+    printf("  %-4s radio on %3u.%u%%", who,
+           (unsigned)((on * 100) / time), (unsigned)(((on * 1000) / time) % 10));
+    if (after->tx > before->tx) {
+        unsigned tx = after->tx - before->tx;
+
+        printf(", latency avg %6" PRIu32 " us, min %6" PRIu32 " us, "
+               "max %6" PRIu32 " us, %u strobes for %u frames",
+               (uint32_t)((after->latency_sum - before->latency_sum) / tx),
+               after->latency_min, after->latency_max,
+               (unsigned)(after->strobes - before->strobes), tx);
+    }
+    puts("");
+}
+
+static int _run(link_t *link)
+{
+    gnrc_lpl_stats_t before[2], after[2];
+    unsigned received = 0;
+
+    for (unsigned i = 0; i < 2; i++) {
+        gnrc_lpl_get_stats(link->pids[i], &before[i]);
+    }
+    for (unsigned i = 0; i < FRAMES; i++) {
+        uint32_t elapsed, start = xtimer_now();
+
+        _send_frame(link, link->radios[1].addr);
+        received += _receive(RX_TIMEOUT);
+        elapsed = xtimer_now() - start;
+        if (elapsed < PERIOD) {
+            xtimer_usleep(PERIOD - elapsed);
+        }
+    }
+    _send_frame(link, BCAST);
+    received += _receive(RX_TIMEOUT);
+    /* let the broadcast strobes end */
+    xtimer_usleep(2 * (link->params.interval + link->params.listen));
+    for (unsigned i = 0; i < 2; i++) {
+        gnrc_lpl_get_stats(link->pids[i], &after[i]);
+    }
+
+    printf("%-6s %2u of %2u frames received\n", link->name, received,
+           FRAMES + 1);
+    _print("node", &before[0], &after[0]);
+    _print("sink", &before[1], &after[1]);
+    return (received == FRAMES + 1) && (after[0].tx_failed == before[0].tx_failed);
+}
+
+int main(void)
+{
+    gnrc_netreg_entry_t rx = { NULL, GNRC_NETREG_DEMUX_CTX_ALL,
+                               KERNEL_PID_UNDEF };
+    int ok = 1;
+
+    puts("Low power listening test");
+    msg_init_queue(_msg_q, MSG_QUEUE_SIZE);
+    memset(_payload, 0xa5, sizeof(_payload));
+    rx.pid = thread_getpid();
+    gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &rx);
+
+    for (unsigned l = 0; l < sizeof(links) / sizeof(links[0]); l++) {
+        link_t *link = &links[l];
+
+        for (unsigned i = 0; i < 2; i++) {
+            link->radios[i].netdev.driver = &_radio_driver;
+            link->radios[i].link = link;
+            link->radios[i].addr = i + 1;
+            link->adapters[i].send = _adapter_send;
+            link->adapters[i].recv = _adapter_recv;
+            link->adapters[i].dev = &link->radios[i].netdev;
+            link->pids[i] = gnrc_lpl_init(link->stacks[i],
+                                          sizeof(link->stacks[i]),
+                                          THREAD_PRIORITY_MAIN - 1, "lpl",
+                                          &link->adapters[i], &link->params);
+        }
+    }
+
+    for (unsigned l = 0; l < sizeof(links) / sizeof(links[0]); l++) {
+        ok &= _run(&links[l]);
+    }
+    puts((ok) ? "SUCCESS" : "FAILURE");
+    return 0;
+}
@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Measures the per-packet latency and the stack memory of the GNRC
+ *          layers with and without the single thread mode
+ *
+ * UDP packets are sent to the IPv6 loopback address, so every packet passes
+ * UDP and IPv6 twice and is then received by the main thread. Build with
+ * SINGLE_THREAD=0 to compare with the threaded mode.
+ *
+ * Afterwards a UDP packet is sent to a link-local neighbor over a simulated
+ * 6LoWPAN interface. This checks that the neighbor solicitation, which NDP
+ * passes to IPv6 with a netif header in front, leaves the interface and that
+ * the queued packet is sent once the neighbor advertisement was received.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "msg.h"
+#include "ps.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/icmpv6.h"
+#include "net/inet_csum.h"
+#include "net/ipv6/hdr.h"
+#include "net/ndp.h"
+#include "net/protnum.h"
+#include "net/sixlowpan.h"
+#include "net/udp.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/ipv6/netif.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/udp.h"
+#ifdef MODULE_GNRC_SINGLE_THREAD
+#include "net/gnrc/single_thread.h"
+#endif
+
+#define ROUNDS          (1000U)
+#define PORT            (8808U)
+#define PAYLOAD_SIZE    (32U)
+#define MSG_QUEUE_SIZE  (8U)
+#define NETIF_TIMEOUT   (1000000U)  /**< time to wait for a packet at the netif */
+#define NETIF_MTU       (127U)      /**< IEEE 802.15.4 frame size */
+
+static msg_t _msg_q[MSG_QUEUE_SIZE];
+static uint8_t _payload[PAYLOAD_SIZE];
+
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static msg_t _netif_msg_q[MSG_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+
+/* our and the neighbor's EUI-64, the IIDs only differ in the U/L bit */
+static const uint8_t _l2addr[] = { 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01 };
+static const uint8_t _iid[] = { 0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01 };
+static const uint8_t _nbr_l2addr[] = { 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x02 };
+static const ipv6_addr_t _nbr_addr = { {
+        0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x02, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x02
+    } };
+
+static int _netif_get(gnrc_netapi_opt_t *opt)
+{
+    switch (opt->opt) {
+        case NETOPT_PROTO:
+            *((gnrc_nettype_t *)opt->data) = GNRC_NETTYPE_SIXLOWPAN;
+            return sizeof(gnrc_nettype_t);
+        case NETOPT_IPV6_IID:
+            memcpy(opt->data, _iid, sizeof(_iid));
+            return sizeof(_iid);
+        case NETOPT_ADDRESS_LONG:
+            memcpy(opt->data, _l2addr, sizeof(_l2addr));
+            return sizeof(_l2addr);
+        case NETOPT_SRC_LEN:
+            *((uint16_t *)opt->data) = sizeof(_l2addr);
+            return sizeof(uint16_t);
+        case NETOPT_MAX_PACKET_SIZE:
+            *((uint16_t *)opt->data) = NETIF_MTU;
+            return sizeof(uint16_t);
+        default:
+            return -ENOTSUP;
+    }
+}
+
+/* a 6LoWPAN interface that passes all packets to send to the main thread */
+static void *_netif_thread(void *arg)
+{
+    msg_t msg, reply;
+
+    (void)arg;
+    msg_init_queue(_netif_msg_q, MSG_QUEUE_SIZE);
+    reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+
+    while (1) {
+        msg_receive(&msg);
+
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_GET:
+                reply.content.value = (uint32_t)_netif_get((gnrc_netapi_opt_t *)msg.content.ptr);
+                msg_reply(&msg, &reply);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                reply.content.value = (uint32_t)(-ENOTSUP);
+                msg_reply(&msg, &reply);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                if (msg_try_send(&msg, _main_pid) < 1) {
+                    gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+/* returns the ICMPv6 type or the UDP destination port of an uncompressed
+ * 6LoWPAN packet sent over the interface, -1 for any other packet */
+static int _netif_pkt_id(gnrc_pktsnip_t *pkt, uint8_t *nh)
+{
+    gnrc_pktsnip_t *snip, *ip;
+    ipv6_hdr_t *hdr;
+
+    LL_SEARCH_SCALAR(pkt, snip, type, GNRC_NETTYPE_SIXLOWPAN);
+    if ((snip == NULL) || (((uint8_t *)snip->data)[0] != SIXLOWPAN_UNCOMP)) {
+        return -1;
+    }
+    ip = snip->next;
+    if ((ip == NULL) || (ip->type != GNRC_NETTYPE_IPV6) || (ip->next == NULL)) {
+        return -1;
+    }
+    hdr = ip->data;
+    *nh = hdr->nh;
+    if (hdr->nh == PROTNUM_ICMPV6) {
+        icmpv6_hdr_t *icmpv6 = ip->next->data;
+
+        if ((icmpv6->type == ICMPV6_NBR_SOL) &&
+            !ipv6_addr_equal(&((ndp_nbr_sol_t *)icmpv6)->tgt, &_nbr_addr)) {
+            return -1;
+        }
+        return icmpv6->type;
+    }
+    if (hdr->nh == PROTNUM_UDP) {
+        return byteorder_ntohs(((udp_hdr_t *)ip->next->data)->dst_port);
+    }
+    return -1;
+}
+
+/* waits for the given packet to arrive at the interface, others (e.g. router
+ * solicitations) are dropped */
+static bool _netif_expect(uint8_t nh, int id)
+{
+    msg_t msg;
+
+    while (xtimer_msg_receive_timeout(&msg, NETIF_TIMEOUT) >= 0) {
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_SND) {
+            gnrc_pktsnip_t *pkt = (gnrc_pktsnip_t *)msg.content.ptr;
+            uint8_t pkt_nh = 0;
+            int pkt_id = _netif_pkt_id(pkt, &pkt_nh);
+
+            gnrc_pktbuf_release(pkt);
+            if ((pkt_nh == nh) && (pkt_id == id)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* receives a neighbor advertisement for _nbr_addr over the interface */
+static bool _netif_recv_nbr_adv(kernel_pid_t iface, const ipv6_addr_t *dst)
+{
+    uint8_t buf[1 + sizeof(ipv6_hdr_t) + sizeof(ndp_nbr_adv_t) + 16];
+    ipv6_hdr_t *hdr = (ipv6_hdr_t *)&buf[1];
+    ndp_nbr_adv_t *nbr_adv = (ndp_nbr_adv_t *)(hdr + 1);
+    ndp_opt_t *opt = (ndp_opt_t *)(nbr_adv + 1);
+    uint16_t len = sizeof(ndp_nbr_adv_t) + 16;
+    uint16_t csum;
+    gnrc_pktsnip_t *netif, *pkt;
+
+    memset(buf, 0, sizeof(buf));
+    buf[0] = SIXLOWPAN_UNCOMP;
+    ipv6_hdr_set_version(hdr);
+    hdr->len = byteorder_htons(len);
+    hdr->nh = PROTNUM_ICMPV6;
+    hdr->hl = 255;
+    hdr->src = _nbr_addr;
+    hdr->dst = *dst;
+    nbr_adv->type = ICMPV6_NBR_ADV;
+    nbr_adv->flags = NDP_NBR_ADV_FLAGS_S | NDP_NBR_ADV_FLAGS_O;
+    nbr_adv->tgt = _nbr_addr;
+    opt->type = NDP_OPT_TL2A;
+    opt->len = 2;   /* option and EUI-64 padded to 16 bytes */
+    memcpy(opt + 1, _nbr_l2addr, sizeof(_nbr_l2addr));
+    csum = inet_csum(0, (uint8_t *)nbr_adv, len);
+    csum = ipv6_hdr_inet_csum(csum, hdr, PROTNUM_ICMPV6, len);
+    nbr_adv->csum = byteorder_htons(~csum);
+
+    netif = gnrc_netif_hdr_build((uint8_t *)_nbr_l2addr, sizeof(_nbr_l2addr),
+                                 (uint8_t *)_l2addr, sizeof(_l2addr));
+    if (netif == NULL) {
+        return false;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = iface;
+    pkt = gnrc_pktbuf_add(netif, buf, sizeof(buf), GNRC_NETTYPE_SIXLOWPAN);
+    if (pkt == NULL) {
+        gnrc_pktbuf_release(netif);
+        return false;
+    }
+    if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_SIXLOWPAN,
+                                      GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+        gnrc_pktbuf_release(pkt);
+        return false;
+    }
+    return true;
+}
+
+static gnrc_pktsnip_t *_build_to(const ipv6_addr_t *addr)
+{
+    ipv6_addr_t dst = *addr;
+    uint16_t port = PORT;
+    gnrc_pktsnip_t *payload, *udp, *ip;
+
+    payload = gnrc_pktbuf_add(NULL, _payload, sizeof(_payload),
+                              GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return NULL;
+    }
+    udp = gnrc_udp_hdr_build(payload, (uint8_t *)&port, sizeof(port),
+                             (uint8_t *)&port, sizeof(port));
+    if (udp == NULL) {
+        gnrc_pktbuf_release(payload);
+        return NULL;
+    }
+    ip = gnrc_ipv6_hdr_build(udp, NULL, 0, (uint8_t *)&dst, sizeof(dst));
+    if (ip == NULL) {
+        gnrc_pktbuf_release(udp);
+        return NULL;
+    }
+    return ip;
+}
+
+static gnrc_pktsnip_t *_build(void)
+{
+    ipv6_addr_t dst = IPV6_ADDR_LOOPBACK;
+
+    return _build_to(&dst);
+}
+
+static bool _test_ndp(void)
+{
+    ipv6_addr_t ll_addr;
+    gnrc_pktsnip_t *pkt;
+    kernel_pid_t iface;
+
+    iface = thread_create(_netif_stack, sizeof(_netif_stack),
+                          THREAD_PRIORITY_MAIN - 1, CREATE_STACKTEST,
+                          _netif_thread, NULL, "netif");
+    if ((iface <= KERNEL_PID_UNDEF) || (gnrc_netif_add(iface) < 0)) {
+        puts("unable to add interface");
+        return false;
+    }
+    gnrc_ipv6_netif_init_by_dev();
+    ipv6_addr_set_aiid(&ll_addr, (uint8_t *)_iid);
+    ipv6_addr_set_link_local_prefix(&ll_addr);
+
+    if ((pkt = _build_to(&_nbr_addr)) == NULL) {
+        puts("unable to allocate packet");
+        return false;
+    }
+    if (!gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP,
+                                   GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+        gnrc_pktbuf_release(pkt);
+        puts("unable to send packet");
+        return false;
+    }
+    if (!_netif_expect(PROTNUM_ICMPV6, ICMPV6_NBR_SOL)) {
+        puts("no neighbor solicitation sent over 6LoWPAN");
+        return false;
+    }
+    puts("neighbor solicitation sent over 6LoWPAN");
+    if (!_netif_recv_nbr_adv(iface, &ll_addr)) {
+        puts("unable to receive neighbor advertisement");
+        return false;
+    }
+    if (!_netif_expect(PROTNUM_UDP, PORT)) {
+        puts("queued packet not sent after neighbor advertisement");
+        return false;
+    }
+    puts("queued packet sent after neighbor advertisement");
+    return true;
+}
+
+int main(void)
+{
+    gnrc_netreg_entry_t entry;
+    uint32_t latency_max = 0, latency_sum = 0;
+    unsigned received = 0;
+    size_t stack;
+
+    msg_init_queue(_msg_q, MSG_QUEUE_SIZE);
+    _main_pid = thread_getpid();
+
+    entry.demux_ctx = PORT;
+    entry.pid = thread_getpid();
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &entry);
+
+#ifdef MODULE_GNRC_SINGLE_THREAD
+    puts("GNRC single thread mode");
+    stack = GNRC_SINGLE_THREAD_STACK_SIZE;
+#else
+    puts("GNRC threaded mode");
+    stack = GNRC_IPV6_STACK_SIZE + GNRC_UDP_STACK_SIZE;
+#endif
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        gnrc_pktsnip_t *pkt = _build();
+        msg_t msg;
+
+        if (pkt == NULL) {
+            puts("unable to allocate packet");
+            return 1;
+        }
+
+        uint32_t start = xtimer_now();
+
+        if (!gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP,
+                                       GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+            puts("unable to send packet");
+            gnrc_pktbuf_release(pkt);
+            return 1;
+        }
+
+        msg_receive(&msg);
+
+        uint32_t latency = xtimer_now() - start;
+
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+            gnrc_pktbuf_release((gnrc_pktsnip_t *)msg.content.ptr);
+            received++;
+        }
+
+        latency_sum += latency;
+        if (latency > latency_max) {
+            latency_max = latency;
+        }
+    }
+
+    gnrc_netreg_unregister(GNRC_NETTYPE_UDP, &entry);
+
+    printf("received %u of %u packets\n", received, ROUNDS);
+    printf("latency: max %" PRIu32 " us, avg %" PRIu32 " us\n",
+           latency_max, latency_sum / ROUNDS);
+    printf("stack memory of the layers: %u bytes\n", (unsigned)stack);
+    ps();
+
+    if ((received != ROUNDS) || !_test_ndp()) {
+        puts("FAILED");
+        return 1;
+    }
+    puts("SUCCESS");
+
+    return 0;
+}
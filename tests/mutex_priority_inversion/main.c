@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Measures the worst case time a high priority thread is blocked
+ *          on a mutex held by a low priority thread while a medium priority
+ *          thread is busy
+ *
+ * The main thread (low priority) locks the mutex and wakes up the high
+ * priority thread, which blocks on the mutex. Then it wakes up the medium
+ * priority thread, which busy waits for BUSY_US. Without priority
+ * inheritance the medium priority thread preempts the mutex owner, so the
+ * high priority thread is blocked for about WORK_US + BUSY_US. With
+ * priority inheritance it is blocked for about WORK_US only.
+ *
+ * The test is run a second time with main holding an inner mutex as well,
+ * which it unlocks right after waking up the other threads. Unlocking the
+ * inner mutex must not drop the priority inherited through the outer one.
+ *
+ * Finally main sleeps a few times with xtimer_usleep(), which blocks on a
+ * mutex on its stack that the timer unlocks. No mutex may be left recorded
+ * as held by main afterwards.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "thread.h"
+#include "mutex.h"
+#include "sched.h"
+#include "tcb.h"
+#include "xtimer.h"
+
+#define ROUNDS      (10U)
+#define WORK_US     (1000U)     /**< time the mutex is held by main */
+#define BUSY_US     (10000U)    /**< time the medium priority thread is busy */
+
+static mutex_t mutex = MUTEX_INIT;
+static mutex_t inner = MUTEX_INIT;
+static char high_stack[THREAD_STACKSIZE_MAIN];
+static char medium_stack[THREAD_STACKSIZE_MAIN];
+static uint32_t blocked_max;
+static uint32_t blocked_sum;
+
+static void spin(uint32_t us)
+{
+    uint32_t start = xtimer_now();
+
+    while ((xtimer_now() - start) < us) {}
+}
+
+static void *high(void *arg)
+{
+    (void) arg;
+
+    while (1) {
+        uint32_t start = xtimer_now();
+
+        mutex_lock(&mutex);
+        uint32_t blocked = xtimer_now() - start;
+        mutex_unlock(&mutex);
+
+        blocked_sum += blocked;
+        if (blocked > blocked_max) {
+            blocked_max = blocked;
+        }
+
+        thread_sleep();
+    }
+
+    return NULL;
+}
+
+static void *medium(void *arg)
+{
+    (void) arg;
+
+    while (1) {
+        spin(BUSY_US);
+        thread_sleep();
+    }
+
+    return NULL;
+}
+
+static kernel_pid_t high_pid;
+static kernel_pid_t medium_pid;
+
+static void run(int nested)
+{
+    blocked_max = 0;
+    blocked_sum = 0;
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        mutex_lock(&mutex);
+        if (nested) {
+            mutex_lock(&inner);
+        }
+        /* high blocks on the mutex right away */
+        thread_wakeup(high_pid);
+        /* medium preempts us, unless we inherited the priority of high */
+        thread_wakeup(medium_pid);
+        if (nested) {
+            /* we still hold the mutex high waits for */
+            mutex_unlock(&inner);
+        }
+        spin(WORK_US);
+        mutex_unlock(&mutex);
+
+        /* both other threads have a higher priority and are sleeping again
+         * when we get here */
+    }
+
+    printf("%s: blocked %u rounds: max %" PRIu32 " us, avg %" PRIu32 " us\n",
+           nested ? "nested" : "single", ROUNDS, blocked_max, blocked_sum / ROUNDS);
+}
+
+static int sleep_test(void)
+{
+    /* every call uses the same stack address for its mutex, the short
+     * sleeps let the timer fire before the second lock */
+    for (unsigned i = 0; i < 3; i++) {
+        xtimer_usleep(WORK_US);
+        xtimer_usleep(1);
+    }
+    puts("sleep: done");
+
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    tcb_t *me = (tcb_t *) sched_active_thread;
+
+    if (me->mutexes || (me->priority != me->base_priority)) {
+        puts("sleep: mutexes left held by main");
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+int main(void)
+{
+    uint32_t single_max;
+    int sleep_ok;
+
+    puts("Priority inversion test");
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    puts("priority inheritance: enabled");
+#else
+    puts("priority inheritance: disabled");
+#endif
+
+    high_pid = thread_create(high_stack, sizeof(high_stack),
+                             THREAD_PRIORITY_MAIN - 2,
+                             CREATE_SLEEPING | CREATE_STACKTEST,
+                             high, NULL, "high");
+    medium_pid = thread_create(medium_stack, sizeof(medium_stack),
+                               THREAD_PRIORITY_MAIN - 1,
+                               CREATE_SLEEPING | CREATE_STACKTEST,
+                               medium, NULL, "medium");
+
+    run(0);
+    single_max = blocked_max;
+    run(1);
+    sleep_ok = sleep_test();
+
+#ifdef MODULE_MUTEX_PRIORITY_INHERITANCE
+    puts(((single_max < BUSY_US) && (blocked_max < BUSY_US) && sleep_ok)
+         ? "SUCCESS" : "FAILURE");
+#else
+    puts(((single_max >= BUSY_US) && (blocked_max >= BUSY_US) && sleep_ok)
+         ? "priority inversion occurred, as expected"
+         : "no priority inversion occurred");
+#endif
+
+    return 0;
+}
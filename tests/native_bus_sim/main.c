@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Bus usage of drivers on the simulated SPI and I2C buses
+ *
+ * Runs the lis3dh driver against a register model and compares per-register
+ * I2C accesses with a burst read of the same registers.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "lis3dh.h"
+#include "native_bus.h"
+#include "periph/i2c.h"
+#include "periph/spi.h"
+
+#define LIS3DH_CS       (0)
+#define LIS3DH_INT1     (1)
+#define LIS3DH_INT2     (2)
+#define SAMPLES         (100U)
+
+#define I2C_ADDR        (0x1d)
+#define I2C_REGS        (6U)
+
+static uint8_t lis3dh_regs[0x40];
+static native_spi_regmap_t lis3dh_model;
+
+static uint8_t i2c_regs[0x20];
+static native_i2c_regmap_t i2c_model;
+
+/* the value lis3dh_read_xyz() reports for the little endian sample at @p reg,
+ * scaled from the +/- 2 g range to milli-G */
+static int16_t lis3dh_expected(unsigned int reg)
+{
+    int16_t raw = (int16_t)(lis3dh_regs[reg] | (lis3dh_regs[reg + 1] << 8));
+
+    return (int16_t)((int32_t)raw * 2000 / 32768);
+}
+
+static void print_stats(const char *name, const native_bus_stats_t *stats,
+                        unsigned int ops)
+{
+    printf("%-24s %5u transactions %6u bytes %8u us bus time "
+           "(%u.%02u transactions/op)\n", name,
+           (unsigned)stats->transactions, (unsigned)stats->bytes,
+           (unsigned)(stats->bus_time / 1000),
+           (unsigned)(stats->transactions / ops),
+           (unsigned)((stats->transactions * 100 / ops) % 100));
+}
+
+int main(void)
+{
+    lis3dh_t dev;
+    lis3dh_data_t data;
+    char buf[I2C_REGS];
+
+    puts("Native bus simulation test\n");
+
+    /* lis3dh: bit 7 selects a read, bit 6 the address auto increment */
+    lis3dh_regs[LIS3DH_REG_WHO_AM_I] = LIS3DH_WHO_AM_I_RESPONSE;
+    for (unsigned int i = 0; i < sizeof(lis3dh_data_t); i++) {
+        lis3dh_regs[LIS3DH_REG_OUT_X_L + i] = i * 16;
+    }
+    native_spi_regmap_init(&lis3dh_model, LIS3DH_CS, lis3dh_regs,
+                           sizeof(lis3dh_regs), 0x80, 0x40);
+    native_spi_attach(SPI_0, &lis3dh_model.dev);
+
+    spi_init_master(SPI_0, SPI_CONF_FIRST_RISING, SPI_SPEED_10MHZ);
+    native_spi_stats_reset(SPI_0);
+    if (lis3dh_init(&dev, SPI_0, LIS3DH_CS, LIS3DH_INT1, LIS3DH_INT2,
+                   LIS3DH_SCALE_2G) < 0) {
+        puts("[FAILED] lis3dh_init");
+        return 1;
+    }
+    print_stats("lis3dh_init", native_spi_stats(SPI_0), 1);
+
+    native_spi_stats_reset(SPI_0);
+    for (unsigned int i = 0; i < SAMPLES; i++) {
+        if (lis3dh_read_xyz(&dev, &data) < 0) {
+            puts("[FAILED] lis3dh_read_xyz");
+            return 1;
+        }
+    }
+    print_stats("lis3dh_read_xyz", native_spi_stats(SPI_0), SAMPLES);
+
+    if (data.acc_x != lis3dh_expected(LIS3DH_REG_OUT_X_L) ||
+        data.acc_y != lis3dh_expected(LIS3DH_REG_OUT_Y_L) ||
+        data.acc_z != lis3dh_expected(LIS3DH_REG_OUT_Z_L)) {
+        puts("[FAILED] lis3dh sample values");
+        return 1;
+    }
+
+    /* the same registers behind an I2C register pointer */
+    for (unsigned int i = 0; i < I2C_REGS; i++) {
+        i2c_regs[i] = i;
+    }
+    native_i2c_regmap_init(&i2c_model, I2C_ADDR, i2c_regs, sizeof(i2c_regs));
+    native_i2c_attach(I2C_0, &i2c_model.dev);
+    i2c_init_master(I2C_0, I2C_SPEED_FAST);
+
+    native_i2c_stats_reset(I2C_0);
+    for (unsigned int i = 0; i < SAMPLES; i++) {
+        for (unsigned int reg = 0; reg < I2C_REGS; reg++) {
+            i2c_read_reg(I2C_0, I2C_ADDR, reg, &buf[reg]);
+        }
+    }
+    print_stats("i2c_read_reg", native_i2c_stats(I2C_0), SAMPLES);
+
+    native_i2c_stats_reset(I2C_0);
+    for (unsigned int i = 0; i < SAMPLES; i++) {
+        if (i2c_read_regs(I2C_0, I2C_ADDR, 0, buf, I2C_REGS) != I2C_REGS) {
+            puts("[FAILED] i2c_read_regs");
+            return 1;
+        }
+    }
+    print_stats("i2c_read_regs", native_i2c_stats(I2C_0), SAMPLES);
+
+    for (unsigned int i = 0; i < I2C_REGS; i++) {
+        if (buf[i] != (char)i) {
+            puts("[FAILED] i2c register contents");
+            return 1;
+        }
+    }
+    if (i2c_read_byte(I2C_0, I2C_ADDR + 1, buf) != -2) {
+        puts("[FAILED] unknown address was acknowledged");
+        return 1;
+    }
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
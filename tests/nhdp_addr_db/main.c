@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for NHDP's central address storage
+ *
+ * Simulates the address storage accesses of HELLO processing in a dense
+ * neighborhood: every neighbor advertises its own address and the addresses
+ * of all other neighbors. Each advertised address is looked up in the central
+ * address storage and released again at the end of the HELLO, as done by
+ * the NHDP reader. Finally a HELLO with more addresses than the storage can
+ * hold is processed, it has to fail without leaking addresses.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "xtimer.h"
+#include "nhdp.h"
+#include "nhdp_address.h"
+
+#define ROUNDS          (10)
+#define ADDR_SIZE       (16)
+
+static const unsigned neighbor_counts[] = { 10, 50, 200 };
+
+static void make_addr(uint8_t *addr, unsigned neighbor)
+{
+    /* link-local IPv6 address with a neighbor specific interface identifier */
+    memset(addr, 0, ADDR_SIZE);
+    addr[0] = 0xfe;
+    addr[1] = 0x80;
+    addr[14] = (uint8_t)(neighbor >> 8);
+    addr[15] = (uint8_t)neighbor;
+}
+
+static int process_hello(unsigned sender, unsigned neighbors)
+{
+    uint8_t addr[ADDR_SIZE];
+    nhdp_addr_t *nhdp_addr;
+
+    make_addr(addr, sender);
+    nhdp_addr = nhdp_addr_db_get_address(addr, ADDR_SIZE, AF_INET6);
+    if (!nhdp_addr) {
+        return -1;
+    }
+    nhdp_addr->in_tmp_table = NHDP_ADDR_TMP_SEND_LIST;
+
+    for (unsigned i = 0; i < neighbors; i++) {
+        if (i == sender) {
+            continue;
+        }
+        make_addr(addr, i);
+        nhdp_addr = nhdp_addr_db_get_address(addr, ADDR_SIZE, AF_INET6);
+        if (!nhdp_addr) {
+            /* storage full: drop the HELLO like the NHDP reader does */
+            nhdp_reset_addresses_tmp_usg(1);
+            return -1;
+        }
+        if (NHDP_ADDR_TMP_IN_ANY(nhdp_addr)) {
+            /* address already referenced by this HELLO */
+            nhdp_decrement_addr_usage(nhdp_addr);
+            continue;
+        }
+        nhdp_addr->in_tmp_table = NHDP_ADDR_TMP_TH_SYM_LIST;
+    }
+
+    /* end of HELLO: release all temporarily referenced addresses */
+    nhdp_reset_addresses_tmp_usg(1);
+
+    return 0;
+}
+
+int main(void)
+{
+    puts("NHDP address storage benchmark");
+
+    for (unsigned n = 0; n < sizeof(neighbor_counts) / sizeof(neighbor_counts[0]); n++) {
+        unsigned neighbors = neighbor_counts[n];
+        uint32_t start = xtimer_now();
+
+        for (unsigned round = 0; round < ROUNDS; round++) {
+            for (unsigned sender = 0; sender < neighbors; sender++) {
+                if (process_hello(sender, neighbors) < 0) {
+                    printf("%3u neighbors: address storage exhausted\n", neighbors);
+                    return 1;
+                }
+            }
+        }
+
+        uint32_t duration = xtimer_now() - start;
+        printf("%3u neighbors: %u HELLOs in %" PRIu32 " us (%" PRIu32 " us/HELLO)\n",
+               neighbors, neighbors * ROUNDS, duration, duration / (neighbors * ROUNDS));
+
+        if (nhdp_get_addr_db_head() != NULL) {
+            puts("error: addresses leaked in central storage");
+            return 1;
+        }
+    }
+
+    if (process_hello(0, NHDP_ADDR_POOL_SIZE + 1) == 0) {
+        puts("error: storage did not run full");
+        return 1;
+    }
+    if (nhdp_get_addr_db_head() != NULL) {
+        puts("error: addresses leaked after dropping a HELLO");
+        return 1;
+    }
+    if (process_hello(0, NHDP_ADDR_POOL_SIZE) < 0) {
+        puts("error: storage unusable after running full");
+        return 1;
+    }
+    puts("full storage: HELLO dropped without leaking addresses");
+
+    puts("done");
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Bus usage of the NVRAM cache on the simulated SPI bus
+ *
+ * A log of small records is appended to a simulated SPI EEPROM and read back,
+ * once through nvram_spi directly and once through the cache. The model
+ * counts writes crossing a page boundary, which a real EEPROM would wrap
+ * around inside the page.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "native_bus.h"
+#include "nvram-spi.h"
+#include "nvram-cache.h"
+#include "periph/spi.h"
+
+#define NVRAM_CS        (0)
+#define NVRAM_SIZE      (4096U)
+#define NVRAM_PAGE      (64U)
+#define READ_SIZE       (128U)
+#define FLUSH_US        (10000U)
+#define RECORDS         (200U)
+#define RECORD_SIZE     (6U)
+#define MSG_QUEUE_SIZE  (4U)
+
+#define CMD_WRITE       (0x02)
+#define CMD_READ        (0x03)
+#define CMD_WREN        (0x06)
+
+/**
+ * @brief SPI EEPROM with two address bytes
+ */
+typedef struct {
+    native_spi_dev_t dev;       /**< SPI device, has to be first */
+    uint8_t mem[NVRAM_SIZE];    /**< memory contents */
+    uint8_t cmd;                /**< command of the transaction */
+    uint8_t pos;                /**< bytes received in the transaction */
+    uint8_t wel;                /**< write enable latch */
+    uint16_t start;             /**< first address of the transaction */
+    uint16_t addr;              /**< current address */
+    unsigned crossings;         /**< writes that crossed a page boundary */
+} eeprom_t;
+
+static eeprom_t eeprom;
+static msg_t _msg_q[MSG_QUEUE_SIZE];
+static uint8_t page_buf[NVRAM_PAGE];
+static uint8_t read_buf[READ_SIZE];
+
+static void _select(native_spi_dev_t *dev)
+{
+    eeprom_t *mem = (eeprom_t *)dev;
+
+    mem->pos = 0;
+    mem->addr = 0;
+}
+
+static uint8_t _transfer(native_spi_dev_t *dev, uint8_t mosi)
+{
+    eeprom_t *mem = (eeprom_t *)dev;
+    uint8_t miso = 0xff;
+
+    if (mem->pos < 3) {
+        if (mem->pos == 0) {
+            mem->cmd = mosi;
+            if (mosi == CMD_WREN) {
+                mem->wel = 1;
+            }
+        }
+        else {
+            mem->addr = (mem->addr << 8) | mosi;
+            mem->start = mem->addr;
+        }
+        mem->pos++;
+        return 0;
+    }
+    if (mem->cmd == CMD_READ) {
+        miso = mem->mem[mem->addr % NVRAM_SIZE];
+    }
+    else if ((mem->cmd == CMD_WRITE) && mem->wel) {
+        if ((mem->addr / NVRAM_PAGE) != (mem->start / NVRAM_PAGE)) {
+            /* count every write only once */
+            mem->crossings++;
+            mem->start = mem->addr;
+        }
+        mem->mem[mem->addr % NVRAM_SIZE] = mosi;
+    }
+    mem->addr++;
+    return miso;
+}
+
+static void _deselect(native_spi_dev_t *dev)
+{
+    eeprom_t *mem = (eeprom_t *)dev;
+
+    if (mem->cmd == CMD_WRITE) {
+        mem->wel = 0;
+    }
+}
+
+static void print_stats(const char *name, const native_bus_stats_t *stats)
+{
+    printf("%-8s %5u transactions %6u bytes %8u us bus time\n", name,
+           (unsigned)stats->transactions, (unsigned)stats->bytes,
+           (unsigned)(stats->bus_time / 1000));
+}
+
+/* append records and read them back, returns 0 if the data matches */
+static int run(nvram_t *dev)
+{
+    uint8_t record[RECORD_SIZE];
+
+    for (unsigned i = 0; i < RECORDS; i++) {
+        memset(record, i, sizeof(record));
+        if (dev->write(dev, record, i * RECORD_SIZE, sizeof(record)) < 0) {
+            return -1;
+        }
+    }
+    for (unsigned i = 0; i < RECORDS; i++) {
+        if (dev->read(dev, record, i * RECORD_SIZE, sizeof(record)) < 0) {
+            return -1;
+        }
+        for (unsigned j = 0; j < RECORD_SIZE; j++) {
+            if (record[j] != (uint8_t)i) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    nvram_spi_params_t spi_params = { SPI_0, NVRAM_CS, 2 };
+    nvram_cache_params_t cache_params = {
+        .page_buf = page_buf,
+        .page_size = sizeof(page_buf),
+        .read_buf = read_buf,
+        .read_size = sizeof(read_buf),
+        .flush_us = FLUSH_US,
+    };
+    native_bus_stats_t direct;
+    nvram_cache_t cache;
+    nvram_t spi, cached;
+    msg_t msg;
+
+    puts("NVRAM cache test\n");
+    msg_init_queue(_msg_q, MSG_QUEUE_SIZE);
+
+    eeprom.dev.cs = NVRAM_CS;
+    eeprom.dev.select = _select;
+    eeprom.dev.transfer = _transfer;
+    eeprom.dev.deselect = _deselect;
+    native_spi_attach(SPI_0, &eeprom.dev);
+    spi_init_master(SPI_0, SPI_CONF_FIRST_RISING, SPI_SPEED_10MHZ);
+    nvram_spi_init(&spi, &spi_params, NVRAM_SIZE);
+
+    native_spi_stats_reset(SPI_0);
+    if (run(&spi) < 0) {
+        puts("[FAILED] nvram_spi contents");
+        return 1;
+    }
+    direct = *native_spi_stats(SPI_0);
+    print_stats("direct", &direct);
+    printf("         %u writes crossed a page\n", eeprom.crossings);
+
+    memset(eeprom.mem, 0, sizeof(eeprom.mem));
+    eeprom.crossings = 0;
+    cache_params.dev = &spi;
+    cache_params.flush_pid = thread_getpid();
+    nvram_cache_init(&cached, &cache, &cache_params);
+
+    native_spi_stats_reset(SPI_0);
+    if (run(&cached) < 0) {
+        puts("[FAILED] nvram_cache contents");
+        return 1;
+    }
+    /* the pending data is written on the flush message */
+    msg_receive(&msg);
+    if ((msg.type != NVRAM_CACHE_MSG_TYPE_FLUSH) ||
+        (nvram_cache_flush((nvram_t *)msg.content.ptr) <= 0)) {
+        puts("[FAILED] no pending data on flush message");
+        return 1;
+    }
+    print_stats("cached", native_spi_stats(SPI_0));
+    printf("         %u writes crossed a page\n", eeprom.crossings);
+    printf("         %u/%u writes merged, %u/%u reads from prefetch, "
+           "%u device writes, %u device reads\n",
+           (unsigned)cache.stats.write_merges, (unsigned)cache.stats.writes,
+           (unsigned)cache.stats.read_hits, (unsigned)cache.stats.reads,
+           (unsigned)cache.stats.dev_writes, (unsigned)cache.stats.dev_reads);
+
+    for (unsigned i = 0; i < RECORDS * RECORD_SIZE; i++) {
+        if (eeprom.mem[i] != (uint8_t)(i / RECORD_SIZE)) {
+            puts("[FAILED] device contents");
+            return 1;
+        }
+    }
+    if ((eeprom.crossings > 0) ||
+        (native_spi_stats(SPI_0)->bytes >= direct.bytes)) {
+        puts("[FAILED]");
+        return 1;
+    }
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
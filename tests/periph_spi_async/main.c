@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for more
+ * details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Compares blocking and asynchronous SPI transfers
+ *
+ * A frame of 127 bytes is transferred blocking, asynchronously and as a
+ * scatter/gather transfer. For the asynchronous transfer, the number of loop
+ * iterations the CPU could do while the transfer was running is printed.
+ *
+ * MISO has to be connected to MOSI, the simulated bus on native loops back
+ * by itself.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "periph/spi.h"
+#include "xtimer.h"
+
+#define TEST_SPI        (SPI_0)
+#define TEST_SPEED      (SPI_SPEED_1MHZ)
+#define FRAME_LEN       (127U)
+
+static char out[FRAME_LEN];
+static char in[FRAME_LEN];
+static volatile int done;
+static volatile int result;
+
+static void _done(void *arg, int res)
+{
+    (void)arg;
+    result = res;
+    done = 1;
+}
+
+static int _check(const char *name, int res, uint32_t time)
+{
+    int ok = (res == (int)FRAME_LEN) && (memcmp(in, out, FRAME_LEN) == 0);
+
+    printf("%-8s %3i bytes in %6" PRIu32 " us: %s\n", name, res, time,
+           ok ? "ok" : "loopback mismatch");
+    memset(in, 0, sizeof(in));
+    return ok;
+}
+
+int main(void)
+{
+    int ok = 1;
+    uint32_t start;
+
+    puts("SPI async transfer test");
+
+    for (unsigned i = 0; i < FRAME_LEN; i++) {
+        out[i] = (char)i;
+    }
+    if (spi_init_master(TEST_SPI, SPI_CONF_FIRST_RISING, TEST_SPEED) < 0) {
+        puts("error: unable to initialize SPI");
+        return 1;
+    }
+
+    spi_acquire(TEST_SPI);
+
+    start = xtimer_now();
+    int res = spi_transfer_bytes(TEST_SPI, out, in, FRAME_LEN);
+    ok &= _check("blocking", res, xtimer_now() - start);
+
+    /* command bytes and payload, as used for radio frame buffers */
+    spi_xfer_t xfers[] = {
+        { .out = out, .in = in, .length = 2 },
+        { .out = out + 2, .in = in + 2, .length = FRAME_LEN - 2 },
+    };
+    unsigned long idle = 0;
+    done = 0;
+    start = xtimer_now();
+    if (spi_transfer_async(TEST_SPI, xfers, 2, _done, NULL) < 0) {
+        puts("error: unable to start async transfer");
+        return 1;
+    }
+    while (!done) {
+        idle++;
+    }
+    ok &= _check("async", result, xtimer_now() - start);
+    printf("%-8s %lu loop iterations while waiting\n", "", idle);
+
+    start = xtimer_now();
+    res = spi_transfer_sg(TEST_SPI, xfers, 2);
+    ok &= _check("sg", res, xtimer_now() - start);
+
+    spi_release(TEST_SPI);
+
+    puts(ok ? "[SUCCESS]" : "[FAILED]");
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Compares the wake-up latency of thread flags with an empty msg_t
+ *
+ * A high priority thread waits for a wake-up signal, which is sent either
+ * from a timer callback (interrupt context) or from the main thread. The
+ * time from sending the signal until the waiting thread runs is measured.
+ *
+ * Finally a burst of signals is sent from interrupt context to show that
+ * messages get lost once the message queue is full, while flags can not.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "thread.h"
+#include "thread_flags.h"
+#include "msg.h"
+#include "xtimer.h"
+
+#define ROUNDS          (1000U)
+#define DELAY_US        (100U)      /**< timer offset for the ISR signal */
+#define QUEUE_SIZE      (4U)
+#define BURST           (2 * QUEUE_SIZE)
+#define FLAG_EVENT      (0x0001)
+
+typedef enum {
+    SIGNAL_MSG,
+    SIGNAL_FLAGS,
+} signal_t;
+
+static char waiter_stack[THREAD_STACKSIZE_MAIN];
+static msg_t waiter_queue[QUEUE_SIZE];
+static kernel_pid_t waiter_pid;
+static volatile signal_t mode;
+static volatile uint32_t sent;
+static uint32_t latency_max;
+static uint32_t latency_sum;
+static unsigned lost;
+
+static void send_signal(signal_t s)
+{
+    if (s == SIGNAL_MSG) {
+        msg_t m;
+
+        if (msg_try_send(&m, waiter_pid) != 1) {
+            lost++;
+        }
+    }
+    else {
+        thread_flags_set(waiter_pid, FLAG_EVENT);
+    }
+}
+
+static void timer_cb(void *arg)
+{
+    (void) arg;
+
+    sent = xtimer_now();
+    send_signal(mode);
+}
+
+static void burst_cb(void *arg)
+{
+    (void) arg;
+
+    for (unsigned i = 0; i < BURST; i++) {
+        send_signal(mode);
+    }
+}
+
+static void *waiter(void *arg)
+{
+    (void) arg;
+
+    msg_init_queue(waiter_queue, QUEUE_SIZE);
+
+    while (1) {
+        if (mode == SIGNAL_MSG) {
+            msg_t m;
+            msg_receive(&m);
+        }
+        else {
+            thread_flags_wait_any(FLAG_EVENT);
+        }
+
+        uint32_t latency = xtimer_now() - sent;
+
+        latency_sum += latency;
+        if (latency > latency_max) {
+            latency_max = latency;
+        }
+    }
+
+    return NULL;
+}
+
+static void reset(signal_t m)
+{
+    signal_t old = mode;
+
+    mode = m;
+    if (old != m) {
+        /* the waiter still waits for the old signal */
+        send_signal(old);
+    }
+
+    latency_max = 0;
+    latency_sum = 0;
+    lost = 0;
+}
+
+static void print_result(const char *name)
+{
+    printf("%-12s max %4" PRIu32 " us, avg %4" PRIu32 " us\n", name,
+           latency_max, latency_sum / ROUNDS);
+}
+
+static void run(signal_t m, const char *name)
+{
+    xtimer_t timer;
+
+    timer.callback = timer_cb;
+    timer.arg = NULL;
+
+    reset(m);
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        xtimer_set(&timer, DELAY_US);
+        xtimer_usleep(2 * DELAY_US);
+    }
+    printf("isr    ");
+    print_result(name);
+
+    reset(m);
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        sent = xtimer_now();
+        /* the waiter has a higher priority and runs right away */
+        send_signal(m);
+    }
+    printf("thread ");
+    print_result(name);
+}
+
+static void run_burst(signal_t m, const char *name)
+{
+    xtimer_t timer;
+
+    timer.callback = burst_cb;
+    timer.arg = NULL;
+
+    reset(m);
+    xtimer_set(&timer, DELAY_US);
+    xtimer_usleep(2 * DELAY_US);
+
+    printf("burst of %u %-12s lost %u\n", (unsigned)BURST, name, lost);
+}
+
+int main(void)
+{
+    puts("Thread flags wake-up latency test");
+
+    waiter_pid = thread_create(waiter_stack, sizeof(waiter_stack),
+                               THREAD_PRIORITY_MAIN - 1, CREATE_STACKTEST,
+                               waiter, NULL, "waiter");
+
+    run(SIGNAL_MSG, "msg");
+    run(SIGNAL_FLAGS, "thread flags");
+
+    run_burst(SIGNAL_MSG, "msg");
+    run_burst(SIGNAL_FLAGS, "thread flags");
+
+    puts("done");
+
+    return 0;
+}
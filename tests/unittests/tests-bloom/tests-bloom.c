@@ -23,6 +23,13 @@
 #define TESTS_BLOOM_NOT_IN_FILTER (996)
 #define TESTS_BLOOM_FALSE_POS_RATE_THR (0.005)
 
+#define TESTS_BLOOM_BLOCKED_BITS (2 * BLOOM_BLOCK_BITS)
+#define TESTS_BLOOM_COUNTING_SIZE (256)
+#define TESTS_BLOOM_K (6)
+/* A contains two elements of B, so two hits are not false positives */
+#define TESTS_BLOOM_BLOCKED_PROB_IN_FILTER (2)
+#define TESTS_BLOOM_COUNTING_PROB_IN_FILTER (3)
+
 static bloom_t bloom;
 BITFIELD(bf, TESTS_BLOOM_BITS);
 hashfp_t hashes[TESTS_BLOOM_HASHF] = {
@@ -34,6 +41,12 @@ hashfp_t hashes[TESTS_BLOOM_HASHF] = {
                      (hashfp_t) dek_hash,
                     };
 
+static bloom_blocked_t bloom_blocked;
+BITFIELD(bf_blocked, TESTS_BLOOM_BLOCKED_BITS);
+
+static bloom_counting_t bloom_counting;
+static uint8_t counters[BLOOM_COUNTING_BYTES(TESTS_BLOOM_COUNTING_SIZE)];
+
 static void load_dictionary_fixture(void)
 {
     for (int i = 0; i < lenB; i++)
@@ -46,11 +59,17 @@ static void load_dictionary_fixture(void)
 static void set_up_bloom(void)
 {
     bloom_init(&bloom, TESTS_BLOOM_BITS, bf, hashes, TESTS_BLOOM_HASHF);
+    bloom_blocked_init(&bloom_blocked, TESTS_BLOOM_BLOCKED_BITS, bf_blocked,
+                       fnv1a_64_hash, TESTS_BLOOM_K);
+    bloom_counting_init(&bloom_counting, TESTS_BLOOM_COUNTING_SIZE, counters,
+                        fnv1a_64_hash, TESTS_BLOOM_K);
 }
 
 static void tear_down_bloom(void)
 {
     bloom_del(&bloom);
+    bloom_blocked_del(&bloom_blocked);
+    bloom_counting_del(&bloom_counting);
 }
 
 static void test_bloom_parameters_bytes_hashf(void)
@@ -85,11 +104,77 @@ static void test_bloom_based_on_dictionary_fixture(void)
     TEST_ASSERT(false_positive_rate < TESTS_BLOOM_FALSE_POS_RATE_THR);
 }
 
+static void test_bloom_blocked_based_on_dictionary_fixture(void)
+{
+    int in = 0;
+
+    TEST_ASSERT_EQUAL_INT(2, bloom_blocked.blocks);
+
+    for (int i = 0; i < lenB; i++) {
+        bloom_blocked_add(&bloom_blocked, (const uint8_t *) B[i], strlen(B[i]));
+    }
+
+    for (int i = 0; i < lenB; i++) {
+        TEST_ASSERT(bloom_blocked_check(&bloom_blocked, (const uint8_t *) B[i],
+                                        strlen(B[i])));
+    }
+
+    for (int i = 0; i < lenA; i++) {
+        if (bloom_blocked_check(&bloom_blocked, (const uint8_t *) A[i], strlen(A[i]))) {
+            in++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(TESTS_BLOOM_BLOCKED_PROB_IN_FILTER, in);
+    TEST_ASSERT((double) in / (double) lenA < TESTS_BLOOM_FALSE_POS_RATE_THR);
+}
+
+static void test_bloom_counting_add_remove(void)
+{
+    int in = 0;
+
+    for (int i = 0; i < lenB; i++) {
+        bloom_counting_add(&bloom_counting, (const uint8_t *) B[i], strlen(B[i]));
+    }
+
+    for (int i = 0; i < lenA; i++) {
+        if (bloom_counting_check(&bloom_counting, (const uint8_t *) A[i], strlen(A[i]))) {
+            in++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(TESTS_BLOOM_COUNTING_PROB_IN_FILTER, in);
+
+    /* remove every other element, the rest must still be found */
+    for (int i = 0; i < lenB; i += 2) {
+        TEST_ASSERT(bloom_counting_remove(&bloom_counting, (const uint8_t *) B[i],
+                                          strlen(B[i])));
+    }
+
+    for (int i = 1; i < lenB; i += 2) {
+        TEST_ASSERT(bloom_counting_check(&bloom_counting, (const uint8_t *) B[i],
+                                         strlen(B[i])));
+    }
+
+    for (int i = 1; i < lenB; i += 2) {
+        TEST_ASSERT(bloom_counting_remove(&bloom_counting, (const uint8_t *) B[i],
+                                          strlen(B[i])));
+    }
+
+    /* the filter is empty again */
+    for (size_t i = 0; i < sizeof(counters); i++) {
+        TEST_ASSERT_EQUAL_INT(0, counters[i]);
+    }
+    TEST_ASSERT(!bloom_counting_remove(&bloom_counting, (const uint8_t *) B[0],
+                                       strlen(B[0])));
+}
+
 Test *tests_bloom_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_bloom_parameters_bytes_hashf),
         new_TestFixture(test_bloom_based_on_dictionary_fixture),
+        new_TestFixture(test_bloom_blocked_based_on_dictionary_fixture),
+        new_TestFixture(test_bloom_counting_add_remove),
     };
 
     EMB_UNIT_TESTCALLER(bloom_tests, set_up_bloom, tear_down_bloom, fixtures);
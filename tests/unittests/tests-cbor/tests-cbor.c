@@ -18,13 +18,13 @@
 #include "bitarithm.h"
 #include "cbor.h"
 
+#include <errno.h>
 #include <float.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
-#include <inttypes.h>
 #ifndef CBOR_NO_CTIME
 #include <time.h>
 #endif /* CBOR_NO_CTIME */
@@ -687,6 +687,376 @@ static void test_double_invalid(void)
 }
 #endif /* CBOR_NO_FLOAT */
 
+/**
+ * Chunk callback handing out @p chunk_data in slices of CHUNK_SIZE bytes
+ */
+#define CHUNK_SIZE (3)
+
+static unsigned char chunk_data[sizeof(stream_data)];
+static unsigned chunk_count;
+
+static int next_chunk(cbor_writer_t *writer)
+{
+    size_t offset = writer->total + writer->pos;
+
+    if (offset + CHUNK_SIZE > sizeof(chunk_data)) {
+        return -1;
+    }
+
+    writer->data = &chunk_data[offset];
+    writer->size = CHUNK_SIZE;
+    chunk_count++;
+    return 0;
+}
+
+static void serialize_sample(cbor_stream_t *s)
+{
+    cbor_serialize_map(s, 3);
+    cbor_serialize_int(s, 1);
+    cbor_serialize_uint64_t(s, 0x100000000llu);
+    cbor_serialize_int(s, 2);
+    cbor_serialize_int64_t(s, -500);
+    cbor_serialize_int(s, 3);
+    cbor_serialize_array_indefinite(s);
+    cbor_serialize_bool(s, true);
+    cbor_serialize_byte_string(s, "abc");
+    cbor_serialize_unicode_string(s, "Hello, world!");
+    cbor_write_break(s);
+}
+
+static void write_sample(cbor_writer_t *w)
+{
+    TEST_ASSERT_EQUAL_INT(1, cbor_write_map(w, 3));
+    TEST_ASSERT_EQUAL_INT(1, cbor_write_uint64_t(w, 1));
+    TEST_ASSERT_EQUAL_INT(9, cbor_write_uint64_t(w, 0x100000000llu));
+    TEST_ASSERT_EQUAL_INT(1, cbor_write_uint64_t(w, 2));
+    TEST_ASSERT_EQUAL_INT(3, cbor_write_int64_t(w, -500));
+    TEST_ASSERT_EQUAL_INT(1, cbor_write_uint64_t(w, 3));
+    TEST_ASSERT_EQUAL_INT(1, cbor_write_array_indefinite(w));
+    TEST_ASSERT_EQUAL_INT(1, cbor_write_bool(w, true));
+    TEST_ASSERT_EQUAL_INT(4, cbor_write_byte_string(w, "abc", 3));
+    TEST_ASSERT_EQUAL_INT(14, cbor_write_unicode_string(w, "Hello, world!", 13));
+    TEST_ASSERT_EQUAL_INT(1, cbor_write_stream_break(w));
+}
+
+static void test_writer(void)
+{
+    unsigned char buffer[64];
+    cbor_writer_t writer;
+
+    serialize_sample(&stream);
+
+    /* single buffer */
+    cbor_writer_init(&writer, buffer, sizeof(buffer), NULL, NULL);
+    write_sample(&writer);
+    TEST_ASSERT_EQUAL_INT(stream.pos, cbor_writer_len(&writer));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(stream.data, buffer, stream.pos));
+
+    /* tiny chunks, items are split across chunk boundaries */
+    chunk_count = 0;
+    memset(chunk_data, 0, sizeof(chunk_data));
+    cbor_writer_init(&writer, chunk_data, CHUNK_SIZE, next_chunk, NULL);
+    write_sample(&writer);
+    TEST_ASSERT_EQUAL_INT(stream.pos, cbor_writer_len(&writer));
+    TEST_ASSERT_EQUAL_INT((stream.pos - 1) / CHUNK_SIZE, chunk_count);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(stream.data, chunk_data, stream.pos));
+}
+
+/**
+ * Chunk callback handing out empty chunks
+ */
+static int empty_chunk(cbor_writer_t *writer)
+{
+    writer->data = chunk_data;
+    writer->size = 0;
+    return 0;
+}
+
+static void test_writer_invalid(void)
+{
+    unsigned char buffer[4];
+    cbor_writer_t writer;
+
+    cbor_writer_init(&writer, NULL, 0, NULL, NULL);
+    TEST_ASSERT_EQUAL_INT(0, cbor_write_uint64_t(&writer, 0));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_len(&writer));
+
+    cbor_writer_init(&writer, buffer, sizeof(buffer), NULL, NULL);
+    TEST_ASSERT_EQUAL_INT(0, cbor_write_uint64_t(&writer, 0x100000000llu));
+    TEST_ASSERT_EQUAL_INT(0, cbor_write_byte_string(&writer, "abcd", 4));
+
+    /* must fail instead of requesting empty chunks forever */
+    cbor_writer_init(&writer, NULL, 0, empty_chunk, NULL);
+    TEST_ASSERT_EQUAL_INT(0, cbor_write_uint64_t(&writer, 0));
+}
+
+#ifdef MODULE_GNRC_PKTBUF
+static void test_pktbuf_writer(void)
+{
+    cbor_pktbuf_writer_t pw;
+    gnrc_pktsnip_t *pkt;
+    size_t len = 0;
+
+    serialize_sample(&stream);
+    gnrc_pktbuf_init();
+
+    /* items are split across snips, only the last snip is trimmed */
+    TEST_ASSERT_EQUAL_INT(0, cbor_pktbuf_writer_init(&pw, CHUNK_SIZE));
+    write_sample(&pw.writer);
+    TEST_ASSERT_EQUAL_INT(stream.pos, cbor_writer_len(&pw.writer));
+    pkt = cbor_pktbuf_writer_finish(&pw);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_EQUAL_INT((stream.pos + CHUNK_SIZE - 1) / CHUNK_SIZE, gnrc_pkt_count(pkt));
+    for (gnrc_pktsnip_t *snip = pkt; snip != NULL; snip = snip->next) {
+        if (snip->next) {
+            TEST_ASSERT_EQUAL_INT(CHUNK_SIZE, snip->size);
+        }
+        else {
+            TEST_ASSERT_EQUAL_INT((stream.pos - 1) % CHUNK_SIZE + 1, snip->size);
+        }
+        TEST_ASSERT_EQUAL_INT(0, memcmp(&stream.data[len], snip->data, snip->size));
+        len += snip->size;
+    }
+    TEST_ASSERT_EQUAL_INT(stream.pos, len);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+
+    /* data ending exactly on a snip boundary does not allocate another snip */
+    TEST_ASSERT_EQUAL_INT(0, cbor_pktbuf_writer_init(&pw, CHUNK_SIZE));
+    TEST_ASSERT_EQUAL_INT(2 * CHUNK_SIZE,
+                          cbor_write_byte_string(&pw.writer, "abcde", 2 * CHUNK_SIZE - 1));
+    pkt = cbor_pktbuf_writer_finish(&pw);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_EQUAL_INT(2, gnrc_pkt_count(pkt));
+    TEST_ASSERT_EQUAL_INT(CHUNK_SIZE, pkt->next->size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp("cde", pkt->next->data, CHUNK_SIZE));
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_pktbuf_writer_invalid(void)
+{
+    cbor_pktbuf_writer_t pw;
+
+    gnrc_pktbuf_init();
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, cbor_pktbuf_writer_init(&pw, 0));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+
+    /* nothing written */
+    TEST_ASSERT_EQUAL_INT(0, cbor_pktbuf_writer_init(&pw, CHUNK_SIZE));
+    TEST_ASSERT_NULL(cbor_pktbuf_writer_finish(&pw));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+#endif /* MODULE_GNRC_PKTBUF */
+
+static void test_reader(void)
+{
+    cbor_reader_t reader;
+    cbor_item_t item;
+
+    serialize_sample(&stream);
+    cbor_reader_init(&reader, stream.data, stream.pos);
+
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_MAP, item.type);
+    TEST_ASSERT_EQUAL_INT(3, item.value.uint);
+
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_UINT, item.type);
+    TEST_ASSERT_EQUAL_INT(1, item.value.uint);
+    TEST_ASSERT_EQUAL_INT(9, cbor_read_next(&reader, &item));
+    TEST_ASSERT(item.value.uint == 0x100000000llu);
+
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(3, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_NEGINT, item.type);
+    TEST_ASSERT(item.value.sint == -500);
+
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_ARRAY, item.type);
+    TEST_ASSERT(item.indefinite);
+
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_BOOL, item.type);
+    TEST_ASSERT(item.value.boolean);
+
+    /* strings are not copied, the item points into the input buffer */
+    TEST_ASSERT_EQUAL_INT(4, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_BYTES, item.type);
+    TEST_ASSERT(item.value.str.ptr == &stream.data[reader.pos - 3]);
+    TEST_ASSERT_EQUAL_INT(3, item.value.str.len);
+
+    TEST_ASSERT_EQUAL_INT(14, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_TEXT, item.type);
+    TEST_ASSERT_EQUAL_INT(0, memcmp("Hello, world!", item.value.str.ptr, 13));
+
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(CBOR_ITEM_BREAK, item.type);
+    TEST_ASSERT(cbor_reader_at_end(&reader));
+    TEST_ASSERT_EQUAL_INT(0, cbor_read_next(&reader, &item));
+}
+
+static void test_reader_invalid(void)
+{
+    cbor_reader_t reader;
+    cbor_item_t item;
+    /* truncated uint32, string longer than the input, reserved additional info */
+    unsigned char truncated[] = {0x1a, 0x00, 0x01};
+    unsigned char too_long[] = {0x45, 'a', 'b'};
+    unsigned char reserved[] = {0x1c};
+
+    cbor_reader_init(&reader, truncated, sizeof(truncated));
+    TEST_ASSERT_EQUAL_INT(0, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(0, reader.pos);
+
+    cbor_reader_init(&reader, too_long, sizeof(too_long));
+    TEST_ASSERT_EQUAL_INT(0, cbor_read_next(&reader, &item));
+
+    cbor_reader_init(&reader, reserved, sizeof(reserved));
+    TEST_ASSERT_EQUAL_INT(0, cbor_read_next(&reader, &item));
+}
+
+static void test_reader_skip(void)
+{
+    cbor_reader_t reader;
+    cbor_item_t item;
+
+    serialize_sample(&stream);
+    cbor_serialize_int(&stream, 7);
+
+    cbor_reader_init(&reader, stream.data, stream.pos);
+    TEST_ASSERT_EQUAL_INT(stream.pos - 1, cbor_read_skip(&reader));
+    TEST_ASSERT_EQUAL_INT(1, cbor_read_next(&reader, &item));
+    TEST_ASSERT_EQUAL_INT(7, item.value.uint);
+
+    /* an unterminated indefinite array can not be skipped */
+    cbor_reader_init(&reader, stream.data, stream.pos - 2);
+    TEST_ASSERT_EQUAL_INT(0, cbor_read_skip(&reader));
+    TEST_ASSERT_EQUAL_INT(0, reader.pos);
+}
+
+typedef struct {
+    uint16_t seq;
+    int32_t temp;
+    bool alarm;
+    char name[8];
+    uint8_t addr[4];
+    uint64_t uptime;
+} record_t;
+
+static const cbor_field_t record_fields[] = {
+    CBOR_FIELD(record_t, seq, CBOR_FIELD_UINT),
+    CBOR_FIELD(record_t, temp, CBOR_FIELD_INT),
+    CBOR_FIELD(record_t, alarm, CBOR_FIELD_BOOL),
+    CBOR_FIELD(record_t, name, CBOR_FIELD_TEXT),
+    CBOR_FIELD(record_t, addr, CBOR_FIELD_BYTES),
+    CBOR_FIELD(record_t, uptime, CBOR_FIELD_UINT),
+};
+
+static const cbor_schema_t record_schema = CBOR_SCHEMA(record_fields);
+
+static const record_t record = { 1000, -25, true, "node", { 1, 2, 3, 4 }, 0x100000000llu };
+
+static void serialize_record(cbor_stream_t *s, const record_t *r)
+{
+    cbor_serialize_map(s, 6);
+    cbor_serialize_unicode_string(s, "seq");
+    cbor_serialize_int(s, r->seq);
+    cbor_serialize_unicode_string(s, "temp");
+    cbor_serialize_int(s, r->temp);
+    cbor_serialize_unicode_string(s, "alarm");
+    cbor_serialize_bool(s, r->alarm);
+    cbor_serialize_unicode_string(s, "name");
+    cbor_serialize_unicode_string(s, r->name);
+    cbor_serialize_unicode_string(s, "addr");
+    cbor_serialize_byte_stringl(s, (const char *)r->addr, sizeof(r->addr));
+    cbor_serialize_unicode_string(s, "uptime");
+    cbor_serialize_uint64_t(s, r->uptime);
+}
+
+static void test_struct(void)
+{
+    unsigned char data[64];
+    cbor_stream_t expected = {data, sizeof(data), 0};
+    record_t out;
+
+    serialize_record(&expected, &record);
+
+    TEST_ASSERT_EQUAL_INT(expected.pos, cbor_serialize_struct(&stream, &record_schema, &record));
+    CBOR_CHECK_SERIALIZED(stream, data, expected.pos);
+    /* temp and name are encoded 3 bytes shorter than their maximum each */
+    TEST_ASSERT_EQUAL_INT(expected.pos + 6, cbor_struct_max_size(&record_schema));
+
+    memset(&out, 0, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(stream.pos, cbor_deserialize_struct(&stream, 0, &record_schema, &out));
+    TEST_ASSERT_EQUAL_INT(record.seq, out.seq);
+    TEST_ASSERT_EQUAL_INT(record.temp, out.temp);
+    TEST_ASSERT(out.alarm);
+    TEST_ASSERT_EQUAL_STRING((const char *)record.name, (const char *)out.name);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(record.addr, out.addr, sizeof(out.addr)));
+    TEST_ASSERT(record.uptime == out.uptime);
+}
+
+static void test_struct_unknown_keys(void)
+{
+    record_t out;
+
+    /* keys in reverse order, mixed with unknown and non-text keys */
+    cbor_serialize_map_indefinite(&stream);
+    cbor_serialize_unicode_string(&stream, "temp");
+    cbor_serialize_int(&stream, -1);
+    cbor_serialize_unicode_string(&stream, "battery");
+    cbor_serialize_array(&stream, 2);
+    cbor_serialize_int(&stream, 3000);
+    cbor_serialize_unicode_string(&stream, "mV");
+    cbor_serialize_int(&stream, 42);
+    cbor_serialize_map(&stream, 1);
+    cbor_serialize_int(&stream, 1);
+    cbor_serialize_int(&stream, 2);
+    cbor_serialize_unicode_string(&stream, "seq");
+    cbor_serialize_int(&stream, 7);
+    cbor_write_break(&stream);
+
+    memcpy(&out, &record, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(stream.pos, cbor_deserialize_struct(&stream, 0, &record_schema, &out));
+    TEST_ASSERT_EQUAL_INT(7, out.seq);
+    TEST_ASSERT_EQUAL_INT(-1, out.temp);
+    /* fields without an entry are untouched */
+    TEST_ASSERT_EQUAL_STRING((const char *)record.name, (const char *)out.name);
+}
+
+static void test_struct_invalid(void)
+{
+    unsigned char data[16];
+    cbor_stream_t small = {data, sizeof(data), 0};
+    record_t out;
+
+    TEST_ASSERT_EQUAL_INT(0, cbor_serialize_struct(&small, &record_schema, &record));
+    TEST_ASSERT_EQUAL_INT(0, small.pos);
+
+    /* value does not fit into uint16_t */
+    cbor_serialize_map(&stream, 1);
+    cbor_serialize_unicode_string(&stream, "seq");
+    cbor_serialize_int(&stream, 70000);
+    TEST_ASSERT_EQUAL_INT(0, cbor_deserialize_struct(&stream, 0, &record_schema, &out));
+
+    /* string does not fit into name */
+    cbor_clear(&stream);
+    cbor_serialize_map(&stream, 1);
+    cbor_serialize_unicode_string(&stream, "name");
+    cbor_serialize_unicode_string(&stream, "too long");
+    TEST_ASSERT_EQUAL_INT(0, cbor_deserialize_struct(&stream, 0, &record_schema, &out));
+
+    /* truncated map */
+    cbor_clear(&stream);
+    cbor_serialize_map(&stream, 2);
+    cbor_serialize_unicode_string(&stream, "seq");
+    cbor_serialize_int(&stream, 1);
+    TEST_ASSERT_EQUAL_INT(0, cbor_deserialize_struct(&stream, 0, &record_schema, &out));
+}
+
 #ifndef CBOR_NO_PRINT
 /**
  * Manual test for testing the cbor_stream_decode function
@@ -787,6 +1157,18 @@ TestRef tests_cbor_all(void)
                         new_TestFixture(test_double),
                         new_TestFixture(test_double_invalid),
 #endif /* CBOR_NO_FLOAT */
+                        new_TestFixture(test_writer),
+                        new_TestFixture(test_writer_invalid),
+#ifdef MODULE_GNRC_PKTBUF
+                        new_TestFixture(test_pktbuf_writer),
+                        new_TestFixture(test_pktbuf_writer_invalid),
+#endif /* MODULE_GNRC_PKTBUF */
+                        new_TestFixture(test_reader),
+                        new_TestFixture(test_reader_invalid),
+                        new_TestFixture(test_reader_skip),
+                        new_TestFixture(test_struct),
+                        new_TestFixture(test_struct_unknown_keys),
+                        new_TestFixture(test_struct_invalid),
     };
 
     EMB_UNIT_TESTCALLER(CborTest, setUp, tearDown, fixtures);
@@ -13,7 +13,7 @@
 
 #include "tests-core.h"
 
-#define Q_LEN (4)
+#define Q_LEN (6)
 
 static priority_queue_t q = PRIORITY_QUEUE_INIT;
 static priority_queue_node_t qe[Q_LEN];
@@ -137,6 +137,94 @@ static void test_priority_queue_remove_one(void)
     TEST_ASSERT_NULL(root->first->next->next);
 }
 
+static void _add_mixed(priority_queue_t *root)
+{
+    /* priorities 5, 3, 5, 7, 3, 5 => order 1, 4, 0, 2, 5, 3 */
+    static const uint32_t prios[Q_LEN] = { 5, 3, 5, 7, 3, 5 };
+
+    for (unsigned i = 0; i < Q_LEN; i++) {
+        qe[i].data = i;
+        qe[i].priority = prios[i];
+        priority_queue_add(root, &(qe[i]));
+    }
+}
+
+static void _assert_order(priority_queue_t *root, const unsigned *order,
+                          unsigned len)
+{
+    priority_queue_node_t *node = root->first;
+
+    for (unsigned i = 0; i < len; i++) {
+        TEST_ASSERT_NOT_NULL(node);
+        TEST_ASSERT_EQUAL_INT(order[i], node->data);
+        node = node->next;
+    }
+    TEST_ASSERT_NULL(node);
+}
+
+static void test_priority_queue_add_mixed(void)
+{
+    static const unsigned order[] = { 1, 4, 0, 2, 5, 3 };
+    priority_queue_t *root = &q;
+
+    _add_mixed(root);
+
+    _assert_order(root, order, Q_LEN);
+}
+
+static void test_priority_queue_remove_head_mixed(void)
+{
+    static const unsigned order[] = { 4, 1, 0, 2, 5, 3 };
+    priority_queue_t *root = &q;
+    priority_queue_node_t *res;
+
+    _add_mixed(root);
+
+    /* re-added node goes behind the remaining nodes of its priority */
+    res = priority_queue_remove_head(root);
+    TEST_ASSERT_EQUAL_INT(1, res->data);
+    priority_queue_add(root, res);
+
+    for (unsigned i = 0; i < Q_LEN; i++) {
+        res = priority_queue_remove_head(root);
+        TEST_ASSERT_NOT_NULL(res);
+        TEST_ASSERT_EQUAL_INT(order[i], res->data);
+    }
+    TEST_ASSERT_NULL(priority_queue_remove_head(root));
+}
+
+static void test_priority_queue_remove_mixed(void)
+{
+    static const unsigned order1[] = { 1, 4, 2, 5, 3 };
+    static const unsigned order2[] = { 4, 2, 3 };
+    static const unsigned order3[] = { 4, 2, 5, 3 };
+    static const unsigned order4[] = { 4, 2, 5, 3, 1 };
+    priority_queue_t *root = &q;
+
+    _add_mixed(root);
+
+    /* first node of a bucket */
+    priority_queue_remove(root, &(qe[0]));
+    _assert_order(root, order1, 5);
+
+    /* first node of the queue, last node of a bucket */
+    priority_queue_remove(root, &(qe[1]));
+    priority_queue_remove(root, &(qe[5]));
+    _assert_order(root, order2, 3);
+
+    /* node not in the queue */
+    priority_queue_remove(root, &(qe[1]));
+    _assert_order(root, order2, 3);
+
+    /* buckets must still be intact */
+    qe[5].priority = 5;
+    priority_queue_add(root, &(qe[5]));
+    _assert_order(root, order3, 4);
+    qe[1].priority = 7;
+    priority_queue_add(root, &(qe[1]));
+    _assert_order(root, order4, 5);
+}
+
 Test *tests_core_priority_queue_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -146,6 +234,9 @@ Test *tests_core_priority_queue_tests(void)
         new_TestFixture(test_priority_queue_add_two_equal),
         new_TestFixture(test_priority_queue_add_two_distinct),
         new_TestFixture(test_priority_queue_remove_one),
+        new_TestFixture(test_priority_queue_add_mixed),
+        new_TestFixture(test_priority_queue_remove_head_mixed),
+        new_TestFixture(test_priority_queue_remove_mixed),
     };
 
     EMB_UNIT_TESTCALLER(core_priority_queue_tests, set_up, NULL,
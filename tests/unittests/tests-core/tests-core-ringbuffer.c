@@ -16,6 +16,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <string.h>
+
 #include "thread.h"
 #include "flags.h"
 #include "kernel.h"
@@ -115,10 +117,68 @@ static void tests_core_ringbuffer(void)
     run_add();
 }
 
+static void tests_core_ringbuffer_bulk(void)
+{
+    char buf[BUF_SIZE];
+    char out[BUF_SIZE + 1];
+    ringbuffer_t bulk;
+
+    ringbuffer_init(&bulk, buf, sizeof(buf));
+
+    /* move the start, so the next add wraps around */
+    TEST_ASSERT_EQUAL_INT(5, ringbuffer_add(&bulk, "abcde", 5));
+    TEST_ASSERT_EQUAL_INT(4, ringbuffer_get(&bulk, out, 4));
+    TEST_ASSERT_EQUAL_INT(6, ringbuffer_add(&bulk, "fghijklm", 8));
+    TEST_ASSERT(ringbuffer_full(&bulk));
+    TEST_ASSERT_EQUAL_INT(0, ringbuffer_add(&bulk, "n", 1));
+
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, ringbuffer_get(&bulk, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("efghijk", out, BUF_SIZE));
+    TEST_ASSERT(ringbuffer_empty(&bulk));
+}
+
+static void tests_core_ringbuffer_region(void)
+{
+    char buf[BUF_SIZE];
+    ringbuffer_t region_rb;
+    char *region;
+
+    ringbuffer_init(&region_rb, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, ringbuffer_add_region(&region_rb, &region));
+    memcpy(region, "abcde", 5);
+    TEST_ASSERT_EQUAL_INT(5, ringbuffer_add_commit(&region_rb, 5));
+
+    TEST_ASSERT_EQUAL_INT(5, ringbuffer_get_region(&region_rb, &region));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("abc", region, 3));
+    TEST_ASSERT_EQUAL_INT(3, ringbuffer_remove(&region_rb, 3));
+
+    /* the free space wraps: first the end, then the start of buf */
+    TEST_ASSERT_EQUAL_INT(2, ringbuffer_add_region(&region_rb, &region));
+    memcpy(region, "fg", 2);
+    ringbuffer_add_commit(&region_rb, 2);
+    TEST_ASSERT_EQUAL_INT(3, ringbuffer_add_region(&region_rb, &region));
+    TEST_ASSERT(region == buf);
+    memcpy(region, "hij", 3);
+    ringbuffer_add_commit(&region_rb, 3);
+    TEST_ASSERT(ringbuffer_full(&region_rb));
+    TEST_ASSERT_EQUAL_INT(0, ringbuffer_add_region(&region_rb, &region));
+
+    TEST_ASSERT_EQUAL_INT(4, ringbuffer_get_region(&region_rb, &region));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("defg", region, 4));
+    ringbuffer_remove(&region_rb, 4);
+    TEST_ASSERT_EQUAL_INT(3, ringbuffer_get_region(&region_rb, &region));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("hij", region, 3));
+    ringbuffer_remove(&region_rb, 3);
+    TEST_ASSERT(ringbuffer_empty(&region_rb));
+}
+
 Test *tests_core_ringbuffer_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(tests_core_ringbuffer),
+        new_TestFixture(tests_core_ringbuffer_bulk),
+        new_TestFixture(tests_core_ringbuffer_region),
     };
 
     EMB_UNIT_TESTCALLER(ringbuffer_tests, NULL, NULL, fixtures);
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/ieee802154.h"
+#include "net/gnrc/ieee802154.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "tests-gnrc_ieee802154.h"
+
+#define TEST_PAN        (0xabcd)
+#define TEST_SEQ        (0x42)
+
+static const uint8_t short_src[] = { 0x12, 0x34 };
+static const uint8_t long_src[] = {
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17
+};
+static const uint8_t short_dst[] = { 0x56, 0x78 };
+static const uint8_t long_dst[] = {
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27
+};
+static const uint8_t bcast[] = { 0xff, 0xff };
+
+static gnrc_ieee802154_hdr_cache_t cache;
+static uint8_t netif_buf[sizeof(gnrc_netif_hdr_t) + 8];
+
+static void set_up(void)
+{
+    memset(&cache, 0, sizeof(cache));
+    gnrc_pktbuf_init();
+}
+
+static gnrc_netif_hdr_t *_netif(const uint8_t *dst, uint8_t dst_len,
+                                uint8_t flags)
+{
+    gnrc_netif_hdr_t *netif = (gnrc_netif_hdr_t *)netif_buf;
+
+    gnrc_netif_hdr_init(netif, 0, dst_len);
+    if (dst_len > 0) {
+        gnrc_netif_hdr_set_dst_addr(netif, (uint8_t *)dst, dst_len);
+    }
+    netif->flags = flags;
+    return netif;
+}
+
+static void _cfg(gnrc_ieee802154_cfg_t *cfg, uint8_t src_len, uint8_t opts)
+{
+    memset(cfg, 0, sizeof(gnrc_ieee802154_cfg_t));
+    cfg->pan = TEST_PAN;
+    cfg->opts = opts;
+    cfg->src_len = src_len;
+    memcpy(cfg->src, (src_len == 8) ? long_src : short_src, src_len);
+}
+
+static void _check_reversed(const uint8_t *wire, const uint8_t *addr,
+                            uint8_t len)
+{
+    for (unsigned i = 0; i < len; i++) {
+        TEST_ASSERT_EQUAL_INT(addr[len - 1 - i], wire[i]);
+    }
+}
+
+/* build and parse a header for one combination of addressing modes */
+static void _test_combination(const uint8_t *dst, uint8_t dst_len,
+                              uint8_t flags, uint8_t src_len, uint8_t opts)
+{
+    gnrc_ieee802154_cfg_t cfg;
+    gnrc_pktsnip_t *snip;
+    gnrc_netif_hdr_t *netif;
+    uint8_t mhr[IEEE802154_MAX_HDR_LEN];
+    uint8_t wire_dst_len = (flags) ? 2 : dst_len;
+    int src_pan = (opts & GNRC_IEEE802154_OPT_USE_SRC_PAN);
+    size_t exp_len = 5 + wire_dst_len + (src_pan ? 2 : 0) + src_len;
+    size_t len, pos = 3;
+
+    _cfg(&cfg, src_len, opts);
+    netif = _netif(dst, dst_len, flags);
+    len = gnrc_ieee802154_build_hdr(&cache, &cfg, netif, TEST_SEQ, mhr);
+    TEST_ASSERT_EQUAL_INT(exp_len, len);
+    TEST_ASSERT_EQUAL_INT(exp_len, gnrc_ieee802154_get_hdr_len(mhr));
+
+    /* frame control field and sequence number */
+    TEST_ASSERT_EQUAL_INT(IEEE802154_FCF_TYPE_DATA,
+                          mhr[0] & IEEE802154_FCF_TYPE_MASK);
+    TEST_ASSERT_EQUAL_INT(!src_pan, !!(mhr[0] & IEEE802154_FCF_PAN_COMP));
+    TEST_ASSERT_EQUAL_INT(!flags && (opts & GNRC_IEEE802154_OPT_ACK_REQ),
+                          !!(mhr[0] & IEEE802154_FCF_ACK_REQ));
+    TEST_ASSERT_EQUAL_INT((wire_dst_len == 8) ? IEEE802154_FCF_DST_ADDR_LONG
+                                              : IEEE802154_FCF_DST_ADDR_SHORT,
+                          mhr[1] & IEEE802154_FCF_DST_ADDR_MASK);
+    TEST_ASSERT_EQUAL_INT((src_len == 8) ? IEEE802154_FCF_SRC_ADDR_LONG
+                                         : IEEE802154_FCF_SRC_ADDR_SHORT,
+                          mhr[1] & IEEE802154_FCF_SRC_ADDR_MASK);
+    TEST_ASSERT_EQUAL_INT(TEST_SEQ, mhr[2]);
+
+    /* addressing fields */
+    TEST_ASSERT_EQUAL_INT(TEST_PAN & 0xff, mhr[pos++]);
+    TEST_ASSERT_EQUAL_INT(TEST_PAN >> 8, mhr[pos++]);
+    _check_reversed(&mhr[pos], (flags) ? bcast : dst, wire_dst_len);
+    pos += wire_dst_len;
+    if (src_pan) {
+        TEST_ASSERT_EQUAL_INT(TEST_PAN & 0xff, mhr[pos++]);
+        TEST_ASSERT_EQUAL_INT(TEST_PAN >> 8, mhr[pos++]);
+    }
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&mhr[pos], cfg.src, src_len));
+
+    /* and back to a netif header */
+    TEST_ASSERT_NOT_NULL((snip = gnrc_ieee802154_make_netif_hdr(mhr, len)));
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_NETIF, snip->type);
+    netif = snip->data;
+    TEST_ASSERT_EQUAL_INT(wire_dst_len, netif->dst_l2addr_len);
+    TEST_ASSERT_EQUAL_INT(src_len, netif->src_l2addr_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(gnrc_netif_hdr_get_dst_addr(netif),
+                                    (flags) ? bcast : dst, wire_dst_len));
+    _check_reversed(&mhr[pos], gnrc_netif_hdr_get_src_addr(netif), src_len);
+    gnrc_pktbuf_release(snip);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_ieee802154__all_combinations(void)
+{
+    static const uint8_t opts[] = {
+        0, GNRC_IEEE802154_OPT_ACK_REQ, GNRC_IEEE802154_OPT_USE_SRC_PAN,
+        GNRC_IEEE802154_OPT_ACK_REQ | GNRC_IEEE802154_OPT_USE_SRC_PAN
+    };
+
+    for (unsigned o = 0; o < sizeof(opts); o++) {
+        for (uint8_t src_len = 2; src_len <= 8; src_len += 6) {
+            _test_combination(short_dst, sizeof(short_dst), 0, src_len,
+                              opts[o]);
+            _test_combination(long_dst, sizeof(long_dst), 0, src_len,
+                              opts[o]);
+            _test_combination(NULL, 0, GNRC_NETIF_HDR_FLAGS_BROADCAST,
+                              src_len, opts[o]);
+            _test_combination(long_dst, sizeof(long_dst),
+                              GNRC_NETIF_HDR_FLAGS_MULTICAST, src_len,
+                              opts[o]);
+        }
+    }
+}
+
+static void test_gnrc_ieee802154_build_hdr__bytes(void)
+{
+    static const uint8_t exp[] = {
+        0x61, 0x98, TEST_SEQ, 0xcd, 0xab, 0x78, 0x56, 0x12, 0x34
+    };
+    gnrc_ieee802154_cfg_t cfg;
+    uint8_t mhr[IEEE802154_MAX_HDR_LEN];
+
+    _cfg(&cfg, sizeof(short_src), GNRC_IEEE802154_OPT_ACK_REQ);
+    TEST_ASSERT_EQUAL_INT(sizeof(exp), gnrc_ieee802154_build_hdr(&cache, &cfg,
+                          _netif(short_dst, sizeof(short_dst), 0), TEST_SEQ,
+                          mhr));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, mhr, sizeof(exp)));
+}
+
+static void test_gnrc_ieee802154_build_hdr__unsupported_dst(void)
+{
+    gnrc_ieee802154_cfg_t cfg;
+    uint8_t mhr[IEEE802154_MAX_HDR_LEN];
+
+    _cfg(&cfg, sizeof(short_src), 0);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ieee802154_build_hdr(&cache, &cfg,
+                          _netif(long_dst, 4, 0), TEST_SEQ, mhr));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ieee802154_build_hdr(&cache, &cfg,
+                          _netif(NULL, 0, 0), TEST_SEQ, mhr));
+}
+
+static void test_gnrc_ieee802154_build_hdr__cached(void)
+{
+    gnrc_ieee802154_cfg_t cfg;
+    uint8_t first[IEEE802154_MAX_HDR_LEN], mhr[IEEE802154_MAX_HDR_LEN];
+    size_t len;
+
+    _cfg(&cfg, sizeof(long_src), 0);
+    len = gnrc_ieee802154_build_hdr(&cache, &cfg,
+                                    _netif(long_dst, sizeof(long_dst), 0),
+                                    1, first);
+    /* fill the cache with other destinations, the first one stays */
+    for (unsigned i = 1; i < GNRC_IEEE802154_HDR_CACHE_SIZE; i++) {
+        uint8_t dst[] = { 0x00, (uint8_t)i };
+        gnrc_ieee802154_build_hdr(&cache, &cfg, _netif(dst, sizeof(dst), 0),
+                                  1, mhr);
+    }
+    TEST_ASSERT_EQUAL_INT(len, gnrc_ieee802154_build_hdr(&cache, &cfg,
+                          _netif(long_dst, sizeof(long_dst), 0), 2, mhr));
+    /* only the sequence number differs */
+    TEST_ASSERT_EQUAL_INT(2, mhr[2]);
+    mhr[2] = first[2];
+    TEST_ASSERT_EQUAL_INT(0, memcmp(first, mhr, len));
+}
+
+static void test_gnrc_ieee802154_build_hdr__evicted(void)
+{
+    gnrc_ieee802154_cfg_t cfg;
+    uint8_t mhr[IEEE802154_MAX_HDR_LEN];
+
+    _cfg(&cfg, sizeof(short_src), 0);
+    /* more destinations than entries */
+    for (unsigned i = 0; i <= 2 * GNRC_IEEE802154_HDR_CACHE_SIZE; i++) {
+        uint8_t dst[] = { 0x00, (uint8_t)i };
+        TEST_ASSERT_EQUAL_INT(9, gnrc_ieee802154_build_hdr(&cache, &cfg,
+                              _netif(dst, sizeof(dst), 0), 0, mhr));
+        TEST_ASSERT_EQUAL_INT(i, mhr[5]);
+        TEST_ASSERT_EQUAL_INT(0, mhr[6]);
+    }
+}
+
+static void test_gnrc_ieee802154_build_hdr__cfg_changed(void)
+{
+    gnrc_ieee802154_cfg_t cfg;
+    uint8_t mhr[IEEE802154_MAX_HDR_LEN];
+    gnrc_netif_hdr_t *netif = _netif(short_dst, sizeof(short_dst), 0);
+
+    _cfg(&cfg, sizeof(short_src), 0);
+    gnrc_ieee802154_build_hdr(&cache, &cfg, netif, 0, mhr);
+    cfg.pan = 0x1234;
+    TEST_ASSERT_EQUAL_INT(9, gnrc_ieee802154_build_hdr(&cache, &cfg, netif, 0,
+                                                       mhr));
+    TEST_ASSERT_EQUAL_INT(0x34, mhr[3]);
+    TEST_ASSERT_EQUAL_INT(0x12, mhr[4]);
+    _cfg(&cfg, sizeof(long_src), 0);
+    TEST_ASSERT_EQUAL_INT(15, gnrc_ieee802154_build_hdr(&cache, &cfg, netif, 0,
+                                                        mhr));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&mhr[7], long_src, sizeof(long_src)));
+}
+
+static void test_gnrc_ieee802154_get_hdr_len__void_addresses(void)
+{
+    /* no addresses at all */
+    uint8_t none[] = { IEEE802154_FCF_TYPE_DATA, 0 };
+    /* source only, the PAN ID is never compressed without destination */
+    uint8_t src_only[] = { IEEE802154_FCF_TYPE_DATA | IEEE802154_FCF_PAN_COMP,
+                           IEEE802154_FCF_SRC_ADDR_LONG };
+    /* destination only */
+    uint8_t dst_only[] = { IEEE802154_FCF_TYPE_DATA,
+                           IEEE802154_FCF_DST_ADDR_SHORT };
+
+    TEST_ASSERT_EQUAL_INT(3, gnrc_ieee802154_get_hdr_len(none));
+    TEST_ASSERT_EQUAL_INT(13, gnrc_ieee802154_get_hdr_len(src_only));
+    TEST_ASSERT_EQUAL_INT(7, gnrc_ieee802154_get_hdr_len(dst_only));
+}
+
+static void test_gnrc_ieee802154_get_hdr_len__reserved(void)
+{
+    uint8_t dst[] = { IEEE802154_FCF_TYPE_DATA, 0x04 };
+    uint8_t src[] = { IEEE802154_FCF_TYPE_DATA, 0x48 };
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ieee802154_get_hdr_len(dst));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ieee802154_get_hdr_len(src));
+}
+
+static void test_gnrc_ieee802154_make_netif_hdr__src_only(void)
+{
+    uint8_t mhr[] = { IEEE802154_FCF_TYPE_DATA,
+                      IEEE802154_FCF_SRC_ADDR_SHORT, TEST_SEQ,
+                      0xcd, 0xab, 0x34, 0x12 };
+    gnrc_pktsnip_t *snip;
+    gnrc_netif_hdr_t *netif;
+
+    TEST_ASSERT_NOT_NULL((snip = gnrc_ieee802154_make_netif_hdr(mhr,
+                                                                sizeof(mhr))));
+    netif = snip->data;
+    TEST_ASSERT_EQUAL_INT(0, netif->dst_l2addr_len);
+    TEST_ASSERT_EQUAL_INT(2, netif->src_l2addr_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(gnrc_netif_hdr_get_src_addr(netif),
+                                    short_src, sizeof(short_src)));
+    gnrc_pktbuf_release(snip);
+}
+
+static void test_gnrc_ieee802154_make_netif_hdr__truncated(void)
+{
+    uint8_t mhr[] = { IEEE802154_FCF_TYPE_DATA | IEEE802154_FCF_PAN_COMP,
+                      IEEE802154_FCF_DST_ADDR_LONG |
+                      IEEE802154_FCF_SRC_ADDR_LONG, TEST_SEQ,
+                      0xcd, 0xab };
+
+    TEST_ASSERT_NULL(gnrc_ieee802154_make_netif_hdr(mhr, sizeof(mhr)));
+    TEST_ASSERT_NULL(gnrc_ieee802154_make_netif_hdr(mhr, 1));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_gnrc_ieee802154_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_ieee802154__all_combinations),
+        new_TestFixture(test_gnrc_ieee802154_build_hdr__bytes),
+        new_TestFixture(test_gnrc_ieee802154_build_hdr__unsupported_dst),
+        new_TestFixture(test_gnrc_ieee802154_build_hdr__cached),
+        new_TestFixture(test_gnrc_ieee802154_build_hdr__evicted),
+        new_TestFixture(test_gnrc_ieee802154_build_hdr__cfg_changed),
+        new_TestFixture(test_gnrc_ieee802154_get_hdr_len__void_addresses),
+        new_TestFixture(test_gnrc_ieee802154_get_hdr_len__reserved),
+        new_TestFixture(test_gnrc_ieee802154_make_netif_hdr__src_only),
+        new_TestFixture(test_gnrc_ieee802154_make_netif_hdr__truncated),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_ieee802154_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_ieee802154_tests;
+}
+
+void tests_gnrc_ieee802154(void)
+{
+    TESTS_RUN(tests_gnrc_ieee802154_tests());
+}
+/** @} */
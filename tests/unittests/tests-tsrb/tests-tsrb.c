@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit/embUnit.h"
+
+#include "tsrb.h"
+#include "tests-tsrb.h"
+
+#define BUF_SIZE    (8U)
+
+static char buf[BUF_SIZE];
+static tsrb_t rb;
+
+static void set_up(void)
+{
+    tsrb_init(&rb, buf, sizeof(buf));
+}
+
+static void test_tsrb_add_get_wrap(void)
+{
+    char out[BUF_SIZE + 1];
+
+    /* move the read position, so the next add wraps around */
+    TEST_ASSERT_EQUAL_INT(6, tsrb_add(&rb, "abcdef", 6));
+    TEST_ASSERT_EQUAL_INT(5, tsrb_get(&rb, out, 5));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("abcde", out, 5));
+
+    TEST_ASSERT_EQUAL_INT(7, tsrb_add(&rb, "ghijklmnop", 10));
+    TEST_ASSERT(tsrb_full(&rb));
+    TEST_ASSERT_EQUAL_INT(-1, tsrb_add_one(&rb, 'q'));
+
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, tsrb_get(&rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("fghijklm", out, BUF_SIZE));
+    TEST_ASSERT(tsrb_empty(&rb));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_get(&rb, out, sizeof(out)));
+}
+
+static void test_tsrb_regions(void)
+{
+    char *region;
+
+    TEST_ASSERT_EQUAL_INT(0, tsrb_get_region(&rb, &region));
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, tsrb_add_region(&rb, &region));
+    memcpy(region, "abcdef", 6);
+    tsrb_add_commit(&rb, 6);
+    TEST_ASSERT_EQUAL_INT(6, tsrb_avail(&rb));
+
+    TEST_ASSERT_EQUAL_INT(6, tsrb_get_region(&rb, &region));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("abcd", region, 4));
+    tsrb_get_commit(&rb, 4);
+
+    /* free space: 2 bytes at the end, then 4 at the start of buf */
+    TEST_ASSERT_EQUAL_INT(2, tsrb_add_region(&rb, &region));
+    memcpy(region, "gh", 2);
+    tsrb_add_commit(&rb, 2);
+    TEST_ASSERT_EQUAL_INT(4, tsrb_add_region(&rb, &region));
+    TEST_ASSERT(region == buf);
+    memcpy(region, "ijkl", 4);
+    tsrb_add_commit(&rb, 4);
+    TEST_ASSERT(tsrb_full(&rb));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_add_region(&rb, &region));
+
+    TEST_ASSERT_EQUAL_INT(4, tsrb_get_region(&rb, &region));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("efgh", region, 4));
+    tsrb_get_commit(&rb, 4);
+    TEST_ASSERT_EQUAL_INT(4, tsrb_get_region(&rb, &region));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("ijkl", region, 4));
+    tsrb_get_commit(&rb, 4);
+    TEST_ASSERT(tsrb_empty(&rb));
+}
+
+Test *tests_tsrb_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_tsrb_add_get_wrap),
+        new_TestFixture(test_tsrb_regions),
+    };
+
+    EMB_UNIT_TESTCALLER(tsrb_tests, set_up, NULL, fixtures);
+
+    return (Test *)&tsrb_tests;
+}
+
+void tests_tsrb(void)
+{
+    TESTS_RUN(tests_tsrb_tests());
+}
+/** @} */
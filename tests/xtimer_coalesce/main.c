@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2016 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Counts xtimer interrupts per simulated hour with and without
+ *              slack
+ *
+ * A set of periodic timers with periods typical for network protocol
+ * housekeeping is run for one simulated hour, once per slack setting. One
+ * simulated second lasts one millisecond. The low-level timer interrupts are
+ * counted by xtimer (xtimer_stats), the test fails unless every setting with
+ * slack needs fewer interrupts than the run without slack.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "irq.h"
+#include "xtimer.h"
+
+/* one simulated second in microseconds */
+#define SIM_SEC             (1000U)
+#define SIM_HOUR            (3600U * SIM_SEC)
+
+#define PERIODIC_NUMOF         (sizeof(periods) / sizeof(periods[0]))
+
+typedef struct {
+    xtimer_t timer;
+    uint32_t period;
+    uint32_t slack;
+} periodic_t;
+
+/* periods in simulated seconds */
+static const uint32_t periods[] = { 2, 3, 5, 7, 10, 13, 30, 60 };
+static const unsigned slack_percent[] = { 0, 10, 25, 50 };
+
+static periodic_t timers[PERIODIC_NUMOF];
+static volatile unsigned callbacks;
+
+static void _fire(void *arg)
+{
+    periodic_t *p = (periodic_t *)arg;
+
+    callbacks++;
+
+    xtimer_set_slack(&p->timer, p->period, p->slack);
+}
+
+static uint32_t _run(unsigned percent)
+{
+    uint32_t interrupts;
+
+    callbacks = 0;
+    interrupts = xtimer_isr_count;
+
+    for (unsigned i = 0; i < PERIODIC_NUMOF; i++) {
+        periodic_t *p = &timers[i];
+        p->timer.callback = _fire;
+        p->timer.arg = p;
+        p->period = periods[i] * SIM_SEC;
+        p->slack = (p->period / 100) * percent;
+        xtimer_set_slack(&p->timer, p->period, p->slack);
+    }
+
+    xtimer_usleep(SIM_HOUR);
+
+    unsigned state = disableIRQ();
+    for (unsigned i = 0; i < PERIODIC_NUMOF; i++) {
+        xtimer_remove(&timers[i].timer);
+    }
+    interrupts = xtimer_isr_count - interrupts;
+    restoreIRQ(state);
+
+    printf("slack %2u%%: %5u callbacks, %5" PRIu32 " interrupts\n", percent,
+           callbacks, interrupts);
+    return interrupts;
+}
+
+int main(void)
+{
+    puts("xtimer coalescing benchmark");
+    printf("%u periodic timers, timer interrupts per simulated hour:\n",
+           (unsigned)PERIODIC_NUMOF);
+
+    uint32_t no_slack = _run(slack_percent[0]);
+    int failed = 0;
+
+    for (unsigned i = 1; i < sizeof(slack_percent) / sizeof(slack_percent[0]); i++) {
+        if (_run(slack_percent[i]) >= no_slack) {
+            printf("slack %u%% did not reduce the number of interrupts\n",
+                   slack_percent[i]);
+            failed = 1;
+        }
+    }
+
+    if (failed) {
+        puts("[FAILED]");
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}